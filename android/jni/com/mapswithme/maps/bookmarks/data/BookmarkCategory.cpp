@@ -33,7 +33,7 @@ Java_com_mapswithme_maps_bookmarks_data_BookmarkCategory_nativeSetVisibility(
   BookmarkCategory * pCat = getBmCategory(id);
   pCat->SetIsVisible(b);
   pCat->NotifyChanges();
-  pCat->SaveToKMLFile();
+  pCat->SaveToFile();
 }
 
 JNIEXPORT void JNICALL
@@ -42,7 +42,7 @@ Java_com_mapswithme_maps_bookmarks_data_BookmarkCategory_nativeSetName(
 {
   BookmarkCategory * pCat = getBmCategory(id);
   pCat->SetName(jni::ToNativeString(env, n));
-  pCat->SaveToKMLFile();
+  pCat->SaveToFile();
 }
 
 JNIEXPORT jstring JNICALL
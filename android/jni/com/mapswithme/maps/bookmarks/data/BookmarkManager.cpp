@@ -4,9 +4,12 @@
 #include "com/mapswithme/maps/Framework.hpp"
 #include "com/mapswithme/maps/UserMarkHelper.hpp"
 
+#include "coding/internal/file_data.hpp"
 #include "coding/zip_creator.hpp"
 #include "map/place_page_info.hpp"
 
+#include "defines.hpp"
+
 namespace
 {
 ::Framework * frm() { return g_framework->NativeFramework(); }
@@ -21,7 +24,7 @@ void RemoveBookmark(int cat, int bmk)
   {
     pCat->DeleteUserMark(bmk);
     pCat->NotifyChanges();
-    pCat->SaveToKMLFile();
+    pCat->SaveToFile();
   }
 }
 }  // namespace bookmarks_helper
@@ -79,7 +82,7 @@ Java_com_mapswithme_maps_bookmarks_data_BookmarkManager_nativeDeleteTrack(
   {
     pCat->DeleteTrack(trk);
     pCat->NotifyChanges();
-    pCat->SaveToKMLFile();
+    pCat->SaveToFile();
   }
 }
 
@@ -91,7 +94,13 @@ Java_com_mapswithme_maps_bookmarks_data_BookmarkManager_nativeSaveToKmzFile(
   if (pCat)
   {
     std::string const name = pCat->GetName();
-    if (CreateZipFromPathDeflatedAndDefaultCompression(pCat->GetFileName(), ToNativeString(env, tmpPath) + name + ".kmz"))
+    std::string const path = ToNativeString(env, tmpPath) + name;
+    // Bookmarks are stored in the binary format, they are shared as kml.
+    std::string const kmlFile = path + BOOKMARKS_FILE_EXTENSION;
+    bool const isSaved = pCat->ExportToKMLFile(kmlFile) &&
+                         CreateZipFromPathDeflatedAndDefaultCompression(kmlFile, path + ".kmz");
+    my::DeleteFileX(kmlFile);
+    if (isSaved)
       return ToJavaString(env, name);
   }
 
@@ -285,4 +285,11 @@ bool HttpClient::RunHttpRequest()
   }
   return true;
 }
+
+// static
+void HttpClient::RunHttpRequests(vector<HttpClient *> const & requests)
+{
+  for (auto request : requests)
+    request->RunHttpRequest();
+}
 }  // namespace platform
@@ -28,6 +28,7 @@ SOURCES += \
     reader_streambuf.cpp \
     reader_writer_ops.cpp \
     simple_dense_coding.cpp \
+    symbol_table.cpp \
     traffic.cpp \
     transliteration.cpp \
     uri.cpp \
@@ -84,6 +85,7 @@ HEADERS += \
     streams_common.hpp \
     streams_sink.hpp \
     succinct_mapper.hpp \
+    symbol_table.hpp \
     text_storage.hpp \
     traffic.hpp \
     transliteration.hpp \
@@ -46,6 +46,7 @@ SOURCES += ../../testing/testingmain.cpp \
     reader_writer_ops_test.cpp \
     simple_dense_coding_test.cpp \
     succinct_mapper_test.cpp \
+    symbol_table_test.cpp \
     text_storage_tests.cpp \
     traffic_test.cpp \
     uri_test.cpp \
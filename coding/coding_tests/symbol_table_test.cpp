@@ -0,0 +1,80 @@
+#include "testing/testing.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/symbol_table.hpp"
+#include "coding/writer.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace coding;
+using namespace std;
+
+namespace
+{
+string EncodeAndDecode(SymbolTable const & table, string const & s)
+{
+  string encoded;
+  table.Encode(s, encoded);
+
+  string decoded;
+  table.Decode(encoded.data(), encoded.data() + encoded.size(), decoded);
+  return decoded;
+}
+
+UNIT_TEST(SymbolTable_Smoke)
+{
+  SymbolTable table;
+  TEST_EQUAL(EncodeAndDecode(table, ""), "", ());
+  TEST_EQUAL(EncodeAndDecode(table, "abc"), "abc", ());
+
+  vector<string> const sample = {"hello world", "hello there", "world of hello", "hello"};
+  table.Build(sample);
+  TEST_GREATER(table.GetNumSymbols(), 0, ());
+  TEST_LESS_OR_EQUAL(table.GetNumSymbols(), SymbolTable::kMaxSymbols, ());
+
+  for (auto const & s : sample)
+  {
+    string encoded;
+    table.Encode(s, encoded);
+    TEST_LESS(encoded.size(), s.size(), (s));
+    TEST_EQUAL(EncodeAndDecode(table, s), s, ());
+  }
+
+  // Bytes which are not in the table are escaped.
+  string const s = {'\0', '\xff', 'x', 'h', 'e', 'l', 'l', 'o'};
+  TEST_EQUAL(EncodeAndDecode(table, s), s, ());
+}
+
+UNIT_TEST(SymbolTable_Serialization)
+{
+  vector<string> const sample = {"abracadabra", "cadabra", "abra"};
+  SymbolTable table;
+  table.Build(sample);
+
+  vector<uint8_t> buffer;
+  {
+    MemWriter<vector<uint8_t>> writer(buffer);
+    table.Serialize(writer);
+  }
+
+  SymbolTable copy;
+  {
+    MemReader reader(buffer.data(), buffer.size());
+    ReaderSource<MemReader> source(reader);
+    copy.Deserialize(source);
+    TEST_EQUAL(source.Size(), 0, ());
+  }
+
+  TEST_EQUAL(copy.GetNumSymbols(), table.GetNumSymbols(), ());
+  for (auto const & s : sample)
+  {
+    string encoded;
+    table.Encode(s, encoded);
+    string decoded;
+    copy.Decode(encoded.data(), encoded.data() + encoded.size(), decoded);
+    TEST_EQUAL(decoded, s, ());
+  }
+}
+}  // namespace
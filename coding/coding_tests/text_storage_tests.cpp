@@ -4,6 +4,9 @@
 #include "coding/text_storage.hpp"
 #include "coding/writer.hpp"
 
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
 #include <cstdint>
 #include <random>
 #include <string>
@@ -31,10 +34,34 @@ string GenerateRandomString(Engine & engine)
   return s;
 }
 
-void DumpStrings(vector<string> const & strings, uint64_t blockSize, vector<uint8_t> & buffer)
+// Generates a text of random words from a small vocabulary, like a review.
+template <typename Engine>
+string GenerateRandomText(Engine & engine)
+{
+  static vector<string> const kWords = {
+      "the",     "a",      "and",      "was",    "very",   "good",  "nice",  "place",
+      "staff",   "food",   "service",  "room",   "clean",  "great", "we",    "stayed",
+      "there",   "for",    "two",      "nights", "would",  "not",   "again", "recommend",
+      "location", "price", "breakfast", "friendly", "hotel", "cafe",  "excellent", "bad"};
+
+  uniform_int_distribution<size_t> length(5, 60);
+  uniform_int_distribution<size_t> word(0, kWords.size() - 1);
+
+  string s;
+  for (size_t i = length(engine); i != 0; --i)
+  {
+    if (!s.empty())
+      s += ' ';
+    s += kWords[word(engine)];
+  }
+  return s;
+}
+
+void DumpStrings(vector<string> const & strings, uint64_t blockSize, vector<uint8_t> & buffer,
+                 BlockedTextStorageCodec codec = BlockedTextStorageCodec::BWT)
 {
   MemWriter<vector<uint8_t>> writer(buffer);
-  BlockedTextStorageWriter<decltype(writer)> ts(writer, blockSize);
+  BlockedTextStorageWriter<decltype(writer)> ts(writer, blockSize, codec);
   for (auto const & s : strings)
     ts.Append(s);
 }
@@ -129,4 +156,121 @@ UNIT_TEST(TextStorage_Random)
   for (size_t i = ts.GetNumStrings() - 1; i < ts.GetNumStrings(); --i)
     TEST_EQUAL(ts.ExtractString(i), strings[i], ());
 }
+
+UNIT_TEST(TextStorage_SymbolTable)
+{
+  int const kSeed = 42;
+  int const kNumStrings = 1000;
+  mt19937 engine(kSeed);
+
+  vector<string> strings;
+  for (int i = 0; i < kNumStrings; ++i)
+  {
+    strings.push_back(i % 2 == 0 ? GenerateRandomText(engine) : GenerateRandomString(engine));
+    if (i % 100 == 0)
+      strings.emplace_back();
+  }
+
+  for (uint64_t const blockSize : {1, 1000, 100000})
+  {
+    vector<uint8_t> buffer;
+    DumpStrings(strings, blockSize, buffer, BlockedTextStorageCodec::SymbolTable);
+
+    MemReader reader(buffer.data(), buffer.size());
+    BlockedTextStorageIndex index;
+    index.Read(reader);
+    TEST(index.GetCodec() == BlockedTextStorageCodec::SymbolTable, ());
+
+    BlockedTextStorage<decltype(reader)> ts(reader);
+    TEST_EQUAL(ts.GetNumStrings(), strings.size(), ());
+    for (size_t i = ts.GetNumStrings() - 1; i < ts.GetNumStrings(); --i)
+      TEST_EQUAL(ts.ExtractString(i), strings[i], (blockSize));
+  }
+}
+
+UNIT_TEST(TextStorage_CacheBudget)
+{
+  int const kSeed = 42;
+  int const kNumStrings = 1000;
+  size_t const kCacheBudget = 2000;
+  mt19937 engine(kSeed);
+
+  vector<string> strings;
+  for (int i = 0; i < kNumStrings; ++i)
+    strings.push_back(GenerateRandomString(engine));
+
+  vector<uint8_t> buffer;
+  DumpStrings(strings, 1000 /* blockSize */, buffer);
+
+  MemReader reader(buffer.data(), buffer.size());
+  BlockedTextStorage<decltype(reader)> ts(reader, kCacheBudget);
+
+  uniform_int_distribution<size_t> index(0, strings.size() - 1);
+  for (int i = 0; i < 10 * kNumStrings; ++i)
+  {
+    auto const j = index(engine);
+    TEST_EQUAL(ts.ExtractString(j), strings[j], ());
+
+    // Each block is smaller than the budget, so the budget is never exceeded.
+    TEST_GREATER(ts.GetCacheSize(), 0, ());
+    TEST_LESS_OR_EQUAL(ts.GetCacheSize(), kCacheBudget, ());
+  }
+
+  ts.ClearCache();
+  TEST_EQUAL(ts.GetCacheSize(), 0, ());
+}
+
+// Compares sizes and latencies of access to random strings for both codecs.
+UNIT_TEST(TextStorage_CodecsBenchmark)
+{
+  int const kSeed = 42;
+  int const kNumStrings = 10000;
+  // BWT decoding of a block takes tens of milliseconds.
+  int const kNumQueries = 20;
+  uint64_t const kBlockSize = 200000;
+  mt19937 engine(kSeed);
+
+  vector<string> strings;
+  size_t size = 0;
+  for (int i = 0; i < kNumStrings; ++i)
+  {
+    strings.push_back(GenerateRandomText(engine));
+    size += strings.back().size();
+  }
+
+  vector<size_t> queries;
+  uniform_int_distribution<size_t> index(0, strings.size() - 1);
+  for (int i = 0; i < kNumQueries; ++i)
+    queries.push_back(index(engine));
+
+  for (auto const codec : {BlockedTextStorageCodec::BWT, BlockedTextStorageCodec::SymbolTable})
+  {
+    vector<uint8_t> buffer;
+    DumpStrings(strings, kBlockSize, buffer, codec);
+
+    MemReader reader(buffer.data(), buffer.size());
+    BlockedTextStorage<decltype(reader)> ts(reader);
+
+    my::HighResTimer timer;
+    for (auto const i : queries)
+    {
+      ts.ClearCache();
+      TEST_EQUAL(ts.ExtractString(i), strings[i], ());
+    }
+    auto const coldTime = timer.ElapsedNano();
+
+    // All blocks of the queries are in the cache now.
+    for (auto const i : queries)
+      ts.ExtractString(i);
+
+    timer.Reset();
+    for (auto const i : queries)
+      TEST_EQUAL(ts.ExtractString(i), strings[i], ());
+    auto const cachedTime = timer.ElapsedNano();
+
+    LOG(LINFO, ("Codec:", static_cast<int>(codec), "size:", buffer.size(), "of", size,
+                "cold access, us:", coldTime / kNumQueries / 1000.0,
+                "cached access, us:", cachedTime / kNumQueries / 1000.0));
+  }
+}
 }  // namespace
@@ -192,6 +192,22 @@ void FileData::Flush()
 #endif
 }
 
+void FileData::Sync()
+{
+  Flush();
+
+#ifdef OMIM_OS_WINDOWS
+  int const res = _commit(fileno(m_File));
+#elif defined OMIM_OS_TIZEN
+  int const res = 0;  // Tizen::Io::File::Flush() already commits data.
+#else
+  int const res = fsync(fileno(m_File));
+#endif
+
+  if (res)
+    MYTHROW(Writer::WriteException, (GetErrorProlog()));
+}
+
 void FileData::Truncate(uint64_t sz)
 {
 #ifdef OMIM_OS_WINDOWS
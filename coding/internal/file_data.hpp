@@ -39,6 +39,8 @@ public:
   void Write(void const * p, size_t size);
 
   void Flush();
+  /// Flushes buffers and asks OS to write file data to the storage device.
+  void Sync();
   void Truncate(uint64_t sz);
 
   string const & GetName() const { return m_FileName; }
@@ -0,0 +1,173 @@
+#include "coding/symbol_table.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+
+using namespace std;
+
+namespace
+{
+// Each round encodes the sample by the current table and takes symbols and pairs
+// of adjacent symbols which would save the most.
+size_t constexpr kBuildRounds = 5;
+
+// Only the beginning of the sample is used since the table converges fast.
+size_t constexpr kMaxSampleSize = 32 * 1024;
+}  // namespace
+
+namespace coding
+{
+// static
+size_t constexpr SymbolTable::kMaxSymbols;
+// static
+size_t constexpr SymbolTable::kMaxSymbolLength;
+// static
+uint8_t constexpr SymbolTable::kEscape;
+
+void SymbolTable::Build(vector<string> const & sample)
+{
+  m_symbols.clear();
+  BuildIndex();
+
+  for (size_t round = 0; round < kBuildRounds; ++round)
+  {
+    // Number of bytes which are covered by the candidate symbol in the sample.
+    unordered_map<string, uint64_t> gains;
+
+    size_t sampleSize = 0;
+    for (auto const & s : sample)
+    {
+      if (sampleSize >= kMaxSampleSize)
+        break;
+      sampleSize += s.size();
+
+      char const * it = s.data();
+      char const * const end = it + s.size();
+      string prev;
+      while (it != end)
+      {
+        uint8_t code;
+        size_t length = FindLongestSymbol(it, end, code);
+        string curr;
+        if (length == 0)
+        {
+          length = 1;
+          curr.assign(it, 1);
+        }
+        else
+        {
+          curr = m_symbols[code];
+          if (length > 1)
+            gains[string(it, 1)] += 1;
+        }
+
+        gains[curr] += curr.size();
+        if (!prev.empty() && prev.size() + curr.size() <= kMaxSymbolLength)
+          gains[prev + curr] += prev.size() + curr.size();
+
+        prev = move(curr);
+        it += length;
+      }
+    }
+
+    vector<pair<uint64_t, string>> candidates;
+    candidates.reserve(gains.size());
+    for (auto & gain : gains)
+    {
+      // A single byte symbol saves one byte per occurrence compared to an escape.
+      if (gain.first.size() == 1 && gain.second < 2)
+        continue;
+      candidates.emplace_back(gain.second, gain.first);
+    }
+
+    auto const numSymbols = min(kMaxSymbols, candidates.size());
+    partial_sort(candidates.begin(), candidates.begin() + numSymbols, candidates.end(),
+                 [](pair<uint64_t, string> const & lhs, pair<uint64_t, string> const & rhs) {
+                   if (lhs.first != rhs.first)
+                     return lhs.first > rhs.first;
+                   return lhs.second < rhs.second;
+                 });
+
+    m_symbols.clear();
+    for (size_t i = 0; i < numSymbols; ++i)
+      m_symbols.push_back(move(candidates[i].second));
+    BuildIndex();
+  }
+}
+
+void SymbolTable::Encode(string const & s, string & out) const
+{
+  char const * it = s.data();
+  char const * const end = it + s.size();
+  while (it != end)
+  {
+    uint8_t code;
+    size_t const length = FindLongestSymbol(it, end, code);
+    if (length == 0)
+    {
+      out.push_back(static_cast<char>(kEscape));
+      out.push_back(*it);
+      ++it;
+      continue;
+    }
+
+    out.push_back(static_cast<char>(code));
+    it += length;
+  }
+}
+
+void SymbolTable::Decode(char const * begin, char const * end, string & out) const
+{
+  while (begin != end)
+  {
+    auto const code = static_cast<uint8_t>(*begin++);
+    if (code == kEscape)
+    {
+      CHECK(begin != end, ("Unterminated escape."));
+      out.push_back(*begin++);
+      continue;
+    }
+
+    CHECK_LESS(code, m_symbols.size(), ());
+    out.append(m_symbols[code]);
+  }
+}
+
+void SymbolTable::BuildIndex()
+{
+  for (auto & codes : m_index)
+    codes.clear();
+
+  for (size_t code = 0; code < m_symbols.size(); ++code)
+  {
+    auto const & symbol = m_symbols[code];
+    ASSERT(!symbol.empty(), ());
+    m_index[static_cast<uint8_t>(symbol[0])].push_back(static_cast<uint8_t>(code));
+  }
+
+  for (auto & codes : m_index)
+  {
+    stable_sort(codes.begin(), codes.end(), [this](uint8_t lhs, uint8_t rhs) {
+      return m_symbols[lhs].size() > m_symbols[rhs].size();
+    });
+  }
+}
+
+size_t SymbolTable::FindLongestSymbol(char const * begin, char const * end, uint8_t & code) const
+{
+  ASSERT(begin != end, ());
+  size_t const size = static_cast<size_t>(end - begin);
+  for (auto const c : m_index[static_cast<uint8_t>(*begin)])
+  {
+    auto const & symbol = m_symbols[c];
+    if (symbol.size() <= size && memcmp(symbol.data(), begin, symbol.size()) == 0)
+    {
+      code = c;
+      return symbol.size();
+    }
+  }
+  return 0;
+}
+}  // namespace coding
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace coding
+{
+// Static symbol table for compression of short strings, similar to FSST
+// (Boncz, Neumann, Leis, "FSST: Fast Random Access String Compression").
+//
+// A symbol is a sequence of 1 to kMaxSymbolLength bytes. Up to kMaxSymbols symbols
+// are coded by single bytes, and all other bytes are written as kEscape followed by
+// the byte itself. Strings are encoded independently of each other, so any string
+// can be decoded without its neighbours, and decoding is just a sequence of copies.
+class SymbolTable
+{
+public:
+  static size_t constexpr kMaxSymbols = 255;
+  static size_t constexpr kMaxSymbolLength = 8;
+  static uint8_t constexpr kEscape = 255;
+
+  // Builds the table which is good for strings similar to |sample|.
+  void Build(std::vector<std::string> const & sample);
+
+  // Appends encoded |s| to |out|.
+  void Encode(std::string const & s, std::string & out) const;
+
+  // Appends decoded [begin, end) to |out|.
+  void Decode(char const * begin, char const * end, std::string & out) const;
+
+  size_t GetNumSymbols() const { return m_symbols.size(); }
+
+  template <typename Sink>
+  void Serialize(Sink & sink) const
+  {
+    WriteVarUint(sink, static_cast<uint32_t>(m_symbols.size()));
+    for (auto const & symbol : m_symbols)
+    {
+      WriteToSink(sink, static_cast<uint8_t>(symbol.size()));
+      sink.Write(symbol.data(), symbol.size());
+    }
+  }
+
+  template <typename Source>
+  void Deserialize(Source & source)
+  {
+    auto const numSymbols = ReadVarUint<uint32_t>(source);
+    CHECK_LESS_OR_EQUAL(numSymbols, kMaxSymbols, ());
+
+    m_symbols.resize(numSymbols);
+    for (auto & symbol : m_symbols)
+    {
+      auto const length = ReadPrimitiveFromSource<uint8_t>(source);
+      CHECK(length != 0 && length <= kMaxSymbolLength, (length));
+      symbol.resize(length);
+      source.Read(&symbol[0], length);
+    }
+    BuildIndex();
+  }
+
+private:
+  void BuildIndex();
+
+  // Returns the length of the longest symbol which is a prefix of [begin, end),
+  // or 0 if there is no such symbol.
+  size_t FindLongestSymbol(char const * begin, char const * end, uint8_t & code) const;
+
+  std::vector<std::string> m_symbols;
+
+  // Codes of the symbols by their first bytes, longer symbols go first.
+  std::array<std::vector<uint8_t>, 256> m_index;
+};
+}  // namespace coding
@@ -2,18 +2,44 @@
 
 #include "coding/bwt_coder.hpp"
 #include "coding/reader.hpp"
+#include "coding/symbol_table.hpp"
 #include "coding/varint.hpp"
 #include "coding/write_to_sink.hpp"
 
 #include "base/assert.hpp"
+#include "base/stl_add.hpp"
 
 #include <algorithm>
 #include <cstdint>
+#include <list>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace coding
 {
+// Compression of the blocks of BlockedTextStorage. It's chosen for the whole storage
+// when the storage is written.
+enum class BlockedTextStorageCodec : uint8_t
+{
+  // The whole block is compressed by BWTCoder. Gives the best compression, but the whole
+  // block must be decoded to get any string from it.
+  BWT = 0,
+
+  // Strings of the block are compressed one by one by a SymbolTable of the block.
+  // Compression is worse, but a single string is decoded much faster.
+  SymbolTable = 1
+};
+
+namespace impl
+{
+// The codec is stored in the highest byte of the offset of the index section.
+uint8_t constexpr kTextStorageCodecShift = 56;
+uint64_t constexpr kTextStorageOffsetMask =
+    (static_cast<uint64_t>(1) << kTextStorageCodecShift) - 1;
+}  // namespace impl
+
 // Writes a set of strings in a format that allows to efficiently
 // access blocks of strings. This means that access of individual
 // strings may be inefficient, but access to a block of strings can be
@@ -22,11 +48,14 @@ namespace coding
 // because the whole number of strings is packed into a single block.
 //
 // Format description:
-// * first 8 bytes - little endian-encoded offset of the index section
-// * data section - represents a catenated sequence of BWT-compressed blocks with
-//   a sequence of individual string lengths in the block
+// * first 8 bytes - little endian-encoded offset of the index section, the highest byte
+//   of which is the BlockedTextStorageCodec
+// * data section - represents a catenated sequence of compressed blocks with
+//   a sequence of individual string lengths in the block. For the SymbolTable codec
+//   the lengths are the lengths of the compressed strings, and they are followed by
+//   the symbol table of the block and by the compressed strings.
 // * index section - represents a delta-encoded sequence of
-//   BWT-compressed blocks offsets intermixed with the number of
+//   compressed blocks offsets intermixed with the number of
 //   strings inside each block.
 //
 // All numbers except the first offset are varints.
@@ -34,8 +63,13 @@ template <typename Writer>
 class BlockedTextStorageWriter
 {
 public:
-  BlockedTextStorageWriter(Writer & writer, uint64_t blockSize)
-    : m_writer(writer), m_blockSize(blockSize), m_startOffset(writer.Pos()), m_blocks(1)
+  BlockedTextStorageWriter(Writer & writer, uint64_t blockSize,
+                           BlockedTextStorageCodec codec = BlockedTextStorageCodec::BWT)
+    : m_writer(writer)
+    , m_blockSize(blockSize)
+    , m_codec(codec)
+    , m_startOffset(writer.Pos())
+    , m_blocks(1)
   {
     CHECK(m_blockSize != 0, ());
     WriteToSink(m_writer, static_cast<uint64_t>(0));
@@ -54,7 +88,10 @@ public:
       auto const currentOffset = m_writer.Pos();
       ASSERT_GREATER_OR_EQUAL(currentOffset, m_startOffset, ());
       m_writer.Seek(m_startOffset);
-      WriteToSink(m_writer, static_cast<uint64_t>(currentOffset - m_startOffset));
+      auto const indexOffset = static_cast<uint64_t>(currentOffset - m_startOffset);
+      CHECK_LESS_OR_EQUAL(indexOffset, impl::kTextStorageOffsetMask, ());
+      WriteToSink(m_writer, indexOffset | (static_cast<uint64_t>(m_codec)
+                                           << impl::kTextStorageCodecShift));
       m_writer.Seek(currentOffset);
     }
 
@@ -106,14 +143,45 @@ private:
 
   void FlushPool(vector<uint64_t> const & lengths, string const & pool)
   {
-    for (auto const & length : lengths)
-      WriteVarUint(m_writer, length);
-    BWTCoder::EncodeAndWriteBlock(m_writer, pool.size(),
-                                  reinterpret_cast<uint8_t const *>(pool.c_str()));
+    switch (m_codec)
+    {
+    case BlockedTextStorageCodec::BWT:
+      for (auto const & length : lengths)
+        WriteVarUint(m_writer, length);
+      BWTCoder::EncodeAndWriteBlock(m_writer, pool.size(),
+                                    reinterpret_cast<uint8_t const *>(pool.c_str()));
+      break;
+    case BlockedTextStorageCodec::SymbolTable:
+    {
+      std::vector<std::string> strings;
+      strings.reserve(lengths.size());
+      uint64_t offset = 0;
+      for (auto const & length : lengths)
+      {
+        strings.emplace_back(pool, offset, length);
+        offset += length;
+      }
+
+      SymbolTable table;
+      table.Build(strings);
+
+      std::string encoded;
+      for (auto const & s : strings)
+      {
+        auto const size = encoded.size();
+        table.Encode(s, encoded);
+        WriteVarUint(m_writer, encoded.size() - size);
+      }
+      table.Serialize(m_writer);
+      m_writer.Write(encoded.data(), encoded.size());
+      break;
+    }
+    }
   }
 
   Writer & m_writer;
   uint64_t const m_blockSize;
+  BlockedTextStorageCodec const m_codec;
   uint64_t m_startOffset = 0;
   uint64_t m_dataOffset = 0;
 
@@ -139,6 +207,7 @@ public:
     uint64_t m_subs = 0;    // number of strings in the block
   };
 
+  BlockedTextStorageCodec GetCodec() const { return m_codec; }
   size_t GetNumBlockInfos() const { return m_blocks.size(); }
   size_t GetNumStrings() const { return m_blocks.empty() ? 0 : m_blocks.back().To(); }
 
@@ -178,7 +247,13 @@ public:
   template <typename Reader>
   void Read(Reader & reader)
   {
-    auto const indexOffset = ReadPrimitiveFromPos<uint64_t, Reader>(reader, 0);
+    auto const header = ReadPrimitiveFromPos<uint64_t, Reader>(reader, 0);
+    auto const indexOffset = header & impl::kTextStorageOffsetMask;
+
+    auto const codec = static_cast<uint8_t>(header >> impl::kTextStorageCodecShift);
+    CHECK_LESS_OR_EQUAL(codec, static_cast<uint8_t>(BlockedTextStorageCodec::SymbolTable),
+                        ("Unknown text storage codec."));
+    m_codec = static_cast<BlockedTextStorageCodec>(codec);
 
     NonOwningReaderSource source(reader);
     source.Skip(indexOffset);
@@ -203,11 +278,21 @@ public:
 
 private:
   std::vector<BlockInfo> m_blocks;
+  BlockedTextStorageCodec m_codec = BlockedTextStorageCodec::BWT;
 };
 
+// Reads strings from BlockedTextStorage. Recently used blocks are kept decoded
+// while their total size is within the cache budget.
 class BlockedTextStorageReader
 {
 public:
+  static size_t constexpr kDefaultCacheBudget = 4 * 1024 * 1024;
+
+  explicit BlockedTextStorageReader(size_t cacheBudget = kDefaultCacheBudget)
+    : m_cacheBudget(cacheBudget)
+  {
+  }
+
   template <typename Reader>
   void InitializeIfNeeded(Reader & reader)
   {
@@ -238,25 +323,17 @@ public:
     auto const & bi = m_index.GetBlockInfo(blockIx);
 
     auto & entry = m_cache[blockIx];
-    if (!entry.m_valid)
+    if (entry.m_valid)
     {
-      NonOwningReaderSource source(reader);
-      source.Skip(bi.m_offset);
-
-      entry.m_value.clear();
-      entry.m_subs.resize(bi.m_subs);
-
-      uint64_t offset = 0;
-      for (size_t i = 0; i < entry.m_subs.size(); ++i)
-      {
-        auto & sub = entry.m_subs[i];
-        sub.m_offset = offset;
-        sub.m_length = ReadVarUint<uint64_t>(source);
-        CHECK_GREATER_OR_EQUAL(sub.m_offset + sub.m_length, sub.m_offset, ());
-        offset += sub.m_length;
-      }
-      BWTCoder::ReadAndDecodeBlock(source, std::back_inserter(entry.m_value));
-      entry.m_valid = true;
+      m_lru.splice(m_lru.begin(), m_lru, entry.m_lru);
+    }
+    else
+    {
+      ReadBlock(reader, bi, entry);
+      m_lru.push_front(blockIx);
+      entry.m_lru = m_lru.begin();
+      m_cacheSize += entry.GetSize();
+      EvictIfNeeded();
     }
     ASSERT(entry.m_valid, ());
 
@@ -269,10 +346,27 @@ public:
     auto const & si = entry.m_subs[stringIx];
     auto const & value = entry.m_value;
     ASSERT_LESS_OR_EQUAL(si.m_offset + si.m_length, value.size(), ());
+
+    if (m_index.GetCodec() == BlockedTextStorageCodec::SymbolTable)
+    {
+      std::string s;
+      auto const begin = value.data() + si.m_offset;
+      ASSERT(entry.m_table, ());
+      entry.m_table->Decode(begin, begin + si.m_length, s);
+      return s;
+    }
     return value.substr(si.m_offset, si.m_length);
   }
 
-  void ClearCache() { m_cache.clear(); }
+  // Returns the total size of the cached blocks.
+  size_t GetCacheSize() const { return m_cacheSize; }
+
+  void ClearCache()
+  {
+    m_cache.clear();
+    m_lru.clear();
+    m_cacheSize = 0;
+  }
 
 private:
   struct StringInfo
@@ -286,13 +380,74 @@ private:
 
   struct CacheEntry
   {
-    std::string m_value;             // concatenation of the strings
+    size_t GetSize() const { return m_value.size() + m_subs.size() * sizeof(StringInfo); }
+
+    // Concatenation of the strings. For the SymbolTable codec the strings are
+    // kept compressed and are decoded on extraction.
+    std::string m_value;
     std::vector<StringInfo> m_subs;  // indices of individual strings
+    std::unique_ptr<SymbolTable> m_table;
+    std::list<size_t>::iterator m_lru;
     bool m_valid = false;
   };
 
+  template <typename Reader>
+  void ReadBlock(Reader & reader, BlockedTextStorageIndex::BlockInfo const & bi,
+                 CacheEntry & entry)
+  {
+    NonOwningReaderSource source(reader);
+    source.Skip(bi.m_offset);
+
+    entry.m_value.clear();
+    entry.m_subs.resize(bi.m_subs);
+
+    uint64_t offset = 0;
+    for (size_t i = 0; i < entry.m_subs.size(); ++i)
+    {
+      auto & sub = entry.m_subs[i];
+      sub.m_offset = offset;
+      sub.m_length = ReadVarUint<uint64_t>(source);
+      CHECK_GREATER_OR_EQUAL(sub.m_offset + sub.m_length, sub.m_offset, ());
+      offset += sub.m_length;
+    }
+
+    switch (m_index.GetCodec())
+    {
+    case BlockedTextStorageCodec::BWT:
+      BWTCoder::ReadAndDecodeBlock(source, std::back_inserter(entry.m_value));
+      break;
+    case BlockedTextStorageCodec::SymbolTable:
+      entry.m_table = my::make_unique<SymbolTable>();
+      entry.m_table->Deserialize(source);
+      entry.m_value.resize(static_cast<size_t>(offset));
+      if (offset != 0)
+        source.Read(&entry.m_value[0], entry.m_value.size());
+      break;
+    }
+    entry.m_valid = true;
+  }
+
+  // Drops least recently used blocks until the cache fits into the budget.
+  // The most recently used block is never dropped.
+  void EvictIfNeeded()
+  {
+    while (m_cacheSize > m_cacheBudget && m_lru.size() > 1)
+    {
+      auto & entry = m_cache[m_lru.back()];
+      ASSERT(entry.m_valid, ());
+      ASSERT_GREATER_OR_EQUAL(m_cacheSize, entry.GetSize(), ());
+      m_cacheSize -= entry.GetSize();
+      m_lru.pop_back();
+      entry = CacheEntry();
+    }
+  }
+
   BlockedTextStorageIndex m_index;
   std::vector<CacheEntry> m_cache;
+  // Indices of the cached blocks, the most recently used go first.
+  std::list<size_t> m_lru;
+  size_t m_cacheBudget;
+  size_t m_cacheSize = 0;
   bool m_initialized = false;
 };
 
@@ -300,13 +455,16 @@ template <typename Reader>
 class BlockedTextStorage
 {
 public:
-  explicit BlockedTextStorage(Reader & reader) : m_reader(reader)
+  explicit BlockedTextStorage(
+      Reader & reader, size_t cacheBudget = BlockedTextStorageReader::kDefaultCacheBudget)
+    : m_storage(cacheBudget), m_reader(reader)
   {
     m_storage.InitializeIfNeeded(m_reader);
   }
 
   size_t GetNumStrings() const { return m_storage.GetNumStrings(); }
   std::string ExtractString(size_t stringIx) { return m_storage.ExtractString(m_reader, stringIx); }
+  size_t GetCacheSize() const { return m_storage.GetCacheSize(); }
   void ClearCache() { m_storage.ClearCache(); }
 
 private:
@@ -8,6 +8,7 @@
 #include "geometry/latlon.hpp"
 
 #include "base/checked_cast.hpp"
+#include "base/exception.hpp"
 
 #include "std/limits.hpp"
 #include "std/vector.hpp"
@@ -60,6 +61,7 @@ public:
     {
     case 0: return SerializeDataPointsV0(writer, points);
     case 1: return SerializeDataPointsV1(writer, points);
+    case 2: return SerializeDataPointsV2(writer, points);
 
     default: ASSERT(false, ("Unexpected serializer version:", version)); break;
     }
@@ -74,6 +76,7 @@ public:
     {
     case 0: return DeserializeDataPointsV0(src, result);
     case 1: return DeserializeDataPointsV1(src, result);
+    case 2: return DeserializeDataPointsV2(src, result);
 
     default: ASSERT(false, ("Unexpected serializer version:", version)); break;
     }
@@ -158,6 +161,69 @@ private:
     return static_cast<size_t>(writer.Pos() - startPos);
   }
 
+  // Version 2:
+  //   The number of points followed by columns of timestamps, latitudes, longitudes
+  //   and traffic. Timestamps are stored as deltas of deltas. Coordinates are truncated
+  //   to integers as in Version 0 and stored as differences with the linear prediction
+  //   by two previous points, so a point of a uniform movement takes a few bytes.
+  //   Traffic is run-length encoded. All integers are written as varints,
+  //   signed ones are zigzag-encoded.
+  template <typename Writer, typename Collection>
+  static size_t SerializeDataPointsV2(Writer & writer, Collection const & points)
+  {
+    auto const startPos = writer.Pos();
+    size_t const size = points.size();
+    WriteVarUint(writer, static_cast<uint64_t>(size));
+    if (size == 0)
+      return static_cast<size_t>(writer.Pos() - startPos);
+
+    WriteVarUint(writer, points[0].m_timestamp);
+    int64_t prevDelta = 0;
+    for (size_t i = 1; i < size; ++i)
+    {
+      ASSERT_LESS_OR_EQUAL(points[i - 1].m_timestamp, points[i].m_timestamp, ());
+      auto const delta = static_cast<int64_t>(points[i].m_timestamp - points[i - 1].m_timestamp);
+      WriteVarInt(writer, delta - prevDelta);
+      prevDelta = delta;
+    }
+
+    SerializeCoordsV2(writer, points, [](DataPoint const & p) {
+      return DoubleToUint32(p.m_latLon.lat, ms::LatLon::kMinLat, ms::LatLon::kMaxLat, kCoordBits);
+    });
+    SerializeCoordsV2(writer, points, [](DataPoint const & p) {
+      return DoubleToUint32(p.m_latLon.lon, ms::LatLon::kMinLon, ms::LatLon::kMaxLon, kCoordBits);
+    });
+
+    for (size_t i = 0; i < size;)
+    {
+      size_t j = i + 1;
+      while (j < size && points[j].m_traffic == points[i].m_traffic)
+        ++j;
+      WriteVarUint(writer, static_cast<uint64_t>(j - i));
+      WriteVarUint(writer, static_cast<uint32_t>(points[i].m_traffic));
+      i = j;
+    }
+
+    ASSERT_LESS_OR_EQUAL(writer.Pos() - startPos, numeric_limits<size_t>::max(),
+                         ("Too much data."));
+    return static_cast<size_t>(writer.Pos() - startPos);
+  }
+
+  template <typename Writer, typename Collection, typename GetCoord>
+  static void SerializeCoordsV2(Writer & writer, Collection const & points, GetCoord && getCoord)
+  {
+    int64_t prev = getCoord(points[0]);
+    int64_t prevPrev = prev;
+    WriteVarUint(writer, static_cast<uint32_t>(prev));
+    for (size_t i = 1; i < points.size(); ++i)
+    {
+      int64_t const coord = getCoord(points[i]);
+      WriteVarInt(writer, coord - (2 * prev - prevPrev));
+      prevPrev = prev;
+      prev = coord;
+    }
+  }
+
   template <typename Source, typename Collection>
   static void DeserializeDataPointsV0(Source & src, Collection & result)
   {
@@ -225,5 +291,70 @@ private:
       }
     }
   }
+
+  // Points are decoded in place, so |result| is not reallocated if it has enough capacity.
+  // Reader::SizeException is thrown for inconsistent data if |src| throws on reading
+  // beyond the end.
+  template <typename Source, typename Collection>
+  static void DeserializeDataPointsV2(Source & src, Collection & result)
+  {
+    while (src.Size() > 0)
+    {
+      auto const size = ReadVarUint<uint64_t>(src);
+      // Each point takes at least three bytes.
+      if (size > src.Size())
+        MYTHROW(Reader::SizeException, ("Too many points:", size, src.Size()));
+
+      size_t const first = result.size();
+      result.resize(first + static_cast<size_t>(size));
+      if (size == 0)
+        continue;
+
+      uint64_t timestamp = ReadVarUint<uint64_t>(src);
+      result[first].m_timestamp = timestamp;
+      int64_t delta = 0;
+      for (size_t i = first + 1; i < result.size(); ++i)
+      {
+        delta += ReadVarInt<int64_t>(src);
+        timestamp += static_cast<uint64_t>(delta);
+        result[i].m_timestamp = timestamp;
+      }
+
+      DeserializeCoordsV2(src, result, first, [](DataPoint & p, uint32_t coord) {
+        p.m_latLon.lat =
+            Uint32ToDouble(coord, ms::LatLon::kMinLat, ms::LatLon::kMaxLat, kCoordBits);
+      });
+      DeserializeCoordsV2(src, result, first, [](DataPoint & p, uint32_t coord) {
+        p.m_latLon.lon =
+            Uint32ToDouble(coord, ms::LatLon::kMinLon, ms::LatLon::kMaxLon, kCoordBits);
+      });
+
+      for (size_t i = first; i < result.size();)
+      {
+        auto const run = ReadVarUint<uint64_t>(src);
+        if (run == 0 || run > result.size() - i)
+          MYTHROW(Reader::SizeException, ("Invalid traffic run:", run));
+        auto const traffic = static_cast<uint8_t>(ReadVarUint<uint32_t>(src));
+        for (size_t const end = i + static_cast<size_t>(run); i < end; ++i)
+          result[i].m_traffic = traffic;
+      }
+    }
+  }
+
+  template <typename Source, typename Collection, typename SetCoord>
+  static void DeserializeCoordsV2(Source & src, Collection & result, size_t first,
+                                  SetCoord && setCoord)
+  {
+    int64_t prev = ReadVarUint<uint32_t>(src);
+    int64_t prevPrev = prev;
+    setCoord(result[first], static_cast<uint32_t>(prev));
+    for (size_t i = first + 1; i < result.size(); ++i)
+    {
+      int64_t const coord = ReadVarInt<int64_t>(src) + 2 * prev - prevPrev;
+      setCoord(result[i], static_cast<uint32_t>(coord));
+      prevPrev = prev;
+      prev = coord;
+    }
+  }
 };
 }  // namespace coding
@@ -158,6 +158,7 @@ tizen{
 }
 
 linux-* {
+  LIBS *= -lcurl
   QMAKE_CFLAGS *= -fdata-sections -ffunction-sections
   QMAKE_CXXFLAGS *= -fdata-sections -ffunction-sections
   QMAKE_LFLAGS *= -Wl,--gc-sections -Wl,-Bsymbolic-functions
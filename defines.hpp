@@ -9,6 +9,7 @@
 #define EXTENSION_TMP ".tmp"
 #define ADDR_FILE_EXTENSION ".addr"
 #define RAW_GEOM_FILE_EXTENSION ".rawgeom"
+#define HOUSE_TO_STREET_CACHE_FILE_EXTENSION ".h2scache"
 
 #define NODES_FILE "nodes.dat"
 #define WAYS_FILE "ways.dat"
@@ -17,6 +18,7 @@
 #define OFFSET_EXT ".offs"
 #define ID2REL_EXT ".id2rel"
 
+#define BUILDINGS_FILE_TAG "buildings"
 #define CENTERS_FILE_TAG "centers"
 #define DATA_FILE_TAG "dat"
 #define GEOMETRY_FILE_TAG "geom"
@@ -57,6 +59,7 @@
 #define RESUME_FILE_EXTENSION ".resume"
 #define DOWNLOADING_FILE_EXTENSION ".downloading"
 #define BOOKMARKS_FILE_EXTENSION ".kml"
+#define BOOKMARKS_BINARY_FILE_EXTENSION ".kmb"
 #define ROUTING_FILE_EXTENSION ".routing"
 #define NOROUTING_FILE_EXTENSION ".norouting"
 #define TRANSIT_FILE_EXTENSION ".transit.json"
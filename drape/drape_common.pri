@@ -17,6 +17,7 @@ SOURCES += \
     $$DRAPE_DIR/glconstants.cpp \
     $$DRAPE_DIR/glextensions_list.cpp \
     $$DRAPE_DIR/glstate.cpp \
+    $$DRAPE_DIR/glyph_cache.cpp \
     $$DRAPE_DIR/glyph_manager.cpp \
     $$DRAPE_DIR/gpu_buffer.cpp \
     $$DRAPE_DIR/gpu_program.cpp \
@@ -73,6 +74,7 @@ HEADERS += \
     $$DRAPE_DIR/glsl_func.hpp \
     $$DRAPE_DIR/glsl_types.hpp \
     $$DRAPE_DIR/glstate.hpp \
+    $$DRAPE_DIR/glyph_cache.hpp \
     $$DRAPE_DIR/glyph_manager.hpp \
     $$DRAPE_DIR/gpu_buffer.hpp \
     $$DRAPE_DIR/gpu_program.hpp \
@@ -3,6 +3,7 @@
 //#define DRAW_TILE_NET
 //#define RENDER_DEBUG_DISPLACEMENT
 //#define DEBUG_OVERLAYS_OUTPUT
+//#define INCREMENTAL_OVERLAY_PLACING
 
 //#define DRAPE_MEASURER
 //#define SCENARIO_ENABLE
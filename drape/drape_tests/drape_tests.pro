@@ -35,10 +35,12 @@ SOURCES += \
     font_texture_tests.cpp \
     glfunctions.cpp \
     glmock_functions.cpp \
+    glyph_cache_tests.cpp \
     glyph_mng_tests.cpp \
     glyph_packer_test.cpp \
     img.cpp \
     object_pool_tests.cpp \
+    overlay_tree_tests.cpp \
     pointers_tests.cpp \
     static_texture_tests.cpp \
     stipple_pen_tests.cpp \
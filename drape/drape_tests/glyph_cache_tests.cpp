@@ -0,0 +1,162 @@
+#include "testing/testing.hpp"
+
+#include "drape/glyph_cache.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/internal/file_data.hpp"
+
+#include <cstring>
+#include <string>
+
+namespace
+{
+uint32_t const kBaseGlyphHeight = 22;
+uint32_t const kSdfScale = 4;
+
+dp::GlyphManager::Glyph MakeGlyph(strings::UniChar code, uint32_t width, uint32_t height,
+                                  uint8_t value)
+{
+  dp::GlyphManager::Glyph glyph;
+  glyph.m_metrics = dp::GlyphManager::GlyphMetrics{1.5f, 0.0f, -0.25f, 2.0f, true};
+  glyph.m_image.m_width = width;
+  glyph.m_image.m_height = height;
+  glyph.m_image.m_bitmapRows = 0;
+  glyph.m_image.m_bitmapPitch = 0;
+  glyph.m_image.m_data = SharedBufferManager::instance().reserveSharedBuffer(width * height);
+  memset(glyph.m_image.m_data->data(), value, width * height);
+  glyph.m_fontIndex = 0;
+  glyph.m_code = code;
+  glyph.m_fixedSize = dp::GlyphManager::kDynamicGlyphSize;
+  return glyph;
+}
+
+void TestGlyph(dp::GlyphCache & cache, dp::GlyphCache::Key const & key, uint32_t width,
+               uint32_t height, uint8_t value)
+{
+  dp::GlyphManager::Glyph glyph;
+  TEST(cache.Find(key, glyph), (key.m_code));
+  TEST(glyph.m_isGenerated, ());
+  TEST_EQUAL(glyph.m_code, key.m_code, ());
+  TEST_EQUAL(glyph.m_fixedSize, key.m_fixedSize, ());
+  TEST_EQUAL(glyph.m_metrics.m_xAdvance, 1.5f, ());
+  TEST_EQUAL(glyph.m_metrics.m_xOffset, -0.25f, ());
+  TEST_EQUAL(glyph.m_metrics.m_yOffset, 2.0f, ());
+  TEST_EQUAL(glyph.m_image.m_width, width, ());
+  TEST_EQUAL(glyph.m_image.m_height, height, ());
+  for (size_t i = 0; i < width * height; ++i)
+    TEST_EQUAL(glyph.m_image.m_data->at(i), value, (i));
+  glyph.m_image.Destroy();
+}
+}  // namespace
+
+UNIT_TEST(GlyphCache_SaveAndLoad)
+{
+  std::string const path = GetPlatform().WritablePathForFile("glyph_cache_test.cache");
+  my::DeleteFileX(path);
+
+  uint32_t const fontId = dp::GlyphCache::GetFontId("font.ttf", 1024);
+  TEST_NOT_EQUAL(fontId, dp::GlyphCache::GetFontId("font.ttf", 1025), ());
+
+  dp::GlyphCache::Key const keyA(fontId, 'a', dp::GlyphManager::kDynamicGlyphSize);
+  dp::GlyphCache::Key const keyB(fontId, 'b', dp::GlyphManager::kDynamicGlyphSize);
+  dp::GlyphCache::Key const keyFixed(fontId, 'a', 12);
+
+  {
+    dp::GlyphCache cache(path, kBaseGlyphHeight, kSdfScale);
+    TEST_EQUAL(cache.GetSize(), 0, ());
+
+    auto glyphA = MakeGlyph('a', 5, 7, 10);
+    cache.Add(keyA, glyphA);
+    glyphA.m_image.Destroy();
+
+    // New glyphs are available before saving.
+    TestGlyph(cache, keyA, 5, 7, 10);
+    dp::GlyphManager::Glyph glyph;
+    TEST(!cache.Find(keyB, glyph), ());
+    TEST(cache.Save(), ());
+  }
+
+  {
+    dp::GlyphCache cache(path, kBaseGlyphHeight, kSdfScale);
+    TEST_EQUAL(cache.GetSize(), 1, ());
+    TestGlyph(cache, keyA, 5, 7, 10);
+
+    auto glyphB = MakeGlyph('b', 3, 4, 20);
+    cache.Add(keyB, glyphB);
+    glyphB.m_image.Destroy();
+
+    auto glyphFixed = MakeGlyph('a', 6, 6, 30);
+    cache.Add(keyFixed, glyphFixed);
+    glyphFixed.m_image.Destroy();
+
+    TEST_EQUAL(cache.GetSize(), 3, ());
+    TEST(cache.Save(), ());
+
+    // Loaded and new glyphs are merged.
+    TEST_EQUAL(cache.GetSize(), 3, ());
+    TestGlyph(cache, keyA, 5, 7, 10);
+    TestGlyph(cache, keyB, 3, 4, 20);
+    TestGlyph(cache, keyFixed, 6, 6, 30);
+  }
+
+  {
+    // The cache is ignored for other glyph parameters.
+    dp::GlyphCache cache(path, kBaseGlyphHeight, kSdfScale + 1);
+    TEST_EQUAL(cache.GetSize(), 0, ());
+  }
+
+  TEST(my::DeleteFileX(path), ());
+}
+
+UNIT_TEST(GlyphCache_Eviction)
+{
+  std::string const path = GetPlatform().WritablePathForFile("glyph_cache_eviction_test.cache");
+  my::DeleteFileX(path);
+
+  uint32_t const kMaxGlyphsCount = 2;
+  uint32_t const fontId = dp::GlyphCache::GetFontId("font.ttf", 1024);
+  dp::GlyphCache::Key const keyA(fontId, 'a', dp::GlyphManager::kDynamicGlyphSize);
+  dp::GlyphCache::Key const keyB(fontId, 'b', dp::GlyphManager::kDynamicGlyphSize);
+  dp::GlyphCache::Key const keyC(fontId, 'c', dp::GlyphManager::kDynamicGlyphSize);
+
+  auto const add = [](dp::GlyphCache & cache, dp::GlyphCache::Key const & key, uint8_t value)
+  {
+    auto glyph = MakeGlyph(key.m_code, 2, 2, value);
+    cache.Add(key, glyph);
+    glyph.m_image.Destroy();
+  };
+
+  {
+    dp::GlyphCache cache(path, kBaseGlyphHeight, kSdfScale, kMaxGlyphsCount);
+    add(cache, keyA, 10);
+    add(cache, keyB, 20);
+    // New glyphs over the limit are dropped.
+    add(cache, keyC, 30);
+    TEST_EQUAL(cache.GetSize(), 2, ());
+    dp::GlyphManager::Glyph glyph;
+    TEST(!cache.Find(keyC, glyph), ());
+    TEST(cache.Save(), ());
+  }
+
+  {
+    dp::GlyphCache cache(path, kBaseGlyphHeight, kSdfScale, kMaxGlyphsCount);
+    TEST_EQUAL(cache.GetSize(), 2, ());
+    TestGlyph(cache, keyA, 2, 2, 10);
+    add(cache, keyC, 30);
+    TEST_EQUAL(cache.GetSize(), 3, ());
+    TEST(cache.Save(), ());
+  }
+
+  {
+    // |keyB| is not used in the second session, so it's evicted.
+    dp::GlyphCache cache(path, kBaseGlyphHeight, kSdfScale, kMaxGlyphsCount);
+    TEST_EQUAL(cache.GetSize(), 2, ());
+    TestGlyph(cache, keyA, 2, 2, 10);
+    TestGlyph(cache, keyC, 2, 2, 30);
+    dp::GlyphManager::Glyph glyph;
+    TEST(!cache.Find(keyB, glyph), ());
+  }
+
+  TEST(my::DeleteFileX(path), ());
+}
@@ -0,0 +1,177 @@
+#include "testing/testing.hpp"
+
+#include "drape/overlay_handle.hpp"
+#include "drape/overlay_tree.hpp"
+#include "drape/pointers.hpp"
+
+#include "indexer/feature_decl.hpp"
+
+#include "geometry/any_rect2d.hpp"
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+#include "geometry/screenbase.hpp"
+
+#include "base/stl_add.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace dp;
+using namespace std;
+
+namespace
+{
+// Rectangular handle of a fixed pixel size at a point of the map.
+class TestHandle : public OverlayHandle
+{
+public:
+  TestHandle(uint32_t index, uint64_t priority, ScreenBase const & screen,
+             m2::PointD const & pixelCenter, m2::PointD const & pixelSize)
+    : OverlayHandle(OverlayID(FeatureID(MwmSet::MwmId(), index)), dp::Center, priority,
+                    false /* isBillboard */)
+    , m_pivot(screen.PtoG(pixelCenter))
+    , m_halfSize(pixelSize / 2.0)
+  {
+  }
+
+  m2::RectD GetPixelRect(ScreenBase const & screen, bool /* perspective */) const override
+  {
+    m2::PointD const center = screen.GtoP(m_pivot);
+    return m2::RectD(center - m_halfSize, center + m_halfSize);
+  }
+
+  void GetPixelShape(ScreenBase const & screen, bool perspective, Rects & rects) const override
+  {
+    rects.emplace_back(GetPixelRect(screen, perspective));
+  }
+
+private:
+  m2::PointD const m_pivot;
+  m2::PointD const m_halfSize;
+};
+
+class OverlayTreeTest
+{
+public:
+  OverlayTreeTest() : m_tree(1.0 /* visualScale */)
+  {
+    m_screen.OnSize(m2::RectI(0, 0, 640, 480));
+    m_screen.SetFromRect(m2::AnyRectD(m2::RectD(0.0, 0.0, 64.0, 48.0)));
+  }
+
+  ref_ptr<OverlayHandle> AddHandle(uint32_t index, uint64_t priority, m2::PointD const & center)
+  {
+    m_handles.push_back(my::make_unique<TestHandle>(index, priority, m_screen, center,
+                                                    m2::PointD(20.0, 20.0) /* pixelSize */));
+    return make_ref<OverlayHandle>(m_handles.back().get());
+  }
+
+  void Place(vector<ref_ptr<OverlayHandle>> const & handles)
+  {
+    while (!m_tree.IsNeedUpdate())
+      m_tree.Frame();
+
+    m_tree.StartOverlayPlacing(m_screen);
+    for (auto const & handle : handles)
+      m_tree.Add(handle);
+    m_tree.EndOverlayPlacing();
+  }
+
+  OverlayTree & GetTree() { return m_tree; }
+  ScreenBase & GetScreen() { return m_screen; }
+
+private:
+  ScreenBase m_screen;
+  OverlayTree m_tree;
+  vector<unique_ptr<TestHandle>> m_handles;
+};
+
+UNIT_CLASS_TEST(OverlayTreeTest, OverlayTree_Priority)
+{
+  auto const low = AddHandle(0 /* index */, 1 /* priority */, {100.0, 100.0});
+  auto const high = AddHandle(1 /* index */, 2 /* priority */, {110.0, 110.0});
+  auto const separate = AddHandle(2 /* index */, 0 /* priority */, {300.0, 300.0});
+
+  // The result doesn't depend on the order of addition.
+  for (auto const & handles : {vector<ref_ptr<OverlayHandle>>{low, high, separate},
+                               vector<ref_ptr<OverlayHandle>>{separate, high, low}})
+  {
+    Place(handles);
+    TEST(high->IsVisible(), ());
+    TEST(!low->IsVisible(), ());
+    TEST(separate->IsVisible(), ());
+    TEST_EQUAL(GetTree().GetHandlesCache().size(), 2, ());
+  }
+}
+
+UNIT_CLASS_TEST(OverlayTreeTest, OverlayTree_EqualPriorities)
+{
+  // Handles with equal priorities are ordered by overlay ids.
+  auto const first = AddHandle(0 /* index */, 1 /* priority */, {100.0, 100.0});
+  auto const second = AddHandle(1 /* index */, 1 /* priority */, {110.0, 110.0});
+
+  Place({first, second});
+  TEST(second->IsVisible(), ());
+  TEST(!first->IsVisible(), ());
+}
+
+UNIT_CLASS_TEST(OverlayTreeTest, OverlayTree_DisplacementOrder)
+{
+  // |top| intersects |middle|, |middle| intersects |bottom|, but |top| doesn't intersect
+  // |bottom|. Handles are placed in order of priorities, so |middle| is displaced
+  // by |top| and doesn't displace |bottom|.
+  auto const top = AddHandle(0 /* index */, 3 /* priority */, {100.0, 100.0});
+  auto const middle = AddHandle(1 /* index */, 2 /* priority */, {115.0, 100.0});
+  auto const bottom = AddHandle(2 /* index */, 1 /* priority */, {130.0, 100.0});
+
+  Place({bottom, middle, top});
+  TEST(top->IsVisible(), ());
+  TEST(!middle->IsVisible(), ());
+  TEST(bottom->IsVisible(), ());
+
+  GetTree().SetDisplacementEnabled(false);
+  Place({bottom, middle, top});
+  TEST(top->IsVisible(), ());
+  TEST(middle->IsVisible(), ());
+  TEST(bottom->IsVisible(), ());
+}
+
+UNIT_CLASS_TEST(OverlayTreeTest, OverlayTree_IncrementalPlacing)
+{
+  GetTree().SetIncrementalPlacingEnabled(true);
+
+  auto const top = AddHandle(0 /* index */, 3 /* priority */, {100.0, 100.0});
+  auto const middle = AddHandle(1 /* index */, 2 /* priority */, {115.0, 100.0});
+  auto const bottom = AddHandle(2 /* index */, 1 /* priority */, {130.0, 100.0});
+  auto const separate = AddHandle(3 /* index */, 0 /* priority */, {300.0, 300.0});
+
+  Place({top, middle, bottom, separate});
+  TEST(top->IsVisible(), ());
+  TEST(!middle->IsVisible(), ());
+  TEST(bottom->IsVisible(), ());
+  TEST(separate->IsVisible(), ());
+
+  // The placement is kept when the map is moved.
+  GetScreen().Move(30.0 /* dx */, -20.0 /* dy */);
+  Place({top, middle, bottom, separate});
+  TEST(top->IsVisible(), ());
+  TEST(!middle->IsVisible(), ());
+  TEST(bottom->IsVisible(), ());
+  TEST(separate->IsVisible(), ());
+
+  // When the displacer is removed, the displaced handle is checked again. Handles
+  // which were displayed in the previous frame win over the ones which were not,
+  // so |middle| doesn't displace |bottom|.
+  GetTree().Remove(top);
+  Place({middle, bottom, separate});
+  TEST(!middle->IsVisible(), ());
+  TEST(bottom->IsVisible(), ());
+  TEST(separate->IsVisible(), ());
+
+  GetTree().Remove(bottom);
+  Place({middle, separate});
+  TEST(middle->IsVisible(), ());
+  TEST(separate->IsVisible(), ());
+}
+}  // namespace
@@ -8,7 +8,9 @@
 #include "base/string_utils.hpp"
 #include "base/stl_add.hpp"
 
+#include "std/algorithm.hpp"
 #include "std/chrono.hpp"
+#include "std/iterator.hpp"
 #include "std/string.hpp"
 #include "std/vector.hpp"
 #include "std/map.hpp"
@@ -16,6 +18,15 @@
 
 namespace dp
 {
+namespace
+{
+uint32_t const kMaxGeneratorThreadsCount = 2;
+
+uint32_t GetGeneratorThreadsCount()
+{
+  return max(1U, min(thread::hardware_concurrency(), kMaxGeneratorThreadsCount));
+}
+}  // namespace
 
 GlyphPacker::GlyphPacker(const m2::PointU & size)
   : m_size(size)
@@ -92,17 +103,21 @@ GlyphGenerator::GlyphGenerator(ref_ptr<GlyphManager> mng, TCompletionHandler con
   : m_mng(mng)
   , m_completionHandler(completionHandler)
   , m_isRunning(true)
-  , m_isSuspended(false)
-  , m_thread(&GlyphGenerator::Routine, this)
+  , m_threadsCount(GetGeneratorThreadsCount())
+  , m_suspendedThreadsCount(0)
 {
   ASSERT(m_completionHandler != nullptr, ());
+  m_threads.reserve(m_threadsCount);
+  for (uint32_t i = 0; i < m_threadsCount; ++i)
+    m_threads.emplace_back(&GlyphGenerator::Routine, this);
 }
 
 GlyphGenerator::~GlyphGenerator()
 {
   m_isRunning = false;
-  m_condition.notify_one();
-  m_thread.join();
+  m_condition.notify_all();
+  for (auto & t : m_threads)
+    t.join();
   m_completionHandler = nullptr;
 
   for (GlyphGenerationData & data : m_queue)
@@ -110,19 +125,26 @@ GlyphGenerator::~GlyphGenerator()
   m_queue.clear();
 }
 
-void GlyphGenerator::WaitForGlyph(list<GlyphGenerationData> & queue)
+void GlyphGenerator::WaitForGlyphs(list<GlyphGenerationData> & batch)
 {
   unique_lock<mutex> lock(m_queueLock);
-  m_isSuspended = true;
+  ++m_suspendedThreadsCount;
   m_condition.wait(lock, [this] { return !m_queue.empty() || !m_isRunning; });
-  m_isSuspended = false;
-  queue.swap(m_queue);
+  --m_suspendedThreadsCount;
+
+  // Queued glyphs are shared between the threads evenly.
+  size_t const batchSize = (m_queue.size() + m_threadsCount - 1) / m_threadsCount;
+  auto batchEnd = m_queue.begin();
+  advance(batchEnd, batchSize);
+  batch.splice(batch.end(), m_queue, m_queue.begin(), batchEnd);
+  if (!m_queue.empty())
+    m_condition.notify_one();
 }
 
 bool GlyphGenerator::IsSuspended() const
 {
   lock_guard<mutex> lock(m_queueLock);
-  return m_isSuspended;
+  return m_suspendedThreadsCount == m_threadsCount && m_queue.empty();
 }
 
 void GlyphGenerator::Routine(GlyphGenerator * generator)
@@ -130,11 +152,11 @@ void GlyphGenerator::Routine(GlyphGenerator * generator)
   ASSERT(generator != nullptr, ());
   while (generator->m_isRunning)
   {
-    list<GlyphGenerationData> queue;
-    generator->WaitForGlyph(queue);
+    list<GlyphGenerationData> batch;
+    generator->WaitForGlyphs(batch);
 
     // generate glyphs
-    for (GlyphGenerationData & data : queue)
+    for (GlyphGenerationData & data : batch)
     {
       GlyphManager::Glyph glyph = generator->m_mng->GenerateGlyph(data.m_glyph);
       data.m_glyph.m_image.Destroy();
@@ -201,7 +223,11 @@ ref_ptr<Texture::ResourceInfo> GlyphIndex::MapResource(GlyphKey const & key, boo
     return nullptr;
   }
 
-  m_generator->GenerateGlyph(r, glyph);
+  // Glyphs from the glyph cache don't need generation.
+  if (glyph.m_isGenerated)
+    OnGlyphGenerationCompletion(r, glyph);
+  else
+    m_generator->GenerateGlyph(r, glyph);
 
   auto res = m_index.emplace(key, GlyphInfo(m_packer.MapTextureCoords(r), glyph.m_metrics));
   ASSERT(res.second, ());
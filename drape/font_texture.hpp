@@ -73,6 +73,8 @@ private:
   GlyphManager::GlyphMetrics m_metrics;
 };
 
+// Generates images of glyphs on a pool of background threads. Every thread takes
+// a batch of queued glyphs at once.
 class GlyphGenerator
 {
 public:
@@ -97,7 +99,7 @@ public:
 
 private:
   static void Routine(GlyphGenerator * generator);
-  void WaitForGlyph(list<GlyphGenerationData> & queue);
+  void WaitForGlyphs(list<GlyphGenerationData> & batch);
 
   ref_ptr<GlyphManager> m_mng;
   TCompletionHandler m_completionHandler;
@@ -107,8 +109,9 @@ private:
 
   atomic<bool> m_isRunning;
   condition_variable m_condition;
-  bool m_isSuspended;
-  thread m_thread;
+  uint32_t const m_threadsCount;
+  uint32_t m_suspendedThreadsCount;
+  vector<thread> m_threads;
 };
 
 class GlyphIndex
@@ -0,0 +1,346 @@
+#include "drape/glyph_cache.hpp"
+
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "platform/platform.hpp"
+
+#include "base/logging.hpp"
+#include "base/math.hpp"
+#include "base/stl_add.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace dp
+{
+namespace
+{
+uint32_t const kMagic = 0x43594C47;  // "GLYC"
+uint32_t const kVersion = 2;
+// Magic, version, base glyph height, sdf scale, session and glyphs count.
+uint64_t const kHeaderSize = 6 * sizeof(uint32_t);
+// Key, metrics, width, height, offset of the image and the last used session.
+uint64_t const kEntrySize = 3 * sizeof(uint32_t) + 4 * sizeof(uint32_t) + 2 * sizeof(uint32_t) +
+                            sizeof(uint64_t) + sizeof(uint32_t);
+
+uint32_t FloatToBits(float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float BitsToFloat(uint32_t bits)
+{
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+}  // namespace
+
+// static
+uint32_t const GlyphCache::kDefaultMaxGlyphsCount;
+
+GlyphCache::GlyphCache(std::string const & filePath, uint32_t baseGlyphHeight, uint32_t sdfScale,
+                       uint32_t maxGlyphsCount)
+  : m_filePath(filePath)
+  , m_baseGlyphHeight(baseGlyphHeight)
+  , m_sdfScale(sdfScale)
+  , m_maxGlyphsCount(maxGlyphsCount)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Load();
+}
+
+// static
+uint32_t GlyphCache::GetFontId(std::string const & fontName, uint64_t fontSize)
+{
+  // FNV-1a hash of the font name and size, the size distinguishes versions of a font.
+  uint32_t hash = 2166136261U;
+  auto const add = [&hash](uint8_t byte) { hash = (hash ^ byte) * 16777619U; };
+  for (char const c : fontName)
+    add(static_cast<uint8_t>(c));
+  for (size_t i = 0; i < sizeof(fontSize); ++i)
+    add(static_cast<uint8_t>(fontSize >> (8 * i)));
+  return hash;
+}
+
+void GlyphCache::Load()
+{
+  m_file.reset();
+  m_loaded.clear();
+  m_session = 1;
+
+  if (!GetPlatform().IsFileExistsByFullPath(m_filePath))
+    return;
+
+  try
+  {
+    auto file = my::make_unique<MmapReader>(m_filePath);
+    ReaderSource<MmapReader> src(*file);
+    if (file->Size() < kHeaderSize || ReadPrimitiveFromSource<uint32_t>(src) != kMagic ||
+        ReadPrimitiveFromSource<uint32_t>(src) != kVersion)
+    {
+      LOG(LWARNING, ("Invalid glyph cache", m_filePath));
+      return;
+    }
+
+    if (ReadPrimitiveFromSource<uint32_t>(src) != m_baseGlyphHeight ||
+        ReadPrimitiveFromSource<uint32_t>(src) != m_sdfScale)
+    {
+      LOG(LINFO, ("Glyph cache", m_filePath, "is built for other glyph parameters"));
+      return;
+    }
+
+    uint32_t const session = ReadPrimitiveFromSource<uint32_t>(src);
+    uint32_t const count = ReadPrimitiveFromSource<uint32_t>(src);
+    if (file->Size() < kHeaderSize + count * kEntrySize)
+    {
+      LOG(LWARNING, ("Truncated glyph cache", m_filePath));
+      return;
+    }
+
+    std::vector<std::pair<Key, Entry>> loaded(count);
+    for (auto & glyph : loaded)
+    {
+      Key & key = glyph.first;
+      key.m_fontId = ReadPrimitiveFromSource<uint32_t>(src);
+      key.m_code = ReadPrimitiveFromSource<uint32_t>(src);
+      key.m_fixedSize = ReadPrimitiveFromSource<int32_t>(src);
+
+      Entry & entry = glyph.second;
+      entry.m_metrics.m_xAdvance = BitsToFloat(ReadPrimitiveFromSource<uint32_t>(src));
+      entry.m_metrics.m_yAdvance = BitsToFloat(ReadPrimitiveFromSource<uint32_t>(src));
+      entry.m_metrics.m_xOffset = BitsToFloat(ReadPrimitiveFromSource<uint32_t>(src));
+      entry.m_metrics.m_yOffset = BitsToFloat(ReadPrimitiveFromSource<uint32_t>(src));
+      entry.m_metrics.m_isValid = true;
+      entry.m_width = ReadPrimitiveFromSource<uint32_t>(src);
+      entry.m_height = ReadPrimitiveFromSource<uint32_t>(src);
+      entry.m_offset = ReadPrimitiveFromSource<uint64_t>(src);
+      entry.m_lastUsedSession = ReadPrimitiveFromSource<uint32_t>(src);
+
+      uint64_t const imageSize = static_cast<uint64_t>(entry.m_width) * entry.m_height;
+      if (entry.m_offset > file->Size() || imageSize > file->Size() - entry.m_offset)
+      {
+        LOG(LWARNING, ("Invalid glyph in the glyph cache", m_filePath));
+        return;
+      }
+    }
+
+    if (!std::is_sorted(loaded.begin(), loaded.end(),
+                        [](std::pair<Key, Entry> const & lhs, std::pair<Key, Entry> const & rhs)
+                        {
+                          return lhs.first < rhs.first;
+                        }))
+    {
+      LOG(LWARNING, ("Unsorted glyph cache", m_filePath));
+      return;
+    }
+
+    m_file = std::move(file);
+    m_loaded = std::move(loaded);
+    m_session = session + 1;
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LWARNING, ("Error reading glyph cache", m_filePath, e.what()));
+  }
+}
+
+uint8_t const * GlyphCache::GetImage(Entry const & entry) const
+{
+  ASSERT(m_file, ());
+  return m_file->Data() + entry.m_offset;
+}
+
+bool GlyphCache::Find(Key const & key, GlyphManager::Glyph & glyph)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  Entry const * entry = nullptr;
+  uint8_t const * image = nullptr;
+
+  auto const it = std::lower_bound(m_loaded.begin(), m_loaded.end(), key,
+                                   [](std::pair<Key, Entry> const & glyph, Key const & key)
+                                   {
+                                     return glyph.first < key;
+                                   });
+  if (it != m_loaded.end() && !(key < it->first))
+  {
+    it->second.m_lastUsedSession = m_session;
+    entry = &it->second;
+    image = GetImage(*entry);
+  }
+  else
+  {
+    auto const newIt = m_new.find(key);
+    if (newIt == m_new.end())
+      return false;
+    entry = &newIt->second.m_entry;
+    image = newIt->second.m_image.data();
+  }
+
+  size_t const imageSize = entry->m_width * entry->m_height;
+  glyph.m_metrics = entry->m_metrics;
+  glyph.m_image.m_width = entry->m_width;
+  glyph.m_image.m_height = entry->m_height;
+  glyph.m_image.m_bitmapRows = 0;
+  glyph.m_image.m_bitmapPitch = 0;
+  glyph.m_image.m_data = nullptr;
+  if (imageSize != 0)
+  {
+    glyph.m_image.m_data =
+        SharedBufferManager::instance().reserveSharedBuffer(my::NextPowOf2(imageSize));
+    memcpy(glyph.m_image.m_data->data(), image, imageSize);
+  }
+  glyph.m_code = key.m_code;
+  glyph.m_fixedSize = key.m_fixedSize;
+  glyph.m_isGenerated = true;
+  return true;
+}
+
+void GlyphCache::Add(Key const & key, GlyphManager::Glyph const & glyph)
+{
+  ASSERT(glyph.m_metrics.m_isValid, ());
+
+  size_t const imageSize = glyph.m_image.m_width * glyph.m_image.m_height;
+  if (imageSize != 0 && glyph.m_image.m_data == nullptr)
+    return;
+
+  NewEntry newEntry;
+  newEntry.m_entry.m_metrics = glyph.m_metrics;
+  newEntry.m_entry.m_width = glyph.m_image.m_width;
+  newEntry.m_entry.m_height = glyph.m_image.m_height;
+  if (imageSize != 0)
+  {
+    ASSERT_LESS_OR_EQUAL(imageSize, glyph.m_image.m_data->size(), ());
+    newEntry.m_image.assign(glyph.m_image.m_data->begin(),
+                            glyph.m_image.m_data->begin() + imageSize);
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // The glyph is generated again after the next saving if the limit is reached.
+  if (m_new.size() >= m_maxGlyphsCount)
+    return;
+  // |m_session| is changed by Load() in Save().
+  newEntry.m_entry.m_lastUsedSession = m_session;
+  m_new.emplace(key, std::move(newEntry));
+}
+
+bool GlyphCache::Save()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_new.empty())
+    return true;
+
+  // Loaded and new glyphs are merged by key.
+  std::vector<std::pair<Key, std::pair<Entry, uint8_t const *>>> glyphs;
+  glyphs.reserve(m_loaded.size() + m_new.size());
+  for (auto const & glyph : m_loaded)
+  {
+    if (m_new.find(glyph.first) == m_new.end())
+      glyphs.emplace_back(glyph.first, std::make_pair(glyph.second, GetImage(glyph.second)));
+  }
+  for (auto const & glyph : m_new)
+  {
+    glyphs.emplace_back(glyph.first,
+                        std::make_pair(glyph.second.m_entry, glyph.second.m_image.data()));
+  }
+
+  // Least recently used glyphs are evicted.
+  if (glyphs.size() > m_maxGlyphsCount)
+  {
+    std::nth_element(glyphs.begin(), glyphs.begin() + m_maxGlyphsCount, glyphs.end(),
+                     [](std::pair<Key, std::pair<Entry, uint8_t const *>> const & lhs,
+                        std::pair<Key, std::pair<Entry, uint8_t const *>> const & rhs)
+                     {
+                       return lhs.second.first.m_lastUsedSession >
+                              rhs.second.first.m_lastUsedSession;
+                     });
+    glyphs.erase(glyphs.begin() + m_maxGlyphsCount, glyphs.end());
+  }
+
+  std::sort(glyphs.begin(), glyphs.end(),
+            [](std::pair<Key, std::pair<Entry, uint8_t const *>> const & lhs,
+               std::pair<Key, std::pair<Entry, uint8_t const *>> const & rhs)
+            {
+              return lhs.first < rhs.first;
+            });
+
+  std::string const tmpFilePath = m_filePath + ".tmp";
+  try
+  {
+    FileWriter writer(tmpFilePath);
+    WriteToSink(writer, kMagic);
+    WriteToSink(writer, kVersion);
+    WriteToSink(writer, m_baseGlyphHeight);
+    WriteToSink(writer, m_sdfScale);
+    WriteToSink(writer, m_session);
+    WriteToSink(writer, static_cast<uint32_t>(glyphs.size()));
+
+    uint64_t offset = kHeaderSize + glyphs.size() * kEntrySize;
+    for (auto const & glyph : glyphs)
+    {
+      Key const & key = glyph.first;
+      Entry const & entry = glyph.second.first;
+      WriteToSink(writer, key.m_fontId);
+      WriteToSink(writer, static_cast<uint32_t>(key.m_code));
+      WriteToSink(writer, static_cast<int32_t>(key.m_fixedSize));
+      WriteToSink(writer, FloatToBits(entry.m_metrics.m_xAdvance));
+      WriteToSink(writer, FloatToBits(entry.m_metrics.m_yAdvance));
+      WriteToSink(writer, FloatToBits(entry.m_metrics.m_xOffset));
+      WriteToSink(writer, FloatToBits(entry.m_metrics.m_yOffset));
+      WriteToSink(writer, entry.m_width);
+      WriteToSink(writer, entry.m_height);
+      WriteToSink(writer, offset);
+      WriteToSink(writer, entry.m_lastUsedSession);
+      offset += static_cast<uint64_t>(entry.m_width) * entry.m_height;
+    }
+
+    for (auto const & glyph : glyphs)
+    {
+      Entry const & entry = glyph.second.first;
+      writer.Write(glyph.second.second, entry.m_width * entry.m_height);
+    }
+  }
+  catch (Writer::Exception const & e)
+  {
+    LOG(LWARNING, ("Error writing glyph cache", tmpFilePath, e.what()));
+    my::DeleteFileX(tmpFilePath);
+    return false;
+  }
+
+  // The old file is unmapped before it's replaced.
+  m_file.reset();
+  m_loaded.clear();
+  bool const renamed = my::RenameFileX(tmpFilePath, m_filePath);
+  if (renamed)
+    m_new.clear();
+  else
+    my::DeleteFileX(tmpFilePath);
+
+  Load();
+  return renamed;
+}
+
+size_t GlyphCache::GetSize() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t size = m_loaded.size();
+  for (auto const & glyph : m_new)
+  {
+    if (!std::binary_search(m_loaded.begin(), m_loaded.end(), std::make_pair(glyph.first, Entry()),
+                            [](std::pair<Key, Entry> const & lhs, std::pair<Key, Entry> const & rhs)
+                            {
+                              return lhs.first < rhs.first;
+                            }))
+    {
+      ++size;
+    }
+  }
+  return size;
+}
+}  // namespace dp
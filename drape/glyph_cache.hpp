@@ -0,0 +1,107 @@
+#pragma once
+
+#include "drape/glyph_manager.hpp"
+
+#include "coding/mmap_reader.hpp"
+
+#include "base/string_utils.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace dp
+{
+// Persistent cache of generated glyph images. Images are keyed by font, unicode point
+// and fixed size and are valid for the base glyph height and sdf scale the cache is
+// created with, a cache file which is built for other parameters is ignored.
+//
+// The file is memory-mapped on loading, so only the index of the cached glyphs is read
+// at startup. Newly generated glyphs are kept in memory until Save() which rewrites
+// the file with all of the glyphs.
+//
+// The cache keeps at most |maxGlyphsCount| glyphs: new glyphs over the limit are not
+// added until the next Save(), and Save() evicts the glyphs which were not used for
+// the longest number of sessions. A session lasts from loading to saving of the file.
+//
+// Find() and Add() can be called from any thread.
+class GlyphCache
+{
+public:
+  struct Key
+  {
+    Key() = default;
+    Key(uint32_t fontId, strings::UniChar code, int fixedSize)
+      : m_fontId(fontId), m_code(code), m_fixedSize(fixedSize)
+    {
+    }
+
+    bool operator<(Key const & rhs) const
+    {
+      return std::tie(m_fontId, m_code, m_fixedSize) <
+             std::tie(rhs.m_fontId, rhs.m_code, rhs.m_fixedSize);
+    }
+
+    uint32_t m_fontId = 0;
+    strings::UniChar m_code = 0;
+    int m_fixedSize = 0;
+  };
+
+  static uint32_t const kDefaultMaxGlyphsCount = 4096;
+
+  GlyphCache(std::string const & filePath, uint32_t baseGlyphHeight, uint32_t sdfScale,
+             uint32_t maxGlyphsCount = kDefaultMaxGlyphsCount);
+
+  // Returns an identifier of the font which is stable between application launches.
+  static uint32_t GetFontId(std::string const & fontName, uint64_t fontSize);
+
+  // Fills metrics and image of |glyph| if it's in the cache.
+  // The image is allocated by SharedBufferManager and must be destroyed by the caller.
+  // Found glyphs are marked as used in the current session.
+  bool Find(Key const & key, GlyphManager::Glyph & glyph);
+  void Add(Key const & key, GlyphManager::Glyph const & glyph);
+
+  // Writes the glyphs to the file if there are new ones.
+  bool Save();
+
+  size_t GetSize() const;
+
+private:
+  struct Entry
+  {
+    GlyphManager::GlyphMetrics m_metrics;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    // Offset of the image in the file for loaded glyphs.
+    uint64_t m_offset = 0;
+    // The last session the glyph was used in.
+    uint32_t m_lastUsedSession = 0;
+  };
+
+  struct NewEntry
+  {
+    Entry m_entry;
+    std::vector<uint8_t> m_image;
+  };
+
+  void Load();
+  uint8_t const * GetImage(Entry const & entry) const;
+
+  std::string const m_filePath;
+  uint32_t const m_baseGlyphHeight;
+  uint32_t const m_sdfScale;
+  uint32_t const m_maxGlyphsCount;
+  uint32_t m_session = 0;
+
+  // Glyphs of the file, sorted by key.
+  std::unique_ptr<MmapReader> m_file;
+  std::vector<std::pair<Key, Entry>> m_loaded;
+
+  std::map<Key, NewEntry> m_new;
+  mutable std::mutex m_mutex;
+};
+}  // namespace dp
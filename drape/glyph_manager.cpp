@@ -1,4 +1,6 @@
 #include "drape/glyph_manager.hpp"
+#include "drape/glyph_cache.hpp"
+
 #include "3party/sdf_image/sdf_image.h"
 
 #include "platform/platform.hpp"
@@ -174,6 +176,8 @@ public:
     }
   }
 
+  uint64_t GetFileSize() const { return m_fontReader.Size(); }
+
   bool HasGlyph(strings::UniChar unicodePoint) const
   {
     return FT_Get_Char_Index(m_fontFace, unicodePoint) != 0;
@@ -266,7 +270,7 @@ public:
       resultGlyph.m_code = glyph.m_code;
       resultGlyph.m_fixedSize = glyph.m_fixedSize;
 
-      if (glyph.m_fixedSize < 0)
+      if (glyph.m_fixedSize < 0 && !glyph.m_isGenerated)
       {
         sdf_image::SdfImage img(glyph.m_image.m_bitmapRows, glyph.m_image.m_bitmapPitch,
                                 glyph.m_image.m_data->data(), m_sdfScale * kSdfBorder);
@@ -292,6 +296,7 @@ public:
       resultGlyph.m_image.m_height = glyph.m_image.m_height;
       resultGlyph.m_image.m_bitmapRows = 0;
       resultGlyph.m_image.m_bitmapPitch = 0;
+      resultGlyph.m_isGenerated = true;
 
       return resultGlyph;
     }
@@ -399,6 +404,9 @@ struct GlyphManager::Impl
   TUniBlocks m_blocks;
   TUniBlockIter m_lastUsedBlock;
   std::vector<std::unique_ptr<Font>> m_fonts;
+  // Identifiers of m_fonts in the glyph cache.
+  std::vector<uint32_t> m_fontIds;
+  std::unique_ptr<GlyphCache> m_cache;
 
   uint32_t m_baseGlyphHeight;
 };
@@ -407,6 +415,11 @@ GlyphManager::GlyphManager(GlyphManager::Params const & params)
   : m_impl(new Impl())
 {
   m_impl->m_baseGlyphHeight = params.m_baseGlyphHeight;
+  if (!params.m_glyphCacheFile.empty())
+  {
+    m_impl->m_cache = my::make_unique<GlyphCache>(params.m_glyphCacheFile, params.m_baseGlyphHeight,
+                                                  params.m_sdfScale);
+  }
 
   using TFontAndBlockName = pair<std::string, std::string>;
   using TFontLst = buffer_vector<TFontAndBlockName, 64>;
@@ -452,6 +465,7 @@ GlyphManager::GlyphManager(GlyphManager::Params const & params)
     {
       m_impl->m_fonts.emplace_back(my::make_unique<Font>(params.m_sdfScale, GetPlatform().GetReader(fontName),
                                                          m_impl->m_library));
+      m_impl->m_fontIds.push_back(GlyphCache::GetFontId(fontName, m_impl->m_fonts.back()->GetFileSize()));
       m_impl->m_fonts.back()->GetCharcodes(charCodes);
     }
     catch(RootException const & e)
@@ -530,6 +544,8 @@ GlyphManager::GlyphManager(GlyphManager::Params const & params)
 
 GlyphManager::~GlyphManager()
 {
+  SaveGlyphCache();
+
   for (auto const & f : m_impl->m_fonts)
     f->DestroyFont();
 
@@ -604,9 +620,17 @@ GlyphManager::Glyph GlyphManager::GetGlyph(strings::UniChar unicodePoint, int fi
   if (fontIndex == kInvalidFont)
     return GetInvalidGlyph(fixedHeight);
 
+  Glyph glyph;
+  if (m_impl->m_cache != nullptr &&
+      m_impl->m_cache->Find(GlyphCache::Key(m_impl->m_fontIds[fontIndex], unicodePoint, fixedHeight), glyph))
+  {
+    glyph.m_fontIndex = fontIndex;
+    return glyph;
+  }
+
   auto const & f = m_impl->m_fonts[fontIndex];
   bool const isSdf = fixedHeight < 0;
-  Glyph glyph = f->GetGlyph(unicodePoint, isSdf ? m_impl->m_baseGlyphHeight : fixedHeight, isSdf);
+  glyph = f->GetGlyph(unicodePoint, isSdf ? m_impl->m_baseGlyphHeight : fixedHeight, isSdf);
   glyph.m_fontIndex = fontIndex;
   return glyph;
 }
@@ -616,7 +640,21 @@ GlyphManager::Glyph GlyphManager::GenerateGlyph(Glyph const & glyph) const
   ASSERT_NOT_EQUAL(glyph.m_fontIndex, -1, ());
   ASSERT_LESS(glyph.m_fontIndex, static_cast<int>(m_impl->m_fonts.size()), ());
   auto const & f = m_impl->m_fonts[glyph.m_fontIndex];
-  return f->GenerateGlyph(glyph);
+  Glyph resultGlyph = f->GenerateGlyph(glyph);
+
+  // Invalid glyphs are not cached because they are not distinguished by the glyph key.
+  if (m_impl->m_cache != nullptr && !glyph.m_isGenerated && glyph.m_metrics.m_isValid)
+  {
+    m_impl->m_cache->Add(GlyphCache::Key(m_impl->m_fontIds[glyph.m_fontIndex], glyph.m_code,
+                                         glyph.m_fixedSize), resultGlyph);
+  }
+  return resultGlyph;
+}
+
+void GlyphManager::SaveGlyphCache()
+{
+  if (m_impl->m_cache != nullptr && !m_impl->m_cache->Save())
+    LOG(LWARNING, ("Glyph cache can't be saved"));
 }
 
 void GlyphManager::ForEachUnicodeBlock(GlyphManager::TUniBlockCallback const & fn) const
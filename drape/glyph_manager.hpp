@@ -28,6 +28,9 @@ public:
 
     uint32_t m_baseGlyphHeight = 22;
     uint32_t m_sdfScale = 4;
+
+    // Path of the persistent cache of generated glyphs, the cache is disabled if it's empty.
+    std::string m_glyphCacheFile;
   };
 
   struct GlyphMetrics
@@ -71,6 +74,9 @@ public:
     int m_fontIndex;
     strings::UniChar m_code;
     int m_fixedSize;
+    // True if the image is final and GenerateGlyph() only copies it,
+    // e.g. the glyph is taken from the glyph cache.
+    bool m_isGenerated = false;
   };
 
   GlyphManager(Params const & params);
@@ -89,6 +95,9 @@ public:
 
   uint32_t GetBaseGlyphHeight() const;
 
+  // Writes newly generated glyphs to the glyph cache file. Called on destruction too.
+  void SaveGlyphCache();
+
 private:
   int GetFontIndex(strings::UniChar unicodePoint);
   // Immutable version can be called from any thread and doesn't require internal synchronization.
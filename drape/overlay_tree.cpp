@@ -3,7 +3,10 @@
 #include "drape/constants.hpp"
 #include "drape/debug_rect_renderer.hpp"
 
+#include "base/math.hpp"
+
 #include <algorithm>
+#include <cmath>
 
 namespace dp
 {
@@ -16,6 +19,11 @@ uint32_t const kMaxHandlesCount = 1000;
 size_t const kAverageHandlesCount[dp::OverlayRanksCount] = { 300, 200, 50 };
 int const kInvalidFrame = -1;
 
+// Handles which are moved relative to the map less than this distance in pixels keep
+// their previous placement in incremental mode.
+double const kPlacingTolerance = 2.0;
+double const kChangedRectsCellSize = 64.0;
+
 namespace
 {
 class HandleComparator
@@ -70,6 +78,11 @@ OverlayTree::OverlayTree(double visualScale)
   : m_frameCounter(kInvalidFrame)
   , m_isDisplacementEnabled(true)
   , m_frameUpdatePeriod(kMinFrameUpdatePeriod)
+  , m_isIncrementalPlacingEnabled(false)
+  , m_isFullPlacingRequired(true)
+  , m_isIncrementalPlacing(false)
+  , m_placingTolerance(kPlacingTolerance * visualScale)
+  , m_changedRects(kChangedRectsCellSize * visualScale)
 {
   m_traits.SetVisualScale(visualScale);
   for (size_t i = 0; i < m_handles.size(); i++)
@@ -84,6 +97,9 @@ void OverlayTree::Clear()
   for (auto & handles : m_handles)
     handles.clear();
   m_displacers.clear();
+  m_placement.clear();
+  m_removedRects.clear();
+  m_isFullPlacingRequired = true;
 }
 
 bool OverlayTree::Frame()
@@ -122,10 +138,27 @@ void OverlayTree::StartOverlayPlacing(ScreenBase const & screen)
   m_handlesCache.clear();
   m_traits.SetModelView(screen);
   m_displacementInfo.clear();
+
+  m_isIncrementalPlacing = IsIncrementalPlacingPossible();
+  if (m_isIncrementalPlacing)
+  {
+    m2::PointD const center = m_placementScreen.PixelRect().Center();
+    m_placementShift = screen.GtoP(m_placementScreen.PtoG(center)) - center;
+  }
 }
 
 void OverlayTree::Remove(ref_ptr<OverlayHandle> handle)
 {
+  // The handle is going to be destroyed, so it's forgotten right now to avoid
+  // matching of a new handle with the same address to it.
+  auto const it = m_placement.find(handle);
+  if (it != m_placement.end())
+  {
+    if (it->second.m_isVisible)
+      m_removedRects.push_back(it->second.m_pixelRect);
+    m_placement.erase(it);
+  }
+
   if (m_frameCounter == kInvalidFrame)
     return;
 
@@ -262,6 +295,8 @@ void OverlayTree::InsertHandle(ref_ptr<OverlayHandle> handle, int currentRank,
         if ((*it)->GetOverlayID() == rivalHandle->GetOverlayID())
         {
           Erase(*it);
+          if (m_isIncrementalPlacing)
+            MarkChanged((*it)->GetExtendedPixelRect(modelView));
           StoreDisplacementInfo(2 /* case index */, handle, *it);
           it = m_handlesCache.erase(it);
         }
@@ -286,24 +321,56 @@ void OverlayTree::EndOverlayPlacing()
 {
   ASSERT(IsNeedUpdate(), ());
 
-  m_displacers.clear();
+  HandlesCache prevDisplacers;
+  prevDisplacers.swap(m_displacers);
 
 #ifdef DEBUG_OVERLAYS_OUTPUT
   LOG(LINFO, ("- BEGIN OVERLAYS PLACING"));
 #endif
 
+  ScreenBase const & modelView = GetModelView();
+  if (m_isIncrementalPlacing)
+    MarkRemovedHandles();
+
   HandleComparator comparator(false /* enableMask */);
 
+  Placement placement;
   for (int rank = 0; rank < dp::OverlayRanksCount; rank++)
   {
     std::sort(m_handles[rank].begin(), m_handles[rank].end(), comparator);
     for (auto const & handle : m_handles[rank])
     {
+      m2::RectD const pixelRect = handle->GetExtendedPixelRect(modelView);
+      if (m_isIncrementalPlacingEnabled)
+        placement[handle].m_pixelRect = pixelRect;
+
       ref_ptr<OverlayHandle> parentOverlay;
       if (!CheckHandle(handle, rank, parentOverlay))
         continue;
 
+      if (m_isIncrementalPlacing && !IsHandleChanged(handle, pixelRect))
+      {
+        // Previous placement of the handle is kept.
+        if (m_placement.find(handle)->second.m_isVisible)
+        {
+          m_handlesCache.insert(handle);
+          TBase::Add(handle, pixelRect);
+          if (prevDisplacers.find(handle) != prevDisplacers.end())
+            m_displacers.insert(handle);
+        }
+        continue;
+      }
+
       InsertHandle(handle, rank, parentOverlay);
+
+      if (m_isIncrementalPlacing)
+      {
+        auto const it = m_placement.find(handle);
+        bool const wasVisible = it != m_placement.end() && it->second.m_isVisible;
+        bool const isVisible = m_handlesCache.find(handle) != m_handlesCache.end();
+        if (wasVisible != isVisible)
+          MarkChanged(pixelRect);
+      }
     }
   }
   
@@ -319,8 +386,16 @@ void OverlayTree::EndOverlayPlacing()
     handle->SetDisplayFlag(true);
     handle->SetIsVisible(true);
     handle->SetCachingEnable(false);
+    if (m_isIncrementalPlacingEnabled)
+      placement[handle].m_isVisible = true;
   }
 
+  m_placement.swap(placement);
+  m_placementScreen = modelView;
+  m_removedRects.clear();
+  m_changedRects.Clear();
+  m_isFullPlacingRequired = false;
+
   m_frameCounter = 0;
 
 #ifdef DEBUG_OVERLAYS_OUTPUT
@@ -328,6 +403,80 @@ void OverlayTree::EndOverlayPlacing()
 #endif
 }
 
+bool OverlayTree::IsIncrementalPlacingPossible() const
+{
+  if (!m_isIncrementalPlacingEnabled || m_isFullPlacingRequired)
+    return false;
+
+  // Placement is kept if the map is moved only, on zooming, rotation and in perspective
+  // mode all of the pixel rects are moved relative to each other.
+  ScreenBase const & screen = GetModelView();
+  return !screen.isPerspective() && !m_placementScreen.isPerspective() &&
+         my::AlmostEqualULPs(screen.GetScale(), m_placementScreen.GetScale()) &&
+         my::AlmostEqualULPs(screen.GetAngle(), m_placementScreen.GetAngle());
+}
+
+bool OverlayTree::IsHandleMoved(ref_ptr<OverlayHandle> const & handle,
+                                m2::RectD const & pixelRect) const
+{
+  auto const it = m_placement.find(handle);
+  if (it == m_placement.end())
+    return true;
+
+  m2::RectD prevRect = it->second.m_pixelRect;
+  prevRect.Offset(m_placementShift);
+  return std::fabs(prevRect.minX() - pixelRect.minX()) > m_placingTolerance ||
+         std::fabs(prevRect.minY() - pixelRect.minY()) > m_placingTolerance ||
+         std::fabs(prevRect.maxX() - pixelRect.maxX()) > m_placingTolerance ||
+         std::fabs(prevRect.maxY() - pixelRect.maxY()) > m_placingTolerance;
+}
+
+bool OverlayTree::IsHandleChanged(ref_ptr<OverlayHandle> const & handle,
+                                  m2::RectD const & pixelRect) const
+{
+  return IsHandleMoved(handle, pixelRect) || m_changedRects.IsIntersect(pixelRect);
+}
+
+void OverlayTree::MarkChanged(m2::RectD const & pixelRect)
+{
+  m_changedRects.Add(pixelRect);
+}
+
+void OverlayTree::MarkRemovedHandles()
+{
+  HandlesCache candidates;
+  for (auto const & handles : m_handles)
+    candidates.insert(handles.begin(), handles.end());
+
+  auto const markShifted = [this](m2::RectD rect) {
+    rect.Offset(m_placementShift);
+    MarkChanged(rect);
+  };
+
+  for (auto const & rect : m_removedRects)
+    markShifted(rect);
+
+  for (auto const & p : m_placement)
+  {
+    if (p.second.m_isVisible && candidates.find(p.first) == candidates.end())
+      markShifted(p.second.m_pixelRect);
+  }
+
+  // Neighbours of added and moved handles are checked for collisions too: both at
+  // the new place of a handle and at the place it has released.
+  for (auto const & handle : candidates)
+  {
+    m2::RectD const pixelRect = handle->GetExtendedPixelRect(GetModelView());
+    if (!IsHandleMoved(handle, pixelRect))
+      continue;
+
+    MarkChanged(pixelRect);
+    auto const it = m_placement.find(handle);
+    if (it != m_placement.end() && it->second.m_isVisible)
+      markShifted(it->second.m_pixelRect);
+  }
+}
+
 bool OverlayTree::CheckHandle(ref_ptr<OverlayHandle> handle, int currentRank,
                               ref_ptr<OverlayHandle> & parentOverlay) const
 {
@@ -354,7 +503,11 @@ void OverlayTree::DeleteHandle(ref_ptr<OverlayHandle> const & handle)
 {
   size_t const deletedCount = m_handlesCache.erase(handle);
   if (deletedCount != 0)
+  {
     Erase(handle);
+    if (m_isIncrementalPlacing)
+      MarkChanged(handle->GetExtendedPixelRect(GetModelView()));
+  }
 }
 
 void OverlayTree::DeleteHandleWithParents(ref_ptr<OverlayHandle> handle, int currentRank)
@@ -429,11 +582,22 @@ void OverlayTree::SetDisplacementEnabled(bool enabled)
   if (m_isDisplacementEnabled == enabled)
     return;
   m_isDisplacementEnabled = enabled;
+  m_isFullPlacingRequired = true;
   m_frameCounter = kInvalidFrame;
 }
 
+void OverlayTree::SetIncrementalPlacingEnabled(bool enabled)
+{
+  if (m_isIncrementalPlacingEnabled == enabled)
+    return;
+  m_isIncrementalPlacingEnabled = enabled;
+  m_isFullPlacingRequired = true;
+}
+
 void OverlayTree::SetSelectedFeature(FeatureID const & featureID)
 {
+  if (!(m_selectedFeatureID == featureID))
+    m_isFullPlacingRequired = true;
   m_selectedFeatureID = featureID;
 }
 
@@ -464,6 +628,55 @@ void OverlayTree::StoreDisplacementInfo(int caseIndex, ref_ptr<OverlayHandle> di
                                   dp::Color(0, 0, 255, 255));
 }
 
+detail::RectsGrid::RectsGrid(double cellSize) : m_cellSize(cellSize)
+{
+  ASSERT_GREATER(m_cellSize, 0.0, ());
+}
+
+template <typename ToDo>
+void detail::RectsGrid::ForEachCell(m2::RectD const & rect, ToDo && toDo) const
+{
+  auto const toCell = [this](double coord) {
+    return static_cast<int32_t>(std::floor(coord / m_cellSize));
+  };
+
+  int32_t const minX = toCell(rect.minX());
+  int32_t const maxX = toCell(rect.maxX());
+  int32_t const minY = toCell(rect.minY());
+  int32_t const maxY = toCell(rect.maxY());
+  for (int32_t x = minX; x <= maxX; ++x)
+  {
+    for (int32_t y = minY; y <= maxY; ++y)
+      toDo((static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y));
+  }
+}
+
+void detail::RectsGrid::Add(m2::RectD const & rect)
+{
+  ForEachCell(rect, [this, &rect](uint64_t cell) { m_cells[cell].push_back(rect); });
+}
+
+bool detail::RectsGrid::IsIntersect(m2::RectD const & rect) const
+{
+  bool intersects = false;
+  ForEachCell(rect, [this, &rect, &intersects](uint64_t cell) {
+    if (intersects)
+      return;
+    auto const it = m_cells.find(cell);
+    if (it == m_cells.end())
+      return;
+    for (auto const & r : it->second)
+    {
+      if (r.IsIntersect(rect))
+      {
+        intersects = true;
+        return;
+      }
+    }
+  });
+  return intersects;
+}
+
 void detail::OverlayTraits::SetVisualScale(double visualScale)
 {
   m_visualScale = visualScale;
@@ -9,7 +9,9 @@
 #include "base/buffer_vector.hpp"
 
 #include <array>
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -47,6 +49,25 @@ struct OverlayHasher
     return m_hasher(handle.get());
   }
 };
+
+// Spatial hash grid of pixel rects, it answers whether a rect intersects
+// any of the added rects.
+class RectsGrid
+{
+public:
+  explicit RectsGrid(double cellSize);
+
+  void Add(m2::RectD const & rect);
+  bool IsIntersect(m2::RectD const & rect) const;
+  void Clear() { m_cells.clear(); }
+
+private:
+  template <typename ToDo>
+  void ForEachCell(m2::RectD const & rect, ToDo && toDo) const;
+
+  double const m_cellSize;
+  std::unordered_map<uint64_t, std::vector<m2::RectD>> m_cells;
+};
 }  // namespace detail
 
 using TOverlayContainer = buffer_vector<ref_ptr<OverlayHandle>, 8>;
@@ -76,6 +97,11 @@ public:
 
   void SetDisplacementEnabled(bool enabled);
 
+  // In incremental mode the placement of the previous frame is kept, only handles which
+  // were added, removed or moved relative to the map, and handles whose pixel rects
+  // intersect them, are checked for collisions again.
+  void SetIncrementalPlacingEnabled(bool enabled);
+
   void SetSelectedFeature(FeatureID const & featureID);
   bool GetSelectedFeatureRect(ScreenBase const & screen, m2::RectD & featureRect);
 
@@ -105,6 +131,16 @@ private:
 
   void StoreDisplacementInfo(int caseIndex, ref_ptr<OverlayHandle> displacerHandle,
                              ref_ptr<OverlayHandle> displacedHandle);
+
+  bool IsIncrementalPlacingPossible() const;
+  // Returns true if |handle| is new or is moved relative to the map since the previous placement.
+  bool IsHandleMoved(ref_ptr<OverlayHandle> const & handle, m2::RectD const & pixelRect) const;
+  // Returns true if |handle| has to be checked for collisions during incremental placing.
+  bool IsHandleChanged(ref_ptr<OverlayHandle> const & handle, m2::RectD const & pixelRect) const;
+  // Marks rects of handles which became visible or hidden during incremental placing.
+  void MarkChanged(m2::RectD const & pixelRect);
+  void MarkRemovedHandles();
+
   int m_frameCounter;
   std::array<std::vector<ref_ptr<OverlayHandle>>, dp::OverlayRanksCount> m_handles;
   HandlesCache m_handlesCache;
@@ -117,5 +153,26 @@ private:
 
   HandlesCache m_displacers;
   uint32_t m_frameUpdatePeriod;
+
+  struct PlacementInfo
+  {
+    m2::RectD m_pixelRect;
+    bool m_isVisible = false;
+  };
+  using Placement = std::unordered_map<ref_ptr<OverlayHandle>, PlacementInfo,
+                                       detail::OverlayHasher>;
+
+  bool m_isIncrementalPlacingEnabled;
+  bool m_isFullPlacingRequired;
+  bool m_isIncrementalPlacing;
+  double m_placingTolerance;
+  // Placement of the previous frame and the screen it was made for.
+  Placement m_placement;
+  ScreenBase m_placementScreen;
+  // Rects of visible handles which were removed from the tree after the last placement.
+  std::vector<m2::RectD> m_removedRects;
+  // Shift of the pixel rects of the previous placement on the current screen.
+  m2::PointD m_placementShift;
+  detail::RectsGrid m_changedRects;
 };
 }  // namespace dp
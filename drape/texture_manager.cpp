@@ -541,6 +541,12 @@ void TextureManager::OnSwitchMapStyle()
   //}
 }
 
+void TextureManager::SaveGlyphCache()
+{
+  if (m_glyphManager != nullptr)
+    m_glyphManager->SaveGlyphCache();
+}
+
 void TextureManager::GetSymbolRegion(string const & symbolName, SymbolRegion & region)
 {
   for (size_t i = 0; i < m_symbolTextures.size(); ++i)
@@ -83,6 +83,8 @@ public:
 
   void Init(Params const & params);
   void OnSwitchMapStyle();
+  // Writes newly generated glyphs to the glyph cache file.
+  void SaveGlyphCache();
 
   void GetSymbolRegion(std::string const & symbolName, SymbolRegion & region);
 
@@ -491,6 +491,12 @@ void BackendRenderer::AcceptMessage(ref_ptr<Message> message)
       break;
     }
 
+  case Message::SaveGlyphCache:
+    {
+      m_texMng->SaveGlyphCache();
+      break;
+    }
+
   default:
     ASSERT(false, ());
     break;
@@ -577,6 +583,7 @@ void BackendRenderer::InitGLDependentResource()
   params.m_glyphMngParams.m_blacklist = "fonts_blacklist.txt";
   params.m_glyphMngParams.m_sdfScale = VisualParams::Instance().GetGlyphSdfScale();
   params.m_glyphMngParams.m_baseGlyphHeight = VisualParams::Instance().GetGlyphBaseSize();
+  params.m_glyphMngParams.m_glyphCacheFile = GetPlatform().WritablePathForFile("glyphs.cache");
   GetPlatform().GetFontNames(params.m_glyphMngParams.m_fonts);
 
   m_texMng->Init(params);
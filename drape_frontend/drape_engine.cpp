@@ -635,6 +635,13 @@ void DrapeEngine::SetTimeInBackground(double time)
                                   MessagePriority::High);
 }
 
+void DrapeEngine::SaveGlyphCache()
+{
+  m_threadCommutator->PostMessage(ThreadsCommutator::ResourceUploadThread,
+                                  make_unique_dp<SaveGlyphCacheMessage>(),
+                                  MessagePriority::Normal);
+}
+
 void DrapeEngine::SetDisplacementMode(int mode)
 {
   m_threadCommutator->PostMessage(ThreadsCommutator::ResourceUploadThread,
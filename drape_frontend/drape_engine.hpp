@@ -184,6 +184,8 @@ public:
   void SetKineticScrollEnabled(bool enabled);
 
   void SetTimeInBackground(double time);
+  // Writes newly generated glyphs to the glyph cache file.
+  void SaveGlyphCache();
 
   void SetDisplacementMode(int mode);
 
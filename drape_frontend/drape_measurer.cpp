@@ -45,6 +45,11 @@ void DrapeMeasurer::StartBenchmark()
   m_minFPS = std::numeric_limits<uint32_t>::max();
   m_totalFPS = 0.0;
   m_totalFPSCount = 0;
+
+  m_startOverlayPlacingTime = currentTime;
+  m_totalOverlayPlacingTime = steady_clock::duration::zero();
+  m_maxOverlayPlacingTime = steady_clock::duration::zero();
+  m_totalOverlayPlacingsCount = 0;
 #endif
 
 #if defined(RENDER_STATISTIC) || defined(TRACK_GPU_MEM)
@@ -150,6 +155,9 @@ std::string DrapeMeasurer::RenderStatistic::ToString() const
   ss << " FPS = " << m_FPS << "\n";
   ss << " min FPS = " << m_minFPS << "\n";
   ss << " Frame render time, ms = " << m_frameRenderTimeInMs << "\n";
+  ss << " Overlay placings count = " << m_overlayPlacingsCount << "\n";
+  ss << " Overlay placing time, us = " << m_overlayPlacingTimeInUs << "\n";
+  ss << " Max overlay placing time, us = " << m_maxOverlayPlacingTimeInUs << "\n";
   ss << " ----- Render statistic report ----- \n";
 
   return ss.str();
@@ -165,8 +173,38 @@ DrapeMeasurer::RenderStatistic DrapeMeasurer::GetRenderStatistic()
   statistic.m_frameRenderTimeInMs =
       static_cast<uint32_t>(duration_cast<milliseconds>(m_totalTPF).count()) / m_totalTPFCount;
 
+  statistic.m_overlayPlacingsCount = m_totalOverlayPlacingsCount;
+  if (m_totalOverlayPlacingsCount != 0)
+  {
+    statistic.m_overlayPlacingTimeInUs =
+        static_cast<uint32_t>(duration_cast<microseconds>(m_totalOverlayPlacingTime).count()) /
+        m_totalOverlayPlacingsCount;
+  }
+  statistic.m_maxOverlayPlacingTimeInUs =
+      static_cast<uint32_t>(duration_cast<microseconds>(m_maxOverlayPlacingTime).count());
+
   return statistic;
 }
+
+void DrapeMeasurer::StartOverlayPlacing()
+{
+  if (!m_isEnabled)
+    return;
+
+  m_startOverlayPlacingTime = std::chrono::steady_clock::now();
+}
+
+void DrapeMeasurer::EndOverlayPlacing()
+{
+  if (!m_isEnabled)
+    return;
+
+  auto const placingTime = std::chrono::steady_clock::now() - m_startOverlayPlacingTime;
+  m_totalOverlayPlacingTime += placingTime;
+  m_maxOverlayPlacingTime = std::max(m_maxOverlayPlacingTime,
+                                     std::chrono::duration_cast<std::chrono::nanoseconds>(placingTime));
+  ++m_totalOverlayPlacingsCount;
+}
 #endif
 
 #if defined(RENDER_STATISTIC) || defined(TRACK_GPU_MEM)
@@ -33,8 +33,15 @@ public:
     uint32_t m_FPS = 0;
     uint32_t m_minFPS = 0;
     uint32_t m_frameRenderTimeInMs = 0;
+
+    uint32_t m_overlayPlacingsCount = 0;
+    uint32_t m_overlayPlacingTimeInUs = 0;
+    uint32_t m_maxOverlayPlacingTimeInUs = 0;
   };
 
+  void StartOverlayPlacing();
+  void EndOverlayPlacing();
+
   RenderStatistic GetRenderStatistic();
 #endif
 
@@ -155,6 +162,11 @@ private:
   uint32_t m_minFPS = std::numeric_limits<uint32_t>::max();
   double m_totalFPS = 0.0;
   uint32_t m_totalFPSCount = 0;
+
+  std::chrono::time_point<std::chrono::steady_clock> m_startOverlayPlacingTime;
+  std::chrono::nanoseconds m_totalOverlayPlacingTime;
+  std::chrono::nanoseconds m_maxOverlayPlacingTime;
+  uint32_t m_totalOverlayPlacingsCount = 0;
 #endif
 
 #if defined(RENDER_STATISTIC) || defined(TRACK_GPU_MEM)
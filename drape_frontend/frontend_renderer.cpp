@@ -149,6 +149,10 @@ FrontendRenderer::FrontendRenderer(Params && params)
   ASSERT(m_tapEventInfoFn, ());
   ASSERT(m_userPositionChangedFn, ());
 
+#ifdef INCREMENTAL_OVERLAY_PLACING
+  m_overlayTree->SetIncrementalPlacingEnabled(true);
+#endif
+
   m_gpsTrackRenderer = make_unique_dp<GpsTrackRenderer>([this](uint32_t pointsCount)
   {
     m_commutator->PostMessage(ThreadsCommutator::ResourceUploadThread,
@@ -1101,8 +1105,16 @@ void FrontendRenderer::EndUpdateOverlayTree()
 {
   if (m_overlayTree->IsNeedUpdate())
   {
+#if defined(DRAPE_MEASURER) && defined(RENDER_STATISTIC)
+    DrapeMeasurer::Instance().StartOverlayPlacing();
+#endif
+
     m_overlayTree->EndOverlayPlacing();
 
+#if defined(DRAPE_MEASURER) && defined(RENDER_STATISTIC)
+    DrapeMeasurer::Instance().EndOverlayPlacing();
+#endif
+
     // Track overlays.
     if (m_overlaysTracker->StartTracking(m_currentZoomLevel,
                                          m_myPositionController->IsModeHasPosition(),
@@ -1222,4 +1222,10 @@ public:
 private:
   drape_ptr<UserEvent> m_event;
 };
+
+class SaveGlyphCacheMessage : public Message
+{
+public:
+  Type GetType() const override { return Message::SaveGlyphCache; }
+};
 }  // namespace df
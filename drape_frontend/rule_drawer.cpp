@@ -84,6 +84,28 @@ double GetBuildingMinHeightInMeters(FeatureType const & f)
   return minHeightInMeters;
 }
 
+// Bits of the result of the checker of area types.
+enum AreaType
+{
+  BuildingHasParts,
+  BuildingPart,
+  Building,
+  Bridge,
+  Tunnel,
+  HatchingTerritory
+};
+
+ftypes::MultiChecker::Result CheckAreaTypes(FeatureType const & f)
+{
+  static ftypes::MultiChecker const checker({&df::IsBuildingHasPartsChecker::Instance(),
+                                             &df::IsBuildingPartChecker::Instance(),
+                                             &ftypes::IsBuildingChecker::Instance(),
+                                             &ftypes::IsBridgeChecker::Instance(),
+                                             &ftypes::IsTunnelChecker::Instance(),
+                                             &df::IsHatchingTerritoryChecker::Instance()});
+  return checker(f);
+}
+
 df::BaseApplyFeature::HotelData ExtractHotelData(FeatureType const & f)
 {
   df::BaseApplyFeature::HotelData result;
@@ -252,19 +274,19 @@ void RuleDrawer::ProcessAreaStyle(FeatureType const & f, Stylist const & s,
                                   TInsertShapeFn const & insertShape,
                                   int & minVisibleScale)
 {
+  auto const areaTypes = CheckAreaTypes(f);
+
   bool isBuilding = false;
   bool is3dBuilding = false;
   bool isBuildingOutline = false;
   if (f.GetLayer() >= 0)
   {
-    bool const hasParts = IsBuildingHasPartsChecker::Instance()(f);
-    bool const isPart = IsBuildingPartChecker::Instance()(f);
+    bool const hasParts = areaTypes[BuildingHasParts];
+    bool const isPart = areaTypes[BuildingPart];
 
     // Looks like nonsense, but there are some osm objects with types
     // highway-path-bridge and building (sic!) at the same time (pedestrian crossing).
-    isBuilding = (isPart || ftypes::IsBuildingChecker::Instance()(f)) &&
-        !ftypes::IsBridgeChecker::Instance()(f) &&
-        !ftypes::IsTunnelChecker::Instance()(f);
+    isBuilding = (isPart || areaTypes[Building]) && !areaTypes[Bridge] && !areaTypes[Tunnel];
 
     isBuildingOutline = isBuilding && hasParts && !isPart;
     is3dBuilding = m_context->Is3dBuildingsEnabled() && (isBuilding && !isBuildingOutline);
@@ -294,7 +316,7 @@ void RuleDrawer::ProcessAreaStyle(FeatureType const & f, Stylist const & s,
   }
   else
   {
-    hatchingArea = IsHatchingTerritoryChecker::Instance()(f);
+    hatchingArea = areaTypes[HatchingTerritory];
   }
 
   bool applyPointStyle = s.PointStyleExists();
@@ -0,0 +1,133 @@
+#include "generator/buildings_table_builder.hpp"
+
+#include "search/house_to_street_table.hpp"
+#include "search/reverse_geocoder.hpp"
+
+#include "indexer/buildings_table.hpp"
+#include "indexer/feature_algo.hpp"
+#include "indexer/features_vector.hpp"
+#include "indexer/index.hpp"
+
+#include "coding/file_container.hpp"
+
+#include "platform/local_country_file.hpp"
+#include "platform/mwm_traits.hpp"
+
+#include "base/exception.hpp"
+#include "base/logging.hpp"
+
+#include "defines.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+// Returns the street of the house in the same way as the search does
+// for features which are not in the buildings table. Streets edited
+// by user are unknown here, so the search doesn't use these ids for
+// mwms with created or deleted streets.
+uint32_t GetMatchingStreet(search::ReverseGeocoder const & rgc,
+                           search::HouseToStreetTable const & houseToStreet, FeatureType & ft)
+{
+  using Street = search::ReverseGeocoder::Street;
+
+  vector<Street> streets;
+  rgc.GetNearbyStreets(ft, streets);
+  auto const it = find_if(streets.begin(), streets.end(), [](Street const & street) {
+    return street.m_distanceMeters > search::ReverseGeocoder::kLookupRadiusM;
+  });
+  streets.erase(it, streets.end());
+
+  uint32_t index;
+  if (houseToStreet.Get(ft.GetID().m_index, index) && index < streets.size())
+    return streets[index].m_id.m_index;
+
+  if (!streets.empty() &&
+      streets[0].m_distanceMeters < search::ReverseGeocoder::kMaxApproxStreetDistanceM)
+  {
+    return streets[0].m_id.m_index;
+  }
+
+  return search::BuildingsTable::kInvalidStreetId;
+}
+}  // namespace
+
+namespace indexer
+{
+bool BuildBuildingsTableFromDataFile(string const & filename, bool forceRebuild)
+{
+  try
+  {
+    search::BuildingsTableBuilder builder;
+
+    {
+      Index index;
+      auto const res = index.RegisterMap(platform::LocalCountryFile::MakeTemporary(filename));
+      if (res.second != MwmSet::RegResult::Success)
+      {
+        LOG(LERROR, ("Can't register", filename));
+        return false;
+      }
+
+      auto handle = index.GetMwmHandleById(res.first);
+      auto & value = *handle.GetValue<MwmValue>();
+      if (!forceRebuild && value.m_cont.IsExist(BUILDINGS_FILE_TAG))
+        return true;
+
+      version::MwmTraits const traits(value.GetMwmVersion());
+      if (!traits.HasOffsetsTable())
+      {
+        LOG(LERROR, (filename, "does not have an offsets table!"));
+        return false;
+      }
+
+      auto const houseToStreet = search::HouseToStreetTable::Load(value);
+      search::ReverseGeocoder const rgc(index);
+
+      FeaturesVector const features(value.m_cont, value.GetHeader(), value.m_table.get());
+
+      builder.SetCodingParams(value.GetHeader().GetDefCodingParams());
+      features.ForEach([&](FeatureType & ft, uint32_t featureId) {
+        // Only buildings with house numbers are kept, as others can't
+        // be matched by house number or street.
+        string const houseNumber = ft.GetHouseNumber();
+        if (houseNumber.empty())
+          return;
+
+        ft.SetID(FeatureID(res.first, featureId));
+
+        search::BuildingsTable::Building building;
+        building.m_center = feature::GetCenter(ft);
+        // The worst geometry is used as FeaturesLayerMatcher does for
+        // features which are not in the table. Geometry of a feature
+        // is parsed only once, so a separate copy is loaded here.
+        if (ft.GetFeatureType() != feature::GEOM_POINT)
+        {
+          FeatureType rectFt;
+          features.GetByIndex(featureId, rectFt);
+          building.m_rect = rectFt.GetLimitRect(FeatureType::WORST_GEOMETRY);
+        }
+        building.m_houseNumber = strings::MakeUniString(houseNumber);
+        building.m_streetId = GetMatchingStreet(rgc, *houseToStreet, ft);
+        builder.Put(featureId, building);
+      });
+    }
+
+    {
+      FilesContainerW writeContainer(filename, FileWriter::OP_WRITE_EXISTING);
+      FileWriter writer = writeContainer.GetWriter(BUILDINGS_FILE_TAG);
+      builder.Freeze(writer);
+    }
+  }
+  catch (RootException const & e)
+  {
+    LOG(LERROR, ("Failed to build buildings table:", e.Msg()));
+    return false;
+  }
+
+  return true;
+}
+}  // namespace indexer
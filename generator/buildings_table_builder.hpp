@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+
+namespace indexer
+{
+// Builds the latest version of the buildings table section and writes
+// it to the mwm file. The search address section must be built
+// before, as streets of buildings are taken from it.
+bool BuildBuildingsTableFromDataFile(std::string const & filename, bool forceRebuild = false);
+}  // namespace indexer
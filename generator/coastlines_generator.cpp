@@ -8,9 +8,12 @@
 #include "base/string_utils.hpp"
 #include "base/logging.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 
 using namespace std;
@@ -20,7 +23,7 @@ typedef m2::PointI PointT;
 typedef m2::RectI RectT;
 
 CoastlineFeaturesGenerator::CoastlineFeaturesGenerator(uint32_t coastType)
-  : m_merger(POINT_COORD_BITS), m_coastType(coastType)
+  : m_coastType(coastType)
 {
 }
 
@@ -89,7 +92,7 @@ void CoastlineFeaturesGenerator::operator()(FeatureBuilder1 const & fb)
   if (fb.IsGeometryClosed())
     AddRegionToTree(fb);
   else
-    m_merger(fb);
+    m_ways.push_back(fb);
 }
 
 namespace
@@ -138,10 +141,118 @@ namespace
   };
 }
 
+namespace
+{
+  class DoCollect : public FeatureEmitterIFace
+  {
+    vector<FeatureBuilder1> & m_features;
+
+  public:
+    DoCollect(vector<FeatureBuilder1> & features) : m_features(features) {}
+
+    virtual void operator() (FeatureBuilder1 const & fb) { m_features.push_back(fb); }
+  };
+
+  uint32_t FindRoot(vector<uint32_t> & parents, uint32_t i)
+  {
+    while (parents[i] != i)
+    {
+      parents[i] = parents[parents[i]];
+      i = parents[i];
+    }
+    return i;
+  }
+
+  /// @return Indices of |ways| grouped by connected components, ways are connected
+  /// if they have equal endpoints. Components and ways in them are in the order of ways.
+  vector<vector<uint32_t>> GetConnectedComponents(vector<FeatureBuilder1> const & ways)
+  {
+    uint32_t const count = static_cast<uint32_t>(ways.size());
+    vector<uint32_t> parents(count);
+    for (uint32_t i = 0; i < count; ++i)
+      parents[i] = i;
+
+    // Way with the endpoint for every quantized endpoint.
+    unordered_map<int64_t, uint32_t> endpoints;
+    endpoints.reserve(2 * ways.size());
+    auto const addEndpoint = [&](m2::PointD const & pt, uint32_t way)
+    {
+      auto const res = endpoints.emplace(PointToInt64(pt, POINT_COORD_BITS), way);
+      if (res.second)
+        return;
+
+      uint32_t const root1 = FindRoot(parents, res.first->second);
+      uint32_t const root2 = FindRoot(parents, way);
+      if (root1 != root2)
+        parents[max(root1, root2)] = min(root1, root2);
+    };
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      auto const & points = ways[i].GetOuterGeometry();
+      addEndpoint(points.front(), i);
+      addEndpoint(points.back(), i);
+    }
+
+    // The root of a component is its way with the least index.
+    vector<vector<uint32_t>> components;
+    vector<uint32_t> rootToComponent(count, count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      uint32_t const root = FindRoot(parents, i);
+      if (rootToComponent[root] == count)
+      {
+        rootToComponent[root] = static_cast<uint32_t>(components.size());
+        components.emplace_back();
+      }
+      components[rootToComponent[root]].push_back(i);
+    }
+    return components;
+  }
+}
+
 bool CoastlineFeaturesGenerator::Finish()
 {
+  // Ways of different components are never merged, so every component is merged by its own
+  // FeatureMergeProcessor. Merged rings are the same as for the merge of all of the ways at once.
+  vector<vector<uint32_t>> const components = GetConnectedComponents(m_ways);
+  vector<vector<FeatureBuilder1>> merged(components.size());
+
+  size_t const numThreads =
+      max(static_cast<size_t>(1), min(static_cast<size_t>(thread::hardware_concurrency()),
+                                      components.size()));
+  LOG(LINFO, ("Merging", m_ways.size(), "coastlines in", components.size(),
+              "components, threads:", numThreads));
+
+  atomic<size_t> nextComponent(0);
+  auto const mergeComponents = [&]()
+  {
+    for (size_t i = nextComponent++; i < components.size(); i = nextComponent++)
+    {
+      FeatureMergeProcessor merger(POINT_COORD_BITS);
+      for (uint32_t const way : components[i])
+        merger(new MergedFeatureBuilder1(move(m_ways[way])));
+
+      DoCollect doCollect(merged[i]);
+      merger.DoMerge(doCollect);
+    }
+  };
+
+  vector<thread> threads;
+  for (size_t i = 0; i < numThreads; ++i)
+    threads.emplace_back(mergeComponents);
+  for (auto & thread : threads)
+    thread.join();
+
+  m_ways.clear();
+  m_ways.shrink_to_fit();
+
   DoAddToTree doAdd(*this);
-  m_merger.DoMerge(doAdd);
+  for (auto const & features : merged)
+  {
+    for (auto const & fb : features)
+      doAdd(fb);
+  }
 
   if (doAdd.HasNotMergedCoasts())
   {
@@ -318,13 +429,17 @@ void CoastlineFeaturesGenerator::GetFeatures(vector<FeatureBuilder1> & features)
   size_t const maxThreads = thread::hardware_concurrency();
   CHECK_GREATER(maxThreads, 0, ("Not supported platform"));
 
+  // Cells are processed in parallel, features are sorted by cells to make the output
+  // independent from the order of processing.
+  vector<pair<int64_t, FeatureBuilder1>> cellFeatures;
   mutex featuresMutex;
   RegionInCellSplitter::Process(
       maxThreads, RegionInCellSplitter::kStartLevel, m_tree,
-      [&features, &featuresMutex, this](RegionInCellSplitter::TCell const & cell, DoDifference & cellData)
+      [&cellFeatures, &featuresMutex, this](RegionInCellSplitter::TCell const & cell, DoDifference & cellData)
       {
         FeatureBuilder1 fb;
-        fb.SetCoastCell(cell.ToInt64(RegionInCellSplitter::kHighLevel + 1));
+        int64_t const cellId = cell.ToInt64(RegionInCellSplitter::kHighLevel + 1);
+        fb.SetCoastCell(cellId);
 
         cellData.AssignGeometry(fb);
         fb.SetArea();
@@ -336,6 +451,16 @@ void CoastlineFeaturesGenerator::GetFeatures(vector<FeatureBuilder1> & features)
 
         // save result
         lock_guard<mutex> lock(featuresMutex);
-        features.emplace_back(move(fb));
+        cellFeatures.emplace_back(cellId, move(fb));
       });
+
+  sort(cellFeatures.begin(), cellFeatures.end(),
+       [](pair<int64_t, FeatureBuilder1> const & lhs, pair<int64_t, FeatureBuilder1> const & rhs)
+       {
+         return lhs.first < rhs.first;
+       });
+
+  features.reserve(features.size() + cellFeatures.size());
+  for (auto & cellFeature : cellFeatures)
+    features.emplace_back(move(cellFeature.second));
 }
@@ -7,12 +7,15 @@
 #include "geometry/tree4d.hpp"
 #include "geometry/region2d.hpp"
 
+#include "std/vector.hpp"
+
 
 class FeatureBuilder1;
 
 class CoastlineFeaturesGenerator
 {
-  FeatureMergeProcessor m_merger;
+  /// Not closed coastlines which are merged in Finish().
+  vector<FeatureBuilder1> m_ways;
 
   using TTree = m4::Tree<m2::RegionI>;
   TTree m_tree;
@@ -25,6 +28,8 @@ public:
   void AddRegionToTree(FeatureBuilder1 const & fb);
 
   void operator() (FeatureBuilder1 const & fb);
+  /// Merges coastlines into rings. Coastlines are split into connected components
+  /// by their endpoints and the components are merged in parallel.
   /// @return false if coasts are not merged and FLAG_fail_on_coasts is set
   bool Finish();
 
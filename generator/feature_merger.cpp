@@ -12,6 +12,12 @@ MergedFeatureBuilder1::MergedFeatureBuilder1(FeatureBuilder1 const & fb)
   m_params.FinishAddingTypes();
 }
 
+MergedFeatureBuilder1::MergedFeatureBuilder1(FeatureBuilder1 && fb)
+  : FeatureBuilder1(std::move(fb)), m_isRound(false)
+{
+  m_params.FinishAddingTypes();
+}
+
 void MergedFeatureBuilder1::SetRound()
 {
   m_isRound = true;
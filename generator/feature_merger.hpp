@@ -16,6 +16,7 @@ class MergedFeatureBuilder1 : public FeatureBuilder1
 public:
   MergedFeatureBuilder1() : m_isRound(false) {}
   MergedFeatureBuilder1(FeatureBuilder1 const & fb);
+  MergedFeatureBuilder1(FeatureBuilder1 && fb);
 
   void SetRound();
   bool IsRound() const { return m_isRound; }
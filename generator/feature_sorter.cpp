@@ -28,6 +28,11 @@
 #include "base/scope_guard.hpp"
 #include "base/string_utils.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+
 namespace
 {
   typedef pair<uint64_t, uint64_t> CellAndOffsetT;
@@ -118,12 +123,26 @@ namespace feature
 
     gen::OsmID2FeatureID m_osm2ft;
 
+    // Squared simplification epsilon of the most detailed scale.
+    double m_minEpsilon;
+
   public:
+    // Douglas-Peucker significance of points of every polygon of a feature in the order
+    // of FeatureBuilder1::GetGeometry(). It's calculated once for all scales.
+    using PointsSignificance = vector<vector<double>>;
+
     FeaturesCollector2(std::string const & fName, DataHeader const & header,
                        RegionData const & regionData, uint32_t versionDate)
       : FeaturesCollector(fName + DATA_FILE_TAG), m_writer(fName),
         m_header(header), m_regionData(regionData), m_versionDate(versionDate)
     {
+      m_minEpsilon = numeric_limits<double>::max();
+      for (size_t i = 0; i < m_header.GetScalesCount(); ++i)
+      {
+        m_minEpsilon = min(m_minEpsilon,
+                           my::sq(scales::GetEpsilonForSimplify(m_header.GetScale(i))));
+      }
+
       for (size_t i = 0; i < m_header.GetScalesCount(); ++i)
       {
         std::string const postfix = strings::to_string(i);
@@ -327,6 +346,10 @@ namespace feature
         return (!m_current.empty() ? m_current : m_rFB.GetOuterGeometry());
       }
 
+      // True if the source points are the outer geometry of the feature and not the points
+      // of the previous scale.
+      bool IsSourceOuterGeometry() const { return m_current.empty(); }
+
       void AddPoints(points_t const & points, int scaleIndex)
       {
         if (m_ptsInner && points.size() < 15)
@@ -405,18 +428,25 @@ namespace feature
       }
     };
 
-    void SimplifyPoints(points_t const & in, points_t & out, int level,
-                        bool isCoast, m2::RectD const & rect)
+    // Simplifies |in| by the |significance| of its points if it's not null.
+    void SimplifyPoints(points_t const & in, vector<double> const * significance, points_t & out,
+                        int level, bool isCoast, m2::RectD const & rect)
     {
       if (isCoast)
       {
         BoundsDistance dist(rect);
-        feature::SimplifyPoints(dist, in, out, level);
+        if (significance)
+          feature::SimplifyPoints(dist, in, *significance, out, level);
+        else
+          feature::SimplifyPoints(dist, in, out, level);
       }
       else
       {
         m2::DistanceToLineSquare<m2::PointD> dist;
-        feature::SimplifyPoints(dist, in, out, level);
+        if (significance)
+          feature::SimplifyPoints(dist, in, *significance, out, level);
+        else
+          feature::SimplifyPoints(dist, in, out, level);
       }
     }
 
@@ -447,7 +477,28 @@ namespace feature
     bool IsCountry() const { return m_header.GetType() == feature::DataHeader::country; }
 
   public:
-    uint32_t operator()(FeatureBuilder2 & fb)
+    // Doesn't change the collector, so it's called for many features in parallel.
+    void CalcPointsSignificance(FeatureBuilder2 const & fb, PointsSignificance & significance) const
+    {
+      significance.clear();
+      m2::RectD const rect = fb.GetLimitRect();
+      for (auto const & points : fb.GetGeometry())
+      {
+        significance.emplace_back();
+        if (fb.IsCoastCell())
+        {
+          CalculateDPSignificance(points.begin(), points.end(), m_minEpsilon,
+                                  BoundsDistance(rect), significance.back());
+        }
+        else
+        {
+          CalculateDPSignificance(points.begin(), points.end(), m_minEpsilon,
+                                  m2::DistanceToLineSquare<m2::PointD>(), significance.back());
+        }
+      }
+    }
+
+    uint32_t operator()(FeatureBuilder2 & fb, PointsSignificance const & significance)
     {
       GeometryHolder holder(*this, fb, m_header);
 
@@ -468,9 +519,17 @@ namespace feature
 
           // Do not change linear geometry for the upper scale.
           if (isLine && i == scalesStart && IsCountry() && fb.IsRoad())
+          {
             points = holder.GetSourcePoints();
+          }
           else
-            SimplifyPoints(holder.GetSourcePoints(), points, level, isCoast, rect);
+          {
+            SimplifyPoints(holder.GetSourcePoints(),
+                           holder.IsSourceOuterGeometry() && !significance.empty()
+                               ? &significance.front()
+                               : nullptr,
+                           points, level, isCoast, rect);
+          }
 
           if (isLine)
             holder.AddPoints(points, i);
@@ -495,11 +554,12 @@ namespace feature
             }
 
             auto iH = polys.begin();
-            for (++iH; iH != polys.end(); ++iH)
+            auto iS = significance.begin();
+            for (++iH, ++iS; iH != polys.end(); ++iH, ++iS)
             {
               simplified.push_back(points_t());
 
-              SimplifyPoints(*iH, simplified.back(), level, isCoast, rect);
+              SimplifyPoints(*iH, &*iS, simplified.back(), level, isCoast, rect);
 
               // Increment level check for coastline polygons for the first scale level.
               // This is used for better coastlines quality.
@@ -604,16 +664,44 @@ namespace feature
       {
         FeaturesCollector2 collector(datFilePath, header, regionData, info.m_versionDate);
 
-        for (size_t i = 0; i < midPoints.m_vec.size(); ++i)
-        {
-          ReaderSource<FileReader> src(reader);
-          src.Skip(midPoints.m_vec[i].second);
+        // Features are read by batches. Significance of points for simplification is
+        // calculated for the batch in parallel, then features are emitted in the sorted order.
+        size_t const kBatchSize = 4096;
+        size_t const numThreads = max(static_cast<size_t>(1),
+                                      static_cast<size_t>(std::thread::hardware_concurrency()));
 
-          FeatureBuilder1 f;
-          ReadFromSourceRowFormat(src, f);
+        vector<FeatureBuilder1> batch;
+        vector<FeaturesCollector2::PointsSignificance> significance;
+        for (size_t begin = 0; begin < midPoints.m_vec.size(); begin += kBatchSize)
+        {
+          size_t const end = min(begin + kBatchSize, midPoints.m_vec.size());
+          batch.clear();
+          batch.resize(end - begin);
+          for (size_t i = begin; i < end; ++i)
+          {
+            ReaderSource<FileReader> src(reader);
+            src.Skip(midPoints.m_vec[i].second);
+            ReadFromSourceRowFormat(src, batch[i - begin]);
+          }
 
-          // emit the feature
-          collector(GetFeatureBuilder2(f));
+          significance.resize(batch.size());
+          std::atomic<size_t> next(0);
+          auto const calcSignificance = [&]()
+          {
+            for (size_t i = next++; i < batch.size(); i = next++)
+              collector.CalcPointsSignificance(GetFeatureBuilder2(batch[i]), significance[i]);
+          };
+
+          vector<std::thread> threads;
+          for (size_t i = 1; i < numThreads; ++i)
+            threads.emplace_back(calcSignificance);
+          calcSignificance();
+          for (auto & thread : threads)
+            thread.join();
+
+          // emit the features
+          for (size_t i = 0; i < batch.size(); ++i)
+            collector(GetFeatureBuilder2(batch[i]), significance[i]);
         }
 
         collector.Finish();
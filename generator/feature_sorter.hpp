@@ -8,6 +8,7 @@
 #include "indexer/scales.hpp"
 
 #include <string>
+#include <vector>
 
 
 namespace feature
@@ -72,4 +73,23 @@ namespace feature
       CHECK ( are_points_equal(in.back(), out.back()), () );
     }
   }
+
+  /// Simplifies |in| for the |level| by Douglas-Peucker |significance| of its points,
+  /// which is calculated once for all levels by CalculateDPSignificance().
+  template <class DistanceT, class PointsContainerT>
+  void SimplifyPoints(DistanceT dist, PointsContainerT const & in,
+                      std::vector<double> const & significance, PointsContainerT & out, int level)
+  {
+    if (in.size() >= 2)
+    {
+      double const eps = my::sq(scales::GetEpsilonForSimplify(level));
+
+      SimplifyBySignificance(in.begin(), in.end(), significance, eps,
+                             AccumulateSkipSmallTrg<DistanceT, m2::PointD>(dist, out, eps));
+
+      CHECK_GREATER ( out.size(), 1, () );
+      CHECK ( are_points_equal(in.front(), out.front()), () );
+      CHECK ( are_points_equal(in.back(), out.back()), () );
+    }
+  }
 }
@@ -20,6 +20,7 @@ SOURCES += \
     booking_scoring.cpp \
     borders_generator.cpp \
     borders_loader.cpp \
+    buildings_table_builder.cpp \
     centers_table_builder.cpp \
     check_model.cpp \
     cities_boundaries_builder.cpp \
@@ -65,6 +66,7 @@ HEADERS += \
     booking_dataset.hpp \
     borders_generator.hpp \
     borders_loader.hpp \
+    buildings_table_builder.hpp \
     centers_table_builder.hpp \
     check_model.hpp \
     cities_boundaries_builder.hpp \
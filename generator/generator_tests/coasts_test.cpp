@@ -1,5 +1,6 @@
 #include "testing/testing.hpp"
 
+#include "generator/coastlines_generator.hpp"
 #include "generator/feature_builder.hpp"
 #include "generator/feature_sorter.hpp"
 #include "generator/feature_generator.hpp"
@@ -177,6 +178,59 @@ namespace
   };
 }
 
+namespace
+{
+  uint32_t const kCoastType = 1;
+
+  FeatureBuilder1 MakeCoast(vector<m2::PointD> const & points)
+  {
+    FeatureBuilder1 fb;
+    for (auto const & pt : points)
+      fb.AddPoint(pt);
+    fb.SetLinear();
+    fb.AddType(kCoastType);
+    return fb;
+  }
+
+  // Two islands split into several coastlines, coastlines of different islands are mixed.
+  vector<FeatureBuilder1> MakeIslands()
+  {
+    return {MakeCoast({{0, 0}, {1, 0}, {1, 1}}),
+            MakeCoast({{10, 10}, {11, 10}}),
+            MakeCoast({{1, 1}, {0, 1}, {0, 0}}),
+            MakeCoast({{11, 11}, {10, 11}, {10, 10}}),
+            MakeCoast({{11, 10}, {11, 11}})};
+  }
+}  // namespace
+
+UNIT_TEST(CoastlineFeaturesGenerator_Merge)
+{
+  vector<FeatureBuilder1> features[2];
+  for (auto & result : features)
+  {
+    CoastlineFeaturesGenerator generator(kCoastType);
+    for (auto const & fb : MakeIslands())
+      generator(fb);
+
+    TEST(generator.Finish(), ());
+    generator.GetFeatures(result);
+    TEST(!result.empty(), ());
+  }
+
+  // Output doesn't depend on the order of processing of cells.
+  TEST(features[0] == features[1], ());
+}
+
+UNIT_TEST(CoastlineFeaturesGenerator_NotMerged)
+{
+  CoastlineFeaturesGenerator generator(kCoastType);
+  for (auto const & fb : MakeIslands())
+    generator(fb);
+  generator(MakeCoast({{20, 20}, {21, 20}, {21, 21}}));
+
+  TEST(!generator.Finish(), ());
+}
+
 /*
 UNIT_TEST(WorldCoasts_CheckBounds)
 {
@@ -0,0 +1,136 @@
+#include "testing/testing.hpp"
+
+#include "generator/routing_index_generator.hpp"
+
+#include "routing/cross_mwm_connector.hpp"
+#include "routing/edge_estimator.hpp"
+#include "routing/geometry.hpp"
+#include "routing/index_graph.hpp"
+#include "routing/joint.hpp"
+#include "routing/road_point.hpp"
+#include "routing/route_weight.hpp"
+#include "routing/segment.hpp"
+
+#include "routing_common/vehicle_model.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "base/stl_add.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+using namespace routing;
+using namespace std;
+
+namespace
+{
+NumMwmId constexpr kTestMwmId = 777;
+uint32_t constexpr kGridSize = 5;
+double constexpr kGridStep = 0.01;
+
+class GridGeometryLoader final : public GeometryLoader
+{
+public:
+  // GeometryLoader overrides:
+  void Load(uint32_t featureId, RoadGeometry & road) override
+  {
+    auto const it = m_roads.find(featureId);
+    if (it != m_roads.end())
+      road = it->second;
+  }
+
+  void AddRoad(uint32_t featureId, double speed, RoadGeometry::Points const & points)
+  {
+    m_roads[featureId] = RoadGeometry(false /* oneWay */, speed, points);
+    m_roads[featureId].SetTransitAllowedForTests(true);
+  }
+
+private:
+  unordered_map<uint32_t, RoadGeometry> m_roads;
+};
+
+// Horizontal roads have feature ids [0, kGridSize), vertical ones have
+// feature ids [kGridSize, 2 * kGridSize). Every road has its own speed.
+unique_ptr<IndexGraph> BuildGrid()
+{
+  auto loader = my::make_unique<GridGeometryLoader>();
+  for (uint32_t i = 0; i < kGridSize; ++i)
+  {
+    RoadGeometry::Points horizontal;
+    RoadGeometry::Points vertical;
+    for (uint32_t j = 0; j < kGridSize; ++j)
+    {
+      horizontal.emplace_back(j * kGridStep, i * kGridStep);
+      vertical.emplace_back(i * kGridStep, j * kGridStep);
+    }
+    loader->AddRoad(i, 20.0 + 10.0 * ((i * 7) % kGridSize) /* speed */, horizontal);
+    loader->AddRoad(kGridSize + i, 25.0 + 10.0 * ((i * 3) % kGridSize) /* speed */, vertical);
+  }
+
+  auto graph = my::make_unique<IndexGraph>(
+      move(loader),
+      EdgeEstimator::Create(VehicleType::Car, 90.0 /* maxSpeedKMpH */, nullptr /* trafficStash */));
+
+  vector<Joint> joints;
+  for (uint32_t i = 0; i < kGridSize; ++i)
+  {
+    for (uint32_t j = 0; j < kGridSize; ++j)
+    {
+      Joint joint;
+      joint.AddPoint(RoadPoint(i /* featureId */, j /* pointId */));
+      joint.AddPoint(RoadPoint(kGridSize + j /* featureId */, i /* pointId */));
+      joints.push_back(joint);
+    }
+  }
+  graph->Import(joints);
+  return graph;
+}
+
+// Horizontal roads enter the mwm on the left side, vertical roads leave it on the top.
+// All roads are two-way, so every transition is an enter and an exit.
+void BuildConnector(CrossMwmConnector & connector)
+{
+  for (uint32_t i = 0; i < kGridSize; ++i)
+  {
+    connector.AddTransition(i /* osmId */, i /* featureId */, 0 /* segmentIdx */,
+                            false /* oneWay */, true /* forwardIsEnter */,
+                            m2::PointD(0.0, i * kGridStep), m2::PointD(kGridStep, i * kGridStep));
+    connector.AddTransition(kGridSize + i /* osmId */, kGridSize + i /* featureId */,
+                            kGridSize - 2 /* segmentIdx */, false /* oneWay */,
+                            false /* forwardIsEnter */,
+                            m2::PointD(i * kGridStep, (kGridSize - 2) * kGridStep),
+                            m2::PointD(i * kGridStep, (kGridSize - 1) * kGridStep));
+  }
+}
+
+UNIT_TEST(CalcCrossMwmWeights_ThreadsIndependent)
+{
+  CrossMwmConnector connector(kTestMwmId);
+  BuildConnector(connector);
+  TEST_EQUAL(connector.GetEnters().size(), 2 * kGridSize, ());
+  TEST_EQUAL(connector.GetExits().size(), 2 * kGridSize, ());
+
+  map<Segment, map<Segment, RouteWeight>> expected;
+  {
+    auto graph = BuildGrid();
+    CalcCrossMwmWeights(*graph, connector, 1 /* numThreads */, true /* disableCrossMwmProgress */,
+                        expected);
+  }
+
+  TEST_EQUAL(expected.size(), connector.GetEnters().size(), ());
+  for (auto const & kv : expected)
+    TEST_EQUAL(kv.second.size(), connector.GetExits().size(), (kv.first));
+
+  for (size_t const numThreads : {2, 3, 8, 64})
+  {
+    auto graph = BuildGrid();
+    map<Segment, map<Segment, RouteWeight>> weights;
+    CalcCrossMwmWeights(*graph, connector, numThreads, true /* disableCrossMwmProgress */, weights);
+    TEST_EQUAL(weights, expected, (numThreads));
+  }
+}
+}  // namespace
@@ -36,6 +36,7 @@ SOURCES += \
     altitude_test.cpp \
     check_mwms.cpp \
     coasts_test.cpp \
+    cross_mwm_weights_test.cpp \
     feature_builder_test.cpp \
     feature_merger_test.cpp \
     metadata_parser_test.cpp \
@@ -46,6 +47,7 @@ SOURCES += \
     road_access_test.cpp \
     restriction_collector_test.cpp \
     restriction_test.cpp \
+    search_index_builder_test.cpp \
     source_data.cpp \
     source_to_element_test.cpp \
     srtm_parser_test.cpp \
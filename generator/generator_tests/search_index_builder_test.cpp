@@ -0,0 +1,320 @@
+#include "testing/testing.hpp"
+
+#include "generator/generator_tests_support/test_feature.hpp"
+#include "generator/generator_tests_support/test_mwm_builder.hpp"
+
+#include "search/house_to_street_table.hpp"
+#include "search/reverse_geocoder.hpp"
+
+#include "indexer/classificator_loader.hpp"
+#include "indexer/data_header.hpp"
+#include "indexer/feature.hpp"
+#include "indexer/features_vector.hpp"
+#include "indexer/index.hpp"
+#include "indexer/search_string_utils.hpp"
+
+#include "platform/country_file.hpp"
+#include "platform/local_country_file.hpp"
+#include "platform/local_country_file_utils.hpp"
+#include "platform/platform.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "base/string_utils.hpp"
+
+#include "defines.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace generator::tests_support;
+using namespace platform;
+using namespace std;
+
+namespace
+{
+string const kTestMwm = "house_to_street_test";
+
+// Buildings form a grid which is crossed by streets, so there are several streets near each
+// building, and buildings with far streets are not matched. There are more buildings than
+// in one matching task.
+size_t const kGridSize = 48;
+double const kGridStep = 0.0004;
+vector<string> const kStreetNames = {"Abbey", "Baker", "Carnaby", "Downing", "Fleet",
+                                     "Gower", "Harley", "Jermyn", "Lombard", "Oxford"};
+
+// Layout of the house to street cache file.
+uint32_t const kCacheVersion = 0;
+using TCacheEntries = vector<pair<uint64_t, uint32_t>>;
+
+uint32_t const kCachedStreet = 5;
+
+class HouseToStreetTest
+{
+public:
+  HouseToStreetTest()
+    : m_file(GetPlatform().WritableDir(), CountryFile(kTestMwm), 0 /* version */)
+    , m_cachePath(GetPlatform().WritablePathForFile(kTestMwm + ".house_to_street"))
+  {
+    classificator::Load();
+    Cleanup();
+
+    double const size = kGridSize * kGridStep;
+    for (size_t i = 0; i < kStreetNames.size(); ++i)
+    {
+      double const offset = (i / 2) * size / 4;
+      vector<m2::PointD> points = {m2::PointD(0.0, offset), m2::PointD(size, offset)};
+      if (i % 2 != 0)
+      {
+        for (auto & point : points)
+          swap(point.x, point.y);
+      }
+      m_streets.emplace_back(points, kStreetNames[i] + " street", "en");
+    }
+
+    for (size_t i = 0; i < kGridSize; ++i)
+    {
+      for (size_t j = 0; j < kGridSize; ++j)
+      {
+        m2::PointD const center((i + 0.5) * kGridStep, (j + 0.5) * kGridStep);
+        string const houseNumber = strings::to_string(i * kGridSize + j + 1);
+        auto const & street = m_streets[(i * 7 + j * 3) % m_streets.size()];
+        m_buildings.emplace_back(center, "" /* name */, houseNumber, street, "en");
+        m_houseStreets[houseNumber] = street.GetName();
+      }
+    }
+  }
+
+  ~HouseToStreetTest() { Cleanup(); }
+
+  void Build(string const & cachePath)
+  {
+    Cleanup(m_file);
+
+    TestMwmBuilder builder(m_file, feature::DataHeader::country);
+    builder.SetHouseToStreetCachePath(cachePath);
+    for (auto const & street : m_streets)
+      builder.Add(street);
+    for (auto const & building : m_buildings)
+      builder.Add(building);
+  }
+
+  string ReadAddressSection() const
+  {
+    string data;
+    FilesContainerR(m_file.GetPath(MapOptions::Map))
+        .GetReader(SEARCH_ADDRESS_FILE_TAG)
+        .ReadAsString(data);
+    return data;
+  }
+
+  // Returns street indices of the address section by feature indices.
+  map<uint32_t, uint32_t> ReadStreetIndices()
+  {
+    map<uint32_t, uint32_t> indices;
+    unique_ptr<search::HouseToStreetTable> table;
+    ForEachBuilding([&](Index const &, MwmValue & value, FeatureType & ft) {
+      if (!table)
+        table = search::HouseToStreetTable::Load(value);
+      uint32_t streetIndex;
+      if (table->Get(ft.GetID().m_index, streetIndex))
+        indices[ft.GetID().m_index] = streetIndex;
+    });
+    return indices;
+  }
+
+  // Returns street indices by feature indices in the way the address section was built before
+  // multithreading and caching.
+  map<uint32_t, uint32_t> MatchStreetIndices()
+  {
+    map<uint32_t, uint32_t> indices;
+    ForEachBuilding([&](Index const & index, MwmValue &, FeatureType & ft) {
+      auto const it = m_houseStreets.find(ft.GetHouseNumber());
+      TEST(it != m_houseStreets.end(), (ft.GetHouseNumber()));
+
+      search::ReverseGeocoder const rgc(index);
+      vector<search::ReverseGeocoder::Street> streets;
+      rgc.GetNearbyStreets(ft, streets);
+      auto const streetIndex =
+          rgc.GetMatchedStreetIndex(search::GetStreetNameAsKey(it->second), streets);
+      if (streetIndex < streets.size())
+        indices[ft.GetID().m_index] = static_cast<uint32_t>(streetIndex);
+    });
+    return indices;
+  }
+
+  TCacheEntries ReadCache() const
+  {
+    FileReader reader(m_cachePath);
+    ReaderSource<FileReader> src(reader);
+    TEST_EQUAL(ReadPrimitiveFromSource<uint32_t>(src), kCacheVersion, ());
+
+    TCacheEntries entries(ReadPrimitiveFromSource<uint64_t>(src));
+    for (auto & entry : entries)
+    {
+      entry.first = ReadPrimitiveFromSource<uint64_t>(src);
+      entry.second = ReadPrimitiveFromSource<uint32_t>(src);
+    }
+    TEST_EQUAL(src.Size(), 0, ());
+    return entries;
+  }
+
+  void WriteCache(uint32_t version, uint64_t count, TCacheEntries const & entries) const
+  {
+    FileWriter writer(m_cachePath);
+    WriteToSink(writer, version);
+    WriteToSink(writer, count);
+    for (auto const & entry : entries)
+    {
+      WriteToSink(writer, entry.first);
+      WriteToSink(writer, entry.second);
+    }
+  }
+
+  size_t GetBuildingsCount() const { return m_buildings.size(); }
+  string const & GetCachePath() const { return m_cachePath; }
+
+private:
+  template <typename TFn>
+  void ForEachBuilding(TFn && fn)
+  {
+    Index index;
+    auto const res = index.RegisterMap(m_file);
+    TEST_EQUAL(res.second, MwmSet::RegResult::Success, ());
+
+    auto handle = index.GetMwmHandleById(res.first);
+    auto & value = *handle.GetValue<MwmValue>();
+    FeaturesVector const features(value.m_cont, value.GetHeader(), value.m_table.get());
+    features.ForEach([&](FeatureType & ft, uint32_t featureId) {
+      if (ft.GetHouseNumber().empty())
+        return;
+      ft.SetID(FeatureID(res.first, featureId));
+      fn(index, value, ft);
+    });
+  }
+
+  static void Cleanup(LocalCountryFile const & file)
+  {
+    CountryIndexes::DeleteFromDisk(file);
+    file.DeleteFromDisk(MapOptions::Map);
+  }
+
+  void Cleanup()
+  {
+    Cleanup(m_file);
+    my::DeleteFileX(m_cachePath);
+  }
+
+  LocalCountryFile m_file;
+  string const m_cachePath;
+  vector<TestStreet> m_streets;
+  vector<TestBuilding> m_buildings;
+  map<string, string> m_houseStreets;
+};
+
+UNIT_CLASS_TEST(HouseToStreetTest, HouseToStreet_Matching)
+{
+  Build(string() /* cachePath */);
+
+  auto const indices = ReadStreetIndices();
+  TEST_EQUAL(indices, MatchStreetIndices(), ());
+
+  // Some buildings are not matched and some are matched to streets other than the nearest one.
+  TEST_LESS(indices.size(), GetBuildingsCount(), ());
+  TEST(any_of(indices.begin(), indices.end(),
+              [](pair<uint32_t const, uint32_t> const & index) { return index.second != 0; }),
+       ());
+}
+
+UNIT_CLASS_TEST(HouseToStreetTest, HouseToStreet_Cache)
+{
+  Build(string() /* cachePath */);
+  auto const addr = ReadAddressSection();
+
+  Build(GetCachePath());
+  TEST_EQUAL(ReadAddressSection(), addr, ());
+  auto const entries = ReadCache();
+  TEST_EQUAL(entries.size(), GetBuildingsCount(), ());
+
+  Build(GetCachePath());
+  TEST_EQUAL(ReadAddressSection(), addr, ());
+  TEST_EQUAL(ReadCache(), entries, ());
+
+  // All buildings are unchanged, so all streets are taken from the cache.
+  TCacheEntries cached = entries;
+  for (auto & entry : cached)
+    entry.second = kCachedStreet;
+  WriteCache(kCacheVersion, cached.size(), cached);
+
+  Build(GetCachePath());
+  auto const indices = ReadStreetIndices();
+  TEST_EQUAL(indices.size(), GetBuildingsCount(), ());
+  for (auto const & index : indices)
+    TEST_EQUAL(index.second, kCachedStreet, (index.first));
+  TEST_EQUAL(ReadCache(), cached, ());
+}
+
+UNIT_CLASS_TEST(HouseToStreetTest, HouseToStreet_CacheVersionMismatch)
+{
+  Build(string() /* cachePath */);
+  auto const addr = ReadAddressSection();
+
+  Build(GetCachePath());
+  auto const entries = ReadCache();
+
+  TCacheEntries cached = entries;
+  for (auto & entry : cached)
+    entry.second = kCachedStreet;
+  WriteCache(kCacheVersion + 1, cached.size(), cached);
+
+  // The cache of an unknown version is ignored and rewritten.
+  Build(GetCachePath());
+  TEST_EQUAL(ReadAddressSection(), addr, ());
+  TEST_EQUAL(ReadCache(), entries, ());
+}
+
+UNIT_CLASS_TEST(HouseToStreetTest, HouseToStreet_CorruptedCache)
+{
+  Build(string() /* cachePath */);
+  auto const addr = ReadAddressSection();
+
+  Build(GetCachePath());
+  auto const entries = ReadCache();
+
+  TCacheEntries cached = entries;
+  for (auto & entry : cached)
+    entry.second = kCachedStreet;
+
+  // The number of entries doesn't match the size of the file.
+  for (auto const count : {static_cast<uint64_t>(cached.size() + 1),
+                           numeric_limits<uint64_t>::max()})
+  {
+    WriteCache(kCacheVersion, count, cached);
+    Build(GetCachePath());
+    TEST_EQUAL(ReadAddressSection(), addr, (count));
+    TEST_EQUAL(ReadCache(), entries, (count));
+  }
+
+  // The header is truncated.
+  {
+    FileWriter writer(GetCachePath());
+    WriteToSink(writer, static_cast<uint16_t>(kCacheVersion));
+  }
+  Build(GetCachePath());
+  TEST_EQUAL(ReadAddressSection(), addr, ());
+  TEST_EQUAL(ReadCache(), entries, ());
+}
+}  // namespace
@@ -1,5 +1,6 @@
 #include "generator/generator_tests_support/test_mwm_builder.hpp"
 
+#include "generator/buildings_table_builder.hpp"
 #include "generator/centers_table_builder.hpp"
 #include "generator/feature_builder.hpp"
 #include "generator/feature_generator.hpp"
@@ -87,12 +88,16 @@ void TestMwmBuilder::Finish()
 
   CHECK(indexer::BuildIndexFromDataFile(path, path), ("Can't build geometry index."));
 
-  CHECK(indexer::BuildSearchIndexFromDataFile(path, true /* forceRebuild */),
+  CHECK(indexer::BuildSearchIndexFromDataFile(path, true /* forceRebuild */,
+                                              m_houseToStreetCachePath),
         ("Can't build search index."));
 
   CHECK(indexer::BuildCentersTableFromDataFile(path, true /* forceRebuild */),
         ("Can't build centers table."));
 
+  CHECK(indexer::BuildBuildingsTableFromDataFile(path, true /* forceRebuild */),
+        ("Can't build buildings table."));
+
   CHECK(search::RankTableBuilder::CreateIfNotExists(path), ());
 
   m_file.SyncWithDisk();
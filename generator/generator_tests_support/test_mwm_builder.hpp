@@ -3,6 +3,7 @@
 #include "indexer/data_header.hpp"
 
 #include <memory>
+#include <string>
 
 namespace feature
 {
@@ -30,11 +31,15 @@ public:
   void Add(TestFeature const & feature);
   bool Add(FeatureBuilder1 & fb);
 
+  // Streets of buildings are matched with the house to street cache at |path|.
+  void SetHouseToStreetCachePath(std::string const & path) { m_houseToStreetCachePath = path; }
+
   void Finish();
 
 private:
   platform::LocalCountryFile & m_file;
   feature::DataHeader::MapType m_type;
+  std::string m_houseToStreetCachePath;
   std::unique_ptr<feature::FeaturesCollector> m_collector;
 };
 }  // namespace tests_support
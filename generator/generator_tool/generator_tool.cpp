@@ -1,6 +1,7 @@
 #include "generator/altitude_generator.hpp"
 #include "generator/borders_generator.hpp"
 #include "generator/borders_loader.hpp"
+#include "generator/buildings_table_builder.hpp"
 #include "generator/centers_table_builder.hpp"
 #include "generator/check_model.hpp"
 #include "generator/cities_boundaries_builder.hpp"
@@ -74,6 +75,9 @@ DEFINE_bool(generate_geometry, false,
             "3rd pass - split and simplify geometry and triangles for features.");
 DEFINE_bool(generate_index, false, "4rd pass - generate index.");
 DEFINE_bool(generate_search_index, false, "5th pass - generate search index.");
+DEFINE_string(house_to_street_cache_path, "",
+              "Directory with house to street matchings of the previous generation, they are "
+              "reused by generate_search_index for unchanged buildings and updated.");
 DEFINE_bool(generate_cities_boundaries, false, "Generate section with cities boundaries");
 DEFINE_bool(generate_world, false, "Generate separate world file.");
 DEFINE_bool(split_by_polygons, false,
@@ -281,7 +285,15 @@ int main(int argc, char ** argv)
     {
       LOG(LINFO, ("Generating search index for", datFile));
 
-      if (!indexer::BuildSearchIndexFromDataFile(datFile, true))
+      std::string houseToStreetCachePath;
+      if (!FLAGS_house_to_street_cache_path.empty())
+      {
+        houseToStreetCachePath = my::JoinFoldersToPath(
+            FLAGS_house_to_street_cache_path, country + HOUSE_TO_STREET_CACHE_FILE_EXTENSION);
+      }
+
+      if (!indexer::BuildSearchIndexFromDataFile(datFile, true /* forceRebuild */,
+                                                 houseToStreetCachePath))
         LOG(LCRITICAL, ("Error generating search index."));
 
       LOG(LINFO, ("Generating rank table for", datFile));
@@ -291,6 +303,10 @@ int main(int argc, char ** argv)
       LOG(LINFO, ("Generating centers table for", datFile));
       if (!indexer::BuildCentersTableFromDataFile(datFile, true /* forceRebuild */))
         LOG(LCRITICAL, ("Error generating centers table."));
+
+      LOG(LINFO, ("Generating buildings table for", datFile));
+      if (!indexer::BuildBuildingsTableFromDataFile(datFile, true /* forceRebuild */))
+        LOG(LCRITICAL, ("Error generating buildings table."));
     }
 
     if (FLAGS_generate_cities_boundaries)
@@ -30,10 +30,12 @@
 #include "base/logging.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -290,36 +292,8 @@ void FillWeights(string const & path, string const & mwmFile, string const & cou
   DeserializeIndexGraph(mwmValue, kCarMask, graph);
 
   map<Segment, map<Segment, RouteWeight>> weights;
-  auto const numEnters = connector.GetEnters().size();
-  size_t foundCount = 0;
-  size_t notFoundCount = 0;
-  for (size_t i = 0; i < numEnters; ++i)
-  {
-    if (!disableCrossMwmProgress && (i % 10 == 0) && (i != 0))
-      LOG(LINFO, ("Building leaps:", i, "/", numEnters, "waves passed"));
-
-    Segment const & enter = connector.GetEnter(i);
-
-    AStarAlgorithm<DijkstraWrapper> astar;
-    DijkstraWrapper wrapper(graph);
-    AStarAlgorithm<DijkstraWrapper>::Context context;
-    astar.PropagateWave(wrapper, enter,
-                        [](Segment const & /* vertex */) { return true; } /* visitVertex */,
-                        context);
-
-    for (Segment const & exit : connector.GetExits())
-    {
-      if (context.HasDistance(exit))
-      {
-        weights[enter][exit] = context.GetDistance(exit);
-        ++foundCount;
-      }
-      else
-      {
-        ++notFoundCount;
-      }
-    }
-  }
+  CalcCrossMwmWeights(graph, connector, thread::hardware_concurrency(), disableCrossMwmProgress,
+                      weights);
 
   connector.FillWeights([&](Segment const & enter, Segment const & exit) {
     auto it0 = weights.find(enter);
@@ -333,8 +307,7 @@ void FillWeights(string const & path, string const & mwmFile, string const & cou
     return it1->second.ToCrossMwmWeight();
   });
 
-  LOG(LINFO, ("Leaps finished, elapsed:", timer.ElapsedSeconds(), "seconds, routes found:",
-              foundCount, ", not found:", notFoundCount));
+  LOG(LINFO, ("Leaps finished, elapsed:", timer.ElapsedSeconds(), "seconds"));
 }
 
 serial::CodingParams LoadCodingParams(string const & mwmFile)
@@ -346,6 +319,71 @@ serial::CodingParams LoadCodingParams(string const & mwmFile)
 
 namespace routing
 {
+void CalcCrossMwmWeights(IndexGraph & graph, CrossMwmConnector const & connector,
+                         size_t numThreads, bool disableCrossMwmProgress,
+                         map<Segment, map<Segment, RouteWeight>> & weights)
+{
+  // Waves are propagated concurrently over the same graph. Geometry of the graph is
+  // loaded lazily, so all roads are loaded here to make the graph read-only for the workers.
+  Geometry & geometry = graph.GetGeometry();
+  graph.ForEachRoad([&geometry](uint32_t featureId, RoadJointIds const & /* roadJoints */) {
+    geometry.GetRoad(featureId);
+  });
+  for (Segment const & enter : connector.GetEnters())
+    geometry.GetRoad(enter.GetFeatureId());
+
+  auto const numEnters = connector.GetEnters().size();
+  numThreads = min(max(numThreads, static_cast<size_t>(1)), numEnters);
+
+  // Distances to the exits from every enter, in the order of enters.
+  vector<map<Segment, RouteWeight>> enterWeights(numEnters);
+  atomic<size_t> nextEnter(0);
+  atomic<size_t> numPassed(0);
+  auto const propagateWaves = [&]() {
+    AStarAlgorithm<DijkstraWrapper> astar;
+    DijkstraWrapper wrapper(graph);
+    for (size_t i = nextEnter++; i < numEnters; i = nextEnter++)
+    {
+      AStarAlgorithm<DijkstraWrapper>::Context context;
+      astar.PropagateWave(wrapper, connector.GetEnter(i),
+                          [](Segment const & /* vertex */) { return true; } /* visitVertex */,
+                          context);
+
+      for (Segment const & exit : connector.GetExits())
+      {
+        if (context.HasDistance(exit))
+          enterWeights[i][exit] = context.GetDistance(exit);
+      }
+
+      size_t const passed = ++numPassed;
+      if (!disableCrossMwmProgress && (passed % 10 == 0))
+        LOG(LINFO, ("Building leaps:", passed, "/", numEnters, "waves passed"));
+    }
+  };
+
+  vector<thread> threads;
+  for (size_t i = 1; i < numThreads; ++i)
+    threads.emplace_back(propagateWaves);
+  propagateWaves();
+  for (auto & t : threads)
+    t.join();
+
+  weights.clear();
+  size_t foundCount = 0;
+  size_t notFoundCount = 0;
+  for (size_t i = 0; i < numEnters; ++i)
+  {
+    foundCount += enterWeights[i].size();
+    notFoundCount += connector.GetExits().size() - enterWeights[i].size();
+    auto & enterToExits = weights[connector.GetEnter(i)];
+    for (auto const & kv : enterWeights[i])
+      enterToExits[kv.first] = kv.second;
+  }
+
+  LOG(LINFO, ("Waves finished, routes found:", foundCount, ", not found:", notFoundCount,
+              ", threads:", numThreads));
+}
+
 bool BuildRoutingIndex(string const & filename, string const & country,
                        CountryParentNameGetterFn const & countryParentNameGetterFn)
 {
@@ -1,7 +1,14 @@
 #pragma once
 
+#include "routing/cross_mwm_connector.hpp"
+#include "routing/index_graph.hpp"
+#include "routing/route_weight.hpp"
+#include "routing/segment.hpp"
+
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <string>
 
 namespace routing
@@ -14,4 +21,11 @@ bool BuildCrossMwmSection(std::string const & path, std::string const & mwmFile,
                           std::string const & country,
                           CountryParentNameGetterFn const & countryParentNameGetterFn,
                           std::string const & osmToFeatureFile, bool disableCrossMwmProgress);
+
+// Calculates weights of the routes in |graph| from every enter of |connector| to its exits.
+// Waves from the enters are propagated by |numThreads| threads, the result doesn't depend
+// on the number of threads. Exits which are not reachable from an enter are not in |weights|.
+void CalcCrossMwmWeights(IndexGraph & graph, CrossMwmConnector const & connector,
+                         size_t numThreads, bool disableCrossMwmProgress,
+                         std::map<Segment, std::map<Segment, RouteWeight>> & weights);
 }  // namespace routing
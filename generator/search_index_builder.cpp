@@ -1,6 +1,7 @@
 #include "search_index_builder.hpp"
 
 #include "search/common.hpp"
+#include "search/mwm_context.hpp"
 #include "search/reverse_geocoder.hpp"
 #include "search/search_index_values.hpp"
 #include "search/search_trie.hpp"
@@ -24,21 +25,32 @@
 #include "platform/platform.hpp"
 
 #include "coding/file_name_utils.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
 #include "coding/fixed_bits_ddvector.hpp"
+#include "coding/internal/file_data.hpp"
 #include "coding/reader_writer_ops.hpp"
+#include "coding/write_to_sink.hpp"
 #include "coding/writer.hpp"
 
 #include "base/assert.hpp"
+#include "base/checked_cast.hpp"
 #include "base/logging.hpp"
+#include "base/math.hpp"
 #include "base/scope_guard.hpp"
 #include "base/stl_add.hpp"
+#include "base/stl_helpers.hpp"
 #include "base/string_utils.hpp"
 #include "base/timer.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <fstream>
 #include <initializer_list>
 #include <limits>
+#include <map>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -324,72 +336,386 @@ void AddFeatureNameIndexPairs(FeaturesVectorTest const & features,
       synonyms.get(), keyValuePairs, categoriesHolder, header.GetScaleRange(), valueBuilder));
 }
 
-void BuildAddressTable(FilesContainerR & container, Writer & writer)
+uint32_t constexpr kUnmatchedStreet = numeric_limits<uint32_t>::max();
+
+// Buildings are matched by tasks of consecutive features, which are close to each other,
+// so the streets loaded for a task are mostly reused by its buildings.
+size_t constexpr kBuildingsPerTask = 1024;
+
+// Max number of street features kept loaded by a thread.
+size_t constexpr kMaxCachedStreets = 4096;
+
+uint32_t constexpr kHouseToStreetCacheVersion = 0;
+
+// Street indices of buildings by fingerprints of the matching inputs.
+using THouseToStreetCache = unordered_map<uint64_t, uint32_t>;
+
+// FNV-1a hash of the inputs of a street matching.
+class Fingerprint
 {
-  ReaderSource<ModelReaderPtr> src = container.GetReader(SEARCH_TOKENS_FILE_TAG);
-  uint32_t address = 0, missing = 0;
-  map<size_t, size_t> bounds;
+public:
+  void Add(uint64_t value)
+  {
+    for (size_t i = 0; i < sizeof(value); ++i)
+    {
+      m_hash ^= (value >> (i * 8)) & 0xFF;
+      m_hash *= 1099511628211ULL;
+    }
+  }
+
+  void Add(double value)
+  {
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(value), "");
+    memcpy(&bits, &value, sizeof(bits));
+    Add(bits);
+  }
+
+  void Add(m2::PointD const & p)
+  {
+    Add(p.x);
+    Add(p.y);
+  }
+
+  template <typename TString>
+  void AddString(TString const & s)
+  {
+    Add(static_cast<uint64_t>(s.size()));
+    for (auto const c : s)
+      Add(static_cast<uint64_t>(c));
+  }
+
+  uint64_t Get() const { return m_hash; }
+
+private:
+  uint64_t m_hash = 14695981039346656037ULL;
+};
+
+uint64_t constexpr kUnknownFingerprint = numeric_limits<uint64_t>::max();
+
+// Returns 0 if |ft| is not a street, otherwise the fingerprint of everything
+// the distance to the street and its name depend on.
+uint64_t GetStreetFingerprint(FeatureType & ft)
+{
+  string name;
+  if (!search::ReverseGeocoder::GetStreetName(ft, name))
+    return 0;
+
+  Fingerprint fingerprint;
+  fingerprint.AddString(name);
+  ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+  for (size_t i = 0; i < ft.GetPointsCount(); ++i)
+    fingerprint.Add(ft.GetPoint(i));
+  return my::clamp(fingerprint.Get(), static_cast<uint64_t>(1), kUnknownFingerprint - 1);
+}
+
+// Street fingerprints by feature indices. They are computed by the matching threads
+// on demand, as only the features near buildings are needed.
+class StreetFingerprints
+{
+public:
+  explicit StreetFingerprints(uint32_t featuresCount) : m_fingerprints(featuresCount)
+  {
+    for (auto & fingerprint : m_fingerprints)
+      fingerprint.store(kUnknownFingerprint, memory_order_relaxed);
+  }
+
+  // Several threads may compute the same fingerprint, the result is the same anyway.
+  uint64_t Get(search::MwmContext const & context, uint32_t index)
+  {
+    auto & stored = m_fingerprints[index];
+    uint64_t fingerprint = stored.load(memory_order_relaxed);
+    if (fingerprint == kUnknownFingerprint)
+    {
+      FeatureType ft;
+      CHECK(context.GetFeature(index, ft), (index));
+      fingerprint = GetStreetFingerprint(ft);
+      stored.store(fingerprint, memory_order_relaxed);
+    }
+    return fingerprint;
+  }
+
+private:
+  vector<atomic<uint64_t>> m_fingerprints;
+};
+
+void LoadHouseToStreetCache(string const & path, THouseToStreetCache & cache)
+{
+  if (!Platform::IsFileExistsByFullPath(path))
+    return;
+
+  try
+  {
+    FileReader reader(path);
+    ReaderSource<FileReader> src(reader);
+    if (ReadPrimitiveFromSource<uint32_t>(src) != kHouseToStreetCacheVersion)
+    {
+      LOG(LWARNING, ("Unknown version of house to street cache", path));
+      return;
+    }
+
+    auto const count = ReadPrimitiveFromSource<uint64_t>(src);
+    uint64_t constexpr kEntrySize = sizeof(uint64_t) + sizeof(uint32_t);
+    if (count > src.Size() / kEntrySize)
+    {
+      LOG(LWARNING, ("Corrupted house to street cache", path, "entries:", count));
+      return;
+    }
+
+    cache.reserve(count);
+    for (uint64_t i = 0; i < count; ++i)
+    {
+      auto const fingerprint = ReadPrimitiveFromSource<uint64_t>(src);
+      cache[fingerprint] = ReadPrimitiveFromSource<uint32_t>(src);
+    }
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LWARNING, ("Can't read house to street cache", path, e.Msg()));
+    cache.clear();
+  }
+}
+
+void SaveHouseToStreetCache(string const & path, THouseToStreetCache const & cache)
+{
+  vector<pair<uint64_t, uint32_t>> entries(cache.begin(), cache.end());
+  sort(entries.begin(), entries.end());
+
+  string const tmpPath = path + EXTENSION_TMP;
+  try
+  {
+    FileWriter writer(tmpPath);
+    WriteToSink(writer, kHouseToStreetCacheVersion);
+    WriteToSink(writer, static_cast<uint64_t>(entries.size()));
+    for (auto const & entry : entries)
+    {
+      WriteToSink(writer, entry.first);
+      WriteToSink(writer, entry.second);
+    }
+  }
+  catch (Writer::Exception const & e)
+  {
+    LOG(LWARNING, ("Can't write house to street cache", path, e.Msg()));
+    my::DeleteFileX(tmpPath);
+    return;
+  }
+
+  if (!my::RenameFileX(tmpPath, path))
+  {
+    LOG(LWARNING, ("Can't replace house to street cache", path));
+    my::DeleteFileX(tmpPath);
+  }
+}
+
+// Matches buildings to streets in the same way as ReverseGeocoder::GetNearbyStreets()
+// and ReverseGeocoder::GetMatchedStreetIndex() do, but keeps street features loaded,
+// as neighbouring buildings have the same nearby streets. Buildings which have the same
+// matching inputs as in |prevCache| get the street from the cache.
+class StreetMatcher
+{
+public:
+  StreetMatcher(Index const & index, MwmSet::MwmId const & id,
+                StreetFingerprints & streetFingerprints, THouseToStreetCache const & prevCache)
+    : m_context(index.GetMwmHandleById(id))
+    , m_streetFingerprints(streetFingerprints)
+    , m_prevCache(prevCache)
+  {
+  }
+
+  // Returns the index of the matched street among the nearby streets of |building|,
+  // or kUnmatchedStreet.
+  uint32_t Match(uint32_t building, strings::UniString const & street, uint64_t & fingerprint)
+  {
+    FeatureType ft;
+    CHECK(m_context.GetFeature(building, ft), (building));
+    m2::PointD const center = feature::GetCenter(ft);
+
+    m_candidates.clear();
+    auto const rect = search::ReverseGeocoder::GetLookupRect(
+        center, search::ReverseGeocoder::kLookupRadiusM);
+    m_context.ForEachIndex(rect, [this](uint32_t index) {
+      if (m_streetFingerprints.Get(m_context, index) != 0)
+        m_candidates.push_back(index);
+    });
+
+    // The order of the candidates matters too, as the order of the nearby streets
+    // at the same distance depends on it.
+    Fingerprint inputs;
+    inputs.Add(center);
+    inputs.AddString(street);
+    for (auto const index : m_candidates)
+      inputs.Add(m_streetFingerprints.Get(m_context, index));
+    fingerprint = inputs.Get();
+
+    auto const it = m_prevCache.find(fingerprint);
+    if (it != m_prevCache.end())
+      return it->second;
+
+    if (m_streets.size() > kMaxCachedStreets)
+      m_streets.clear();
+
+    using TStreet = search::ReverseGeocoder::Street;
+    vector<TStreet> streets;
+    streets.reserve(m_candidates.size());
+    for (auto const index : m_candidates)
+    {
+      auto const & s = GetStreet(index);
+      streets.emplace_back(s.m_feature.GetID(), feature::GetMinDistanceMeters(s.m_feature, center),
+                           s.m_name);
+    }
+    sort(streets.begin(), streets.end(), my::LessBy(&TStreet::m_distanceMeters));
+
+    auto const streetIndex = search::ReverseGeocoder::GetMatchedStreetIndex(street, streets);
+    if (streetIndex < streets.size())
+      return base::checked_cast<uint32_t>(streetIndex);
+    return kUnmatchedStreet;
+  }
+
+private:
+  struct Street
+  {
+    FeatureType m_feature;
+    string m_name;
+  };
+
+  Street const & GetStreet(uint32_t index)
+  {
+    auto const res = m_streets.emplace(index, Street());
+    auto & s = res.first->second;
+    if (res.second)
+    {
+      CHECK(m_context.GetFeature(index, s.m_feature), (index));
+      VERIFY(search::ReverseGeocoder::GetStreetName(s.m_feature, s.m_name), (index));
+    }
+    return s;
+  }
+
+  search::MwmContext m_context;
+  StreetFingerprints & m_streetFingerprints;
+  THouseToStreetCache const & m_prevCache;
+
+  unordered_map<uint32_t, Street> m_streets;
+  vector<uint32_t> m_candidates;
+};
+
+void BuildAddressTable(FilesContainerR & container, Writer & writer,
+                       string const & houseToStreetCachePath)
+{
+  my::Timer timer;
+
+  // Buildings with streets and their street keys, by feature indices.
+  vector<pair<uint32_t, strings::UniString>> buildings;
+  uint32_t featuresCount = 0;
+  {
+    ReaderSource<ModelReaderPtr> src = container.GetReader(SEARCH_TOKENS_FILE_TAG);
+    for (; src.Size() > 0; ++featuresCount)
+    {
+      feature::AddressData data;
+      data.Deserialize(src);
+
+      strings::UniString street =
+          search::GetStreetNameAsKey(data.Get(feature::AddressData::STREET));
+      if (!street.empty())
+        buildings.emplace_back(featuresCount, move(street));
+    }
+  }
 
   Index mwmIndex;
   /// @ todo Make some better solution, or legalize MakeTemporary.
   auto const res = mwmIndex.RegisterMap(platform::LocalCountryFile::MakeTemporary(container.GetFileName()));
   ASSERT_EQUAL(res.second, MwmSet::RegResult::Success, ());
-  search::ReverseGeocoder rgc(mwmIndex);
 
+  StreetFingerprints streetFingerprints(featuresCount);
+
+  THouseToStreetCache prevCache;
+  if (!houseToStreetCachePath.empty())
+    LoadHouseToStreetCache(houseToStreetCachePath, prevCache);
+
+  vector<uint32_t> streetIndices(buildings.size());
+  vector<uint64_t> fingerprints(buildings.size());
+
+  size_t const tasksCount = (buildings.size() + kBuildingsPerTask - 1) / kBuildingsPerTask;
+  size_t const numThreads =
+      max(static_cast<size_t>(1),
+          min(static_cast<size_t>(thread::hardware_concurrency()), tasksCount));
+  LOG(LINFO, ("Address: Matching", buildings.size(), "buildings, threads:", numThreads));
+
+  atomic<size_t> nextTask(0);
+  auto const matchBuildings = [&]()
+  {
+    StreetMatcher matcher(mwmIndex, res.first, streetFingerprints, prevCache);
+    for (size_t task = nextTask++; task < tasksCount; task = nextTask++)
+    {
+      size_t const end = min(buildings.size(), (task + 1) * kBuildingsPerTask);
+      for (size_t i = task * kBuildingsPerTask; i < end; ++i)
+      {
+        streetIndices[i] =
+            matcher.Match(buildings[i].first, buildings[i].second, fingerprints[i]);
+      }
+    }
+  };
+
+  vector<thread> threads;
+  for (size_t i = 0; i < numThreads; ++i)
+    threads.emplace_back(matchBuildings);
+  for (auto & thread : threads)
+    thread.join();
+
+  uint32_t address = 0, missing = 0, reused = 0;
+  map<size_t, size_t> bounds;
+  THouseToStreetCache cache;
   {
     FixedBitsDDVector<3, FileReader>::Builder<Writer> building2Street(writer);
 
-    FeaturesVectorTest features(container);
-    for (uint32_t index = 0; src.Size() > 0; ++index)
+    size_t building = 0;
+    for (uint32_t index = 0; index < featuresCount; ++index)
     {
-      feature::AddressData data;
-      data.Deserialize(src);
-
-      size_t streetIndex = 0;
-      bool streetMatched = false;
-      strings::UniString const street = search::GetStreetNameAsKey(data.Get(feature::AddressData::STREET));
-      if (!street.empty())
+      if (building == buildings.size() || buildings[building].first != index)
       {
-        FeatureType ft;
-        features.GetVector().GetByIndex(index, ft);
-        ft.SetID({res.first, index});
+        building2Street.PushBackUndefined();
+        continue;
+      }
 
-        using TStreet = search::ReverseGeocoder::Street;
-        vector<TStreet> streets;
-        rgc.GetNearbyStreets(ft, streets);
+      uint32_t const streetIndex = streetIndices[building];
+      if (prevCache.count(fingerprints[building]) != 0)
+        ++reused;
+      cache.emplace(fingerprints[building], streetIndex);
+      ++building;
+      ++address;
 
-        streetIndex = rgc.GetMatchedStreetIndex(street, streets);
-        if (streetIndex < streets.size())
-        {
-          ++bounds[streetIndex];
-          streetMatched = true;
-        }
-        else
-        {
-          ++missing;
-        }
-        ++address;
+      if (streetIndex != kUnmatchedStreet)
+      {
+        ++bounds[streetIndex];
+        building2Street.PushBack(
+            base::checked_cast<decltype(building2Street)::ValueType>(streetIndex));
       }
-      if (streetMatched)
-        building2Street.PushBack(base::checked_cast<decltype(building2Street)::ValueType>(streetIndex));
       else
+      {
+        ++missing;
         building2Street.PushBackUndefined();
+      }
     }
 
     LOG(LINFO, ("Address: Building -> Street (opt, all)", building2Street.GetCount()));
   }
 
+  if (!houseToStreetCachePath.empty())
+    SaveHouseToStreetCache(houseToStreetCachePath, cache);
+
   double matchedPercent = 100;
   if (address > 0)
     matchedPercent = 100.0 * (1.0 - static_cast<double>(missing) / static_cast<double>(address));
   LOG(LINFO, ("Address: Matched percent", matchedPercent));
   LOG(LINFO, ("Address: Upper bounds", bounds));
+  LOG(LINFO, ("Address: Reused from the previous generation", reused, "of", address));
+  LOG(LINFO, ("Address: Elapsed seconds", timer.ElapsedSeconds()));
 }
 }  // namespace
 
 namespace indexer
 {
-bool BuildSearchIndexFromDataFile(string const & filename, bool forceRebuild)
+bool BuildSearchIndexFromDataFile(string const & filename, bool forceRebuild,
+                                  string const & houseToStreetCachePath)
 {
   Platform & platform = GetPlatform();
 
@@ -419,7 +745,7 @@ bool BuildSearchIndexFromDataFile(string const & filename, bool forceRebuild)
     if (filename != WORLD_FILE_NAME && filename != WORLD_COASTS_FILE_NAME)
     {
       FileWriter writer(addrFilePath);
-      BuildAddressTable(readContainer, writer);
+      BuildAddressTable(readContainer, writer, houseToStreetCachePath);
       LOG(LINFO, ("Search address table size =", writer.Size()));
     }
     {
@@ -11,7 +11,12 @@ namespace indexer
 // An attempt to rewrite the search index of an old mwm may result in a future crash
 // when using search because this function does not update mwm's version. This results
 // in version mismatch when trying to read the index.
-bool BuildSearchIndexFromDataFile(std::string const & filename, bool forceRebuild = false);
+//
+// When |houseToStreetCachePath| is not empty, streets of the buildings whose street matching
+// inputs are the same as in the previous generation are taken from the cache at that path,
+// and the cache is updated with the matchings of this generation.
+bool BuildSearchIndexFromDataFile(std::string const & filename, bool forceRebuild = false,
+                                  std::string const & houseToStreetCachePath = std::string());
 
 void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter);
 }  // namespace indexer
@@ -48,6 +48,7 @@ HEADERS += \
   line2d.hpp \
   mercator.hpp \
   nearby_points_sweeper.hpp \
+  packed_tree.hpp \
   packer.hpp \
   point2d.hpp \
   pointu_to_uint64.hpp \
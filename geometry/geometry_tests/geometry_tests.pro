@@ -37,6 +37,7 @@ SOURCES += \
   line2d_tests.cpp \
   mercator_test.cpp \
   nearby_points_sweeper_test.cpp \
+  packed_tree_test.cpp \
   packer_test.cpp \
   point_test.cpp \
   pointu_to_uint64_test.cpp \
@@ -0,0 +1,170 @@
+#include "testing/testing.hpp"
+
+#include "geometry/packed_tree.hpp"
+#include "geometry/rect2d.hpp"
+#include "geometry/tree4d.hpp"
+
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+struct Object
+{
+  Object() = default;
+  Object(uint32_t id, m2::RectD const & rect) : m_id(id), m_rect(rect) {}
+
+  bool operator==(Object const & rhs) const { return m_id == rhs.m_id; }
+  bool operator<(Object const & rhs) const { return m_id < rhs.m_id; }
+
+  m2::RectD const & GetLimitRect() const { return m_rect; }
+
+  uint32_t m_id = 0;
+  m2::RectD m_rect;
+};
+
+string DebugPrint(Object const & object) { return strings::to_string(object.m_id); }
+
+vector<Object> MakeObjects(size_t n, mt19937 & rng)
+{
+  uniform_real_distribution<double> coord(0.0, 1000.0);
+  uniform_real_distribution<double> size(0.0, 10.0);
+
+  vector<Object> objects;
+  objects.reserve(n);
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    double const x = coord(rng);
+    double const y = coord(rng);
+    objects.emplace_back(i, m2::RectD(x, y, x + size(rng), y + size(rng)));
+  }
+  return objects;
+}
+
+vector<m2::RectD> MakeQueries(size_t n, mt19937 & rng)
+{
+  uniform_real_distribution<double> coord(0.0, 1000.0);
+  uniform_real_distribution<double> size(0.0, 50.0);
+
+  vector<m2::RectD> queries;
+  queries.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    double const x = coord(rng);
+    double const y = coord(rng);
+    queries.emplace_back(x, y, x + size(rng), y + size(rng));
+  }
+  return queries;
+}
+
+template <typename Tree>
+vector<Object> Query(Tree const & tree, m2::RectD const & rect)
+{
+  vector<Object> result;
+  tree.ForEachInRect(rect, [&result](Object const & object) { result.push_back(object); });
+  sort(result.begin(), result.end());
+  return result;
+}
+}  // namespace
+
+UNIT_TEST(PackedTree_Smoke)
+{
+  m4::PackedTree<Object> tree;
+  TEST(tree.IsEmpty(), ());
+
+  vector<Object> const objects = {Object(0, m2::RectD(0, 0, 1, 1)),
+                                  Object(1, m2::RectD(1, 1, 2, 2)),
+                                  Object(2, m2::RectD(2, 2, 3, 3))};
+  tree.Build(objects.begin(), objects.end());
+  TEST_EQUAL(tree.GetSize(), 3, ());
+
+  TEST_EQUAL(Query(tree, m2::RectD(1.5, 1.5, 1.5, 1.5)), vector<Object>({objects[1]}), ());
+  // Touching rects are not reported.
+  TEST_EQUAL(Query(tree, m2::RectD(3, 3, 4, 4)), vector<Object>(), ());
+
+  tree.Add(Object(3, m2::RectD(1.2, 1.2, 1.8, 1.8)));
+  TEST_EQUAL(Query(tree, m2::RectD(1.5, 1.5, 1.5, 1.5)),
+             vector<Object>({objects[1], Object(3, m2::RectD())}), ());
+
+  tree.Erase(objects[1]);
+  TEST_EQUAL(tree.GetSize(), 3, ());
+  TEST_EQUAL(Query(tree, m2::RectD(1.5, 1.5, 1.5, 1.5)), vector<Object>({Object(3, m2::RectD())}),
+             ());
+
+  tree.Build();
+  TEST_EQUAL(tree.GetSize(), 3, ());
+  TEST_EQUAL(Query(tree, m2::RectD(0, 0, 3, 3)),
+             vector<Object>({objects[0], objects[2], Object(3, m2::RectD())}), ());
+
+  tree.Clear();
+  TEST(tree.IsEmpty(), ());
+}
+
+UNIT_TEST(PackedTree_SameAsTree4D)
+{
+  mt19937 rng(0);
+  vector<Object> const objects = MakeObjects(10000, rng);
+  vector<m2::RectD> const queries = MakeQueries(1000, rng);
+
+  m4::Tree<Object> expected;
+  m4::PackedTree<Object> packed;
+  for (size_t i = 0; i < objects.size(); ++i)
+  {
+    expected.Add(objects[i]);
+    packed.Add(objects[i]);
+  }
+
+  // Erase every third object to test both deletion and rebuilding.
+  for (size_t i = 0; i < objects.size(); i += 3)
+  {
+    expected.Erase(objects[i]);
+    packed.Erase(objects[i]);
+  }
+  TEST_EQUAL(expected.GetSize(), packed.GetSize(), ());
+
+  for (auto const & query : queries)
+    TEST_EQUAL(Query(expected, query), Query(packed, query), (query));
+}
+
+UNIT_TEST(PackedTree_Benchmark)
+{
+  mt19937 rng(0);
+  vector<Object> const objects = MakeObjects(100000, rng);
+  vector<m2::RectD> const queries = MakeQueries(10000, rng);
+
+  my::Timer timer;
+  m4::Tree<Object> tree;
+  for (auto const & object : objects)
+    tree.Add(object);
+  double const treeBuildSeconds = timer.ElapsedSeconds();
+
+  timer.Reset();
+  m4::PackedTree<Object> packed;
+  packed.Build(objects.begin(), objects.end());
+  double const packedBuildSeconds = timer.ElapsedSeconds();
+
+  size_t treeCount = 0;
+  timer.Reset();
+  for (auto const & query : queries)
+    tree.ForEachInRect(query, [&treeCount](Object const &) { ++treeCount; });
+  double const treeQuerySeconds = timer.ElapsedSeconds();
+
+  size_t packedCount = 0;
+  timer.Reset();
+  for (auto const & query : queries)
+    packed.ForEachInRect(query, [&packedCount](Object const &) { ++packedCount; });
+  double const packedQuerySeconds = timer.ElapsedSeconds();
+
+  TEST_EQUAL(treeCount, packedCount, ());
+  LOG(LINFO, ("Objects:", objects.size(), "queries:", queries.size(), "found:", treeCount));
+  LOG(LINFO, ("m4::Tree build:", treeBuildSeconds, "s, queries:", treeQuerySeconds, "s"));
+  LOG(LINFO, ("m4::PackedTree build:", packedBuildSeconds, "s, queries:", packedQuerySeconds, "s"));
+}
@@ -166,6 +166,34 @@ UNIT_TEST(Simpfication_DP_DegenerateTrg)
   CheckDPStrict(arr2, ARRAY_SIZE(arr2), 1.0, 4);
 }
 
+UNIT_TEST(Simplification_DP_Significance)
+{
+  m2::PointD const * points = LargePolylineTestData::m_Data;
+  size_t const count = LargePolylineTestData::m_Size;
+
+  double const kMinEpsilon = 0.000001;
+  vector<double> significance;
+  CalculateDPSignificance(points, points + count, kMinEpsilon, DistanceF(), significance);
+  TEST_EQUAL(significance.size(), count, ());
+
+  for (double epsilon = kMinEpsilon; epsilon < 0.11; epsilon *= 3)
+  {
+    vector<m2::PointD> expected;
+    SimplifyDP(points, points + count, epsilon, DistanceF(), MakeBackInsertFunctor(expected));
+
+    vector<m2::PointD> result;
+    SimplifyBySignificance(points, points + count, significance, epsilon,
+                           MakeBackInsertFunctor(result));
+    TEST_EQUAL(result, expected, (epsilon));
+  }
+
+  vector<m2::PointD> result;
+  P const line[] = {P(0.0, 1.0), P(2.2, 3.6)};
+  CalculateDPSignificance(line, line + 2, kMinEpsilon, DistanceF(), significance);
+  SimplifyBySignificance(line, line + 2, significance, 1000.0, MakeBackInsertFunctor(result));
+  TEST_EQUAL(result, vector<m2::PointD>(line, line + 2), ());
+}
+
 #include "geometry/geometry_tests/large_polygon.hpp"
 
 m2::PointD const * LargePolylineTestData::m_Data = LargePolygon::kLargePolygon;
@@ -0,0 +1,364 @@
+#pragma once
+
+#include "geometry/rect2d.hpp"
+#include "geometry/tree4d.hpp"
+
+#include "base/assert.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace m4
+{
+// Bulk-loaded R-tree which is stored in flat arrays.
+//
+// Objects are sorted by the Hilbert curve index of the centers of their rects and
+// every kFanout consecutive entries of a level are covered by a node of the next level.
+// Rects of every level are stored as four separate coordinate arrays, so the overlap
+// test of all children of a node is a branch-free loop over contiguous memory which
+// is vectorized by the compiler. Queries use an explicit stack instead of recursion.
+//
+// The tree is dynamic: added objects are collected in a small unsorted batch which is
+// scanned linearly by queries, erased objects are marked as deleted. The tree is rebuilt
+// when the batch or the number of deleted objects becomes large enough, or by an explicit
+// call of Build().
+//
+// The semantics of queries are the same as for m4::Tree: rects which only touch the
+// query rect are not reported. The order of reported objects is unspecified.
+//
+// *NOTE* The class is NOT thread-safe.
+template <typename T, typename Traits = TraitsDef<T>>
+class PackedTree
+{
+public:
+  static size_t constexpr kFanout = 16;
+  // Minimal size of the batch of added objects which triggers rebuilding of the tree.
+  static size_t constexpr kMinBatchSize = 64;
+
+  explicit PackedTree(Traits const & traits = Traits()) : m_traits(traits) {}
+
+  // Builds the tree of |objects| at once. Previous content of the tree is discarded.
+  template <typename It>
+  void Build(It begin, It end)
+  {
+    Clear();
+    for (; begin != end; ++begin)
+      m_batch.emplace_back(*begin, m_traits.LimitRect(*begin));
+    Build();
+  }
+
+  // Builds the tree of objects with given rects at once. Previous content of the tree is discarded.
+  void Build(std::vector<std::pair<T, m2::RectD>> && entries)
+  {
+    Clear();
+    Pack(entries);
+  }
+
+  void Add(T const & obj) { Add(obj, m_traits.LimitRect(obj)); }
+  void Add(T const & obj, m2::RectD const & rect)
+  {
+    m_batch.emplace_back(obj, rect);
+    RebuildIfNeeded();
+  }
+
+  void Erase(T const & obj) { Erase(obj, m_traits.LimitRect(obj)); }
+  // Erases an object which is equal to |obj| and has the same |rect|.
+  void Erase(T const & obj, m2::RectD const & rect)
+  {
+    for (auto it = m_batch.begin(); it != m_batch.end(); ++it)
+    {
+      if (it->first == obj && it->second == rect)
+      {
+        m_batch.erase(it);
+        return;
+      }
+    }
+
+    size_t found = m_values.size();
+    ForEachIndexInRect(rect, false /* strict */, [&](size_t index) {
+      if (found == m_values.size() && m_values[index] == obj && GetRect(index) == rect)
+        found = index;
+    });
+
+    if (found != m_values.size())
+    {
+      m_deleted[found] = 1;
+      ++m_numDeleted;
+      RebuildIfNeeded();
+    }
+  }
+
+  // Rebuilds the tree of all objects which are in the tree now.
+  void Build()
+  {
+    std::vector<std::pair<T, m2::RectD>> entries;
+    entries.reserve(m_values.size() - m_numDeleted + m_batch.size());
+    for (size_t i = 0; i < m_values.size(); ++i)
+    {
+      if (!m_deleted[i])
+        entries.emplace_back(std::move(m_values[i]), GetRect(i));
+    }
+    for (auto & entry : m_batch)
+      entries.emplace_back(std::move(entry));
+
+    Clear();
+    Pack(entries);
+  }
+
+  template <typename ToDo>
+  void ForEachInRect(m2::RectD const & rect, ToDo && toDo) const
+  {
+    ForEachInRectEx(rect, [&toDo](m2::RectD const & /* r */, T const & t) { toDo(t); });
+  }
+
+  template <typename ToDo>
+  void ForEachInRectEx(m2::RectD const & rect, ToDo && toDo) const
+  {
+    for (auto const & entry : m_batch)
+    {
+      if (IsIntersect(entry.second, rect))
+        toDo(entry.second, entry.first);
+    }
+
+    ForEachIndexInRect(rect, true /* strict */,
+                       [&](size_t index) { toDo(GetRect(index), m_values[index]); });
+  }
+
+  template <typename ToDo>
+  void ForEach(ToDo && toDo) const
+  {
+    for (auto const & entry : m_batch)
+      toDo(entry.first);
+    for (size_t i = 0; i < m_values.size(); ++i)
+    {
+      if (!m_deleted[i])
+        toDo(m_values[i]);
+    }
+  }
+
+  bool IsEmpty() const { return GetSize() == 0; }
+  size_t GetSize() const { return m_values.size() - m_numDeleted + m_batch.size(); }
+
+  void Clear()
+  {
+    m_levels.clear();
+    m_values.clear();
+    m_deleted.clear();
+    m_numDeleted = 0;
+    m_batch.clear();
+  }
+
+private:
+  // Rects of all entries of a level, entries [i * kFanout, (i + 1) * kFanout) of a level
+  // are children of the entry i of the next level.
+  struct Level
+  {
+    void Reserve(size_t n)
+    {
+      m_minX.reserve(n);
+      m_minY.reserve(n);
+      m_maxX.reserve(n);
+      m_maxY.reserve(n);
+    }
+
+    void Add(m2::RectD const & rect)
+    {
+      m_minX.push_back(rect.minX());
+      m_minY.push_back(rect.minY());
+      m_maxX.push_back(rect.maxX());
+      m_maxY.push_back(rect.maxY());
+    }
+
+    // Sets hits[i] for entries [begin, begin + n) whose rects intersect |rect|.
+    void Intersect(size_t begin, size_t n, m2::RectD const & rect, bool strict,
+                   uint8_t * hits) const
+    {
+      double const * minX = m_minX.data() + begin;
+      double const * minY = m_minY.data() + begin;
+      double const * maxX = m_maxX.data() + begin;
+      double const * maxY = m_maxY.data() + begin;
+
+      // Bitwise ands keep the loops free of branches.
+      if (strict)
+      {
+        for (size_t i = 0; i < n; ++i)
+        {
+          hits[i] = static_cast<uint8_t>((maxX[i] > rect.minX()) & (minX[i] < rect.maxX()) &
+                                         (maxY[i] > rect.minY()) & (minY[i] < rect.maxY()));
+        }
+      }
+      else
+      {
+        for (size_t i = 0; i < n; ++i)
+        {
+          hits[i] = static_cast<uint8_t>((maxX[i] >= rect.minX()) & (minX[i] <= rect.maxX()) &
+                                         (maxY[i] >= rect.minY()) & (minY[i] <= rect.maxY()));
+        }
+      }
+    }
+
+    std::vector<double> m_minX;
+    std::vector<double> m_minY;
+    std::vector<double> m_maxX;
+    std::vector<double> m_maxY;
+  };
+
+  static bool IsIntersect(m2::RectD const & r1, m2::RectD const & r2)
+  {
+    return !(r1.maxX() <= r2.minX() || r1.minX() >= r2.maxX() || r1.maxY() <= r2.minY() ||
+             r1.minY() >= r2.maxY());
+  }
+
+  // Returns the index of the point (x, y), 0 <= x, y < 2^16, on the Hilbert curve.
+  static uint64_t GetHilbertIndex(uint32_t x, uint32_t y)
+  {
+    uint32_t constexpr kSide = 1 << 16;
+    uint64_t d = 0;
+    for (uint32_t s = kSide / 2; s > 0; s /= 2)
+    {
+      uint32_t const rx = (x & s) != 0 ? 1 : 0;
+      uint32_t const ry = (y & s) != 0 ? 1 : 0;
+      d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+      if (ry == 0)
+      {
+        if (rx == 1)
+        {
+          x = kSide - 1 - x;
+          y = kSide - 1 - y;
+        }
+        std::swap(x, y);
+      }
+    }
+    return d;
+  }
+
+  // Calls |fn| for indices of the packed objects which are not deleted and whose rects
+  // intersect |rect|. Touching rects are skipped if |strict| is true.
+  template <typename Fn>
+  void ForEachIndexInRect(m2::RectD const & rect, bool strict, Fn && fn) const
+  {
+    if (m_levels.empty())
+      return;
+
+    // Pairs of (level + 1, index of the first entry to check at the level).
+    std::vector<std::pair<size_t, size_t>> stack;
+    stack.emplace_back(m_levels.size(), 0);
+
+    uint8_t hits[kFanout];
+    while (!stack.empty())
+    {
+      size_t const level = stack.back().first - 1;
+      size_t const begin = stack.back().second;
+      stack.pop_back();
+
+      Level const & l = m_levels[level];
+      size_t const n = std::min(begin + kFanout, l.m_minX.size()) - begin;
+      l.Intersect(begin, n, rect, strict, hits);
+
+      for (size_t i = 0; i < n; ++i)
+      {
+        if (!hits[i])
+          continue;
+
+        size_t const index = begin + i;
+        if (level != 0)
+          stack.emplace_back(level, index * kFanout);
+        else if (!m_deleted[index])
+          fn(index);
+      }
+    }
+  }
+
+  void RebuildIfNeeded()
+  {
+    size_t const size = m_values.size();
+    if (m_batch.size() >= std::max(kMinBatchSize, size / 4) ||
+        (m_numDeleted >= kMinBatchSize && m_numDeleted >= size / 2))
+    {
+      Build();
+    }
+  }
+
+  m2::RectD GetRect(size_t index) const
+  {
+    Level const & l = m_levels[0];
+    return m2::RectD(l.m_minX[index], l.m_minY[index], l.m_maxX[index], l.m_maxY[index]);
+  }
+
+  void Pack(std::vector<std::pair<T, m2::RectD>> & entries)
+  {
+    if (entries.empty())
+      return;
+
+    m2::RectD bounds;
+    for (auto const & entry : entries)
+      bounds.Add(entry.second);
+
+    double const kMaxCoord = (1 << 16) - 1;
+    double const sx = bounds.SizeX() > 0 ? kMaxCoord / bounds.SizeX() : 0;
+    double const sy = bounds.SizeY() > 0 ? kMaxCoord / bounds.SizeY() : 0;
+
+    std::vector<uint64_t> keys(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+      m2::PointD const center = entries[i].second.Center();
+      keys[i] = GetHilbertIndex(static_cast<uint32_t>((center.x - bounds.minX()) * sx),
+                                static_cast<uint32_t>((center.y - bounds.minY()) * sy));
+    }
+
+    std::vector<size_t> order(entries.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&keys](size_t lhs, size_t rhs) { return keys[lhs] < keys[rhs]; });
+
+    m_levels.emplace_back();
+    m_levels[0].Reserve(entries.size());
+    m_values.reserve(entries.size());
+    for (size_t const i : order)
+    {
+      m_levels[0].Add(entries[i].second);
+      m_values.push_back(std::move(entries[i].first));
+    }
+    m_deleted.assign(m_values.size(), 0);
+
+    while (m_levels.back().m_minX.size() > kFanout)
+    {
+      size_t const n = m_levels.back().m_minX.size();
+      Level next;
+      next.Reserve((n + kFanout - 1) / kFanout);
+      for (size_t begin = 0; begin < n; begin += kFanout)
+      {
+        Level const & l = m_levels.back();
+        size_t const end = std::min(begin + kFanout, n);
+        m2::RectD rect(l.m_minX[begin], l.m_minY[begin], l.m_maxX[begin], l.m_maxY[begin]);
+        for (size_t i = begin + 1; i < end; ++i)
+          rect.Add(m2::RectD(l.m_minX[i], l.m_minY[i], l.m_maxX[i], l.m_maxY[i]));
+        next.Add(rect);
+      }
+      m_levels.push_back(std::move(next));
+    }
+  }
+
+  Traits m_traits;
+
+  // Levels of the tree from the objects to the root.
+  std::vector<Level> m_levels;
+  // Objects in the order of rects of the level 0.
+  std::vector<T> m_values;
+  std::vector<uint8_t> m_deleted;
+  size_t m_numDeleted = 0;
+
+  // Objects which are added after the last build.
+  std::vector<std::pair<T, m2::RectD>> m_batch;
+};
+
+template <typename T, typename Traits>
+size_t constexpr PackedTree<T, Traits>::kFanout;
+
+template <typename T, typename Traits>
+size_t constexpr PackedTree<T, Traits>::kMinBatchSize;
+}  // namespace m4
@@ -1,10 +1,12 @@
 #pragma once
+#include "base/assert.hpp"
 #include "base/base.hpp"
 #include "base/stl_add.hpp"
 #include "base/logging.hpp"
 
 #include "std/iterator.hpp"
 #include "std/algorithm.hpp"
+#include "std/limits.hpp"
 #include "std/utility.hpp"
 #include "std/vector.hpp"
 
@@ -80,6 +82,70 @@ void SimplifyDP(IterT beg, IterT end, double epsilon, DistanceF dist, OutT out)
   }
 }
 
+// Calculates Douglas-Peucker significance of points of the range [beg, end): a point is in the
+// SimplifyDP() result for every positive epsilon which is not greater than its significance,
+// so simplifications for all epsilons are filters of the points, see SimplifyBySignificance().
+// The end points have the maximal significance. Significance which is less than |minEpsilon|
+// is not calculated exactly, it's only guaranteed to be less than |minEpsilon|.
+// Ranges are processed with an explicit stack, so long polylines don't overflow the call stack.
+template <typename DistanceF, typename IterT>
+void CalculateDPSignificance(IterT beg, IterT end, double minEpsilon, DistanceF dist,
+                             vector<double> & significance)
+{
+  size_t const n = static_cast<size_t>(distance(beg, end));
+  significance.assign(n, 0.0);
+  if (n == 0)
+    return;
+
+  double const kMaxSignificance = numeric_limits<double>::max();
+  significance.front() = kMaxSignificance;
+  significance.back() = kMaxSignificance;
+
+  // Ranges [first, last] of points with the significance of the range.
+  struct Range
+  {
+    size_t m_first;
+    size_t m_last;
+    double m_significance;
+  };
+  vector<Range> stack = {{0, n - 1, kMaxSignificance}};
+  while (!stack.empty())
+  {
+    Range const range = stack.back();
+    stack.pop_back();
+
+    IterT const last = beg + range.m_last;
+    pair<double, IterT> const maxDist = impl::MaxDistance(beg + range.m_first, last, dist);
+    if (maxDist.second == last)
+      continue;
+
+    size_t const split = static_cast<size_t>(distance(beg, maxDist.second));
+    double const value = min(maxDist.first, range.m_significance);
+    significance[split] = value;
+    // Points of the subranges are less significant than |value|.
+    if (value >= minEpsilon)
+    {
+      stack.push_back({range.m_first, split, value});
+      stack.push_back({split, range.m_last, value});
+    }
+  }
+}
+
+// Calls |out| for points of [beg, end) whose significance is not less than |epsilon|.
+// For significance which is calculated by CalculateDPSignificance() the result is the same
+// as the result of SimplifyDP() for the positive |epsilon|.
+template <typename IterT, typename OutT>
+void SimplifyBySignificance(IterT beg, IterT end, vector<double> const & significance,
+                            double epsilon, OutT out)
+{
+  ASSERT_EQUAL(static_cast<size_t>(distance(beg, end)), significance.size(), ());
+  for (size_t i = 0; beg != end; ++beg, ++i)
+  {
+    if (significance[i] >= epsilon)
+      out(*beg);
+  }
+}
+
 // Dynamic programming near-optimal simplification.
 // Uses O(n) additional memory.
 // Worst case O(n^3) performance, average O(n*k^2), where k is kMaxFalseLookAhead - parameter,
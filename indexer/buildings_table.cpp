@@ -0,0 +1,306 @@
+#include "indexer/buildings_table.hpp"
+
+#include "indexer/geometry_coding.hpp"
+
+#include "coding/endianness.hpp"
+#include "coding/memory_region.hpp"
+#include "coding/point_to_integer.hpp"
+#include "coding/reader.hpp"
+#include "coding/succinct_mapper.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+#include "base/logging.hpp"
+
+namespace search
+{
+namespace
+{
+uint8_t const kHasRect = 1;
+
+template <typename TCont>
+void EndiannessAwareMap(bool endiannesMismatch, CopiedMemoryRegion & region, TCont & cont)
+{
+  TCont c;
+  if (endiannesMismatch)
+  {
+    coding::ReverseMapVisitor visitor(region.MutableData());
+    c.map(visitor);
+  }
+  else
+  {
+    coding::MapVisitor visitor(region.ImmutableData());
+    c.map(visitor);
+  }
+
+  c.swap(cont);
+}
+}  // namespace
+
+// static
+uint32_t const BuildingsTable::kBlockSize;
+// static
+uint32_t const BuildingsTable::kInvalidStreetId;
+
+// BuildingsTable::Header --------------------------------------------------------------------------
+void BuildingsTable::Header::Read(Reader & reader)
+{
+  NonOwningReaderSource source(reader);
+  m_version = ReadPrimitiveFromSource<uint16_t>(source);
+  m_endianness = ReadPrimitiveFromSource<uint16_t>(source);
+  m_positionsOffset = ReadPrimitiveFromSource<uint32_t>(source);
+  m_dataOffset = ReadPrimitiveFromSource<uint32_t>(source);
+  m_endOffset = ReadPrimitiveFromSource<uint32_t>(source);
+}
+
+void BuildingsTable::Header::Write(Writer & writer)
+{
+  WriteToSink(writer, m_version);
+  WriteToSink(writer, m_endianness);
+  WriteToSink(writer, m_positionsOffset);
+  WriteToSink(writer, m_dataOffset);
+  WriteToSink(writer, m_endOffset);
+}
+
+bool BuildingsTable::Header::IsValid() const
+{
+  if (m_endianness > 1)
+  {
+    LOG(LERROR, ("Wrong endianness:", m_endianness));
+    return false;
+  }
+  if (m_positionsOffset < sizeof(Header))
+  {
+    LOG(LERROR, ("Positions before header:", m_positionsOffset, sizeof(Header)));
+    return false;
+  }
+  if (m_dataOffset < m_positionsOffset)
+  {
+    LOG(LERROR, ("Data before positions:", m_dataOffset, m_positionsOffset));
+    return false;
+  }
+  if (m_endOffset < m_dataOffset)
+  {
+    LOG(LERROR, ("End of section before data:", m_endOffset, m_dataOffset));
+    return false;
+  }
+  return true;
+}
+
+// BuildingsTable ----------------------------------------------------------------------------------
+BuildingsTable::BuildingsTable(Reader & reader, serial::CodingParams const & codingParams)
+  : m_reader(reader), m_codingParams(codingParams)
+{
+}
+
+BuildingsTable::~BuildingsTable() = default;
+
+bool BuildingsTable::Get(uint32_t id, Building & building)
+{
+  if (id >= m_ids.size() || !m_ids[id])
+    return false;
+  uint32_t const rank = static_cast<uint32_t>(m_ids.rank(id));
+
+  auto const & block = GetBlock(rank / kBlockSize);
+  uint32_t const offset = rank % kBlockSize;
+  if (offset >= block.size())
+    return false;
+
+  building = block[offset];
+  return true;
+}
+
+// static
+unique_ptr<BuildingsTable> BuildingsTable::Load(Reader & reader,
+                                                serial::CodingParams const & codingParams)
+{
+  uint16_t const version = ReadPrimitiveFromPos<uint16_t>(reader, 0 /* pos */);
+  if (version != 0)
+    return unique_ptr<BuildingsTable>();
+
+  unique_ptr<BuildingsTable> table(new BuildingsTable(reader, codingParams));
+  if (!table->Init())
+    return unique_ptr<BuildingsTable>();
+  return table;
+}
+
+bool BuildingsTable::Init()
+{
+  m_header.Read(m_reader);
+
+  if (!m_header.IsValid())
+    return false;
+
+  bool const isHostBigEndian = IsBigEndian();
+  bool const isDataBigEndian = m_header.m_endianness == 1;
+  bool const endiannesMismatch = isHostBigEndian != isDataBigEndian;
+
+  {
+    uint32_t const idsSize = m_header.m_positionsOffset - sizeof(m_header);
+    vector<uint8_t> data(idsSize);
+    m_reader.Read(sizeof(m_header), data.data(), data.size());
+    m_idsRegion = make_unique<CopiedMemoryRegion>(move(data));
+    EndiannessAwareMap(endiannesMismatch, *m_idsRegion, m_ids);
+  }
+
+  {
+    uint32_t const positionsSize = m_header.m_dataOffset - m_header.m_positionsOffset;
+    vector<uint8_t> data(positionsSize);
+    m_reader.Read(m_header.m_positionsOffset, data.data(), data.size());
+    m_positionsRegion = make_unique<CopiedMemoryRegion>(move(data));
+    EndiannessAwareMap(endiannesMismatch, *m_positionsRegion, m_positions);
+  }
+
+  return true;
+}
+
+vector<BuildingsTable::Building> const & BuildingsTable::GetBlock(uint32_t base)
+{
+  auto & block = m_cache[base];
+  if (!block.empty())
+    return block;
+
+  auto const start = m_positions.select(base);
+  auto const end = base + 1 < m_positions.num_ones()
+                       ? m_positions.select(base + 1)
+                       : m_header.m_endOffset - m_header.m_dataOffset;
+
+  vector<uint8_t> data(end - start);
+  m_reader.Read(m_header.m_dataOffset + start, data.data(), data.size());
+
+  MemReader mreader(data.data(), data.size());
+  NonOwningReaderSource msource(mreader);
+
+  auto const coordBits = m_codingParams.GetCoordBits();
+  m2::PointU prev = m_codingParams.GetBasePoint();
+  string houseNumber;
+  for (size_t i = 0; i < kBlockSize && msource.Size() > 0; ++i)
+  {
+    block.emplace_back();
+    auto & building = block.back();
+
+    auto const center = DecodeDelta(ReadVarUint<uint64_t>(msource), prev);
+    building.m_center = PointU2PointD(center, coordBits);
+    prev = center;
+
+    auto const flags = ReadPrimitiveFromSource<uint8_t>(msource);
+    if (flags & kHasRect)
+    {
+      auto const min = DecodeDelta(ReadVarUint<uint64_t>(msource), center);
+      auto const max = DecodeDelta(ReadVarUint<uint64_t>(msource), center);
+      building.m_rect = m2::RectD(PointU2PointD(min, coordBits), PointU2PointD(max, coordBits));
+    }
+
+    auto const streetId = ReadVarUint<uint32_t>(msource);
+    if (streetId != 0)
+      building.m_streetId = streetId - 1;
+
+    houseNumber.resize(ReadVarUint<uint32_t>(msource));
+    if (!houseNumber.empty())
+      msource.Read(&houseNumber[0], houseNumber.size());
+    building.m_houseNumber = strings::MakeUniString(houseNumber);
+  }
+
+  return block;
+}
+
+// BuildingsTableBuilder ---------------------------------------------------------------------------
+void BuildingsTableBuilder::Put(uint32_t featureId, BuildingsTable::Building const & building)
+{
+  if (!m_ids.empty())
+    CHECK_LESS(m_ids.back(), featureId, ());
+
+  auto const coordBits = m_codingParams.GetCoordBits();
+
+  Entry entry;
+  entry.m_center = PointD2PointU(building.m_center, coordBits);
+  if (building.m_rect.IsValid())
+  {
+    entry.m_hasRect = true;
+    entry.m_min = PointD2PointU(building.m_rect.LeftBottom(), coordBits);
+    entry.m_max = PointD2PointU(building.m_rect.RightTop(), coordBits);
+  }
+  entry.m_houseNumber = strings::ToUtf8(building.m_houseNumber);
+  entry.m_streetId = building.m_streetId;
+
+  m_entries.push_back(move(entry));
+  m_ids.push_back(featureId);
+}
+
+void BuildingsTableBuilder::Freeze(Writer & writer) const
+{
+  BuildingsTable::Header header;
+  header.m_endianness = IsBigEndian() ? 1 : 0;
+
+  auto const startOffset = writer.Pos();
+  header.Write(writer);
+
+  {
+    uint64_t const numBits = m_ids.empty() ? 0 : m_ids.back() + 1;
+
+    succinct::bit_vector_builder builder(numBits);
+    for (auto const & id : m_ids)
+      builder.set(id, true);
+
+    coding::FreezeVisitor<Writer> visitor(writer);
+    succinct::rs_bit_vector(&builder).map(visitor);
+  }
+
+  vector<uint32_t> positions;
+  vector<uint8_t> data;
+
+  {
+    MemWriter<vector<uint8_t>> writer(data);
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+      if (i % BuildingsTable::kBlockSize == 0)
+        positions.push_back(static_cast<uint32_t>(data.size()));
+
+      auto const & entry = m_entries[i];
+      m2::PointU const prev = i % BuildingsTable::kBlockSize == 0 ? m_codingParams.GetBasePoint()
+                                                                  : m_entries[i - 1].m_center;
+      WriteVarUint(writer, EncodeDelta(entry.m_center, prev));
+
+      WriteToSink(writer, entry.m_hasRect ? kHasRect : uint8_t(0));
+      if (entry.m_hasRect)
+      {
+        WriteVarUint(writer, EncodeDelta(entry.m_min, entry.m_center));
+        WriteVarUint(writer, EncodeDelta(entry.m_max, entry.m_center));
+      }
+
+      WriteVarUint(writer, entry.m_streetId == BuildingsTable::kInvalidStreetId
+                               ? uint32_t(0)
+                               : entry.m_streetId + 1);
+
+      WriteVarUint(writer, static_cast<uint32_t>(entry.m_houseNumber.size()));
+      writer.Write(entry.m_houseNumber.data(), entry.m_houseNumber.size());
+    }
+  }
+
+  {
+    succinct::elias_fano::elias_fano_builder builder(
+        positions.empty() ? 0 : positions.back() + 1, positions.size());
+    for (auto const & position : positions)
+      builder.push_back(position);
+
+    header.m_positionsOffset = base::checked_cast<uint32_t>(writer.Pos() - startOffset);
+    coding::FreezeVisitor<Writer> visitor(writer);
+    succinct::elias_fano(&builder).map(visitor);
+  }
+
+  {
+    header.m_dataOffset = base::checked_cast<uint32_t>(writer.Pos() - startOffset);
+    writer.Write(data.data(), data.size());
+    header.m_endOffset = base::checked_cast<uint32_t>(writer.Pos() - startOffset);
+  }
+
+  auto const endOffset = writer.Pos();
+
+  writer.Seek(startOffset);
+  header.Write(writer);
+  writer.Seek(endOffset);
+}
+}  // namespace search
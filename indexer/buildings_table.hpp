@@ -0,0 +1,154 @@
+#pragma once
+
+#include "indexer/coding_params.hpp"
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+
+#include "base/macros.hpp"
+#include "base/string_utils.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/limits.hpp"
+#include "std/string.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/unordered_map.hpp"
+#include "std/vector.hpp"
+
+#include "3party/succinct/elias_fano.hpp"
+#include "3party/succinct/rs_bit_vector.hpp"
+
+class CopiedMemoryRegion;
+class Reader;
+class Writer;
+
+namespace search
+{
+// A wrapper class around serialized buildings-table. The table keeps
+// for each building of the mwm everything search needs to match the
+// building by house number and street, so that buildings can be
+// matched without loading of features.
+//
+// The table has the following format:
+//
+// File offset (bytes)  Field name          Field size (bytes)
+// 0                    version             2
+// 2                    endianness          2
+// 4                    positions offset    4
+// 8                    data offset         4
+// 12                   end of section      4
+// 16                   identifiers table   positions offset - 16
+// positions offset     positions table     data offset - positions offset
+// data offset          data blocks         end of section - data offset
+//
+// Version, endianness and all offsets are stored in little-endian
+// format. Identifiers and positions tables are stored in the native
+// endianness, they are the same as in CentersTable.
+//
+// Each data block (with the exception of the last one) contains
+// kBlockSize consecutive buildings. A building is encoded as:
+// * varuint delta of the center from the previous center in the block,
+//   the first center is predicted by the base point;
+// * flags byte;
+// * if kHasRect flag is set, two varuint deltas of the limit rect
+//   corners from the center;
+// * varuint street id + 1, or 0 when there is no street;
+// * varuint length of the house number and utf8 house number.
+class BuildingsTable
+{
+public:
+  static uint32_t const kBlockSize = 64;
+  static uint32_t const kInvalidStreetId = numeric_limits<uint32_t>::max();
+
+  struct Building
+  {
+    // Center of the building computed by the best geometry.
+    m2::PointD m_center;
+
+    // Limit rect of an area building, empty for point buildings.
+    m2::RectD m_rect;
+
+    strings::UniString m_houseNumber;
+
+    // Id of the street feature the building is located on, or
+    // kInvalidStreetId.
+    uint32_t m_streetId = kInvalidStreetId;
+  };
+
+  struct Header
+  {
+    void Read(Reader & reader);
+    void Write(Writer & writer);
+    bool IsValid() const;
+
+    uint16_t m_version = 0;
+    uint16_t m_endianness = 0;
+    uint32_t m_positionsOffset = 0;
+    uint32_t m_dataOffset = 0;
+    uint32_t m_endOffset = 0;
+  };
+
+  static_assert(sizeof(Header) == 16, "Wrong header size");
+
+  ~BuildingsTable();
+
+  // Tries to get |building| identified by |id|.  Returns false if
+  // table does not have entry for the feature.
+  WARN_UNUSED_RESULT bool Get(uint32_t id, Building & building);
+
+  // Loads BuildingsTable instance. Note that |reader| must be alive
+  // until the destruction of loaded table. Returns nullptr if
+  // BuildingsTable can't be loaded.
+  static unique_ptr<BuildingsTable> Load(Reader & reader,
+                                         serial::CodingParams const & codingParams);
+
+private:
+  BuildingsTable(Reader & reader, serial::CodingParams const & codingParams);
+
+  bool Init();
+
+  vector<Building> const & GetBlock(uint32_t base);
+
+  Header m_header;
+  Reader & m_reader;
+  serial::CodingParams const m_codingParams;
+
+  unique_ptr<CopiedMemoryRegion> m_idsRegion;
+  unique_ptr<CopiedMemoryRegion> m_positionsRegion;
+
+  succinct::rs_bit_vector m_ids;
+  succinct::elias_fano m_positions;
+
+  unordered_map<uint32_t, vector<Building>> m_cache;
+
+  DISALLOW_COPY_AND_MOVE(BuildingsTable);
+};
+
+class BuildingsTableBuilder
+{
+public:
+  inline void SetCodingParams(serial::CodingParams const & codingParams)
+  {
+    m_codingParams = codingParams;
+  }
+
+  void Put(uint32_t featureId, BuildingsTable::Building const & building);
+  void Freeze(Writer & writer) const;
+
+private:
+  struct Entry
+  {
+    m2::PointU m_center;
+    bool m_hasRect = false;
+    m2::PointU m_min;
+    m2::PointU m_max;
+    string m_houseNumber;
+    uint32_t m_streetId = BuildingsTable::kInvalidStreetId;
+  };
+
+  serial::CodingParams m_codingParams;
+
+  vector<Entry> m_entries;
+  vector<uint32_t> m_ids;
+};
+}  // namespace search
@@ -425,12 +425,101 @@ uint32_t Classificator::GetTypeByReadableObjectName(string const & name) const
 void Classificator::ReadTypesMapping(istream & s)
 {
   m_mapping.Load(s);
+  ResetDrawRules();
 }
 
+// static
+int constexpr Classificator::DrawRules::kScalesCount;
+// static
+int constexpr Classificator::DrawRules::kGeomTypesCount;
+
+Classificator::Classificator() : m_root("world") { ResetDrawRules(); }
+
 void Classificator::Clear()
 {
   ClassifObject("world").Swap(m_root);
   m_mapping.Clear();
+  ResetDrawRules();
+}
+
+void Classificator::ResetDrawRules() { m_drawRules = make_unique<DrawRules>(); }
+
+Classificator::DrawRules const & Classificator::GetDrawRules() const
+{
+  call_once(m_drawRules->m_built, &Classificator::BuildDrawRules, this);
+  return *m_drawRules;
+}
+
+void Classificator::BuildDrawRules() const
+{
+  static_assert(DrawRules::kScalesCount <= 32, "Scales must fit into the mask");
+
+  DrawRules & rules = *m_drawRules;
+  uint32_t const count = m_mapping.GetSize();
+  rules.m_offsets.reserve(count * DrawRules::kScalesCount * DrawRules::kGeomTypesCount + 1);
+  rules.m_offsets.push_back(0);
+  rules.m_drawableScales.resize(count, 0);
+
+  drule::KeysT keys;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    ClassifObject const * p = GetObject(m_mapping.GetType(i));
+    for (int scale = 0; scale < DrawRules::kScalesCount; ++scale)
+    {
+      if (p != &m_root && p->IsDrawable(scale))
+        rules.m_drawableScales[i] |= uint32_t(1) << scale;
+
+      for (int ft = 0; ft < DrawRules::kGeomTypesCount; ++ft)
+      {
+        keys.clear();
+        if (p != &m_root)
+          p->GetSuitable(scale, static_cast<feature::EGeomType>(ft), keys);
+        rules.m_keys.insert(rules.m_keys.end(), keys.begin(), keys.end());
+        rules.m_offsets.push_back(static_cast<uint32_t>(rules.m_keys.size()));
+      }
+    }
+  }
+  rules.m_keys.shrink_to_fit();
+}
+
+void Classificator::GetSuitable(uint32_t type, int scale, feature::EGeomType ft,
+                                drule::KeysT & keys) const
+{
+  ASSERT(ft >= 0 && ft < DrawRules::kGeomTypesCount, ());
+  ASSERT(scale >= 0 && scale < DrawRules::kScalesCount, (scale));
+
+  uint32_t index;
+  if (!m_mapping.FindIndex(type, index))
+  {
+    ClassifObject const * p = GetObject(type);
+    if (p != &m_root)
+      p->GetSuitable(scale, ft, keys);
+    return;
+  }
+
+  DrawRules const & rules = GetDrawRules();
+  size_t const cell = (index * DrawRules::kScalesCount + scale) * DrawRules::kGeomTypesCount + ft;
+  keys.append(rules.m_keys.begin() + rules.m_offsets[cell],
+              rules.m_keys.begin() + rules.m_offsets[cell + 1]);
+}
+
+uint32_t Classificator::GetDrawableScales(uint32_t type) const
+{
+  uint32_t index;
+  if (m_mapping.FindIndex(type, index))
+    return GetDrawRules().m_drawableScales[index];
+
+  ClassifObject const * p = GetObject(type);
+  if (p == &m_root)
+    return 0;
+
+  uint32_t drawableScales = 0;
+  for (int scale = 0; scale < DrawRules::kScalesCount; ++scale)
+  {
+    if (p->IsDrawable(scale))
+      drawableScales |= uint32_t(1) << scale;
+  }
+  return drawableScales;
 }
 
 string Classificator::GetReadableObjectName(uint32_t type) const
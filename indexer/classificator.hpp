@@ -9,8 +9,10 @@
 #include "std/bitset.hpp"
 #include "std/initializer_list.hpp"
 #include "std/iostream.hpp"
+#include "std/mutex.hpp"
 #include "std/noncopyable.hpp"
 #include "std/string.hpp"
+#include "std/unique_ptr.hpp"
 #include "std/vector.hpp"
 
 class ClassifObject;
@@ -161,10 +163,31 @@ class Classificator : private noncopyable
 
   uint32_t m_coastType;
 
+  /// Drawing rules of all types with index, flattened to avoid walks through the tree
+  /// for every type of every drawn feature.
+  struct DrawRules
+  {
+    static int constexpr kScalesCount = scales::UPPER_STYLE_SCALE + 1;
+    static int constexpr kGeomTypesCount = 3;
+
+    /// Keys of the cell (index of type, scale, geometry type) are in range
+    /// [m_offsets[cell], m_offsets[cell + 1]) of m_keys.
+    vector<uint32_t> m_offsets;
+    vector<drule::Key> m_keys;
+    /// Masks of scales on which types are drawable, by index of type.
+    vector<uint32_t> m_drawableScales;
+
+    once_flag m_built;
+  };
+  mutable unique_ptr<DrawRules> m_drawRules;
+
   static ClassifObject * AddV(ClassifObject * parent, string const & key, string const & value);
 
+  DrawRules const & GetDrawRules() const;
+  void BuildDrawRules() const;
+
 public:
-  Classificator() : m_root("world") {}
+  Classificator();
 
   ClassifObject * Add(ClassifObject * parent, string const & key, string const & value);
 
@@ -196,10 +219,25 @@ public:
 
   uint32_t GetIndexForType(uint32_t t) const { return m_mapping.GetIndex(t); }
   uint32_t GetTypeForIndex(uint32_t i) const { return m_mapping.GetType(i); }
+  /// Same as GetIndexForType() but returns false for types which have no index.
+  bool FindIndexForType(uint32_t t, uint32_t & i) const { return m_mapping.FindIndex(t, i); }
+  /// Indices of types are in range [0, GetTypesCount()).
+  uint32_t GetTypesCount() const { return m_mapping.GetSize(); }
   bool IsTypeValid(uint32_t t) const { return m_mapping.HasIndex(t); }
 
   inline uint32_t GetCoastType() const { return m_coastType; }
 
+  /// @name Drawing rules of types.
+  /// Rules of types with index are taken from a table which is built on first use.
+  //@{
+  /// Same as ClassifObject::GetSuitable() for the object of |type|.
+  void GetSuitable(uint32_t type, int scale, feature::EGeomType ft, drule::KeysT & keys) const;
+  /// @return Mask of scales on which |type| is drawable, see ClassifObject::IsDrawable().
+  uint32_t GetDrawableScales(uint32_t type) const;
+  /// Must be called when drawing rules of objects are changed.
+  void ResetDrawRules();
+  //@}
+
   /// @name used in osm2type.cpp, not for public use.
   //@{
   ClassifObject const * GetRoot() const { return &m_root; }
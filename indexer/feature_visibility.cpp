@@ -60,43 +60,15 @@ string Classificator::GetFullObjectName(uint32_t type) const
 namespace feature
 {
 
-namespace
-{
-  class DrawRuleGetter
-  {
-    int m_scale;
-    EGeomType m_ft;
-    drule::KeysT & m_keys;
-
-  public:
-    DrawRuleGetter(int scale, EGeomType ft, drule::KeysT & keys)
-      : m_scale(scale), m_ft(ft), m_keys(keys)
-    {
-    }
-
-    typedef bool ResultType;
-
-    void operator() (ClassifObject const *)
-    {
-    }
-    bool operator() (ClassifObject const * p, bool & res)
-    {
-      res = true;
-      p->GetSuitable(min(m_scale, scales::GetUpperStyleScale()), m_ft, m_keys);
-      return false;
-    }
-  };
-}
-
 pair<int, bool> GetDrawRule(TypesHolder const & types, int level,
                             drule::KeysT & keys)
 {
   ASSERT ( keys.empty(), () );
   Classificator const & c = classif();
 
-  DrawRuleGetter doRules(level, types.GetGeoType(), keys);
+  int const scale = min(level, scales::GetUpperStyleScale());
   for (uint32_t t : types)
-    (void)c.ProcessObjects(t, doRules);
+    c.GetSuitable(t, scale, types.GetGeoType(), keys);
 
   return make_pair(types.GetGeoType(), types.Has(c.GetCoastType()));
 }
@@ -108,10 +80,9 @@ void GetDrawRule(vector<uint32_t> const & types, int level, int geoType,
   ASSERT ( keys.empty(), () );
   Classificator const & c = classif();
 
-  DrawRuleGetter doRules(level, EGeomType(geoType), keys);
-
+  int const scale = min(level, scales::GetUpperStyleScale());
   for (uint32_t t : types)
-    (void)c.ProcessObjects(t, doRules);
+    c.GetSuitable(t, scale, EGeomType(geoType), keys);
 }
 
 void FilterRulesByRuntimeSelector(FeatureType const & f, int zoomLevel, drule::KeysT & keys)
@@ -127,27 +98,6 @@ void FilterRulesByRuntimeSelector(FeatureType const & f, int zoomLevel, drule::K
 
 namespace
 {
-  class IsDrawableChecker
-  {
-    int m_scale;
-
-  public:
-    IsDrawableChecker(int scale) : m_scale(scale) {}
-
-    typedef bool ResultType;
-
-    void operator() (ClassifObject const *) {}
-    bool operator() (ClassifObject const * p, bool & res)
-    {
-      if (p->IsDrawable(m_scale))
-      {
-        res = true;
-        return true;
-      }
-      return false;
-    }
-  };
-
   class IsDrawableLikeChecker
   {
     EGeomType m_geomType;
@@ -285,19 +235,14 @@ bool IsDrawableLike(vector<uint32_t> const & types, EGeomType geomType)
   return false;
 }
 
-bool IsDrawableForIndex(FeatureBase const & f, int level)
+namespace
 {
-  return IsDrawableForIndexGeometryOnly(f, level) && IsDrawableForIndexClassifOnly(f, level);
-}
-
-bool IsDrawableForIndexGeometryOnly(FeatureBase const & f, int level)
+bool IsDrawableForIndexGeometryOnly(FeatureBase const & f, TypesHolder const & types, int level)
 {
   Classificator const & c = classif();
 
   static uint32_t const buildingPartType = c.GetTypeByPath({"building:part"});
 
-  TypesHolder const types(f);
-
   if (types.GetGeoType() == GEOM_AREA
       && !types.Has(c.GetCoastType()) && !types.Has(buildingPartType)
       && !scales::IsGoodForLevel(level, f.GetLimitRect()))
@@ -306,18 +251,38 @@ bool IsDrawableForIndexGeometryOnly(FeatureBase const & f, int level)
   return true;
 }
 
-bool IsDrawableForIndexClassifOnly(FeatureBase const & f, int level)
+uint32_t GetDrawableScales(TypesHolder const & types)
 {
   Classificator const & c = classif();
 
+  uint32_t drawableScales = 0;
+  for (uint32_t t : types)
+    drawableScales |= c.GetDrawableScales(t);
+  return drawableScales;
+}
+
+bool IsDrawableOnScale(uint32_t drawableScales, int level)
+{
+  ASSERT(level >= 0 && level <= scales::GetUpperStyleScale(), (level));
+  return (drawableScales >> level) & 1;
+}
+}  // namespace
+
+bool IsDrawableForIndex(FeatureBase const & f, int level)
+{
   TypesHolder const types(f);
+  return IsDrawableForIndexGeometryOnly(f, types, level) &&
+         IsDrawableOnScale(GetDrawableScales(types), level);
+}
 
-  IsDrawableChecker doCheck(level);
-  for (uint32_t t : types)
-    if (c.ProcessObjects(t, doCheck))
-      return true;
+bool IsDrawableForIndexGeometryOnly(FeatureBase const & f, int level)
+{
+  return IsDrawableForIndexGeometryOnly(f, TypesHolder(f), level);
+}
 
-  return false;
+bool IsDrawableForIndexClassifOnly(FeatureBase const & f, int level)
+{
+  return IsDrawableOnScale(GetDrawableScales(TypesHolder(f)), level);
 }
 
 bool RemoveNoDrawableTypes(vector<uint32_t> & types, EGeomType geomType, bool emptyName)
@@ -352,9 +317,16 @@ int GetMinDrawableScale(FeatureBase const & f)
 {
   int const upBound = scales::GetUpperStyleScale();
 
+  TypesHolder const types(f);
+  uint32_t const drawableScales = GetDrawableScales(types);
   for (int level = 0; level <= upBound; ++level)
-    if (IsDrawableForIndex(f, level))
+  {
+    if (IsDrawableOnScale(drawableScales, level) &&
+        IsDrawableForIndexGeometryOnly(f, types, level))
+    {
       return level;
+    }
+  }
 
   return -1;
 }
@@ -363,8 +335,9 @@ int GetMinDrawableScaleClassifOnly(FeatureBase const & f)
 {
   int const upBound = scales::GetUpperStyleScale();
 
+  uint32_t const drawableScales = GetDrawableScales(TypesHolder(f));
   for (int level = 0; level <= upBound; ++level)
-    if (IsDrawableForIndexClassifOnly(f, level))
+    if (IsDrawableOnScale(drawableScales, level))
       return level;
 
   return -1;
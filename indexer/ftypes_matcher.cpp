@@ -120,10 +120,34 @@ bool BaseChecker::IsMatched(uint32_t type) const
   return (find(m_types.begin(), m_types.end(), PrepareToMatch(type, m_level)) != m_types.end());
 }
 
+// static
+size_t constexpr BaseChecker::kMaxTypesToScan;
+
+bool BaseChecker::IsMatchedByIndex(uint32_t type) const
+{
+  if (!m_types.empty() && m_types.size() <= kMaxTypesToScan)
+    return IsMatched(type);
+
+  call_once(m_compiled, &BaseChecker::Compile, this);
+
+  uint32_t index;
+  if (classif().FindIndexForType(type, index) && index < m_matched.size())
+    return m_matched[index];
+  return IsMatched(type);
+}
+
+void BaseChecker::Compile() const
+{
+  Classificator const & c = classif();
+  m_matched.resize(c.GetTypesCount());
+  for (uint32_t i = 0; i < m_matched.size(); ++i)
+    m_matched[i] = IsMatched(c.GetTypeForIndex(i));
+}
+
 bool BaseChecker::operator()(feature::TypesHolder const & types) const
 {
   for (uint32_t t : types)
-    if (IsMatched(t))
+    if (IsMatchedByIndex(t))
       return true;
 
   return false;
@@ -138,12 +162,60 @@ bool BaseChecker::operator()(vector<uint32_t> const & types) const
 {
   for (size_t i = 0; i < types.size(); ++i)
   {
-    if (IsMatched(types[i]))
+    if (IsMatchedByIndex(types[i]))
       return true;
   }
   return false;
 }
 
+// static
+size_t constexpr MultiChecker::kMaxCheckers;
+
+MultiChecker::MultiChecker(vector<BaseChecker const *> const & checkers) : m_checkers(checkers)
+{
+  CHECK_LESS_OR_EQUAL(m_checkers.size(), kMaxCheckers, ());
+
+  Classificator const & c = classif();
+  m_masks.resize(c.GetTypesCount());
+  for (uint32_t i = 0; i < m_masks.size(); ++i)
+  {
+    uint32_t const type = c.GetTypeForIndex(i);
+    for (size_t j = 0; j < m_checkers.size(); ++j)
+    {
+      if (m_checkers[j]->IsMatched(type))
+        m_masks[i] |= uint64_t(1) << j;
+    }
+  }
+}
+
+MultiChecker::Result MultiChecker::operator()(feature::TypesHolder const & types) const
+{
+  uint64_t mask = 0;
+  for (uint32_t t : types)
+    mask |= GetMask(t);
+  return Result(mask);
+}
+
+MultiChecker::Result MultiChecker::operator()(FeatureType const & ft) const
+{
+  return this->operator()(feature::TypesHolder(ft));
+}
+
+uint64_t MultiChecker::GetMask(uint32_t type) const
+{
+  uint32_t index;
+  if (classif().FindIndexForType(type, index) && index < m_masks.size())
+    return m_masks[index];
+
+  uint64_t mask = 0;
+  for (size_t j = 0; j < m_checkers.size(); ++j)
+  {
+    if (m_checkers[j]->IsMatched(type))
+      mask |= uint64_t(1) << j;
+  }
+  return mask;
+}
+
 IsPeakChecker::IsPeakChecker()
 {
   Classificator const & c = classif();
@@ -4,8 +4,10 @@
 
 #include "std/algorithm.hpp"
 #include "std/array.hpp"
+#include "std/bitset.hpp"
 #include "std/initializer_list.hpp"
 #include "std/limits.hpp"
+#include "std/mutex.hpp"
 #include "std/string.hpp"
 #include "std/utility.hpp"
 #include "std/vector.hpp"
@@ -39,6 +41,41 @@ public:
   {
     for_each(m_types.cbegin(), m_types.cend(), forward<TFn>(fn));
   }
+
+private:
+  /// Scanning of that many types is not slower than the lookup of the index of a type.
+  static size_t constexpr kMaxTypesToScan = 16;
+
+  /// Same as IsMatched() but looks the type up in m_matched for checkers which have
+  /// many types or override IsMatched() without types.
+  bool IsMatchedByIndex(uint32_t type) const;
+  void Compile() const;
+
+  /// The i-th value is the result of IsMatched() for the type with index i in the classificator.
+  /// It's filled on first use, when m_types are filled and IsMatched() is overridden.
+  mutable vector<bool> m_matched;
+  mutable once_flag m_compiled;
+};
+
+/// Matches types against several checkers in one pass.
+class MultiChecker
+{
+public:
+  static size_t constexpr kMaxCheckers = 64;
+  using Result = bitset<kMaxCheckers>;
+
+  explicit MultiChecker(vector<BaseChecker const *> const & checkers);
+
+  /// The i-th bit of the result is set if the i-th checker matches |types|.
+  Result operator()(feature::TypesHolder const & types) const;
+  Result operator()(FeatureType const & ft) const;
+
+private:
+  uint64_t GetMask(uint32_t type) const;
+
+  vector<BaseChecker const *> m_checkers;
+  /// Masks of the checkers which match the type with index i in the classificator.
+  vector<uint64_t> m_masks;
 };
 
 class IsPeakChecker : public BaseChecker
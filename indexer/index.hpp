@@ -218,11 +218,15 @@ public:
     ForEachInIntervals(implFunctor, covering::ViewportWithLowLevels, rect, scale);
   }
 
+  // With covering::ViewportWithLowLevels |f| is called for the same
+  // features as by ForEachInRect(), and in the same order, except for
+  // obsolete features.
   template <typename F>
-  void ForEachFeatureIDInRect(F && f, m2::RectD const & rect, int scale) const
+  void ForEachFeatureIDInRect(F && f, m2::RectD const & rect, int scale,
+                              covering::CoveringMode mode = covering::LowLevelsOnly) const
   {
     ReadFeatureIndexFunctor<F> implFunctor(f);
-    ForEachInIntervals(implFunctor, covering::LowLevelsOnly, rect, scale);
+    ForEachInIntervals(implFunctor, mode, rect, scale);
   }
 
   template <typename F>
@@ -0,0 +1,87 @@
+#include "testing/testing.hpp"
+
+#include "indexer/buildings_table.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "geometry/mercator.hpp"
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+
+#include "base/string_utils.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+using namespace search;
+
+namespace
+{
+using TBuffer = vector<uint8_t>;
+
+UNIT_TEST(BuildingsTable_Smoke)
+{
+  serial::CodingParams codingParams;
+
+  // Buildings span several blocks of the table.
+  vector<pair<uint32_t, BuildingsTable::Building>> buildings;
+  for (uint32_t i = 0; i < 3 * BuildingsTable::kBlockSize; ++i)
+  {
+    BuildingsTable::Building building;
+    building.m_center = m2::PointD(0.001 * i, -0.002 * i);
+    if (i % 2 == 0)
+    {
+      building.m_rect = MercatorBounds::RectByCenterXYAndSizeInMeters(building.m_center, 20.0);
+      building.m_streetId = 1000 + i;
+    }
+    if (i % 3 != 0)
+      building.m_houseNumber = strings::MakeUniString(strings::to_string(i) + "к1");
+    buildings.emplace_back(2 * i + 1, building);
+  }
+
+  TBuffer buffer;
+  {
+    BuildingsTableBuilder builder;
+
+    builder.SetCodingParams(codingParams);
+    for (auto const & building : buildings)
+      builder.Put(building.first, building.second);
+
+    MemWriter<TBuffer> writer(buffer);
+    builder.Freeze(writer);
+  }
+
+  MemReader reader(buffer.data(), buffer.size());
+  auto table = BuildingsTable::Load(reader, codingParams);
+  TEST(table.get(), ());
+
+  BuildingsTable::Building actual;
+  TEST(!table->Get(0, actual), ());
+  TEST(!table->Get(2 * static_cast<uint32_t>(buildings.size()) + 1, actual), ());
+
+  for (auto const & building : buildings)
+  {
+    auto const & expected = building.second;
+
+    TEST(table->Get(building.first, actual), (building.first));
+    TEST(!table->Get(building.first + 1, actual), (building.first));
+
+    TEST_LESS_OR_EQUAL(MercatorBounds::DistanceOnEarth(actual.m_center, expected.m_center), 1,
+                       (building.first));
+    TEST_EQUAL(actual.m_rect.IsValid(), expected.m_rect.IsValid(), (building.first));
+    if (expected.m_rect.IsValid())
+    {
+      TEST_LESS_OR_EQUAL(MercatorBounds::DistanceOnEarth(actual.m_rect.LeftBottom(),
+                                                         expected.m_rect.LeftBottom()),
+                         1, (building.first));
+      TEST_LESS_OR_EQUAL(
+          MercatorBounds::DistanceOnEarth(actual.m_rect.RightTop(), expected.m_rect.RightTop()), 1,
+          (building.first));
+    }
+    TEST_EQUAL(actual.m_houseNumber, expected.m_houseNumber, (building.first));
+    TEST_EQUAL(actual.m_streetId, expected.m_streetId, (building.first));
+  }
+}
+}  // namespace
@@ -5,6 +5,7 @@
 #include "indexer/index.hpp"
 #include "indexer/classificator.hpp"
 #include "indexer/classificator_loader.hpp"
+#include "indexer/feature_data.hpp"
 
 #include "base/logging.hpp"
 
@@ -159,3 +160,40 @@ UNIT_TEST(GetHighwayClassTest)
   types3.Add(c.GetTypeByPath({"highway"}));
   TEST_EQUAL(ftypes::GetHighwayClass(types3), ftypes::HighwayClass::Error, ());
 }
+
+UNIT_TEST(MultiChecker)
+{
+  classificator::Load();
+
+  Classificator const & c = classif();
+
+  vector<ftypes::BaseChecker const *> const checkers = {
+      &ftypes::IsStreetChecker::Instance(), &ftypes::IsBridgeChecker::Instance(),
+      &ftypes::IsTunnelChecker::Instance(), &ftypes::IsBuildingChecker::Instance(),
+      &ftypes::IsAddressObjectChecker::Instance(), &ftypes::IsInvisibleIndexedChecker::Instance()};
+  ftypes::MultiChecker const multiChecker(checkers);
+
+  for (uint32_t i = 0; i < c.GetTypesCount(); ++i)
+  {
+    uint32_t const type = c.GetTypeForIndex(i);
+    feature::TypesHolder types;
+    types.Add(type);
+
+    auto const result = multiChecker(types);
+    for (size_t j = 0; j < checkers.size(); ++j)
+    {
+      bool const matched = checkers[j]->IsMatched(type);
+      TEST_EQUAL(result[j], matched, (c.GetReadableObjectName(type), j));
+      TEST_EQUAL((*checkers[j])(types), matched, (c.GetReadableObjectName(type), j));
+    }
+  }
+
+  feature::TypesHolder types;
+  types.Add(c.GetTypeByPath({"highway", "trunk", "bridge"}));
+  types.Add(c.GetTypeByPath({"building"}));
+  auto const result = multiChecker(types);
+  TEST(result[0], ());
+  TEST(result[1], ());
+  TEST(!result[2], ());
+  TEST(result[3], ());
+}
@@ -28,6 +28,7 @@ HEADERS += \
 
 SOURCES += \
     ../../testing/testingmain.cpp \
+    buildings_table_test.cpp \
     categories_test.cpp \
     cell_coverer_test.cpp \
     cell_id_test.cpp \
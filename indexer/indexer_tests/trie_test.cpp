@@ -6,12 +6,18 @@
 
 #include "coding/byte_stream.hpp"
 #include "coding/reader.hpp"
+#include "coding/reader_wrapper.hpp"
 #include "coding/write_to_sink.hpp"
 
+#include "base/dfa_helpers.hpp"
+#include "base/levenshtein_dfa.hpp"
 #include "base/logging.hpp"
+#include "base/timer.hpp"
 
 #include "std/algorithm.hpp"
 #include "std/cstring.hpp"
+#include "std/queue.hpp"
+#include "std/random.hpp"
 #include "std/string.hpp"
 #include "std/type_traits.hpp"
 #include "std/utility.hpp"
@@ -108,6 +114,40 @@ public:
 private:
   vector<TValue> m_values;
 };
+
+using TKey = buffer_vector<trie::TrieChar, 8>;
+using TNodeReader =
+    trie::NodeReader<MemReader, ValueList<uint32_t>, SingleValueSerializer<uint32_t>>;
+
+template <typename TF, typename TString>
+void ForEachRef(TNodeReader & reader, trie::NodePosition const & position, TF && f,
+                TString const & s)
+{
+  auto const & node = reader.Read(position);
+  node.m_valueList.ForEach([&f, &s](uint32_t value) { f(s, value); });
+
+  // The node may be invalidated by reading its children.
+  vector<pair<trie::NodePosition, TString>> children;
+  for (size_t i = 0; i < node.m_edge.size(); ++i)
+  {
+    TString s1(s);
+    s1.insert(s1.end(), node.m_edge[i].m_label.begin(), node.m_edge[i].m_label.end());
+    children.emplace_back(node.GetChild(i), s1);
+  }
+
+  for (auto const & child : children)
+    ForEachRef(reader, child.first, f, child.second);
+}
+
+vector<uint8_t> BuildTrie(vector<pair<TKey, uint32_t>> const & v)
+{
+  vector<uint8_t> buf;
+  PushBackByteSink<vector<uint8_t>> sink(buf);
+  trie::Build<PushBackByteSink<vector<uint8_t>>, TKey, ValueList<uint32_t>,
+              SingleValueSerializer<uint32_t>>(sink, SingleValueSerializer<uint32_t>(), v);
+  reverse(buf.begin(), buf.end());
+  return buf;
+}
 }  //  namespace
 
 #define ZENC bits::ZigZagEncode
@@ -183,7 +223,6 @@ UNIT_TEST(TrieBuilder_Build)
     {
       for (int i2 = i1; i2 < count; ++i2)
       {
-        using TKey = buffer_vector<trie::TrieChar, 8>;
         using TValue = uint32_t;
         using TKeyValuePair = pair<TKey, TValue>;
 
@@ -219,7 +258,132 @@ UNIT_TEST(TrieBuilder_Build)
         trie::ForEachRef(*root, addKeyValuePair, TKey());
         sort(res.begin(), res.end());
         TEST_EQUAL(v, res, ());
+
+        res.clear();
+        TNodeReader reader(memReader, serializer);
+        ForEachRef(reader, reader.GetRoot(), addKeyValuePair, TKey());
+        sort(res.begin(), res.end());
+        TEST_EQUAL(v, res, ());
+      }
+    }
+  }
+}
+
+UNIT_TEST(TrieNodeReader_LargeNodes)
+{
+  vector<pair<TKey, uint32_t>> v;
+  TKey const key({'a', 'b'});
+  // Values of the node don't fit into the first read.
+  for (uint32_t i = 0; i < 1000; ++i)
+    v.emplace_back(key, i);
+  for (char c = 'a'; c <= 'z'; ++c)
+    v.emplace_back(TKey({'a', 'b', static_cast<trie::TrieChar>(c)}), c);
+  sort(v.begin(), v.end());
+
+  vector<uint8_t> const buf = BuildTrie(v);
+  TNodeReader reader(MemReader(buf.data(), buf.size()), SingleValueSerializer<uint32_t>());
+
+  vector<pair<TKey, uint32_t>> res;
+  ForEachRef(reader, reader.GetRoot(),
+             [&res](TKey const & k, uint32_t value) { res.emplace_back(k, value); }, TKey());
+  sort(res.begin(), res.end());
+  TEST_EQUAL(v, res, ());
+}
+
+// Compares fuzzy matching over the trie by iterators, which is how search
+// retrieval used to traverse the search index, with matching by NodeReader.
+UNIT_TEST(TrieNodeReader_LevenshteinBenchmark)
+{
+  using TIterator = trie::Iterator<ValueList<uint32_t>>;
+
+  size_t const kNumWords = 50000;
+  size_t const kNumQueries = 100;
+
+  mt19937 rng(0);
+  vector<pair<TKey, uint32_t>> v;
+  for (uint32_t i = 0; i < kNumWords; ++i)
+  {
+    TKey key(4 + rng() % 8);
+    for (auto & c : key)
+      c = 'a' + rng() % 26;
+    v.emplace_back(key, i);
+  }
+  sort(v.begin(), v.end());
+
+  vector<uint8_t> const buf = BuildTrie(v);
+  MemReader const memReader(buf.data(), buf.size());
+  // Search index is read by the same wrapper over a polymorphic reader.
+  using TReader = SubReaderWrapper<Reader const>;
+  TReader const reader(&memReader);
+  SingleValueSerializer<uint32_t> const serializer;
+
+  vector<strings::LevenshteinDFA> dfas;
+  for (size_t i = 0; i < kNumQueries; ++i)
+  {
+    auto const & key = v[rng() % v.size()].first;
+    dfas.emplace_back(strings::UniString(key.begin(), key.end()), 1 /* prefixCharsToKeep */,
+                      2 /* maxErrors */);
+  }
+
+  vector<uint32_t> expected;
+  my::HighResTimer timer;
+  {
+    auto const root = trie::ReadTrie<TReader, ValueList<uint32_t>>(reader, serializer);
+    for (auto const & dfa : dfas)
+    {
+      queue<pair<shared_ptr<TIterator>, strings::LevenshteinDFA::Iterator>> q;
+      q.emplace(root->Clone(), dfa.Begin());
+      while (!q.empty())
+      {
+        auto const p = q.front();
+        q.pop();
+        if (p.second.Accepts())
+          p.first->m_valueList.ForEach([&expected](uint32_t value) { expected.push_back(value); });
+        for (size_t i = 0; i < p.first->m_edge.size(); ++i)
+        {
+          auto it = p.second;
+          strings::DFAMove(it, p.first->m_edge[i].m_label.begin(), p.first->m_edge[i].m_label.end());
+          if (!it.Rejects())
+            q.emplace(p.first->GoToEdge(i), it);
+        }
+      }
+    }
+  }
+  uint64_t const iteratorTime = timer.ElapsedNano();
+
+  vector<uint32_t> actual;
+  timer.Reset();
+  {
+    trie::NodeReader<TReader, ValueList<uint32_t>, SingleValueSerializer<uint32_t>> nodeReader(
+        reader, serializer);
+    vector<pair<trie::NodePosition, strings::LevenshteinDFA::Iterator>> states;
+    for (auto const & dfa : dfas)
+    {
+      states.emplace_back(nodeReader.GetRoot(), dfa.Begin());
+      while (!states.empty())
+      {
+        auto const p = states.back();
+        states.pop_back();
+        auto const & node = nodeReader.Read(p.first);
+        if (p.second.Accepts())
+          node.m_valueList.ForEach([&actual](uint32_t value) { actual.push_back(value); });
+        for (size_t i = 0; i < node.m_edge.size(); ++i)
+        {
+          auto it = p.second;
+          strings::DFAMove(it, node.m_edge[i].m_label.begin(), node.m_edge[i].m_label.end());
+          if (!it.Rejects())
+            states.emplace_back(node.GetChild(i), it);
+        }
       }
     }
   }
+  uint64_t const nodeReaderTime = timer.ElapsedNano();
+
+  LOG(LINFO, ("Fuzzy matching of", kNumQueries, "queries over", kNumWords, "words, ms. Iterator:",
+              iteratorTime / 1000000.0, "NodeReader:", nodeReaderTime / 1000000.0));
+
+  TEST(!expected.empty(), ());
+  sort(expected.begin(), expected.end());
+  sort(actual.begin(), actual.end());
+  TEST_EQUAL(expected, actual, ());
 }
@@ -8,8 +8,87 @@
 #include "base/bits.hpp"
 #include "base/macros.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/unordered_map.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
 namespace trie
 {
+namespace impl
+{
+struct EdgeInfo
+{
+  uint32_t m_offset;
+  bool m_isLeaf;
+};
+
+// Parses a node of |nodeSize| bytes from |src|. Offsets of the children relative to the beginning
+// of the node are stored in |edgeInfo|, the last element of which is the end of the node.
+template <typename TSource, typename TValueList, typename TSerializer, typename TEdges,
+          typename TEdgeInfo>
+void ParseNode(TSource & src, uint64_t nodeSize, TrieChar baseChar, TSerializer const & serializer,
+               TValueList & valueList, TEdges & edges, TEdgeInfo & edgeInfo)
+{
+  // [1: header]: [2: min(valueCount, 3)] [6: min(childCount, 63)]
+  uint8_t const header = ReadPrimitiveFromSource<uint8_t>(src);
+  uint32_t valueCount = (header >> 6);
+  uint32_t childCount = (header & 63);
+
+  // [vu valueCount]: if valueCount in header == 3
+  if (valueCount == 3)
+    valueCount = ReadVarUint<uint32_t>(src);
+
+  // [vu childCount]: if childCount in header == 63
+  if (childCount == 63)
+    childCount = ReadVarUint<uint32_t>(src);
+
+  // [valueList]
+  valueList.Deserialize(src, valueCount, serializer);
+
+  // [childInfo] ... [childInfo]
+  edges.resize(childCount);
+  edgeInfo.resize(childCount + 1);
+  edgeInfo[0].m_offset = 0;
+  for (uint32_t i = 0; i < childCount; ++i)
+  {
+    auto & e = edges[i];
+    e.m_label.clear();
+
+    // [1: header]: [1: isLeaf] [1: isShortEdge] [6: (edgeChar0 - baseChar) or min(edgeLen-1, 63)]
+    uint8_t const header = ReadPrimitiveFromSource<uint8_t>(src);
+    edgeInfo[i].m_isLeaf = ((header & 128) != 0);
+    if (header & 64)
+      e.m_label.push_back(baseChar + bits::ZigZagDecode(header & 63U));
+    else
+    {
+      // [vu edgeLen-1]: if edgeLen-1 in header == 63
+      uint32_t edgeLen = (header & 63);
+      if (edgeLen == 63)
+        edgeLen = ReadVarUint<uint32_t>(src);
+      edgeLen += 1;
+
+      // [vi edgeChar0 - baseChar] [vi edgeChar1 - edgeChar0] ... [vi edgeCharN - edgeCharN-1]
+      e.m_label.reserve(edgeLen);
+      for (uint32_t i = 0; i < edgeLen; ++i)
+        e.m_label.push_back(baseChar += ReadVarInt<int32_t>(src));
+    }
+
+    // [child size]: if the child is not the last one
+    edgeInfo[i + 1].m_offset = edgeInfo[i].m_offset;
+    if (i != childCount - 1)
+      edgeInfo[i + 1].m_offset += ReadVarUint<uint32_t>(src);
+
+    baseChar = e.m_label[0];
+  }
+
+  uint32_t const currentOffset = static_cast<uint32_t>(src.Pos());
+  for (size_t i = 0; i < edgeInfo.size(); ++i)
+    edgeInfo[i].m_offset += currentOffset;
+  edgeInfo.back().m_offset = static_cast<uint32_t>(nodeSize);
+}
+}  // namespace impl
+
 template <class TValueList, typename TSerializer>
 class LeafIterator0 : public Iterator<TValueList>
 {
@@ -78,74 +157,146 @@ private:
   void ParseNode(TrieChar baseChar)
   {
     ReaderSource<TReader> src(m_reader);
+    impl::ParseNode(src, m_reader.Size(), baseChar, m_serializer, m_valueList, this->m_edge,
+                    m_edgeInfo);
+  }
 
-    // [1: header]: [2: min(valueCount, 3)] [6: min(childCount, 63)]
-    uint8_t const header = ReadPrimitiveFromSource<uint8_t>(src);
-    uint32_t valueCount = (header >> 6);
-    uint32_t childCount = (header & 63);
+  buffer_vector<impl::EdgeInfo, 9> m_edgeInfo;
 
-    // [vu valueCount]: if valueCount in header == 3
-    if (valueCount == 3)
-      valueCount = ReadVarUint<uint32_t>(src);
+  TReader m_reader;
+  TSerializer m_serializer;
+};
 
-    // [vu childCount]: if childCount in header == 63
-    if (childCount == 63)
-      childCount = ReadVarUint<uint32_t>(src);
+// Location of a node in the serialized trie.
+struct NodePosition
+{
+  uint64_t m_offset = 0;
+  uint64_t m_size = 0;
+  // The last char of the edge to the node, labels of the node's edges are encoded relative to it.
+  TrieChar m_baseChar = kDefaultChar;
+  uint32_t m_depth = 0;
+  bool m_isLeaf = false;
+};
 
-    // [valueList]
-    m_valueList.Deserialize(src, valueCount, m_serializer);
+// Trie node decoded by NodeReader. Unlike Iterator, a node refers to its children by positions,
+// so it can be decoded into the same object again and again.
+template <typename TValueList>
+struct DecodedNode
+{
+  NodePosition GetChild(size_t i) const
+  {
+    ASSERT_LESS(i, m_edge.size(), ());
+    NodePosition child;
+    child.m_offset = m_offset + m_edgeInfo[i].m_offset;
+    child.m_size = m_edgeInfo[i + 1].m_offset - m_edgeInfo[i].m_offset;
+    child.m_baseChar = m_edge[i].m_label.back();
+    child.m_depth = m_depth + 1;
+    child.m_isLeaf = m_edgeInfo[i].m_isLeaf;
+    return child;
+  }
 
-    // [childInfo] ... [childInfo]
-    this->m_edge.resize(childCount);
-    m_edgeInfo.resize(childCount + 1);
-    m_edgeInfo[0].m_offset = 0;
-    for (uint32_t i = 0; i < childCount; ++i)
-    {
-      typename Iterator<TValueList>::Edge & e = this->m_edge[i];
-
-      // [1: header]: [1: isLeaf] [1: isShortEdge] [6: (edgeChar0 - baseChar) or min(edgeLen-1, 63)]
-      uint8_t const header = ReadPrimitiveFromSource<uint8_t>(src);
-      m_edgeInfo[i].m_isLeaf = ((header & 128) != 0);
-      if (header & 64)
-        e.m_label.push_back(baseChar + bits::ZigZagDecode(header & 63U));
-      else
-      {
-        // [vu edgeLen-1]: if edgeLen-1 in header == 63
-        uint32_t edgeLen = (header & 63);
-        if (edgeLen == 63)
-          edgeLen = ReadVarUint<uint32_t>(src);
-        edgeLen += 1;
-
-        // [vi edgeChar0 - baseChar] [vi edgeChar1 - edgeChar0] ... [vi edgeCharN - edgeCharN-1]
-        e.m_label.reserve(edgeLen);
-        for (uint32_t i = 0; i < edgeLen; ++i)
-          e.m_label.push_back(baseChar += ReadVarInt<int32_t>(src));
-      }
+  buffer_vector<typename Iterator<TValueList>::Edge, 8> m_edge;
+  TValueList m_valueList;
+
+  buffer_vector<impl::EdgeInfo, 9> m_edgeInfo;
+  uint64_t m_offset = 0;
+  uint32_t m_depth = 0;
+};
+
+// Reads nodes of the trie at arbitrary positions without creating iterators and subreaders.
+// The bytes of a node are read by a single call to |reader| into a buffer which is reused
+// for all nodes. Nodes of the upper levels, which are visited by almost every traversal,
+// are decoded once and kept for the lifetime of the reader.
+//
+// *NOTE* This class is not thread-safe.
+template <typename TReader, typename TValueList, typename TSerializer>
+class NodeReader
+{
+public:
+  using TNode = DecodedNode<TValueList>;
+  using TValue = typename TValueList::TValue;
+
+  // Nodes with smaller depth are cached.
+  static uint32_t constexpr kCachedDepth = 3;
+
+  NodeReader(TReader const & reader, TSerializer const & serializer)
+    : m_reader(reader), m_serializer(serializer)
+  {
+  }
 
-      // [child size]: if the child is not the last one
-      m_edgeInfo[i + 1].m_offset = m_edgeInfo[i].m_offset;
-      if (i != childCount - 1)
-        m_edgeInfo[i + 1].m_offset += ReadVarUint<uint32_t>(src);
+  NodePosition GetRoot() const
+  {
+    NodePosition root;
+    root.m_size = m_reader.Size();
+    return root;
+  }
 
-      baseChar = e.m_label[0];
+  // Returned node is valid until the next call to Read() if its depth is kCachedDepth or more,
+  // otherwise it's valid for the lifetime of the reader.
+  TNode const & Read(NodePosition const & position)
+  {
+    bool const cacheable = position.m_depth < kCachedDepth;
+    if (cacheable)
+    {
+      auto const it = m_cache.find(position.m_offset);
+      if (it != m_cache.end())
+        return it->second;
     }
 
-    uint32_t const currentOffset = static_cast<uint32_t>(src.Pos());
-    for (size_t i = 0; i < m_edgeInfo.size(); ++i)
-      m_edgeInfo[i].m_offset += currentOffset;
-    m_edgeInfo.back().m_offset = static_cast<uint32_t>(m_reader.Size());
+    Decode(position, m_node);
+    if (cacheable)
+      return m_cache.emplace(position.m_offset, move(m_node)).first->second;
+    return m_node;
   }
 
-  struct EdgeInfo
+private:
+  void Decode(NodePosition const & position, TNode & node)
   {
-    uint32_t m_offset;
-    bool m_isLeaf;
-  };
+    // The size of a node includes all its subtrees, so only the beginning of an internal node
+    // is read. The buffer is extended if the header and the values of the node don't fit.
+    uint64_t const kMinReadSize = 256;
+    uint64_t size = position.m_isLeaf ? position.m_size : min(position.m_size, kMinReadSize);
 
-  buffer_vector<EdgeInfo, 9> m_edgeInfo;
+    node.m_offset = position.m_offset;
+    node.m_depth = position.m_depth;
+    while (true)
+    {
+      if (m_buffer.size() < size)
+        m_buffer.resize(static_cast<size_t>(size));
+      m_reader.Read(position.m_offset, m_buffer.data(), static_cast<size_t>(size));
+
+      MemReaderWithExceptions reader(m_buffer.data(), static_cast<size_t>(size));
+      ReaderSource<MemReaderWithExceptions> src(reader);
+      try
+      {
+        if (position.m_isLeaf)
+        {
+          node.m_valueList.Deserialize(src, m_serializer);
+          node.m_edge.clear();
+          node.m_edgeInfo.clear();
+        }
+        else
+        {
+          impl::ParseNode(src, position.m_size, position.m_baseChar, m_serializer,
+                          node.m_valueList, node.m_edge, node.m_edgeInfo);
+        }
+        return;
+      }
+      catch (Reader::SizeException const &)
+      {
+        if (size == position.m_size)
+          throw;
+        size = min(2 * size, position.m_size);
+      }
+    }
+  }
 
   TReader m_reader;
   TSerializer m_serializer;
+
+  vector<uint8_t> m_buffer;
+  TNode m_node;
+  unordered_map<uint64_t, TNode> m_cache;
 };
 
 // Returns iterator to the root of the trie.
@@ -2,7 +2,7 @@
 #include "base/assert.hpp"
 
 #include "std/vector.hpp"
-#include "std/map.hpp"
+#include "std/unordered_map.hpp"
 #include "std/iostream.hpp"
 
 
@@ -10,7 +10,7 @@ class IndexAndTypeMapping
 {
   vector<uint32_t> m_types;
 
-  typedef map<uint32_t, uint32_t> MapT;
+  typedef unordered_map<uint32_t, uint32_t> MapT;
   MapT m_map;
 
   void Add(uint32_t ind, uint32_t type);
@@ -26,6 +26,17 @@ public:
   }
 
   uint32_t GetIndex(uint32_t t) const;
+  /// @return false if there is no index for |t|.
+  bool FindIndex(uint32_t t, uint32_t & ind) const
+  {
+    auto const it = m_map.find(t);
+    if (it == m_map.end())
+      return false;
+    ind = it->second;
+    return true;
+  }
+
+  uint32_t GetSize() const { return static_cast<uint32_t>(m_types.size()); }
 
   /// For Debug purposes only.
   bool HasIndex(uint32_t t) const { return (m_map.find(t) != m_map.end()); }
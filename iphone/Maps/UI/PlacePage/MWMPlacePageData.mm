@@ -483,7 +483,7 @@ using namespace place_page;
     NSAssert(category, @"Category can't be nullptr!");
     category->DeleteUserMark(bac.m_bookmarkIndex);
     category->NotifyChanges();
-    category->SaveToKMLFile();
+    category->SaveToFile();
 
     m_sections.erase(remove(m_sections.begin(), m_sections.end(), Sections::Bookmark));
   }
@@ -1,8 +1,17 @@
 #include "testing/testing.hpp"
 
+#include "local_ads/file_helpers.hpp"
 #include "local_ads/statistics.hpp"
 
+#include "platform/platform.hpp"
+
 #include "coding/file_name_utils.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/point_to_integer.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "geometry/mercator.hpp"
 
 namespace
 {
@@ -19,6 +28,32 @@ public:
 private:
   local_ads::Statistics & m_statistics;
 };
+
+// Writes |events| of one mwm to the statistics file of the format with fixed size records.
+void WriteLegacyFile(std::string const & fileName, std::list<local_ads::Event> const & events)
+{
+  using namespace std::chrono;
+
+  std::string const folder = my::JoinFoldersToPath(GetPlatform().WritableDir(), "local_ads_stats");
+  TEST(GetPlatform().IsFileExistsByFullPath(folder) || Platform::MkDirChecked(folder), ());
+
+  FileWriter writer(my::JoinPath(folder, fileName));
+  local_ads::WriteCountryName(writer, events.front().m_countryId);
+  local_ads::WriteZigZag(writer, events.front().m_mwmVersion);
+  local_ads::WriteTimestamp<seconds>(writer, events.front().m_timestamp);
+  for (auto const & event : events)
+  {
+    WriteToSink(writer, static_cast<uint8_t>(event.m_type));
+    WriteToSink(writer, event.m_zoomLevel);
+    WriteToSink(writer, event.m_featureId);
+    WriteToSink(writer, static_cast<uint32_t>(
+                            duration_cast<seconds>(event.m_timestamp - events.front().m_timestamp)
+                                .count()));
+    auto const mercator = MercatorBounds::FromLatLon(event.m_latitude, event.m_longitude);
+    local_ads::WriteZigZag(writer, PointToInt64(mercator, POINT_COORD_BITS));
+    WriteToSink(writer, event.m_accuracyInMeters);
+  }
+}
 }  // namespace
 
 using namespace std::chrono;
@@ -162,3 +197,93 @@ UNIT_TEST(LocalAdsStatistics_Process_Complex)
   expectedResult2.push_back(local_ads::Event(events2.back()));
   TEST_EQUAL(statistics.ReadEventsForTesting("Minsk_123456.dat"), expectedResult2, ());
 }
+
+UNIT_TEST(LocalAdsStatistics_Columnar_Blocks)
+{
+  local_ads::Statistics statistics;
+  StatisticsGuard guard(statistics);
+
+  std::list<local_ads::Event> expectedResult;
+  for (size_t block = 0; block < 3; ++block)
+  {
+    std::list<local_ads::Event> events;
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+      auto const minute = static_cast<int>(block * 100 + i);
+      events.emplace_back(i % 2 == 0 ? ET::ShowPoint : ET::OpenInfo, 123456, "Moscow",
+                          (i * 7919) % 1000, 15 + i % 3, TS(minutes(minute)), 55.0 + i * 1e-3,
+                          37.0 - i * 1e-3, 10 + i);
+    }
+    std::string fileNameToRebuild;
+    TEST(statistics.WriteEventsForTesting(events, fileNameToRebuild).empty(), ());
+    TEST(fileNameToRebuild.empty(), ());
+    expectedResult.insert(expectedResult.end(), events.begin(), events.end());
+  }
+
+  TEST_EQUAL(statistics.ReadEventsForTesting("Moscow_123456.dat"), expectedResult, ());
+
+  // Fixed size records of the legacy format take 20 bytes per event.
+  uint64_t const kFixedRecordSize = 20;
+  uint64_t size = 0;
+  TEST(my::GetFileSize(my::JoinFoldersToPath({GetPlatform().WritableDir(), "local_ads_stats"},
+                                             "Moscow_123456.dat"),
+                       size),
+       ());
+  TEST_LESS(size, expectedResult.size() * kFixedRecordSize * 2 / 3, ());
+}
+
+UNIT_TEST(LocalAdsStatistics_Legacy_Format)
+{
+  local_ads::Statistics statistics;
+  StatisticsGuard guard(statistics);
+
+  std::list<local_ads::Event> events;
+  events.emplace_back(ET::ShowPoint, 123456, "Moscow", 111, 15, TS(minutes(5)), 20.0, 14.0, 20);
+  events.emplace_back(ET::OpenInfo, 123456, "Moscow", 222, 17, TS(minutes(10)), 30.0, 14.0, 20);
+
+  // The file of the format with fixed size records.
+  WriteLegacyFile("Moscow_123456.dat", events);
+  TEST_EQUAL(statistics.ReadEventsForTesting("Moscow_123456.dat"), events, ());
+
+  // Events of the legacy file are rewritten on the first writing.
+  std::list<local_ads::Event> events2;
+  events2.emplace_back(ET::ShowPoint, 123456, "Moscow", 333, 15, TS(minutes(20)), 20.0, 14.0, 20);
+  std::string fileNameToRebuild;
+  TEST(statistics.WriteEventsForTesting(events2, fileNameToRebuild).empty(), ());
+
+  std::list<local_ads::Event> expectedResult = events;
+  expectedResult.insert(expectedResult.end(), events2.begin(), events2.end());
+  TEST_EQUAL(statistics.ReadEventsForTesting("Moscow_123456.dat"), expectedResult, ());
+}
+
+
+UNIT_TEST(LocalAdsStatistics_Legacy_Interrupted)
+{
+  local_ads::Statistics statistics;
+  StatisticsGuard guard(statistics);
+
+  // Legacy files which are left after an interrupted rewriting.
+  std::list<local_ads::Event> legacyEvents;
+  legacyEvents.emplace_back(ET::ShowPoint, 123456, "Moscow", 111, 15, TS(minutes(5)), 20.0, 14.0,
+                            20);
+  legacyEvents.emplace_back(ET::OpenInfo, 123456, "Minsk", 222, 17, TS(minutes(10)), 30.0, 14.0,
+                            20);
+  WriteLegacyFile("Moscow_123456.dat.legacy", {legacyEvents.front()});
+  WriteLegacyFile("Minsk_123456.dat.legacy", {legacyEvents.back()});
+
+  std::list<local_ads::Event> events;
+  events.emplace_back(ET::ShowPoint, 123456, "Moscow", 333, 15, TS(minutes(20)), 20.0, 14.0, 20);
+  std::string fileNameToRebuild;
+  TEST(statistics.WriteEventsForTesting(events, fileNameToRebuild).empty(), ());
+
+  std::list<local_ads::Event> expectedResult = {legacyEvents.front(), events.front()};
+  TEST_EQUAL(statistics.ReadEventsForTesting("Moscow_123456.dat"), expectedResult, ());
+  expectedResult = {legacyEvents.back()};
+  TEST_EQUAL(statistics.ReadEventsForTesting("Minsk_123456.dat"), expectedResult, ());
+
+  // Legacy files are deleted after rewriting.
+  std::vector<std::string> files;
+  GetPlatform().GetFilesByExt(
+      my::JoinFoldersToPath(GetPlatform().WritableDir(), "local_ads_stats"), ".legacy", files);
+  TEST(files.empty(), (files));
+}
@@ -7,8 +7,10 @@
 
 #include "coding/file_name_utils.hpp"
 #include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
 #include "coding/point_to_integer.hpp"
 #include "coding/url_encode.hpp"
+#include "coding/varint.hpp"
 #include "coding/write_to_sink.hpp"
 
 #include "geometry/mercator.hpp"
@@ -20,6 +22,7 @@
 
 #include <functional>
 #include <sstream>
+#include <vector>
 
 #include "private.h"
 
@@ -27,6 +30,9 @@ namespace
 {
 std::string const kStatisticsFolderName = "local_ads_stats";
 std::string const kStatisticsExt = ".dat";
+// Files of the legacy format are renamed before they are rewritten in the columnar format,
+// since the rewritten files get the same names.
+std::string const kLegacyExt = ".legacy";
 
 uint64_t constexpr kMaxFilesSizeInBytes = 10 * 1024 * 1024;
 float const kEventsDisposingRate = 0.2f;
@@ -37,9 +43,30 @@ auto constexpr kDeletionPeriod = std::chrono::hours(24);
 
 std::string const kStatisticsServer = LOCAL_ADS_STATISTICS_SERVER_URL;
 
+// Files of the columnar format start with the marker and the version. Files of the legacy
+// format with fixed size records start with the name of the country, the first byte of which
+// is less than the marker.
+uint8_t const kColumnarFormatMarker = 0xFF;
+uint8_t const kColumnarFormatVersion = 1;
+
+using PackedData = local_ads::Statistics::PackedData;
+
+// Returns true for files of the columnar format.
+bool IsColumnarFormat(FileReader const & reader)
+{
+  if (reader.Size() < 2)
+    return false;
+
+  uint8_t header[2];
+  reader.Read(0, header, sizeof(header));
+  return header[0] == kColumnarFormatMarker && header[1] == kColumnarFormatVersion;
+}
+
 void WriteMetadata(FileWriter & writer, std::string const & countryId, int64_t mwmVersion,
                    local_ads::Timestamp const & ts)
 {
+  WriteToSink(writer, kColumnarFormatMarker);
+  WriteToSink(writer, kColumnarFormatVersion);
   local_ads::WriteCountryName(writer, countryId);
   local_ads::WriteZigZag(writer, mwmVersion);
   local_ads::WriteTimestamp<std::chrono::seconds>(writer, ts);
@@ -53,25 +80,114 @@ void ReadMetadata(ReaderSource<FileReader> & src, std::string & countryId, int64
   ts = local_ads::ReadTimestamp<std::chrono::seconds>(src);
 }
 
-void WritePackedData(FileWriter & writer, local_ads::Statistics::PackedData && packedData)
+// Events which are written at once are stored as a block: the number of events and
+// the columns of their fields. Events of a block are sorted by time, so the columns of
+// seconds, feature indices and coordinates are delta-encoded by varints.
+void WritePackedDataBlock(FileWriter & writer, std::vector<PackedData> const & block)
+{
+  if (block.empty())
+    return;
+
+  std::vector<uint8_t> buffer;
+  MemWriter<std::vector<uint8_t>> sink(buffer);
+  WriteVarUint(sink, static_cast<uint64_t>(block.size()));
+  for (auto const & data : block)
+    WriteToSink(sink, data.m_eventType);
+  for (auto const & data : block)
+    WriteToSink(sink, data.m_zoomLevel);
+
+  int64_t prevSeconds = 0;
+  for (auto const & data : block)
+  {
+    WriteVarInt(sink, static_cast<int64_t>(data.m_seconds) - prevSeconds);
+    prevSeconds = data.m_seconds;
+  }
+
+  int64_t prevFeatureIndex = 0;
+  for (auto const & data : block)
+  {
+    WriteVarInt(sink, static_cast<int64_t>(data.m_featureIndex) - prevFeatureIndex);
+    prevFeatureIndex = data.m_featureIndex;
+  }
+
+  int64_t prevMercator = 0;
+  for (auto const & data : block)
+  {
+    WriteVarInt(sink, data.m_mercator - prevMercator);
+    prevMercator = data.m_mercator;
+  }
+
+  for (auto const & data : block)
+    WriteVarUint(sink, static_cast<uint32_t>(data.m_accuracy));
+
+  // The block is written by a single call, so an interrupted writing can only
+  // damage the last block.
+  writer.Write(buffer.data(), buffer.size());
+}
+
+void ReadPackedDataBlock(ReaderSource<FileReader> & src, std::vector<PackedData> & block)
 {
-  WriteToSink(writer, packedData.m_eventType);
-  WriteToSink(writer, packedData.m_zoomLevel);
-  WriteToSink(writer, packedData.m_featureIndex);
-  WriteToSink(writer, packedData.m_seconds);
-  local_ads::WriteZigZag(writer, packedData.m_mercator);
-  WriteToSink(writer, packedData.m_accuracy);
+  // Every event takes at least one byte in each of six columns.
+  auto const count = ReadVarUint<uint64_t>(src);
+  if (count > src.Size() / 6)
+    MYTHROW(Reader::SizeException, (src.Pos(), count));
+
+  block.assign(static_cast<size_t>(count), PackedData());
+  for (auto & data : block)
+    data.m_eventType = ReadPrimitiveFromSource<uint8_t>(src);
+  for (auto & data : block)
+    data.m_zoomLevel = ReadPrimitiveFromSource<uint8_t>(src);
+
+  int64_t seconds = 0;
+  for (auto & data : block)
+  {
+    seconds += ReadVarInt<int64_t>(src);
+    data.m_seconds = static_cast<uint32_t>(seconds);
+  }
+
+  int64_t featureIndex = 0;
+  for (auto & data : block)
+  {
+    featureIndex += ReadVarInt<int64_t>(src);
+    data.m_featureIndex = static_cast<uint32_t>(featureIndex);
+  }
+
+  int64_t mercator = 0;
+  for (auto & data : block)
+  {
+    mercator += ReadVarInt<int64_t>(src);
+    data.m_mercator = mercator;
+  }
+
+  for (auto & data : block)
+    data.m_accuracy = static_cast<uint16_t>(ReadVarUint<uint32_t>(src));
 }
 
 template <typename ToDo>
-void ReadPackedData(ReaderSource<FileReader> & src, ToDo && toDo)
+void ReadPackedData(FileReader const & reader, ToDo && toDo)
 {
-  using PackedData = local_ads::Statistics::PackedData;
+  bool const isColumnar = IsColumnarFormat(reader);
+  ReaderSource<FileReader> src(reader);
+  if (isColumnar)
+    src.Skip(2 * sizeof(uint8_t));
 
   std::string countryId;
   int64_t mwmVersion;
   local_ads::Timestamp baseTimestamp;
   ReadMetadata(src, countryId, mwmVersion, baseTimestamp);
+
+  if (isColumnar)
+  {
+    std::vector<PackedData> block;
+    while (src.Size() > 0)
+    {
+      ReadPackedDataBlock(src, block);
+      for (auto & data : block)
+        toDo(std::move(data), countryId, mwmVersion, baseTimestamp);
+    }
+    return;
+  }
+
   while (src.Size() > 0)
   {
     PackedData data;
@@ -161,8 +277,13 @@ namespace local_ads
 {
 Statistics::~Statistics()
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
   ASSERT(!m_isRunning, ());
+  for (EventNode * node = m_events.exchange(nullptr); node != nullptr;)
+  {
+    EventNode * next = node->m_next;
+    delete node;
+    node = next;
+  }
 }
 
 void Statistics::Startup()
@@ -190,41 +311,84 @@ void Statistics::Teardown()
 
 bool Statistics::RequestEvents(std::list<Event> & events, bool & needToSend)
 {
-  std::unique_lock<std::mutex> lock(m_mutex);
-
-  bool const isTimeout = !m_condition.wait_for(lock, kSendingTimeout, [this]
   {
-    return !m_isRunning || !m_events.empty();
-  });
+    std::unique_lock<std::mutex> lock(m_mutex);
 
-  if (!m_isRunning)
-    return false;
+    bool const isTimeout = !m_condition.wait_for(lock, kSendingTimeout, [this]
+    {
+      return !m_isRunning || m_events.load(std::memory_order_acquire) != nullptr;
+    });
 
-  using namespace std::chrono;
-  needToSend = m_isFirstSending || isTimeout ||
-    (std::chrono::steady_clock::now() > (m_lastSending + kSendingTimeout));
+    if (!m_isRunning)
+      return false;
 
-  events = std::move(m_events);
-  m_events.clear();
+    using namespace std::chrono;
+    needToSend = m_isFirstSending || isTimeout ||
+      (std::chrono::steady_clock::now() > (m_lastSending + kSendingTimeout));
+  }
+
+  events = TakeEvents();
   return true;
 }
 
 void Statistics::RegisterEvent(Event && event)
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
   if (!m_isRunning)
     return;
-  m_events.push_back(std::move(event));
-  m_condition.notify_one();
+  auto * node = new EventNode(std::move(event));
+  PushEvents(node, node);
 }
 
 void Statistics::RegisterEvents(std::list<Event> && events)
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
-  if (!m_isRunning)
+  if (!m_isRunning || events.empty())
     return;
-  m_events.splice(m_events.end(), std::move(events));
-  m_condition.notify_one();
+
+  // The stack is taken in the reverse order, so the chain is linked from the last event.
+  EventNode * first = nullptr;
+  EventNode * last = nullptr;
+  for (auto & event : events)
+  {
+    auto * node = new EventNode(std::move(event));
+    node->m_next = first;
+    first = node;
+    if (last == nullptr)
+      last = node;
+  }
+  events.clear();
+  PushEvents(first, last);
+}
+
+void Statistics::PushEvents(EventNode * first, EventNode * last)
+{
+  EventNode * head = m_events.load(std::memory_order_relaxed);
+  do
+  {
+    last->m_next = head;
+  } while (!m_events.compare_exchange_weak(head, first, std::memory_order_release,
+                                           std::memory_order_relaxed));
+
+  // The thread is woken up by the first event only, the rest are taken with it. The mutex
+  // guarantees that the wake up is not lost between the check of the stack and waiting.
+  if (head == nullptr)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_condition.notify_one();
+  }
+}
+
+std::list<Event> Statistics::TakeEvents()
+{
+  std::list<Event> events;
+  EventNode * node = m_events.exchange(nullptr, std::memory_order_acquire);
+  while (node != nullptr)
+  {
+    events.push_front(std::move(node->m_event));
+    EventNode * next = node->m_next;
+    delete node;
+    node = next;
+  }
+  return events;
 }
 
 void Statistics::ThreadRoutine()
@@ -244,55 +408,50 @@ void Statistics::ThreadRoutine()
 
 std::list<Event> Statistics::WriteEvents(std::list<Event> & events, std::string & fileNameToRebuild)
 {
-  try
+  CreateDirIfNotExist();
+  if (!m_isMetadataIndexed)
   {
-    CreateDirIfNotExist();
-    if (m_metadataCache.empty())
-      IndexMetadata();
+    m_isMetadataIndexed = true;
+    IndexMetadata();
+  }
 
-    std::unique_ptr<FileWriter> writer;
+  events.sort();
 
-    events.sort();
+  std::vector<PackedData> block;
+  auto eventIt = events.begin();
+  while (eventIt != events.end())
+  {
+    // Events of an mwm are adjacent after sorting, they are written as a single block.
+    Event const & firstEvent = *eventIt;
+    MetadataKey const key = std::make_pair(firstEvent.m_countryId, firstEvent.m_mwmVersion);
+    auto it = m_metadataCache.find(key);
 
-    auto eventIt = events.begin();
+    // Get metadata.
+    bool needWriteMetadata = false;
+    if (it == m_metadataCache.end())
+    {
+      auto const timestamp =
+          GetMinTimestamp(events, firstEvent.m_countryId, firstEvent.m_mwmVersion);
+      it = m_metadataCache.emplace(key, Metadata(GetPath(firstEvent), timestamp)).first;
+      needWriteMetadata = true;
+    }
+    Metadata & metadata = it->second;
+
+    block.clear();
+    bool isOutOfDate = false;
     for (; eventIt != events.end(); ++eventIt)
     {
       Event const & event = *eventIt;
-      MetadataKey const key = std::make_pair(event.m_countryId, event.m_mwmVersion);
-      auto it = m_metadataCache.find(key);
-
-      // Get metadata.
-      Metadata metadata;
-      bool needWriteMetadata = false;
-      if (it == m_metadataCache.end())
-      {
-        metadata.m_timestamp = GetMinTimestamp(events, event.m_countryId, event.m_mwmVersion);
-        metadata.m_fileName = GetPath(event);
-        m_metadataCache[key] = metadata;
-        needWriteMetadata = true;
-      }
-      else
-      {
-        metadata = it->second;
-      }
-
-      if (writer == nullptr || writer->GetName() != metadata.m_fileName)
-        writer = my::make_unique<FileWriter>(metadata.m_fileName, FileWriter::OP_APPEND);
-
-      if (needWriteMetadata)
-        WriteMetadata(*writer, event.m_countryId, event.m_mwmVersion, metadata.m_timestamp);
+      if (event.m_countryId != key.first || event.m_mwmVersion != key.second)
+        break;
 
       // Check if timestamp is out of date. In this case we have to rebuild events package.
       using namespace std::chrono;
       int64_t const s = duration_cast<seconds>(event.m_timestamp - metadata.m_timestamp).count();
       if (s < 0 || s > kEventMaxLifetimeInSeconds)
       {
-        fileNameToRebuild = writer->GetName();
-
-        // Return unprocessed events.
-        std::list<Event> unprocessedEvents;
-        unprocessedEvents.splice(unprocessedEvents.end(), events, eventIt, events.end());
-        return unprocessedEvents;
+        isOutOfDate = true;
+        break;
       }
 
       PackedData data;
@@ -303,12 +462,27 @@ std::list<Event> Statistics::WriteEvents(std::list<Event> & events, std::string
       auto const mercatorPt = MercatorBounds::FromLatLon(event.m_latitude, event.m_longitude);
       data.m_mercator = PointToInt64(mercatorPt, POINT_COORD_BITS);
       data.m_accuracy = event.m_accuracyInMeters;
-      WritePackedData(*writer, std::move(data));
+      block.push_back(data);
+    }
+
+    {
+      FileWriter writer(metadata.m_fileName, FileWriter::OP_APPEND);
+      if (needWriteMetadata)
+        WriteMetadata(writer, key.first, key.second, metadata.m_timestamp);
+      WritePackedDataBlock(writer, block);
+    }
+    if (!my::GetFileSize(metadata.m_fileName, metadata.m_size))
+      metadata.m_size = 0;
+
+    if (isOutOfDate)
+    {
+      fileNameToRebuild = metadata.m_fileName;
+
+      // Return unprocessed events.
+      std::list<Event> unprocessedEvents;
+      unprocessedEvents.splice(unprocessedEvents.end(), events, eventIt, events.end());
+      return unprocessedEvents;
     }
-  }
-  catch (RootException const & ex)
-  {
-    LOG(LWARNING, (ex.Msg()));
   }
   return std::list<Event>();
 }
@@ -321,17 +495,7 @@ std::list<Event> Statistics::ReadEvents(std::string const & fileName) const
 
   try
   {
-    FileReader reader(fileName);
-    ReaderSource<FileReader> src(reader);
-    ReadPackedData(src, [&result](PackedData && data, std::string const & countryId,
-                                  int64_t mwmVersion, Timestamp const & baseTimestamp) {
-      auto const mercatorPt = Int64ToPoint(data.m_mercator, POINT_COORD_BITS);
-      result.emplace_back(static_cast<EventType>(data.m_eventType), mwmVersion, countryId,
-                          data.m_featureIndex, data.m_zoomLevel,
-                          baseTimestamp + std::chrono::seconds(data.m_seconds),
-                          MercatorBounds::YToLat(mercatorPt.y),
-                          MercatorBounds::XToLon(mercatorPt.x), data.m_accuracy);
-    });
+    ReadEventsFromFile(fileName, result);
   }
   catch (Reader::Exception const & ex)
   {
@@ -340,13 +504,36 @@ std::list<Event> Statistics::ReadEvents(std::string const & fileName) const
   return result;
 }
 
-void Statistics::ProcessEvents(std::list<Event> & events)
+void Statistics::ReadEventsFromFile(std::string const & fileName, std::list<Event> & events) const
+{
+  FileReader reader(fileName);
+  ReadPackedData(reader, [&events](PackedData && data, std::string const & countryId,
+                                   int64_t mwmVersion, Timestamp const & baseTimestamp) {
+    auto const mercatorPt = Int64ToPoint(data.m_mercator, POINT_COORD_BITS);
+    events.emplace_back(static_cast<EventType>(data.m_eventType), mwmVersion, countryId,
+                        data.m_featureIndex, data.m_zoomLevel,
+                        baseTimestamp + std::chrono::seconds(data.m_seconds),
+                        MercatorBounds::YToLat(mercatorPt.y),
+                        MercatorBounds::XToLon(mercatorPt.x), data.m_accuracy);
+  });
+}
+
+bool Statistics::ProcessEvents(std::list<Event> & events)
 {
   bool needRebuild;
   do
   {
     std::string fileNameToRebuild;
-    auto unprocessedEvents = WriteEvents(events, fileNameToRebuild);
+    std::list<Event> unprocessedEvents;
+    try
+    {
+      unprocessedEvents = WriteEvents(events, fileNameToRebuild);
+    }
+    catch (RootException const & ex)
+    {
+      LOG(LWARNING, (ex.Msg()));
+      return false;
+    }
     needRebuild = !unprocessedEvents.empty();
     if (!needRebuild)
       break;
@@ -381,6 +568,7 @@ void Statistics::ProcessEvents(std::list<Event> & events)
     FileWriter::DeleteFileX(fileNameToRebuild);
     std::swap(events, newEvents);
   } while (needRebuild);
+  return true;
 }
 
 void Statistics::SendToServer()
@@ -458,6 +646,43 @@ void Statistics::IndexMetadata()
   for (auto const & filename : files)
     ExtractMetadata(GetPath(filename));
   BalanceMemory();
+  RewriteLegacyFiles();
+}
+
+void Statistics::RewriteLegacyFiles()
+{
+  // Legacy files which are left after an interrupted rewriting are processed too.
+  std::vector<std::string> files;
+  GetPlatform().GetFilesByExt(StatisticsFolder(), kLegacyExt, files);
+  if (files.empty())
+    return;
+
+  std::list<Event> legacyEvents;
+  std::vector<std::string> readFiles;
+  for (auto const & filename : files)
+  {
+    std::string const path = GetPath(filename);
+    std::list<Event> events;
+    try
+    {
+      ReadEventsFromFile(path, events);
+    }
+    catch (Reader::Exception const & ex)
+    {
+      // The file is kept, so events are not lost.
+      LOG(LWARNING, ("Error reading legacy file:", path, ex.Msg()));
+      continue;
+    }
+    legacyEvents.splice(legacyEvents.end(), events);
+    readFiles.push_back(path);
+  }
+
+  // Legacy files are deleted only when their events are written in the columnar format.
+  if (!legacyEvents.empty() && !ProcessEvents(legacyEvents))
+    return;
+
+  for (auto const & path : readFiles)
+    FileWriter::DeleteFileX(path);
 }
 
 void Statistics::ExtractMetadata(std::string const & fileName)
@@ -468,11 +693,29 @@ void Statistics::ExtractMetadata(std::string const & fileName)
     std::string countryId;
     int64_t mwmVersion;
     Timestamp baseTimestamp;
+    uint64_t size = 0;
+    bool isColumnar = false;
     {
+      // The reader is closed before the file is renamed.
       FileReader reader(fileName);
-      ReaderSource<FileReader> src(reader);
-      ReadMetadata(src, countryId, mwmVersion, baseTimestamp);
+      isColumnar = IsColumnarFormat(reader);
+      if (isColumnar)
+      {
+        ReaderSource<FileReader> src(reader);
+        src.Skip(2 * sizeof(uint8_t));
+        ReadMetadata(src, countryId, mwmVersion, baseTimestamp);
+        size = reader.Size();
+      }
+    }
+
+    if (!isColumnar)
+    {
+      // The file is rewritten in the columnar format by RewriteLegacyFiles().
+      if (!my::RenameFileX(fileName, fileName + kLegacyExt))
+        LOG(LWARNING, ("Unable to rename legacy file:", fileName));
+      return;
     }
+
     MetadataKey const key = std::make_pair(countryId, mwmVersion);
     auto it = m_metadataCache.find(key);
     if (it != m_metadataCache.end())
@@ -484,6 +727,7 @@ void Statistics::ExtractMetadata(std::string const & fileName)
         FileWriter::DeleteFileX(fileName);
     }
     m_metadataCache[key] = Metadata(fileName, baseTimestamp);
+    m_metadataCache[key].m_size = size;
   }
   catch (Reader::Exception const & ex)
   {
@@ -493,31 +737,26 @@ void Statistics::ExtractMetadata(std::string const & fileName)
 
 void Statistics::BalanceMemory()
 {
-  std::map<MetadataKey, uint64_t> sizeInBytes;
+  std::vector<MetadataKey> keys;
   uint64_t totalSize = 0;
   for (auto const & metadata : m_metadataCache)
   {
-    FileReader reader(metadata.second.m_fileName);
-    sizeInBytes[metadata.first] = reader.Size();
-    totalSize += reader.Size();
+    keys.push_back(metadata.first);
+    totalSize += metadata.second.m_size;
   }
 
   if (totalSize < kMaxFilesSizeInBytes)
     return;
 
-  auto constexpr kPackedDataSize =
-      sizeof(PackedData::m_featureIndex) + sizeof(PackedData::m_seconds) +
-      sizeof(PackedData::m_accuracy) + sizeof(PackedData::m_mercator) +
-      sizeof(PackedData::m_zoomLevel) + sizeof(PackedData::m_eventType);
-  for (auto const & metadata : sizeInBytes)
+  for (auto const & key : keys)
   {
-    auto const disposingSize = static_cast<uint64_t>(metadata.second * kEventsDisposingRate);
-    auto const disposingCount = disposingSize / kPackedDataSize;
-
-    std::string fileName = m_metadataCache[metadata.first].m_fileName;
+    std::string fileName = m_metadataCache[key].m_fileName;
     std::list<Event> events = ReadEvents(fileName);
-    m_metadataCache.erase(metadata.first);
+    m_metadataCache.erase(key);
     FileWriter::DeleteFileX(fileName);
+
+    // Records are of variable size, so the share of events is disposed.
+    auto const disposingCount = static_cast<size_t>(events.size() * kEventsDisposingRate);
     if (events.size() <= disposingCount)
       continue;
 
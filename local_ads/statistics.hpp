@@ -4,6 +4,7 @@
 
 #include "base/thread.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <functional>
@@ -52,16 +53,35 @@ public:
   void CleanupAfterTesting();
 
 private:
+  // Node of the lock-free stack of registered events.
+  struct EventNode
+  {
+    explicit EventNode(Event && event) : m_event(std::move(event)) {}
+
+    Event m_event;
+    EventNode * m_next = nullptr;
+  };
+
   void ThreadRoutine();
   bool RequestEvents(std::list<Event> & events, bool & needToSend);
+  // Pushes the chain of nodes from |first| to |last| linked by m_next.
+  void PushEvents(EventNode * first, EventNode * last);
+  // Takes all registered events in the order of registration.
+  std::list<Event> TakeEvents();
 
   void IndexMetadata();
+  // Files of the legacy format are renamed to be rewritten by RewriteLegacyFiles().
   void ExtractMetadata(std::string const & fileName);
+  // Legacy files are deleted after their events are written in the columnar format.
+  void RewriteLegacyFiles();
   void BalanceMemory();
 
   std::list<Event> WriteEvents(std::list<Event> & events, std::string & fileNameToRebuild);
   std::list<Event> ReadEvents(std::string const & fileName) const;
-  void ProcessEvents(std::list<Event> & events);
+  // Throws Reader::Exception.
+  void ReadEventsFromFile(std::string const & fileName, std::list<Event> & events) const;
+  // Returns false if the events can't be written.
+  bool ProcessEvents(std::list<Event> & events);
 
   void SendToServer();
   std::vector<uint8_t> SerializeForServer(std::list<Event> const & events) const;
@@ -71,6 +91,8 @@ private:
   {
     std::string m_fileName;
     Timestamp m_timestamp;
+    // Size of the file, it's updated on writing, so files are not reopened to balance memory.
+    uint64_t m_size = 0;
 
     Metadata() = default;
     Metadata(std::string const & fileName, Timestamp const & timestamp)
@@ -79,14 +101,17 @@ private:
     }
   };
   std::map<MetadataKey, Metadata> m_metadataCache;
+  bool m_isMetadataIndexed = false;
   std::chrono::steady_clock::time_point m_lastSending;
   bool m_isFirstSending = true;
 
   std::string m_userId;
   ServerSerializer m_serverSerializer;
 
-  bool m_isRunning = false;
-  std::list<Event> m_events;
+  std::atomic<bool> m_isRunning{false};
+  // Registered events are pushed without locking, the mutex is only locked to wake up
+  // the thread when the first event is pushed to the empty stack.
+  std::atomic<EventNode *> m_events{nullptr};
 
   std::condition_variable m_condition;
   std::mutex m_mutex;
@@ -38,6 +38,7 @@ void AllResult::Print()
 {
   //m_reading.PrintAllTimes();
   m_reading.CalcMetrics();
+  m_styling.CalcMetrics();
 
   if (m_all < 0.0)
     cout << "No frames" << endl;
@@ -51,6 +52,11 @@ void AllResult::Print()
     cout << "TOTAL[ idx:" << m_all - m_reading.m_all <<
             " decoding:" << m_reading.m_all <<
             " summ:" << m_all << " ]" << endl;
+    size_t const usCount = 1000000;
+    cout << "STYLING*1000000[ median:" << m_styling.m_med * usCount <<
+            " avg:" << m_styling.m_avg * usCount <<
+            " max:" << m_styling.m_max * usCount <<
+            " ] TOTAL[ styling:" << m_styling.m_all << " ]" << endl;
   }
 }
 
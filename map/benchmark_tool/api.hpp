@@ -32,6 +32,8 @@ namespace bench
   {
   public:
     Result m_reading;
+    /// Time of getting of drawing rules of a feature.
+    Result m_styling;
     double m_all;
 
   public:
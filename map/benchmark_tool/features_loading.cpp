@@ -24,11 +24,12 @@ namespace
     size_t m_count;
 
     Result & m_res;
+    Result & m_styling;
 
     int m_scale;
 
   public:
-    Accumulator(Result & res) : m_res(res) {}
+    Accumulator(Result & res, Result & styling) : m_res(res), m_styling(styling) {}
 
     void Reset(int scale)
     {
@@ -46,6 +47,7 @@ namespace
 
       drule::KeysT keys;
       (void)feature::GetDrawRule(ft, m_scale, keys);
+      m_styling.Add(m_timer.ElapsedSeconds());
 
       if (!keys.empty())
       {
@@ -65,7 +67,7 @@ namespace
     vector<m2::RectD> rects;
     rects.push_back(rect);
 
-    Accumulator acc(res.m_reading);
+    Accumulator acc(res.m_reading, res.m_styling);
 
     while (!rects.empty())
     {
@@ -8,6 +8,7 @@
 #include "geometry/mercator.hpp"
 
 #include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
 #include "coding/parse_xml.hpp"  // LoadFromKML
 #include "coding/internal/file_data.hpp"
 #include "coding/hex.hpp"
@@ -129,12 +130,15 @@ void Bookmark::SetScale(double scale)
 
 void BookmarkCategory::AddTrack(std::unique_ptr<Track> && track)
 {
+  Load();
   SetDirty();
+  m_needSnapshot = true;
   m_tracks.push_back(move(track));
 }
 
 Track const * BookmarkCategory::GetTrack(size_t index) const
 {
+  Load();
   return (index < m_tracks.size() ? m_tracks[index].get() : 0);
 }
 
@@ -162,16 +166,120 @@ df::UserLineMark const * BookmarkCategory::GetUserLineMark(size_t index) const
 
 void BookmarkCategory::ClearTracks()
 {
+  m_needSnapshot = true;
   m_tracks.clear();
 }
 
+size_t BookmarkCategory::GetTracksCount() const
+{
+  return m_isLoaded ? m_tracks.size() : m_header.m_tracksCount;
+}
+
 void BookmarkCategory::DeleteTrack(size_t index)
 {
+  Load();
   SetDirty();
+  m_needSnapshot = true;
   ASSERT_LESS(index, m_tracks.size(), ());
   m_tracks.erase(next(m_tracks.begin(), index));
 }
 
+size_t constexpr BookmarkCategory::JournalOp::kDeleted;
+
+size_t BookmarkCategory::GetUserMarkCount() const
+{
+  return m_isLoaded ? TBase::GetUserMarkCount() : m_header.m_bookmarksCount;
+}
+
+UserMark const * BookmarkCategory::GetUserMark(size_t index) const
+{
+  Load();
+  return TBase::GetUserMark(index);
+}
+
+UserMark * BookmarkCategory::CreateUserMark(m2::PointD const & ptOrg)
+{
+  Load();
+  PushJournalOp(bookmarks::JournalRecordType::AddBookmark, 0 /* index */);
+  return TBase::CreateUserMark(ptOrg);
+}
+
+UserMark * BookmarkCategory::GetUserMarkForEdit(size_t index)
+{
+  Load();
+  PushJournalOp(bookmarks::JournalRecordType::ReplaceBookmark, index);
+  return TBase::GetUserMarkForEdit(index);
+}
+
+void BookmarkCategory::DeleteUserMark(size_t index)
+{
+  Load();
+  if (index < TBase::GetUserMarkCount())
+    PushJournalOp(bookmarks::JournalRecordType::DeleteBookmark, index);
+  TBase::DeleteUserMark(index);
+}
+
+void BookmarkCategory::Clear(size_t skipCount)
+{
+  Load();
+  TBase::Clear(skipCount);
+  m_needSnapshot = true;
+  m_journalOps.clear();
+}
+
+void BookmarkCategory::SetIsVisible(bool isVisible)
+{
+  // Visible category is drawn, so its bookmarks are needed.
+  if (isVisible)
+    Load();
+  TBase::SetIsVisible(isVisible);
+}
+
+void BookmarkCategory::PushJournalOp(bookmarks::JournalRecordType type, size_t index)
+{
+  // Everything will be written to the new snapshot.
+  if (m_needSnapshot)
+    return;
+
+  // Keep current indices of the edited bookmarks up to date to take their data on saving.
+  for (auto & op : m_journalOps)
+  {
+    if (op.m_currentIndex == JournalOp::kDeleted)
+      continue;
+
+    if (type == bookmarks::JournalRecordType::AddBookmark)
+    {
+      ++op.m_currentIndex;
+    }
+    else if (type == bookmarks::JournalRecordType::DeleteBookmark)
+    {
+      if (op.m_currentIndex == index)
+        op.m_currentIndex = JournalOp::kDeleted;
+      else if (op.m_currentIndex > index)
+        --op.m_currentIndex;
+    }
+  }
+
+  // Several edits of the same bookmark produce one record.
+  if (type == bookmarks::JournalRecordType::ReplaceBookmark)
+  {
+    for (auto const & op : m_journalOps)
+    {
+      if (op.m_currentIndex == index)
+        return;
+    }
+  }
+
+  bool const isDelete = type == bookmarks::JournalRecordType::DeleteBookmark;
+  m_journalOps.push_back({type, index, isDelete ? JournalOp::kDeleted : index});
+}
+
+void BookmarkCategory::ResetJournal()
+{
+  m_needSnapshot = false;
+  m_journalOps.clear();
+}
+
 namespace
 {
   std::string const kPlacemark = "Placemark";
@@ -574,6 +682,70 @@ bool BookmarkCategory::LoadFromKML(ReaderPtr<Reader> const & reader)
   }
 }
 
+void BookmarkCategory::Load() const
+{
+  if (m_isLoaded)
+    return;
+  const_cast<BookmarkCategory *>(this)->LoadData();
+}
+
+bool BookmarkCategory::LoadData()
+{
+  // Name and visibility could be changed before loading, they are not saved yet.
+  std::string const name = m_name;
+  bool const isVisible = IsVisible();
+  bool const wasLoaded = m_isLoaded;
+
+  // Loaded bookmarks are not edits, they are not recorded to the journal.
+  m_isLoaded = true;
+  m_needSnapshot = true;
+
+  bookmarks::Header header;
+  bool const result = bookmarks::ReadData(m_file, *this, header);
+  if (result)
+  {
+    m_header = header;
+    ResetJournal();
+    DropIncompleteJournal();
+  }
+  else
+  {
+    LOG(LWARNING, ("Can't load bookmarks from", m_file));
+    m_journalOps.clear();
+  }
+
+  if (!wasLoaded)
+  {
+    m_name = name;
+    TBase::SetIsVisible(isVisible);
+  }
+  return result;
+}
+
+BookmarkCategory * BookmarkCategory::CreateFromFile(std::string const & file, Framework & framework)
+{
+  std::unique_ptr<BookmarkCategory> cat(new BookmarkCategory("", framework));
+  cat->m_file = file;
+
+  bookmarks::Header header;
+  if (bookmarks::ReadHeader(file, header))
+  {
+    cat->m_header = header;
+    cat->m_name = header.m_name;
+    cat->TBase::SetIsVisible(header.m_isVisible);
+    cat->m_isLoaded = false;
+    cat->ResetJournal();
+    return cat.release();
+  }
+
+  // Header is a cache, restore it from the data file.
+  if (!cat->LoadData())
+    return nullptr;
+  if (!bookmarks::WriteHeader(file, cat->m_header))
+    LOG(LWARNING, ("Can't write bookmarks header for", file));
+  return cat.release();
+}
+
 BookmarkCategory * BookmarkCategory::CreateFromKMLFile(std::string const & file, Framework & framework)
 {
   std::auto_ptr<BookmarkCategory> cat(new BookmarkCategory("", framework));
@@ -676,6 +848,7 @@ namespace
 
 void BookmarkCategory::SaveToKML(std::ostream & s)
 {
+  Load();
   s << kmlHeader;
 
   // Use CDATA if we have special symbols in the name
@@ -800,26 +973,25 @@ std::string BookmarkCategory::RemoveInvalidSymbols(std::string const & name)
   return (uniName.empty() ? "Bookmarks" : strings::ToUtf8(uniName));
 }
 
-std::string BookmarkCategory::GenerateUniqueFileName(const std::string & path, std::string name)
+std::string BookmarkCategory::GenerateUniqueFileName(const std::string & path, std::string name,
+                                                     std::string const & ext)
 {
-  std::string const kmlExt(BOOKMARKS_FILE_EXTENSION);
-
-  // check if file name already contains .kml extension
-  size_t const extPos = name.rfind(kmlExt);
+  // check if file name already contains extension
+  size_t const extPos = name.rfind(ext);
   if (extPos != std::string::npos)
   {
     // remove extension
-    ASSERT_GREATER_OR_EQUAL(name.size(), kmlExt.size(), ());
-    size_t const expectedPos = name.size() - kmlExt.size();
+    ASSERT_GREATER_OR_EQUAL(name.size(), ext.size(), ());
+    size_t const expectedPos = name.size() - ext.size();
     if (extPos == expectedPos)
       name.resize(expectedPos);
   }
 
   size_t counter = 1;
   std::string suffix;
-  while (Platform::IsFileExistsByFullPath(path + name + suffix + kmlExt))
+  while (Platform::IsFileExistsByFullPath(path + name + suffix + ext))
     suffix = strings::to_string(counter++);
-  return (path + name + suffix + kmlExt);
+  return (path + name + suffix + ext);
 }
 
 UserMark * BookmarkCategory::AllocateUserMark(m2::PointD const & ptOrg)
@@ -827,7 +999,7 @@ UserMark * BookmarkCategory::AllocateUserMark(m2::PointD const & ptOrg)
   return new Bookmark(ptOrg, this);
 }
 
-bool BookmarkCategory::SaveToKMLFile()
+std::string BookmarkCategory::UpdateFileName(std::string const & ext)
 {
   std::string oldFile;
 
@@ -845,15 +1017,23 @@ bool BookmarkCategory::SaveToKMLFile()
     else
       ++i1;
 
-    // If m_file doesn't match name, assign new m_file for this category and save old file name.
-    if (m_file.substr(i1, i2 - i1).find(name) != 0)
+    // If m_file doesn't match name or extension, assign new m_file for this category
+    // and save old file name.
+    if (m_file.substr(i1, i2 - i1).find(name) != 0 || m_file.substr(i2) != ext)
     {
-      oldFile = GenerateUniqueFileName(GetPlatform().SettingsDir(), name);
+      oldFile = GenerateUniqueFileName(GetPlatform().SettingsDir(), name, ext);
       m_file.swap(oldFile);
     }
   }
   else
-    m_file = GenerateUniqueFileName(GetPlatform().SettingsDir(), name);
+    m_file = GenerateUniqueFileName(GetPlatform().SettingsDir(), name, ext);
+
+  return oldFile;
+}
+
+bool BookmarkCategory::SaveToKMLFile()
+{
+  std::string oldFile = UpdateFileName(BOOKMARKS_FILE_EXTENSION);
 
   std::string const fileTmp = m_file + ".tmp";
 
@@ -893,3 +1073,177 @@ bool BookmarkCategory::SaveToKMLFile()
 
   return false;
 }
+
+bool BookmarkCategory::ExportToKMLFile(std::string const & file)
+{
+  try
+  {
+    /// @todo On Windows UTF-8 file names are not supported.
+    std::ofstream of(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+    SaveToKML(of);
+    of.flush();
+    if (!of.fail())
+      return true;
+  }
+  catch (std::exception const & e)
+  {
+    LOG(LWARNING, ("Exception while exporting bookmarks:", e.what()));
+  }
+
+  LOG(LWARNING, ("Can't export bookmarks category", m_name, "to file", file));
+  my::DeleteFileX(file);
+  return false;
+}
+
+bool BookmarkCategory::SaveToFile()
+{
+  std::string const oldFile = UpdateFileName(BOOKMARKS_BINARY_FILE_EXTENSION);
+
+  // The journal is compacted when it becomes bigger than the snapshot.
+  uint64_t const kMinJournalSizeToCompact = 64 * 1024;
+  uint64_t const journalSize = m_header.m_dataSize - m_header.m_snapshotSize;
+  if (m_needSnapshot || !oldFile.empty() ||
+      journalSize > std::max(m_header.m_snapshotSize, kMinJournalSizeToCompact))
+  {
+    return SaveSnapshot(oldFile);
+  }
+
+  return AppendJournal();
+}
+
+bool BookmarkCategory::SaveSnapshot(std::string const & oldFile)
+{
+  Load();
+
+  bookmarks::Header header = m_header;
+  ++header.m_generation;
+  bool const result = my::WriteToTempAndRenameToFile(m_file, [this, &header](std::string const & fn)
+  {
+    try
+    {
+      FileWriter writer(fn);
+      bookmarks::WriteSnapshot(writer, *this, header.m_generation);
+      header.m_snapshotSize = header.m_dataSize = writer.Pos();
+    }
+    catch (Writer::Exception const & e)
+    {
+      LOG(LWARNING, ("Exception while saving bookmarks:", e.Msg()));
+      return false;
+    }
+    return true;
+  });
+
+  if (!result)
+  {
+    LOG(LWARNING, ("Can't save bookmarks category", m_name, "to file", m_file));
+    // return old file name in case of error
+    if (!oldFile.empty())
+      m_file = oldFile;
+    return false;
+  }
+
+  header.m_name = m_name;
+  header.m_isVisible = IsVisible();
+  header.m_bookmarksCount = static_cast<uint32_t>(GetUserMarkCount());
+  header.m_tracksCount = static_cast<uint32_t>(GetTracksCount());
+  m_header = header;
+  // Outdated header is detected on loading, so the failure is not critical.
+  if (!bookmarks::WriteHeader(m_file, m_header))
+    LOG(LWARNING, ("Can't save bookmarks header for", m_file));
+  ResetJournal();
+
+  // delete old files
+  if (!oldFile.empty())
+  {
+    VERIFY(my::DeleteFileX(oldFile), (oldFile, m_file));
+    my::DeleteFileX(bookmarks::GetHeaderFilePath(oldFile));
+  }
+  return true;
+}
+
+void BookmarkCategory::DropIncompleteJournal()
+{
+  // The tail of an interrupted write invalidates the header, it's dropped to not reread the
+  // data file on every start.
+  try
+  {
+    my::FileData file(m_file, my::FileData::OP_WRITE_EXISTING);
+    if (file.Size() > m_header.m_dataSize)
+      file.Truncate(m_header.m_dataSize);
+  }
+  catch (RootException const & e)
+  {
+    LOG(LWARNING, ("Can't truncate bookmarks file", m_file, e.Msg()));
+  }
+}
+
+bool BookmarkCategory::AppendJournal()
+{
+  if (!Platform::IsFileExistsByFullPath(m_file))
+    return SaveSnapshot(std::string());
+
+  std::vector<char> buffer;
+  MemWriter<std::vector<char>> writer(buffer);
+  for (auto const & op : m_journalOps)
+  {
+    switch (op.m_type)
+    {
+    case bookmarks::JournalRecordType::AddBookmark:
+      if (op.m_currentIndex == JournalOp::kDeleted)
+      {
+        // Bookmark is deleted by the following record, only its position is important.
+        bookmarks::WriteAddRecord(writer, m2::PointD(), BookmarkData());
+      }
+      else
+      {
+        auto const * bookmark = static_cast<Bookmark const *>(TBase::GetUserMark(op.m_currentIndex));
+        bookmarks::WriteAddRecord(writer, bookmark->GetPivot(), bookmark->GetData());
+      }
+      break;
+    case bookmarks::JournalRecordType::ReplaceBookmark:
+      if (op.m_currentIndex != JournalOp::kDeleted)
+      {
+        auto const * bookmark = static_cast<Bookmark const *>(TBase::GetUserMark(op.m_currentIndex));
+        bookmarks::WriteReplaceRecord(writer, op.m_index, bookmark->GetData());
+      }
+      break;
+    case bookmarks::JournalRecordType::DeleteBookmark:
+      bookmarks::WriteDeleteRecord(writer, op.m_index);
+      break;
+    default:
+      ASSERT(false, ("Unexpected journal operation"));
+    }
+  }
+  if (m_name != m_header.m_name)
+    bookmarks::WriteNameRecord(writer, m_name);
+  if (IsVisible() != m_header.m_isVisible)
+    bookmarks::WriteVisibilityRecord(writer, IsVisible());
+
+  if (buffer.empty())
+    return true;
+
+  try
+  {
+    // Data after m_dataSize is a tail of an interrupted write, it's overwritten.
+    my::FileData file(m_file, my::FileData::OP_WRITE_EXISTING);
+    file.Truncate(m_header.m_dataSize);
+    file.Seek(m_header.m_dataSize);
+    file.Write(buffer.data(), buffer.size());
+    file.Flush();
+  }
+  catch (RootException const & e)
+  {
+    LOG(LWARNING, ("Can't append bookmarks journal to file", m_file, e.Msg()));
+    return false;
+  }
+
+  m_header.m_dataSize += buffer.size();
+  m_header.m_name = m_name;
+  m_header.m_isVisible = IsVisible();
+  m_header.m_bookmarksCount = static_cast<uint32_t>(GetUserMarkCount());
+  m_header.m_tracksCount = static_cast<uint32_t>(GetTracksCount());
+  if (!bookmarks::WriteHeader(m_file, m_header))
+    LOG(LWARNING, ("Can't save bookmarks header for", m_file));
+  m_journalOps.clear();
+  return true;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "map/bookmark_binary.hpp"
 #include "map/user_mark.hpp"
 #include "map/user_mark_container.hpp"
 
@@ -12,7 +13,10 @@
 
 #include "std/noncopyable.hpp"
 
+#include "defines.hpp"
+
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -124,6 +128,18 @@ public:
   size_t GetUserLineCount() const override;
   df::UserLineMark const * GetUserLineMark(size_t index) const override;
 
+  /// @name UserMarksController overrides, they load bookmarks of the category if it's needed
+  /// and record edits for the journal of the binary file.
+  //@{
+  size_t GetUserMarkCount() const override;
+  UserMark const * GetUserMark(size_t index) const override;
+  UserMark * CreateUserMark(m2::PointD const & ptOrg) override;
+  UserMark * GetUserMarkForEdit(size_t index) override;
+  void DeleteUserMark(size_t index) override;
+  void Clear(size_t skipCount = 0) override;
+  void SetIsVisible(bool isVisible) override;
+  //@}
+
   static std::string GetDefaultType();
 
   void ClearTracks();
@@ -132,7 +148,7 @@ public:
   //@{
   void AddTrack(std::unique_ptr<Track> && track);
   Track const * GetTrack(size_t index) const;
-  inline size_t GetTracksCount() const { return m_tracks.size(); }
+  size_t GetTracksCount() const;
   void DeleteTrack(size_t index);
   //@}
 
@@ -140,6 +156,28 @@ public:
   std::string const & GetName() const { return m_name; }
   std::string const & GetFileName() const { return m_file; }
 
+  /// @name Binary storage routine.
+  //@{
+  /// Creates category from the binary file. Only the header of the category is read,
+  /// bookmarks and tracks are loaded on the first access.
+  /// @return 0 in the case of error
+  static BookmarkCategory * CreateFromFile(std::string const & file, Framework & framework);
+
+  /// Saves changes to the binary file. Edits of bookmarks are appended to the journal
+  /// of the file, the whole file is rewritten only when the journal is too big or
+  /// tracks are changed. Uses the same file name from which was loaded or
+  /// creates unique file name on first save.
+  bool SaveToFile();
+
+  /// Returns true if bookmarks and tracks of the category are loaded.
+  bool IsLoaded() const { return m_isLoaded; }
+  /// Loads bookmarks and tracks of the category if they are not loaded yet.
+  void Load() const;
+
+  /// Writes the category to the kml file to share it.
+  bool ExportToKMLFile(std::string const & file);
+  //@}
+
   /// @name Theese fuctions are public for unit tests only.
   /// You don't need to call them from client code.
   //@{
@@ -156,11 +194,39 @@ public:
   /// Get valid file name from input (remove illegal symbols).
   static std::string RemoveInvalidSymbols(std::string const & name);
   /// Get unique bookmark file name from path and valid file name.
-  static std::string GenerateUniqueFileName(const std::string & path, std::string name);
+  static std::string GenerateUniqueFileName(const std::string & path, std::string name,
+                                            std::string const & ext = BOOKMARKS_FILE_EXTENSION);
   //@}
 
 protected:
   UserMark * AllocateUserMark(m2::PointD const & ptOrg) override;
+
+private:
+  /// Edit of a bookmark which is not saved to the journal yet.
+  struct JournalOp
+  {
+    static size_t constexpr kDeleted = std::numeric_limits<size_t>::max();
+
+    bookmarks::JournalRecordType m_type;
+    /// Index of the bookmark at the moment of the edit.
+    size_t m_index;
+    /// Current index of the bookmark or kDeleted.
+    size_t m_currentIndex;
+  };
+
+  bool LoadData();
+  void PushJournalOp(bookmarks::JournalRecordType type, size_t index);
+  void ResetJournal();
+  bool SaveSnapshot(std::string const & oldFile);
+  bool AppendJournal();
+  void DropIncompleteJournal();
+  /// Updates m_file according to the category name, returns previous file name if it's changed.
+  std::string UpdateFileName(std::string const & ext);
+
+  bool m_isLoaded = true;
+  bool m_needSnapshot = true;
+  bookmarks::Header m_header;
+  std::vector<JournalOp> m_journalOps;
 };
 
 struct BookmarkAndCategory
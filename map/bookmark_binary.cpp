@@ -0,0 +1,439 @@
+#include "map/bookmark_binary.hpp"
+
+#include "map/bookmark.hpp"
+#include "map/track.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/read_write_utils.hpp"
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/zlib.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/stl_add.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace bookmarks
+{
+namespace
+{
+uint32_t constexpr kDataMagic = 0x424d574d;    // "MWMB"
+uint32_t constexpr kHeaderMagic = 0x484d574d;  // "MWMH"
+uint32_t constexpr kVersion = 2;
+
+char const kHeaderFileExtension[] = ".hdr";
+
+template <typename TSink>
+void WriteDouble(TSink & sink, double d)
+{
+  uint64_t bits;
+  static_assert(sizeof(bits) == sizeof(d), "");
+  memcpy(&bits, &d, sizeof(d));
+  WriteToSink(sink, bits);
+}
+
+template <typename TSource>
+double ReadDouble(TSource & src)
+{
+  uint64_t const bits = ReadPrimitiveFromSource<uint64_t>(src);
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+
+struct BookmarkRecord
+{
+  m2::PointD m_org;
+  BookmarkData m_data;
+};
+
+template <typename TSink>
+void WriteBookmarkData(TSink & sink, BookmarkData const & data)
+{
+  rw::Write(sink, data.GetName());
+  rw::Write(sink, data.GetDescription());
+  rw::Write(sink, data.GetType());
+  WriteDouble(sink, data.GetScale());
+  WriteToSink(sink, static_cast<int64_t>(data.GetTimeStamp()));
+}
+
+template <typename TSink>
+void WriteBookmark(TSink & sink, m2::PointD const & org, BookmarkData const & data)
+{
+  WriteDouble(sink, org.x);
+  WriteDouble(sink, org.y);
+  WriteBookmarkData(sink, data);
+}
+
+template <typename TSource>
+void ReadBookmarkData(TSource & src, BookmarkData & data)
+{
+  std::string s;
+  rw::Read(src, s);
+  data.SetName(s);
+  rw::Read(src, s);
+  data.SetDescription(s);
+  rw::Read(src, s);
+  data.SetType(s);
+  data.SetScale(ReadDouble(src));
+  data.SetTimeStamp(static_cast<time_t>(ReadPrimitiveFromSource<int64_t>(src)));
+}
+
+template <typename TSource>
+void ReadBookmark(TSource & src, BookmarkRecord & record)
+{
+  record.m_org.x = ReadDouble(src);
+  record.m_org.y = ReadDouble(src);
+  ReadBookmarkData(src, record.m_data);
+}
+
+uint32_t GetChecksum(std::vector<char> const & payload)
+{
+  return static_cast<uint32_t>(
+      crc32(0, reinterpret_cast<Bytef const *>(payload.data()), static_cast<uInt>(payload.size())));
+}
+
+// Journal record is the size of its payload, the payload and the checksum of the payload.
+// The payload starts with the record type.
+template <typename TFn>
+void WriteRecord(Writer & writer, JournalRecordType type, TFn && writePayload)
+{
+  std::vector<char> payload;
+  MemWriter<std::vector<char>> payloadWriter(payload);
+  WriteToSink(payloadWriter, type);
+  writePayload(payloadWriter);
+
+  WriteVarUint(writer, static_cast<uint32_t>(payload.size()));
+  writer.Write(payload.data(), payload.size());
+  WriteToSink(writer, GetChecksum(payload));
+}
+
+// Reads the payload of the next record.
+// @return false if the record is incomplete or its checksum doesn't match.
+template <typename TSource>
+bool ReadRecord(TSource & src, std::vector<char> & payload)
+{
+  try
+  {
+    uint32_t const size = ReadVarUint<uint32_t>(src);
+    if (src.Size() < static_cast<uint64_t>(size) + sizeof(uint32_t))
+      return false;
+    payload.resize(size);
+    src.Read(payload.data(), payload.size());
+    return ReadPrimitiveFromSource<uint32_t>(src) == GetChecksum(payload);
+  }
+  catch (Reader::Exception const &)
+  {
+    return false;
+  }
+}
+
+template <typename TSink>
+void WriteTrack(TSink & sink, Track const & track)
+{
+  rw::Write(sink, track.GetName());
+
+  WriteVarUint(sink, static_cast<uint32_t>(track.GetLayerCount()));
+  for (size_t i = 0; i < track.GetLayerCount(); ++i)
+  {
+    dp::Color const & color = track.GetColor(i);
+    WriteToSink(sink, color.GetRed());
+    WriteToSink(sink, color.GetGreen());
+    WriteToSink(sink, color.GetBlue());
+    WriteToSink(sink, color.GetAlfa());
+    WriteDouble(sink, track.GetWidth(i));
+  }
+
+  Track::PolylineD const & poly = track.GetPolyline();
+  WriteVarUint(sink, static_cast<uint32_t>(poly.GetSize()));
+  for (auto it = poly.Begin(); it != poly.End(); ++it)
+  {
+    WriteDouble(sink, it->x);
+    WriteDouble(sink, it->y);
+  }
+}
+
+template <typename TSource>
+std::unique_ptr<Track> ReadTrack(TSource & src)
+{
+  Track::Params params;
+  rw::Read(src, params.m_name);
+
+  uint32_t const layersCount = ReadVarUint<uint32_t>(src);
+  for (uint32_t i = 0; i < layersCount; ++i)
+  {
+    uint8_t const r = ReadPrimitiveFromSource<uint8_t>(src);
+    uint8_t const g = ReadPrimitiveFromSource<uint8_t>(src);
+    uint8_t const b = ReadPrimitiveFromSource<uint8_t>(src);
+    uint8_t const a = ReadPrimitiveFromSource<uint8_t>(src);
+    float const width = static_cast<float>(ReadDouble(src));
+    params.m_colors.push_back({width, dp::Color(r, g, b, a)});
+  }
+
+  uint32_t const pointsCount = ReadVarUint<uint32_t>(src);
+  std::vector<m2::PointD> points(pointsCount);
+  for (auto & pt : points)
+  {
+    pt.x = ReadDouble(src);
+    pt.y = ReadDouble(src);
+  }
+
+  return my::make_unique<Track>(Track::PolylineD(points), params);
+}
+
+void AddBookmark(BookmarkCategory & category, BookmarkRecord const & record)
+{
+  auto * bookmark = static_cast<Bookmark *>(category.CreateUserMark(record.m_org));
+  bookmark->SetData(record.m_data);
+}
+}  // namespace
+
+std::string GetHeaderFilePath(std::string const & dataFilePath)
+{
+  return dataFilePath + kHeaderFileExtension;
+}
+
+bool ReadHeader(std::string const & dataFilePath, Header & header)
+{
+  try
+  {
+    FileReader headerReader(GetHeaderFilePath(dataFilePath), true /* withExceptions */);
+    ReaderSource<FileReader> src(headerReader);
+    if (ReadPrimitiveFromSource<uint32_t>(src) != kHeaderMagic ||
+        ReadPrimitiveFromSource<uint32_t>(src) != kVersion)
+    {
+      return false;
+    }
+
+    header.m_generation = ReadPrimitiveFromSource<uint64_t>(src);
+    header.m_dataSize = ReadPrimitiveFromSource<uint64_t>(src);
+    header.m_snapshotSize = ReadPrimitiveFromSource<uint64_t>(src);
+    rw::Read(src, header.m_name);
+    header.m_isVisible = ReadPrimitiveFromSource<uint8_t>(src) != 0;
+    header.m_bookmarksCount = ReadPrimitiveFromSource<uint32_t>(src);
+    header.m_tracksCount = ReadPrimitiveFromSource<uint32_t>(src);
+
+    // Header is valid if it describes the current snapshot of the data file and the whole
+    // journal, as the journal may be appended without updating of the header due to a crash.
+    FileReader dataReader(dataFilePath, true /* withExceptions */);
+    ReaderSource<FileReader> dataSrc(dataReader);
+    return dataReader.Size() == header.m_dataSize &&
+           ReadPrimitiveFromSource<uint32_t>(dataSrc) == kDataMagic &&
+           ReadPrimitiveFromSource<uint32_t>(dataSrc) == kVersion &&
+           ReadPrimitiveFromSource<uint64_t>(dataSrc) == header.m_generation;
+  }
+  catch (Reader::Exception const &)
+  {
+    return false;
+  }
+}
+
+bool WriteHeader(std::string const & dataFilePath, Header const & header)
+{
+  return my::WriteToTempAndRenameToFile(GetHeaderFilePath(dataFilePath),
+                                        [&header](std::string const & fileName)
+  {
+    try
+    {
+      FileWriter writer(fileName);
+      WriteToSink(writer, kHeaderMagic);
+      WriteToSink(writer, kVersion);
+      WriteToSink(writer, header.m_generation);
+      WriteToSink(writer, header.m_dataSize);
+      WriteToSink(writer, header.m_snapshotSize);
+      rw::Write(writer, header.m_name);
+      WriteToSink(writer, static_cast<uint8_t>(header.m_isVisible ? 1 : 0));
+      WriteToSink(writer, header.m_bookmarksCount);
+      WriteToSink(writer, header.m_tracksCount);
+    }
+    catch (Writer::Exception const & e)
+    {
+      LOG(LWARNING, ("Can't write bookmarks header", fileName, e.Msg()));
+      return false;
+    }
+    return true;
+  });
+}
+
+void WriteSnapshot(Writer & writer, BookmarkCategory const & category, uint64_t generation)
+{
+  WriteToSink(writer, kDataMagic);
+  WriteToSink(writer, kVersion);
+  WriteToSink(writer, generation);
+
+  rw::Write(writer, category.GetName());
+  WriteToSink(writer, static_cast<uint8_t>(category.IsVisible() ? 1 : 0));
+
+  // Bookmarks are stored in reverse order, because they are pushed front on loading.
+  // See the same note in BookmarkCategory::SaveToKML.
+  size_t const bookmarksCount = category.GetUserMarkCount();
+  WriteVarUint(writer, static_cast<uint32_t>(bookmarksCount));
+  for (size_t i = bookmarksCount; i > 0; --i)
+  {
+    auto const * bookmark = static_cast<Bookmark const *>(category.GetUserMark(i - 1));
+    WriteBookmark(writer, bookmark->GetPivot(), bookmark->GetData());
+  }
+
+  WriteVarUint(writer, static_cast<uint32_t>(category.GetTracksCount()));
+  for (size_t i = 0; i < category.GetTracksCount(); ++i)
+    WriteTrack(writer, *category.GetTrack(i));
+}
+
+void WriteAddRecord(Writer & writer, m2::PointD const & org, BookmarkData const & data)
+{
+  WriteRecord(writer, JournalRecordType::AddBookmark, [&](Writer & payload)
+  {
+    WriteBookmark(payload, org, data);
+  });
+}
+
+void WriteReplaceRecord(Writer & writer, size_t index, BookmarkData const & data)
+{
+  WriteRecord(writer, JournalRecordType::ReplaceBookmark, [&](Writer & payload)
+  {
+    WriteVarUint(payload, static_cast<uint32_t>(index));
+    WriteBookmarkData(payload, data);
+  });
+}
+
+void WriteDeleteRecord(Writer & writer, size_t index)
+{
+  WriteRecord(writer, JournalRecordType::DeleteBookmark, [&](Writer & payload)
+  {
+    WriteVarUint(payload, static_cast<uint32_t>(index));
+  });
+}
+
+void WriteNameRecord(Writer & writer, std::string const & name)
+{
+  WriteRecord(writer, JournalRecordType::SetName, [&](Writer & payload)
+  {
+    rw::Write(payload, name);
+  });
+}
+
+void WriteVisibilityRecord(Writer & writer, bool isVisible)
+{
+  WriteRecord(writer, JournalRecordType::SetVisibility, [&](Writer & payload)
+  {
+    WriteToSink(payload, static_cast<uint8_t>(isVisible ? 1 : 0));
+  });
+}
+
+bool ReadData(std::string const & dataFilePath, BookmarkCategory & category, Header & header)
+{
+  try
+  {
+    FileReader fileReader(dataFilePath, true /* withExceptions */);
+    ReaderSource<FileReader> src(fileReader);
+
+    if (ReadPrimitiveFromSource<uint32_t>(src) != kDataMagic ||
+        ReadPrimitiveFromSource<uint32_t>(src) != kVersion)
+    {
+      LOG(LWARNING, ("Unsupported bookmarks file", dataFilePath));
+      return false;
+    }
+    header.m_generation = ReadPrimitiveFromSource<uint64_t>(src);
+
+    std::string name;
+    rw::Read(src, name);
+    category.SetName(name);
+    category.SetIsVisible(ReadPrimitiveFromSource<uint8_t>(src) != 0);
+
+    uint32_t const bookmarksCount = ReadVarUint<uint32_t>(src);
+    for (uint32_t i = 0; i < bookmarksCount; ++i)
+    {
+      BookmarkRecord record;
+      ReadBookmark(src, record);
+      AddBookmark(category, record);
+    }
+
+    uint32_t const tracksCount = ReadVarUint<uint32_t>(src);
+    for (uint32_t i = 0; i < tracksCount; ++i)
+      category.AddTrack(ReadTrack(src));
+
+    header.m_snapshotSize = src.Pos();
+
+    // Journal records are applied only when they are complete and their checksums match,
+    // the rest of the file is a tail of an interrupted write. The records are not limited by
+    // the size from the header file, as the header is rewritten after the journal.
+    header.m_dataSize = src.Pos();
+    std::vector<char> payload;
+    while (src.Size() > 0 && ReadRecord(src, payload))
+    {
+      try
+      {
+        MemReader payloadReader(payload.data(), payload.size());
+        ReaderSource<MemReader> record(payloadReader);
+        auto const type = static_cast<JournalRecordType>(ReadPrimitiveFromSource<uint8_t>(record));
+        switch (type)
+        {
+        case JournalRecordType::AddBookmark:
+        {
+          BookmarkRecord bookmark;
+          ReadBookmark(record, bookmark);
+          AddBookmark(category, bookmark);
+          break;
+        }
+        case JournalRecordType::DeleteBookmark:
+        {
+          uint32_t const index = ReadVarUint<uint32_t>(record);
+          if (index < category.GetUserMarkCount())
+            category.DeleteUserMark(index);
+          break;
+        }
+        case JournalRecordType::ReplaceBookmark:
+        {
+          uint32_t const index = ReadVarUint<uint32_t>(record);
+          BookmarkData data;
+          ReadBookmarkData(record, data);
+          if (index < category.GetUserMarkCount())
+            static_cast<Bookmark *>(category.GetUserMarkForEdit(index))->SetData(data);
+          break;
+        }
+        case JournalRecordType::SetName:
+        {
+          rw::Read(record, name);
+          category.SetName(name);
+          break;
+        }
+        case JournalRecordType::SetVisibility:
+          category.SetIsVisible(ReadPrimitiveFromSource<uint8_t>(record) != 0);
+          break;
+        default:
+          LOG(LWARNING, ("Unknown journal record", static_cast<int>(type), "in", dataFilePath));
+          break;
+        }
+      }
+      catch (Reader::Exception const &)
+      {
+        LOG(LWARNING, ("Malformed journal record in", dataFilePath));
+        break;
+      }
+
+      header.m_dataSize = src.Pos();
+    }
+
+    if (header.m_dataSize != fileReader.Size())
+      LOG(LWARNING, ("Incomplete journal record is skipped in", dataFilePath));
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LWARNING, ("Can't read bookmarks from", dataFilePath, e.Msg()));
+    return false;
+  }
+
+  header.m_name = category.GetName();
+  header.m_isVisible = category.IsVisible();
+  header.m_bookmarksCount = static_cast<uint32_t>(category.GetUserMarkCount());
+  header.m_tracksCount = static_cast<uint32_t>(category.GetTracksCount());
+  return true;
+}
+}  // namespace bookmarks
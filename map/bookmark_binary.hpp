@@ -0,0 +1,76 @@
+#pragma once
+
+#include "coding/writer.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class BookmarkCategory;
+class BookmarkData;
+
+namespace bookmarks
+{
+// Binary storage of a bookmark category consists of two files.
+// The data file "<name>.kmb" contains a snapshot of the category (name, visibility, bookmarks
+// and tracks) followed by a journal of edits which were made after the snapshot.
+// The header file "<name>.kmb.hdr" is small and contains a category description which is
+// enough to list categories without reading of the data file. The header is rewritten
+// on every save, the data file is only appended to until the journal is compacted into a new
+// snapshot. Header is a cache: when it's absent or doesn't match the data file, the category
+// is restored from the data file.
+// Every journal record has the size and the checksum of its payload, so complete records are
+// found without the header, which is written after the journal.
+
+enum class JournalRecordType : uint8_t
+{
+  AddBookmark = 0,
+  DeleteBookmark = 1,
+  ReplaceBookmark = 2,
+  SetName = 3,
+  SetVisibility = 4,
+};
+
+struct Header
+{
+  // Generation of the snapshot, it's incremented every time the data file is rewritten.
+  uint64_t m_generation = 0;
+  // Size of the valid part of the data file, i.e. snapshot and journal.
+  uint64_t m_dataSize = 0;
+  // Size of the snapshot part of the data file.
+  uint64_t m_snapshotSize = 0;
+
+  std::string m_name;
+  bool m_isVisible = true;
+  uint32_t m_bookmarksCount = 0;
+  uint32_t m_tracksCount = 0;
+};
+
+std::string GetHeaderFilePath(std::string const & dataFilePath);
+
+/// Reads and validates the header of the category which is stored in dataFilePath.
+/// @return false if the header is absent or is outdated.
+bool ReadHeader(std::string const & dataFilePath, Header & header);
+bool WriteHeader(std::string const & dataFilePath, Header const & header);
+
+/// Writes snapshot of the category data.
+void WriteSnapshot(Writer & writer, BookmarkCategory const & category, uint64_t generation);
+
+/// @name Writers of the journal records.
+//@{
+void WriteAddRecord(Writer & writer, m2::PointD const & org, BookmarkData const & data);
+void WriteReplaceRecord(Writer & writer, size_t index, BookmarkData const & data);
+void WriteDeleteRecord(Writer & writer, size_t index);
+void WriteNameRecord(Writer & writer, std::string const & name);
+void WriteVisibilityRecord(Writer & writer, bool isVisible);
+//@}
+
+/// Loads snapshot and replays all complete journal records of the data file into the empty
+/// category. Incomplete or corrupted record at the end of the data (e.g. after a crash)
+/// is skipped with the rest of the file.
+/// @param header - output, description of the loaded data.
+/// @return false if the file can't be read.
+bool ReadData(std::string const & dataFilePath, BookmarkCategory & category, Header & header);
+}  // namespace bookmarks
@@ -63,28 +63,51 @@ void BookmarkManager::ClearCategories()
 void BookmarkManager::LoadBookmarks()
 {
   ClearCategories();
+  LoadState();
 
   string const dir = GetPlatform().SettingsDir();
 
   Platform::FilesList files;
+  Platform::GetFilesByExt(dir, BOOKMARKS_BINARY_FILE_EXTENSION, files);
+  for (size_t i = 0; i < files.size(); ++i)
+  {
+    std::unique_ptr<BookmarkCategory> cat(BookmarkCategory::CreateFromFile(dir + files[i], m_framework));
+    if (cat)
+      m_categories.emplace_back(std::move(cat));
+  }
+
+  // KML files are left after the previous versions or an interrupted import,
+  // they are converted to the binary format.
+  files.clear();
   Platform::GetFilesByExt(dir, BOOKMARKS_FILE_EXTENSION, files);
   for (size_t i = 0; i < files.size(); ++i)
     LoadBookmark(dir + files[i]);
-
-  LoadState();
 }
 
 void BookmarkManager::LoadBookmark(string const & filePath)
 {
   std::unique_ptr<BookmarkCategory> cat(BookmarkCategory::CreateFromKMLFile(filePath, m_framework));
-  if (cat)
-    m_categories.emplace_back(std::move(cat));
+  if (!cat)
+    return;
+
+  // KML file is replaced with the binary one on success.
+  if (cat->SaveToFile() && m_lastCategoryUrl == filePath)
+  {
+    m_lastCategoryUrl = cat->GetFileName();
+    SaveState();
+  }
+  m_categories.emplace_back(std::move(cat));
 }
 
 void BookmarkManager::InitBookmarks()
 {
+  // Bookmarks of invisible categories are loaded on demand.
   for (auto & cat : m_categories)
+  {
+    if (cat->IsVisible())
+      cat->Load();
     cat->NotifyChanges();
+  }
 }
 
 size_t BookmarkManager::AddBookmark(size_t categoryIndex, m2::PointD const & ptOrg, BookmarkData & bm)
@@ -97,7 +120,7 @@ size_t BookmarkManager::AddBookmark(size_t categoryIndex, m2::PointD const & ptO
   Bookmark * bookmark = static_cast<Bookmark *>(cat.CreateUserMark(ptOrg));
   bookmark->SetData(bm);
   cat.SetIsVisible(true);
-  cat.SaveToKMLFile();
+  cat.SaveToFile();
   cat.NotifyChanges();
 
   m_lastCategoryUrl = cat.GetFileName();
@@ -119,7 +142,7 @@ size_t BookmarkManager::MoveBookmark(size_t bmIndex, size_t curCatIndex, size_t
   ptOrg = bm->GetPivot();
 
   cat->DeleteUserMark(bmIndex);
-  cat->SaveToKMLFile();
+  cat->SaveToFile();
   cat->NotifyChanges();
 
   return AddBookmark(newCatIndex, ptOrg, data);
@@ -129,7 +152,7 @@ void BookmarkManager::ReplaceBookmark(size_t catIndex, size_t bmIndex, BookmarkD
 {
   BookmarkCategory & cat = *m_categories[catIndex];
   static_cast<Bookmark *>(cat.GetUserMarkForEdit(bmIndex))->SetData(bm);
-  cat.SaveToKMLFile();
+  cat.SaveToFile();
   cat.NotifyChanges();
 
   m_lastType = bm.GetType();
@@ -171,6 +194,7 @@ void BookmarkManager::DeleteBmCategory(CategoryIter it)
   BookmarkCategory & cat = *it->get();
   cat.DeleteLater();
   FileWriter::DeleteFileX(cat.GetFileName());
+  FileWriter::DeleteFileX(bookmarks::GetHeaderFilePath(cat.GetFileName()));
   m_categories.erase(it);
 }
 
@@ -1434,6 +1434,11 @@ void Framework::EnterBackground()
   settings::Set("LastEnterBackground", m_startBackgroundTime);
 
   SaveViewport();
+  // The application may be killed in the background.
+  settings::Flush();
+  marketing::Settings::Flush();
+  if (m_drapeEngine != nullptr)
+    m_drapeEngine->SaveGlyphCache();
 
   m_trafficManager.OnEnterBackground();
   m_routingManager.SetAllowSendingPoints(false);
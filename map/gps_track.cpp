@@ -180,6 +180,10 @@ void GpsTrack::InitCollection(hours duration)
     vector<location::GpsInfo> originPoints;
     originPoints.reserve(kItemBlockSize);
 
+    // Only the tail of the track which fits into the duration is read.
+    double const fromTimestamp =
+        m_storage->GetMaxTimestamp() - duration_cast<seconds>(duration).count();
+
     m_storage->ForEach([this, &originPoints](location::GpsInfo const & originPoint)->bool
     {
       originPoints.emplace_back(originPoint);
@@ -194,7 +198,7 @@ void GpsTrack::InitCollection(hours duration)
         originPoints.clear();
       }
       return true;
-    });
+    }, fromTimestamp);
 
     if (!originPoints.empty())
     {
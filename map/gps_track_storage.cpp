@@ -1,32 +1,52 @@
 #include "map/gps_track_storage.hpp"
 
+#include "platform/platform.hpp"
+
 #include "coding/endianness.hpp"
+#include "coding/file_name_utils.hpp"
 #include "coding/internal/file_data.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
 
 #include "std/algorithm.hpp"
 #include "std/cstring.hpp"
 
 #include "base/assert.hpp"
 #include "base/logging.hpp"
+#include "base/stl_add.hpp"
+#include "base/string_utils.hpp"
 
 namespace
 {
 
-// Current file format version
-uint32_t constexpr kCurrentVersion = 1;
+// Version of the single file format, which is migrated to chunks.
+uint32_t constexpr kLegacyVersion = 1;
+
+// Current chunk file format version
+uint32_t constexpr kCurrentVersion = 2;
 
 // Header size in bytes, header consists of uint32_t 'version' only
 uint32_t constexpr kHeaderSize = sizeof(uint32_t);
 
+// Footer of a sealed chunk: uint32_t item count, double min timestamp, double max timestamp
+// and uint32_t magic.
+uint32_t constexpr kFooterSize = 2 * sizeof(uint32_t) + 2 * sizeof(double);
+uint32_t constexpr kFooterMagic = 0x58495447; // "GTIX"
+
 // Number of items for batch processing
 size_t constexpr kItemBlockSize = 1000;
 
+// Min period between syncs of the active chunk to the disk.
+seconds constexpr kSyncPeriod = seconds(10);
+
 // TODO
 // Now GpsInfo written as plain values, but values can be compressed.
 
 // Size of point in bytes to write in file of read from file
 size_t constexpr kPointSize = 8 * sizeof(double) + sizeof(uint8_t);
 
+static_assert(kFooterSize < kPointSize, "Footer must be distinguishable from items by size.");
+
 // Writes value in memory in LittleEndian
 template <typename T>
 void MemWrite(void * ptr, T value)
@@ -45,7 +65,7 @@ T MemRead(void const * ptr)
 }
 
 void Pack(char * p, location::GpsInfo const & info)
-{  
+{
   MemWrite<double>(p + 0 * sizeof(double), info.m_timestamp);
   MemWrite<double>(p + 1 * sizeof(double), info.m_latitude);
   MemWrite<double>(p + 2 * sizeof(double), info.m_longitude);
@@ -73,242 +93,456 @@ void Unpack(char const * p, location::GpsInfo & info)
   info.m_source = static_cast<location::TLocationSource>(source);
 }
 
-inline size_t GetItemOffset(size_t itemIndex)
+inline uint64_t GetItemOffset(size_t itemIndex)
 {
-  return kHeaderSize + itemIndex * kPointSize;
+  return kHeaderSize + static_cast<uint64_t>(itemIndex) * kPointSize;
 }
 
-inline size_t GetItemCount(size_t fileSize)
+inline uint32_t ReadVersion(my::FileData & f)
 {
-  ASSERT_GREATER_OR_EQUAL(fileSize, kHeaderSize, ());
-  return (fileSize - kHeaderSize) / kPointSize;
+  uint32_t version = 0;
+  f.Read(0, &version, kHeaderSize);
+  return SwapIfBigEndian(version);
 }
 
-inline bool WriteVersion(fstream & f, uint32_t version)
+inline void WriteVersion(my::FileData & f, uint32_t version)
 {
   static_assert(kHeaderSize == sizeof(version), "");
   version = SwapIfBigEndian(version);
-  f.write(reinterpret_cast<char const *>(&version), kHeaderSize);
-  return f.good();
+  f.Write(&version, kHeaderSize);
 }
 
-inline bool ReadVersion(fstream & f, uint32_t & version)
+// Reads items [first, last) of the file and calls fn for each item, returns false if fn stopped reading.
+template <typename TFn>
+bool ReadItems(my::FileData & f, size_t first, size_t last, TFn && fn)
 {
-  static_assert(kHeaderSize == sizeof(version), "");
-  f.read(reinterpret_cast<char *>(&version), kHeaderSize);
-  version = SwapIfBigEndian(version);
-  return f.good();
+  vector<char> buff(min(kItemBlockSize, last - first) * kPointSize);
+  for (size_t i = first; i < last;)
+  {
+    size_t const n = min(last - i, kItemBlockSize);
+    f.Read(GetItemOffset(i), buff.data(), n * kPointSize);
+
+    for (size_t j = 0; j < n; ++j)
+    {
+      location::GpsInfo item;
+      Unpack(buff.data() + j * kPointSize, item);
+      if (!fn(item))
+        return false;
+    }
+
+    i += n;
+  }
+  return true;
+}
+
+// Returns sorted indices of chunk files "<filePath>.<index>".
+vector<uint64_t> GetChunkIndices(string const & filePath)
+{
+  string name = filePath;
+  my::GetNameFromFullPath(name);
+  string const prefix = name + ".";
+
+  Platform::FilesList files;
+  Platform::GetFilesByRegExp(my::GetDirectory(filePath), "\\.[0-9]+$", files);
+
+  vector<uint64_t> indices;
+  for (auto const & file : files)
+  {
+    uint64_t index;
+    if (strings::StartsWith(file, prefix.c_str()) && strings::to_uint64(file.substr(prefix.size()), index))
+      indices.push_back(index);
+  }
+  sort(indices.begin(), indices.end());
+  return indices;
 }
 
 } // namespace
 
-GpsTrackStorage::GpsTrackStorage(string const & filePath, size_t maxItemCount)
+size_t const GpsTrackStorage::kDefaultChunkItemCount = 10000;
+
+GpsTrackStorage::GpsTrackStorage(string const & filePath, size_t maxItemCount, size_t chunkItemCount)
   : m_filePath(filePath)
   , m_maxItemCount(maxItemCount)
+  , m_chunkItemCount(chunkItemCount)
   , m_itemCount(0)
+  , m_needSync(false)
+  , m_lastSyncTime(steady_clock::now())
 {
   ASSERT_GREATER(m_maxItemCount, 0, ());
+  ASSERT_GREATER(m_chunkItemCount, 0, ());
 
-  // Open existing file
-  m_stream.open(m_filePath, ios::in | ios::out | ios::binary);
+  try
+  {
+    LoadChunks();
+    if (m_chunks.empty())
+      MigrateLegacyFile();
+  }
+  catch (RootException const & e)
+  {
+    MYTHROW(OpenException, (e.Msg(), m_filePath));
+  }
+}
 
-  if (m_stream)
+GpsTrackStorage::~GpsTrackStorage()
+{
+  try
+  {
+    Sync();
+  }
+  catch (RootException const & e)
   {
-    uint32_t version = 0;
-    if (!ReadVersion(m_stream, version))
-      MYTHROW(OpenException, ("Read version error.", m_filePath));
+    LOG(LWARNING, ("Track storage sync error:", e.Msg()));
+  }
+}
 
-    if (version == kCurrentVersion)
-    {
-      // Seek to end to get file size
-      m_stream.seekp(0, ios::end);
-      if (!m_stream.good())
-        MYTHROW(OpenException, ("Seek to the end error.", m_filePath));
+void GpsTrackStorage::Append(vector<TItem> const & items)
+{
+  if (items.empty())
+    return;
 
-      size_t const fileSize = m_stream.tellp();
+  try
+  {
+    for (size_t i = 0; i < items.size();)
+    {
+      if (!m_activeFile)
+        OpenActiveChunk(true /* create */);
 
-      m_itemCount = GetItemCount(fileSize);
+      size_t const n = min(items.size() - i, m_chunkItemCount - m_chunks.back().m_itemCount);
+      AppendToActiveChunk(&items[i], n);
+      i += n;
 
-      // Set write position after last item position
-      size_t const offset = GetItemOffset(m_itemCount);
-      m_stream.seekp(offset, ios::beg);
-      if (!m_stream.good())
-        MYTHROW(OpenException, ("Seek to the offset error:", offset, m_filePath));
+      if (m_chunks.back().m_itemCount >= m_chunkItemCount)
+        SealActiveChunk();
     }
-    else
-    {
-      m_stream.close();
-      // TODO: migration for file m_filePath from version 'version' to version 'kCurrentVersion'
-      // TODO: For now we support only one version, but in future migration may be needed.
-    }
-  }
-
-  if (!m_stream)
-  {
-    // Create new file
-    m_stream.open(m_filePath, ios::in | ios::out | ios::binary | ios::trunc);
 
-    if (!m_stream)
-      MYTHROW(OpenException, ("Open file error.", m_filePath));
+    if (m_activeFile)
+      m_activeFile->Flush();
 
-    if (!WriteVersion(m_stream, kCurrentVersion))
-      MYTHROW(OpenException, ("Write version error.", m_filePath));
+    DropExtraChunks();
 
-    m_itemCount = 0;
+    // Group sync: points come often by one, so the disk is synced once per period only.
+    if (m_needSync && steady_clock::now() - m_lastSyncTime >= kSyncPeriod)
+      Sync();
+  }
+  catch (Reader::Exception const & e)
+  {
+    MYTHROW(ReadException, (e.Msg(), m_filePath));
+  }
+  catch (Writer::Exception const & e)
+  {
+    MYTHROW(WriteException, (e.Msg(), m_filePath));
   }
 }
 
-void GpsTrackStorage::Append(vector<TItem> const & items)
+void GpsTrackStorage::Clear()
 {
-  ASSERT(m_stream.is_open(), ());
-
-  if (items.empty())
-    return;
+  m_activeFile.reset();
+  m_needSync = false;
 
-  bool const needTrunc = (m_itemCount + items.size()) > (m_maxItemCount * 2); // see NOTE in declaration
+  for (auto const & chunk : m_chunks)
+  {
+    string const path = GetChunkPath(chunk.m_index);
+    if (!my::DeleteFileX(path))
+      MYTHROW(WriteException, ("File:", path));
+  }
 
-  if (needTrunc)
-    TruncFile();
+  m_chunks.clear();
+  m_itemCount = 0;
+}
 
-  // Write position must be after last item position
-  ASSERT_EQUAL(m_stream.tellp(), GetItemOffset(m_itemCount), ());
+void GpsTrackStorage::ForEach(std::function<bool(TItem const & item)> const & fn,
+                              double fromTimestamp)
+{
+  size_t skipCount = GetFirstItemIndex();
 
-  vector<char> buff(min(kItemBlockSize, items.size()) * kPointSize);
-  for (size_t i = 0; i < items.size();)
+  try
+  {
+    for (auto const & chunk : m_chunks)
+    {
+      if (skipCount >= chunk.m_itemCount)
+      {
+        skipCount -= chunk.m_itemCount;
+        continue;
+      }
+
+      size_t const first = skipCount;
+      skipCount = 0;
+
+      // Time index: the chunk contains older items only.
+      if (chunk.m_maxTimestamp < fromTimestamp)
+        continue;
+
+      my::FileData f(GetChunkPath(chunk.m_index), my::FileData::OP_READ);
+      bool const completed = ReadItems(f, first, chunk.m_itemCount, [&](TItem const & item)
+      {
+        return item.m_timestamp < fromTimestamp || fn(item);
+      });
+      if (!completed)
+        return;
+    }
+  }
+  catch (Reader::Exception const & e)
   {
-    size_t const n = min(items.size() - i, kItemBlockSize);
+    MYTHROW(ReadException, (e.Msg(), m_filePath));
+  }
+}
 
-    for (size_t j = 0; j < n; ++j)
-      Pack(&buff[0] + j * kPointSize, items[i + j]);
+double GpsTrackStorage::GetMaxTimestamp() const
+{
+  double res = 0.0;
+  for (auto const & chunk : m_chunks)
+  {
+    if (chunk.m_itemCount != 0)
+      res = max(res, chunk.m_maxTimestamp);
+  }
+  return res;
+}
 
-    m_stream.write(&buff[0], n * kPointSize);
-    if (!m_stream.good())
-      MYTHROW(WriteException, ("File:", m_filePath));
+void GpsTrackStorage::Sync()
+{
+  if (!m_activeFile || !m_needSync)
+    return;
 
-    i += n;
+  try
+  {
+    m_activeFile->Sync();
+  }
+  catch (Writer::Exception const & e)
+  {
+    MYTHROW(WriteException, (e.Msg(), m_filePath));
   }
 
-  m_stream.flush();
-  if (!m_stream.good())
-    MYTHROW(WriteException, ("File:", m_filePath));
-
-  m_itemCount += items.size();
+  m_needSync = false;
+  m_lastSyncTime = steady_clock::now();
 }
 
-void GpsTrackStorage::Clear()
+// static
+void GpsTrackStorage::DeleteFiles(string const & filePath)
 {
-  ASSERT(m_stream.is_open(), ());
-
-  m_itemCount = 0;
+  for (auto const index : GetChunkIndices(filePath))
+    my::DeleteFileX(filePath + "." + strings::to_string(index));
+  my::DeleteFileX(filePath);
+}
 
-  m_stream.close();
+void GpsTrackStorage::LoadChunks()
+{
+  vector<uint64_t> const indices = GetChunkIndices(m_filePath);
 
-  m_stream.open(m_filePath, ios::in | ios::out | ios::binary | ios::trunc);
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    Chunk chunk;
+    chunk.m_index = indices[i];
+    string const path = GetChunkPath(chunk.m_index);
 
-  if (!m_stream)
-    MYTHROW(WriteException, ("File:", m_filePath));
+    bool sealed = false;
+    {
+      my::FileData f(path, my::FileData::OP_READ);
+      uint64_t const fileSize = f.Size();
+      if (fileSize < kHeaderSize || ReadVersion(f) != kCurrentVersion)
+      {
+        LOG(LWARNING, ("Unsupported track chunk is removed:", path));
+        my::DeleteFileX(path);
+        continue;
+      }
+
+      uint64_t const dataSize = fileSize - kHeaderSize;
+      chunk.m_itemCount = static_cast<size_t>(dataSize / kPointSize);
+
+      if (dataSize % kPointSize == kFooterSize)
+      {
+        char footer[kFooterSize];
+        f.Read(fileSize - kFooterSize, footer, kFooterSize);
+        if (MemRead<uint32_t>(footer + kFooterSize - sizeof(uint32_t)) == kFooterMagic &&
+            MemRead<uint32_t>(footer) == chunk.m_itemCount)
+        {
+          chunk.m_minTimestamp = MemRead<double>(footer + sizeof(uint32_t));
+          chunk.m_maxTimestamp = MemRead<double>(footer + sizeof(uint32_t) + sizeof(double));
+          sealed = true;
+        }
+      }
+
+      if (!sealed)
+      {
+        // Chunk is not sealed, so time index is restored from items.
+        // Trailing bytes of an item which was not written completely are ignored.
+        bool first = true;
+        ReadItems(f, 0, chunk.m_itemCount, [&chunk, &first](TItem const & item)
+        {
+          chunk.m_minTimestamp = first ? item.m_timestamp : min(chunk.m_minTimestamp, item.m_timestamp);
+          chunk.m_maxTimestamp = first ? item.m_timestamp : max(chunk.m_maxTimestamp, item.m_timestamp);
+          first = false;
+          return true;
+        });
+      }
+    }
 
-  if (!WriteVersion(m_stream, kCurrentVersion))
-    MYTHROW(WriteException, ("File:", m_filePath));
+    m_chunks.push_back(chunk);
+    m_itemCount += chunk.m_itemCount;
 
-  // Write position is set to the first item in the file
-  ASSERT_EQUAL(m_stream.tellp(), GetItemOffset(0), ());
+    if (!sealed)
+    {
+      OpenActiveChunk(false /* create */);
+      // Only the last chunk may stay active.
+      if (i + 1 != indices.size())
+        SealActiveChunk();
+    }
+  }
 }
 
-void GpsTrackStorage::ForEach(std::function<bool(TItem const & item)> const & fn)
+void GpsTrackStorage::MigrateLegacyFile()
 {
-  ASSERT(m_stream.is_open(), ());
+  if (!Platform::IsFileExistsByFullPath(m_filePath))
+    return;
 
-  size_t i = GetFirstItemIndex();
+  try
+  {
+    vector<TItem> items;
+    {
+      my::FileData f(m_filePath, my::FileData::OP_READ);
+      uint64_t const fileSize = f.Size();
+      if (fileSize >= kHeaderSize && ReadVersion(f) == kLegacyVersion)
+      {
+        size_t const itemCount = static_cast<size_t>((fileSize - kHeaderSize) / kPointSize);
+        size_t const first = itemCount > m_maxItemCount ? itemCount - m_maxItemCount : 0;
+        items.reserve(itemCount - first);
+        ReadItems(f, first, itemCount, [&items](TItem const & item)
+        {
+          items.push_back(item);
+          return true;
+        });
+      }
+    }
 
-  // Set read position to the first item
-  m_stream.seekg(GetItemOffset(i), ios::beg);
-  if (!m_stream.good())
-    MYTHROW(ReadException, ("File:", m_filePath));
+    Append(items);
+    Sync();
 
-  vector<char> buff(min(kItemBlockSize, m_itemCount) * kPointSize);
-  for (; i < m_itemCount;)
+    // The legacy file is deleted only when all its points are in the chunks.
+    my::DeleteFileX(m_filePath);
+  }
+  catch (RootException const & e)
   {
-    size_t const n = min(m_itemCount - i, kItemBlockSize);
-
-    m_stream.read(&buff[0], n * kPointSize);
-    if (!m_stream.good())
-      MYTHROW(ReadException, ("File:", m_filePath));
+    LOG(LWARNING, ("Track file migration error:", e.Msg(), m_filePath));
 
-    for (size_t j = 0; j < n; ++j)
-    {      
-      TItem item;
-      Unpack(&buff[0] + j * kPointSize, item);
-      if (!fn(item))
-        return;
+    // Partially migrated chunks are dropped, so the migration is retried on the next start.
+    try
+    {
+      Clear();
+    }
+    catch (RootException const & e)
+    {
+      LOG(LWARNING, ("Can't drop partially migrated track:", e.Msg()));
     }
-
-    i += n;
   }
 }
 
-void GpsTrackStorage::TruncFile()
+void GpsTrackStorage::OpenActiveChunk(bool create)
 {
-  string const tmpFilePath = m_filePath + ".tmp";
+  ASSERT(!m_activeFile, ());
 
-  // Create a tmp file
-  fstream tmp(tmpFilePath, ios::in | ios::out | ios::binary | ios::trunc);
+  if (create)
+  {
+    Chunk chunk;
+    chunk.m_index = m_chunks.empty() ? 0 : m_chunks.back().m_index + 1;
+    m_chunks.push_back(chunk);
 
-  if (!tmp)
-    MYTHROW(WriteException, ("Unable to create temporary file:", tmpFilePath));
+    m_activeFile = my::make_unique<my::FileData>(GetChunkPath(chunk.m_index),
+                                                 my::FileData::OP_WRITE_TRUNCATE);
+    WriteVersion(*m_activeFile, kCurrentVersion);
+  }
+  else
+  {
+    m_activeFile = my::make_unique<my::FileData>(GetChunkPath(m_chunks.back().m_index),
+                                                 my::FileData::OP_WRITE_EXISTING);
+    // Write position is set after the last complete item.
+    uint64_t const offset = GetItemOffset(m_chunks.back().m_itemCount);
+    m_activeFile->Truncate(offset);
+    m_activeFile->Seek(offset);
+  }
 
-  if (!WriteVersion(tmp, kCurrentVersion))
-    MYTHROW(WriteException, ("File:", tmpFilePath));
+  m_needSync = true;
+}
 
-  size_t i = GetFirstItemIndex();
+void GpsTrackStorage::SealActiveChunk()
+{
+  ASSERT(m_activeFile, ());
 
-  // Set read position to the first item
-  m_stream.seekg(GetItemOffset(i), ios::beg);
-  if (!m_stream.good())
-    MYTHROW(ReadException, ("File:", m_filePath));
+  Chunk const & chunk = m_chunks.back();
 
-  size_t newItemCount = 0;
+  // Write position must be after last item position
+  ASSERT_EQUAL(m_activeFile->Pos(), GetItemOffset(chunk.m_itemCount), ());
 
-  // Copy items
-  vector<char> buff(min(kItemBlockSize, m_itemCount) * kPointSize);
-  for (; i < m_itemCount;)
-  {
-    size_t const n = min(m_itemCount - i, kItemBlockSize);
+  char footer[kFooterSize];
+  MemWrite<uint32_t>(footer, static_cast<uint32_t>(chunk.m_itemCount));
+  MemWrite<double>(footer + sizeof(uint32_t), chunk.m_minTimestamp);
+  MemWrite<double>(footer + sizeof(uint32_t) + sizeof(double), chunk.m_maxTimestamp);
+  MemWrite<uint32_t>(footer + kFooterSize - sizeof(uint32_t), kFooterMagic);
+  m_activeFile->Write(footer, kFooterSize);
 
-    m_stream.read(&buff[0], n * kPointSize);
-    if (!m_stream.good())
-      MYTHROW(ReadException, ("File:", m_filePath));
+  // Sealed chunk is never written again, so it is synced once.
+  m_activeFile->Sync();
+  m_activeFile.reset();
 
-    tmp.write(&buff[0], n * kPointSize);
-    if (!tmp.good())
-      MYTHROW(WriteException, ("File:", tmpFilePath));
+  m_needSync = false;
+  m_lastSyncTime = steady_clock::now();
+}
 
-    i += n;
-    newItemCount += n;
+void GpsTrackStorage::DropExtraChunks()
+{
+  // The active chunk is the last one and it is never dropped.
+  while (m_chunks.size() > 1 && m_itemCount - m_chunks.front().m_itemCount >= m_maxItemCount)
+  {
+    string const path = GetChunkPath(m_chunks.front().m_index);
+    if (!my::DeleteFileX(path))
+      MYTHROW(WriteException, ("File:", path));
+
+    m_itemCount -= m_chunks.front().m_itemCount;
+    m_chunks.pop_front();
   }
-  buff.clear();
-  buff.shrink_to_fit();
+}
+
+void GpsTrackStorage::AppendToActiveChunk(TItem const * items, size_t count)
+{
+  ASSERT(m_activeFile, ());
+
+  Chunk & chunk = m_chunks.back();
 
-  tmp.close();
-  m_stream.close();
+  // Write position must be after last item position
+  ASSERT_EQUAL(m_activeFile->Pos(), GetItemOffset(chunk.m_itemCount), ());
 
-  // Replace file
-  if (!my::DeleteFileX(m_filePath) ||
-      !my::RenameFileX(tmpFilePath, m_filePath))
+  vector<char> buff(min(kItemBlockSize, count) * kPointSize);
+  for (size_t i = 0; i < count;)
   {
-    MYTHROW(WriteException, ("File:", m_filePath));
-  }
+    size_t const n = min(count - i, kItemBlockSize);
 
-  // Reopen stream
-  m_stream.open(m_filePath, ios::in | ios::out | ios::binary | ios::ate);
+    for (size_t j = 0; j < n; ++j)
+    {
+      TItem const & item = items[i + j];
+      Pack(buff.data() + j * kPointSize, item);
+
+      if (chunk.m_itemCount + i + j == 0)
+      {
+        chunk.m_minTimestamp = chunk.m_maxTimestamp = item.m_timestamp;
+      }
+      else
+      {
+        chunk.m_minTimestamp = min(chunk.m_minTimestamp, item.m_timestamp);
+        chunk.m_maxTimestamp = max(chunk.m_maxTimestamp, item.m_timestamp);
+      }
+    }
+
+    m_activeFile->Write(buff.data(), n * kPointSize);
 
-  if (!m_stream)
-    MYTHROW(WriteException, ("File:", m_filePath));
+    i += n;
+  }
 
-  m_itemCount = newItemCount;
+  chunk.m_itemCount += count;
+  m_itemCount += count;
+  m_needSync = true;
+}
 
-  // Write position must be after last item position (end of file)
-  ASSERT_EQUAL(m_stream.tellp(), GetItemOffset(m_itemCount), ());
+string GpsTrackStorage::GetChunkPath(uint64_t index) const
+{
+  return m_filePath + "." + strings::to_string(index);
 }
 
 size_t GpsTrackStorage::GetFirstItemIndex() const
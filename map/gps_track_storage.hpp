@@ -2,14 +2,23 @@
 
 #include "platform/location.hpp"
 
+#include "coding/internal/file_data.hpp"
+
 #include "base/exception.hpp"
 #include "base/macros.hpp"
 
-#include "std/fstream.hpp"
+#include "std/chrono.hpp"
+#include "std/deque.hpp"
 #include "std/function.hpp"
 #include "std/limits.hpp"
 #include "std/string.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
 
+/// Append-only segmented log of gps track points.
+/// Points are stored in chunk files "<filePath>.<chunkIndex>" of at most chunkItemCount items.
+/// Every full (sealed) chunk ends with a footer which contains number of items and range of
+/// timestamps of the chunk. The last chunk is active, new points are appended to it.
 class GpsTrackStorage final
 {
 public:
@@ -19,15 +28,23 @@ public:
 
   using TItem = location::GpsInfo;
 
+  static size_t const kDefaultChunkItemCount;
+
   /// Opens storage with track data.
-  /// @param filePath - path to the file on disk
-  /// @param maxItemCount - max number of items in recycling file
+  /// @param filePath - base path of the track files on disk
+  /// @param maxItemCount - max number of items in the storage
+  /// @param chunkItemCount - max number of items in one chunk file
   /// @exception OpenException if seek fails.
-  GpsTrackStorage(string const & filePath, size_t maxItemCount);
+  /// @note Track file of previous format which is located at filePath is migrated to chunks.
+  GpsTrackStorage(string const & filePath, size_t maxItemCount,
+                  size_t chunkItemCount = kDefaultChunkItemCount);
+  ~GpsTrackStorage();
 
   /// Appends new point to the storage
   /// @param items - collection of gps track points.
   /// @exceptions WriteException if write fails or ReadException if read fails.
+  /// @note Written data is flushed on every call, but synced to the disk
+  /// not often than once per kSyncPeriod or when a chunk is sealed.
   void Append(vector<TItem> const & items);
 
   /// Removes all data from the storage
@@ -36,29 +53,56 @@ public:
 
   /// Reads the storage and calls functor for each item
   /// @param fn - callable function, return true to stop ForEach
+  /// @param fromTimestamp - only items with timestamp not less than fromTimestamp are read,
+  /// chunks which contain older items only are not read at all.
   /// @exceptions ReadException if read fails.
-  void ForEach(std::function<bool(TItem const & item)> const & fn);
+  void ForEach(std::function<bool(TItem const & item)> const & fn,
+               double fromTimestamp = numeric_limits<double>::lowest());
+
+  /// Returns max timestamp of items in the storage or 0 if the storage is empty.
+  double GetMaxTimestamp() const;
+
+  /// Forces written items to be synced to the disk.
+  /// @exceptions WriteException if sync fails.
+  void Sync();
+
+  /// Removes all files of the storage located at filePath.
+  static void DeleteFiles(string const & filePath);
 
 private:
   DISALLOW_COPY_AND_MOVE(GpsTrackStorage);
 
-  void TruncFile();
+  struct Chunk
+  {
+    uint64_t m_index = 0;
+    size_t m_itemCount = 0;
+    double m_minTimestamp = 0.0;
+    double m_maxTimestamp = 0.0;
+  };
+
+  void LoadChunks();
+  void MigrateLegacyFile();
+  void OpenActiveChunk(bool create);
+  void SealActiveChunk();
+  void DropExtraChunks();
+  void AppendToActiveChunk(TItem const * items, size_t count);
+  string GetChunkPath(uint64_t index) const;
   size_t GetFirstItemIndex() const;
 
   string const m_filePath;
   size_t const m_maxItemCount;
-  fstream m_stream;
-  size_t m_itemCount; // current number of items in file, read note
+  size_t const m_chunkItemCount;
+
+  // Chunks ordered by index, the last one is active.
+  deque<Chunk> m_chunks;
+  unique_ptr<my::FileData> m_activeFile;
+  size_t m_itemCount; // current number of items in all chunks
+  bool m_needSync;
+  steady_clock::time_point m_lastSyncTime;
 
   // NOTE
-  // New items append to the end of file, when file become too big, it is truncated.
-  // Here 'silly window sindrome' is possible: for example max file size is 100k items,
-  // and 99k items are filled, when 2k items is coming, then 98k items is copying to the tmp file
-  // which replaces origin file, and 2k added to the new file. Next time, when 1k items
-  // is comming, then again file truncated. That means that trunc will happens every time.
-  // Similar problem in TCP called 'silly window sindrome'.
-  // To prevent that problem, max file size can be 2 x m_maxItemCount items, when current number of items m_itemCount
-  // exceed 2 x m_maxItemCount, then second half of file - m_maxItemCount items is copying to the tmp file,
-  // which replaces origin file. That means that trunc will happens only then new m_maxItemCount items will be
-  // added but not every time.
+  // Truncation drops whole chunks only: the oldest chunk is removed when all its items are beyond
+  // the latest m_maxItemCount items. So up to m_maxItemCount + m_chunkItemCount items are stored,
+  // extra items at the beginning are skipped by ForEach. Unlike rewriting of a single file,
+  // removal of a chunk costs O(1) and does not depend on the track length.
 };
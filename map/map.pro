@@ -14,6 +14,7 @@ HEADERS += \
     api_mark_point.hpp \
     benchmark_tools.hpp \
     bookmark.hpp \
+    bookmark_binary.hpp \
     bookmark_manager.hpp \
     chart_generator.hpp \
     displacement_mode_manager.hpp \
@@ -48,6 +49,7 @@ SOURCES += \
     api_mark_point.cpp \
     benchmark_tools.cpp \
     bookmark.cpp \
+    bookmark_binary.cpp \
     bookmark_manager.cpp \
     chart_generator.cpp \
     displacement_mode_manager.cpp \
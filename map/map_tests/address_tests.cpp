@@ -44,3 +44,38 @@ UNIT_TEST(ReverseGeocoder_Smoke)
   TestAddress(coder, {53.89724, 27.54983}, "проспектнезависимости", "11");
   TestAddress(coder, {53.89745, 27.55835}, "улицакарламаркса", "18А");
 }
+
+UNIT_TEST(ReverseGeocoder_Batch)
+{
+  classificator::Load();
+
+  LocalCountryFile file = LocalCountryFile::MakeForTesting("minsk-pass");
+
+  Index index;
+  TEST_EQUAL(index.RegisterMap(file).second, MwmSet::RegResult::Success, ());
+
+  ReverseGeocoder coder(index);
+
+  vector<m2::PointD> centers;
+  for (double lat = 53.895; lat <= 53.9; lat += 0.001)
+  {
+    for (double lon = 27.54; lon <= 27.56; lon += 0.002)
+      centers.push_back(MercatorBounds::FromLatLon(lat, lon));
+  }
+
+  vector<ReverseGeocoder::Address> addrs;
+  coder.GetNearbyAddresses(centers, addrs, 2 /* threadsCount */);
+  TEST_EQUAL(addrs.size(), centers.size(), ());
+
+  for (size_t i = 0; i < centers.size(); ++i)
+  {
+    ReverseGeocoder::Address expected;
+    coder.GetNearbyAddress(centers[i], expected);
+
+    TEST_EQUAL(expected.m_building.m_id, addrs[i].m_building.m_id, (centers[i]));
+    TEST_EQUAL(expected.GetHouseNumber(), addrs[i].GetHouseNumber(), (centers[i]));
+    TEST_EQUAL(expected.GetDistance(), addrs[i].GetDistance(), (centers[i]));
+    TEST_EQUAL(expected.m_street.m_id, addrs[i].m_street.m_id, (centers[i]));
+    TEST_EQUAL(expected.GetStreetName(), addrs[i].GetStreetName(), (centers[i]));
+  }
+}
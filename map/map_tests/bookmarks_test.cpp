@@ -11,8 +11,11 @@
 #include "platform/platform.hpp"
 #include "platform/preferred_languages.hpp"
 
+#include "coding/file_writer.hpp"
 #include "coding/internal/file_data.hpp"
 
+#include "base/string_utils.hpp"
+
 #include "std/fstream.hpp"
 #include "std/unique_ptr.hpp"
 
@@ -662,3 +665,142 @@ UNIT_TEST(TrackParsingTest_2)
   TEST_GREATER(track->GetLayerCount(), 0, ());
   TEST_EQUAL(track->GetColor(0), dp::Color(57, 255, 32, 255), ());
 }
+
+namespace
+{
+void CheckEqualCategories(BookmarkCategory const & cat1, BookmarkCategory const & cat2)
+{
+  TEST_EQUAL(cat1.GetName(), cat2.GetName(), ());
+  TEST_EQUAL(cat1.IsVisible(), cat2.IsVisible(), ());
+  TEST_EQUAL(cat1.GetUserMarkCount(), cat2.GetUserMarkCount(), ());
+  TEST_EQUAL(cat1.GetTracksCount(), cat2.GetTracksCount(), ());
+  for (size_t i = 0; i < cat1.GetUserMarkCount(); ++i)
+  {
+    Bookmark const * bm1 = static_cast<Bookmark const *>(cat1.GetUserMark(i));
+    Bookmark const * bm2 = static_cast<Bookmark const *>(cat2.GetUserMark(i));
+    TEST(EqualBookmarks(*bm1, *bm2), (i));
+  }
+}
+
+void DeleteBinaryCategoryFiles(string const & file)
+{
+  my::DeleteFileX(file);
+  my::DeleteFileX(bookmarks::GetHeaderFilePath(file));
+}
+}  // namespace
+
+UNIT_TEST(Bookmarks_BinaryStorage)
+{
+  Framework framework(kFrameworkParams);
+  BookmarkCategory cat1("", framework);
+  TEST(cat1.LoadFromKML(make_unique<MemReader>(kmlString, strlen(kmlString))), ());
+  TEST(cat1.SaveToFile(), ());
+  string const file = cat1.GetFileName();
+  TEST(strings::EndsWith(file, BOOKMARKS_BINARY_FILE_EXTENSION), (file));
+  uint64_t snapshotSize = 0;
+  TEST(my::GetFileSize(file, snapshotSize), ());
+
+  // Edits are appended to the journal, the snapshot is not rewritten.
+  static_cast<Bookmark *>(cat1.CreateUserMark(m2::PointD(10, 10)))->SetData(
+      BookmarkData("New", "placemark-red"));
+  static_cast<Bookmark *>(cat1.GetUserMarkForEdit(2))->SetName("Edited");
+  cat1.DeleteUserMark(1);
+  cat1.CreateUserMark(m2::PointD(20, 20));
+  static_cast<Bookmark *>(cat1.GetUserMarkForEdit(1))->SetName("Edited again");
+  cat1.DeleteUserMark(0);
+  cat1.SetIsVisible(true);
+  TEST(cat1.SaveToFile(), ());
+  TEST_EQUAL(cat1.GetFileName(), file, ());
+  uint64_t dataSize = 0;
+  TEST(my::GetFileSize(file, dataSize), ());
+  TEST_GREATER(dataSize, snapshotSize, ());
+
+  // Only header is read on creation, bookmarks are loaded on the first access.
+  {
+    unique_ptr<BookmarkCategory> const cat2(BookmarkCategory::CreateFromFile(file, framework));
+    TEST(cat2.get(), ());
+    TEST(!cat2->IsLoaded(), ());
+    TEST_EQUAL(cat2->GetName(), cat1.GetName(), ());
+    TEST_EQUAL(cat2->GetUserMarkCount(), cat1.GetUserMarkCount(), ());
+    TEST(!cat2->IsLoaded(), ());
+    CheckEqualCategories(cat1, *cat2);
+    TEST(cat2->IsLoaded(), ());
+  }
+
+  // Incomplete record at the end of the file is skipped and is overwritten by the next save.
+  {
+    FileWriter writer(file, FileWriter::OP_APPEND);
+    uint8_t const kTornRecord[] = {0 /* AddBookmark */, 1, 2};
+    writer.Write(kTornRecord, sizeof(kTornRecord));
+  }
+  TEST(my::DeleteFileX(bookmarks::GetHeaderFilePath(file)), ());
+  {
+    unique_ptr<BookmarkCategory> const cat2(BookmarkCategory::CreateFromFile(file, framework));
+    TEST(cat2.get(), ());
+    CheckEqualCategories(cat1, *cat2);
+
+    cat2->DeleteUserMark(0);
+    TEST(cat2->SaveToFile(), ());
+    unique_ptr<BookmarkCategory> const cat3(BookmarkCategory::CreateFromFile(file, framework));
+    TEST(cat3.get(), ());
+    CheckEqualCategories(*cat2, *cat3);
+  }
+
+  // Journal records which are written before a crash are kept, even when the header
+  // was not updated.
+  {
+    unique_ptr<BookmarkCategory> const cat2(BookmarkCategory::CreateFromFile(file, framework));
+    TEST(cat2.get(), ());
+    cat2->Load();
+    string const headerFile = bookmarks::GetHeaderFilePath(file);
+    string const staleHeaderFile = headerFile + ".stale";
+    TEST(my::CopyFileX(headerFile, staleHeaderFile), ());
+
+    static_cast<Bookmark *>(cat2->GetUserMarkForEdit(0))->SetName("Saved before crash");
+    cat2->CreateUserMark(m2::PointD(30, 30));
+    TEST(cat2->SaveToFile(), ());
+    TEST(my::RenameFileX(staleHeaderFile, headerFile), ());
+
+    unique_ptr<BookmarkCategory> const cat3(BookmarkCategory::CreateFromFile(file, framework));
+    TEST(cat3.get(), ());
+    CheckEqualCategories(*cat2, *cat3);
+
+    // Corrupted record is skipped with the rest of the file.
+    {
+      my::FileData f(file, my::FileData::OP_WRITE_EXISTING);
+      uint64_t const size = f.Size();
+      f.Seek(size - 1);
+      uint8_t const kGarbage = 0xff;
+      f.Write(&kGarbage, sizeof(kGarbage));
+    }
+    TEST(my::DeleteFileX(headerFile), ());
+    unique_ptr<BookmarkCategory> const cat4(BookmarkCategory::CreateFromFile(file, framework));
+    TEST(cat4.get(), ());
+    TEST_EQUAL(cat4->GetUserMarkCount() + 1, cat2->GetUserMarkCount(), ());
+    TEST_EQUAL(static_cast<Bookmark const *>(cat4->GetUserMark(0))->GetName(), "Saved before crash",
+               ());
+  }
+
+  // Renamed category is written to the new file.
+  cat1.SetName("Binary storage test");
+  TEST(cat1.SaveToFile(), ());
+  TEST_NOT_EQUAL(cat1.GetFileName(), file, ());
+  TEST(!Platform::IsFileExistsByFullPath(file), ());
+  {
+    unique_ptr<BookmarkCategory> const cat2(BookmarkCategory::CreateFromFile(cat1.GetFileName(), framework));
+    TEST(cat2.get(), ());
+    CheckEqualCategories(cat1, *cat2);
+  }
+
+  // Category is exported to kml.
+  string const kmlFile = GetPlatform().SettingsDir() + "BinaryStorageExport.kml";
+  TEST(cat1.ExportToKMLFile(kmlFile), ());
+  {
+    unique_ptr<BookmarkCategory> const cat2(BookmarkCategory::CreateFromKMLFile(kmlFile, framework));
+    TEST(cat2.get(), ());
+    CheckEqualCategories(cat1, *cat2);
+  }
+
+  TEST(my::DeleteFileX(kmlFile), ());
+  DeleteBinaryCategoryFiles(cat1.GetFileName());
+}
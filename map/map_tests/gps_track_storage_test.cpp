@@ -12,6 +12,8 @@
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/bind.hpp"
 #include "std/chrono.hpp"
 
 namespace
@@ -42,8 +44,8 @@ UNIT_TEST(GpsTrackStorage_WriteReadWithoutTrunc)
   LOG(LINFO, ("Timestamp", ctime(&t), timestamp));
 
   string const filePath = GetGpsTrackFilePath();
-  MY_SCOPE_GUARD(gpsTestFileDeleter, bind(FileWriter::DeleteFileX, filePath));
-  FileWriter::DeleteFileX(filePath);
+  MY_SCOPE_GUARD(gpsTestFileDeleter, bind(GpsTrackStorage::DeleteFiles, filePath));
+  GpsTrackStorage::DeleteFiles(filePath);
 
   size_t const fileMaxItemCount = 100000;
 
@@ -108,8 +110,8 @@ UNIT_TEST(GpsTrackStorage_WriteReadWithTrunc)
   LOG(LINFO, ("Timestamp", ctime(&t), timestamp));
 
   string const filePath = GetGpsTrackFilePath();
-  MY_SCOPE_GUARD(gpsTestFileDeleter, bind(FileWriter::DeleteFileX, filePath));
-  FileWriter::DeleteFileX(filePath);
+  MY_SCOPE_GUARD(gpsTestFileDeleter, bind(GpsTrackStorage::DeleteFiles, filePath));
+  GpsTrackStorage::DeleteFiles(filePath);
 
   size_t const fileMaxItemCount = 100000;
 
@@ -184,3 +186,115 @@ UNIT_TEST(GpsTrackStorage_WriteReadWithTrunc)
     TEST_EQUAL(i, 0, ());
   }
 }
+
+UNIT_TEST(GpsTrackStorage_ChunksAndTimeIndex)
+{
+  time_t const t = system_clock::to_time_t(system_clock::now());
+  double const timestamp = t;
+
+  string const filePath = GetGpsTrackFilePath();
+  MY_SCOPE_GUARD(gpsTestFileDeleter, bind(GpsTrackStorage::DeleteFiles, filePath));
+  GpsTrackStorage::DeleteFiles(filePath);
+
+  size_t const maxItemCount = 1000;
+  size_t const chunkItemCount = 100;
+
+  vector<location::GpsInfo> points;
+  for (size_t i = 0; i < 2 * maxItemCount + chunkItemCount / 2; ++i)
+    points.emplace_back(Make(timestamp + i, ms::LatLon(-90 + i % 180, -180 + i % 360), 60 + i));
+
+  // Points are appended by small batches like in GpsTrack.
+  {
+    GpsTrackStorage stg(filePath, maxItemCount, chunkItemCount);
+    for (size_t i = 0; i < points.size(); i += 7)
+    {
+      size_t const last = min(points.size(), i + 7);
+      stg.Append(vector<location::GpsInfo>(points.begin() + i, points.begin() + last));
+    }
+    TEST_EQUAL(stg.GetMaxTimestamp(), points.back().m_timestamp, ());
+  }
+
+  // Only the last maxItemCount points are read, the storage is reopened with the active chunk.
+  {
+    GpsTrackStorage stg(filePath, maxItemCount, chunkItemCount);
+    TEST_EQUAL(stg.GetMaxTimestamp(), points.back().m_timestamp, ());
+
+    size_t const first = points.size() - maxItemCount;
+    size_t i = 0;
+    stg.ForEach([&](location::GpsInfo const & point)->bool
+    {
+      TEST_EQUAL(point.m_timestamp, points[first + i].m_timestamp, ());
+      TEST_EQUAL(point.m_latitude, points[first + i].m_latitude, ());
+      ++i;
+      return true;
+    });
+    TEST_EQUAL(i, maxItemCount, ());
+
+    // Time index.
+    double const fromTimestamp = points[points.size() - 10].m_timestamp;
+    i = 0;
+    stg.ForEach([&](location::GpsInfo const & point)->bool
+    {
+      TEST_EQUAL(point.m_timestamp, points[points.size() - 10 + i].m_timestamp, ());
+      ++i;
+      return true;
+    }, fromTimestamp);
+    TEST_EQUAL(i, 10, ());
+
+    // Append continues the active chunk.
+    stg.Append({Make(timestamp + points.size(), ms::LatLon(0, 0), 10)});
+    TEST_EQUAL(stg.GetMaxTimestamp(), timestamp + points.size(), ());
+  }
+
+  // Old chunks are dropped as whole files.
+  {
+    Platform::FilesList files;
+    Platform::GetFilesByRegExp(my::GetDirectory(filePath), "\\.[0-9]+$", files);
+    size_t chunkCount = 0;
+    for (auto const & file : files)
+    {
+      if (file.find("gpstrack_test.bin.") == 0)
+        ++chunkCount;
+    }
+    TEST_LESS_OR_EQUAL(chunkCount, maxItemCount / chunkItemCount + 1, ());
+  }
+}
+
+UNIT_TEST(GpsTrackStorage_MigrateLegacyFile)
+{
+  string const filePath = GetGpsTrackFilePath();
+  MY_SCOPE_GUARD(gpsTestFileDeleter, bind(GpsTrackStorage::DeleteFiles, filePath));
+  GpsTrackStorage::DeleteFiles(filePath);
+
+  size_t const maxItemCount = 100;
+
+  // Writes the file of the previous format: version 1 and plain items.
+  {
+    FileWriter writer(filePath);
+    uint32_t const version = 1;
+    writer.Write(&version, sizeof(version));
+    for (size_t i = 0; i < 2 * maxItemCount; ++i)
+    {
+      double const values[8] = {static_cast<double>(i), 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0};
+      writer.Write(values, sizeof(values));
+      uint8_t const source = location::EAndroidNative;
+      writer.Write(&source, sizeof(source));
+    }
+  }
+
+  {
+    GpsTrackStorage stg(filePath, maxItemCount, 30 /* chunkItemCount */);
+    TEST(!Platform::IsFileExistsByFullPath(filePath), ());
+
+    size_t i = 0;
+    stg.ForEach([&](location::GpsInfo const & point)->bool
+    {
+      TEST_EQUAL(point.m_timestamp, maxItemCount + i, ());
+      TEST_EQUAL(point.m_latitude, 1.0, ());
+      TEST_EQUAL(point.m_verticalAccuracy, 7.0, ());
+      ++i;
+      return true;
+    });
+    TEST_EQUAL(i, maxItemCount, ());
+  }
+}
@@ -83,8 +83,8 @@ seconds const kWaitForCallbackTimeout = seconds(5);
 UNIT_TEST(GpsTrack_Simple)
 {
   string const filePath = GetGpsTrackFilePath();
-  MY_SCOPE_GUARD(gpsTestFileDeleter, bind(FileWriter::DeleteFileX, filePath));
-  FileWriter::DeleteFileX(filePath);
+  MY_SCOPE_GUARD(gpsTestFileDeleter, bind(GpsTrackStorage::DeleteFiles, filePath));
+  GpsTrackStorage::DeleteFiles(filePath);
 
   time_t const t = system_clock::to_time_t(system_clock::now());
   double const timestamp = t;
@@ -150,8 +150,8 @@ UNIT_TEST(GpsTrack_Simple)
 UNIT_TEST(GpsTrack_EvictedByAdd)
 {
   string const filePath = GetGpsTrackFilePath();
-  MY_SCOPE_GUARD(gpsTestFileDeleter, bind(FileWriter::DeleteFileX, filePath));
-  FileWriter::DeleteFileX(filePath);
+  MY_SCOPE_GUARD(gpsTestFileDeleter, bind(GpsTrackStorage::DeleteFiles, filePath));
+  GpsTrackStorage::DeleteFiles(filePath);
 
   time_t const t = system_clock::to_time_t(system_clock::now());
   double const timestamp = t;
@@ -50,6 +50,42 @@ UNIT_TEST(Classificator_CheckConsistency)
   });
 }
 
+UNIT_TEST(Classificator_DrawRulesTable)
+{
+  UnitTestInitPlatform();
+  styles::RunForEveryMapStyle([](MapStyle)
+  {
+    Classificator const & c = classif();
+
+    // Rules from the table are the same as rules from the objects of the classificator.
+    for (uint32_t i = 0; i < c.GetTypesCount(); ++i)
+    {
+      uint32_t const type = c.GetTypeForIndex(i);
+      ClassifObject const * p = c.GetObject(type);
+
+      uint32_t drawableScales = 0;
+      for (int scale = 0; scale <= scales::GetUpperStyleScale(); ++scale)
+      {
+        if (p->IsDrawable(scale))
+          drawableScales |= uint32_t(1) << scale;
+
+        for (auto const ft : {feature::GEOM_POINT, feature::GEOM_LINE, feature::GEOM_AREA})
+        {
+          drule::KeysT expected;
+          p->GetSuitable(scale, ft, expected);
+
+          drule::KeysT keys;
+          c.GetSuitable(type, scale, ft, keys);
+          TEST_EQUAL(keys.size(), expected.size(), (c.GetReadableObjectName(type), scale, ft));
+          for (size_t j = 0; j < keys.size(); ++j)
+            TEST(keys[j] == expected[j], (c.GetReadableObjectName(type), scale, ft));
+        }
+      }
+      TEST_EQUAL(c.GetDrawableScales(type), drawableScales, (c.GetReadableObjectName(type)));
+    }
+  });
+}
+
 using namespace feature;
 
 namespace
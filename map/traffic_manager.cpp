@@ -12,6 +12,8 @@
 
 #include "platform/platform.hpp"
 
+#include "std/shared_ptr.hpp"
+
 #include "3party/Alohalytics/src/alohalytics.h"
 
 namespace
@@ -364,6 +366,9 @@ void TrafficManager::OnTrafficRequestFailed(traffic::TrafficInfo && info)
 
 void TrafficManager::OnTrafficDataResponse(traffic::TrafficInfo && info)
 {
+  bool hasPrevColoring = false;
+  bool evicted = false;
+  traffic::TrafficInfo::Coloring delta;
   {
     lock_guard<mutex> lock(m_mutex);
 
@@ -378,24 +383,54 @@ void TrafficManager::OnTrafficDataResponse(traffic::TrafficInfo && info)
 
     if (!info.GetColoring().empty())
     {
-      // Update cache.
+      // Update cache. The coloring is kept by drape and in |m_lastColoring|.
       size_t constexpr kElementSize = sizeof(traffic::TrafficInfo::RoadSegmentId) + sizeof(traffic::SpeedGroup);
-      size_t const dataSize = info.GetColoring().size() * kElementSize;
+      size_t const dataSize = 2 * info.GetColoring().size() * kElementSize;
       m_currentCacheSizeBytes += (dataSize - it->second.m_dataSize);
       it->second.m_dataSize = dataSize;
+
+      hasPrevColoring = !it->second.m_lastColoring.empty();
+      if (hasPrevColoring)
+      {
+        traffic::TrafficInfo::GetColoringDelta(it->second.m_lastColoring, info.GetColoring(),
+                                               delta);
+      }
+      it->second.m_lastColoring = info.GetColoring();
+
       ShrinkCacheToAllowableSize();
+      evicted = m_mwmCache.find(info.GetMwmId()) == m_mwmCache.end();
     }
 
     UpdateState();
   }
 
-  if (!info.GetColoring().empty())
-  {
-    m_drapeEngine.SafeCall(&df::DrapeEngine::UpdateTraffic,
-                           static_cast<traffic::TrafficInfo const &>(info));
+  // The removal of the mwm evicted by ShrinkCacheToAllowableSize() is already sent.
+  if (info.GetColoring().empty() || evicted)
+    return;
+
+  m_drapeEngine.SafeCall(&df::DrapeEngine::UpdateTraffic,
+                         static_cast<traffic::TrafficInfo const &>(info));
 
-    // Update traffic colors for routing.
-    m_observer.OnTrafficInfoAdded(move(info));
+  // Update traffic colors for routing. Usually only a small part of segments is changed
+  // between updates, so the changes are passed instead of the whole coloring.
+  // The observer is called on the same thread as OnTrafficInfoRemoved() in ClearCache(),
+  // so it gets the updates and the removals of an mwm in the right order.
+  if (!hasPrevColoring)
+  {
+    auto sharedInfo = make_shared<traffic::TrafficInfo>(move(info));
+    GetPlatform().RunOnGuiThread([this, sharedInfo]()
+    {
+      m_observer.OnTrafficInfoAdded(move(*sharedInfo));
+    });
+  }
+  else if (!delta.empty())
+  {
+    auto sharedDelta = make_shared<traffic::TrafficInfo::Coloring>(move(delta));
+    auto const mwmId = info.GetMwmId();
+    GetPlatform().RunOnGuiThread([this, mwmId, sharedDelta]()
+    {
+      m_observer.OnTrafficInfoUpdated(mwmId, move(*sharedDelta));
+    });
   }
 }
 
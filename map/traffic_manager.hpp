@@ -99,6 +99,10 @@ private:
     bool m_isWaitingForResponse;
 
     traffic::TrafficInfo::Availability m_lastAvailability;
+
+    // Coloring which has been passed to the observer last time. It's used to pass
+    // only changed segments on the next update and is counted in |m_dataSize|.
+    traffic::TrafficInfo::Coloring m_lastColoring;
   };
 
   void ThreadRoutine();
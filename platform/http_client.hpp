@@ -28,6 +28,7 @@ SOFTWARE.
 #include "std/string.hpp"
 #include "std/unordered_map.hpp"
 #include "std/utility.hpp"
+#include "std/vector.hpp"
 
 namespace platform
 {
@@ -44,6 +45,11 @@ public:
   // @note Implementations should transparently support all needed HTTP redirects.
   // Implemented for each platform.
   bool RunHttpRequest();
+  // Runs all of the |requests| concurrently and returns when they are finished.
+  // Results are stored in the requests as by RunHttpRequest(), ErrorCode() of a failed
+  // request is kNoError. Platforms which can't run requests concurrently run them one by one.
+  // Implemented for each platform.
+  static void RunHttpRequests(vector<HttpClient *> const & requests);
 
   // Shared methods for all platforms, implemented at http_client.cpp
   HttpClient & SetDebugMode(bool debug_mode);
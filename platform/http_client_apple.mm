@@ -142,4 +142,11 @@ bool HttpClient::RunHttpRequest()
 
   return false;
 }
+
+// static
+void HttpClient::RunHttpRequests(vector<HttpClient *> const & requests)
+{
+  for (auto request : requests)
+    request->RunHttpRequest();
+}
 } // namespace platform
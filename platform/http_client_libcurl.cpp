@@ -0,0 +1,447 @@
+#include "platform/http_client.hpp"
+
+#include "coding/zlib.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/macros.hpp"
+#include "base/stl_add.hpp"
+#include "base/string_utils.hpp"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <curl/curl.h>
+
+// curl_multi_wait() and CURLMOPT_MAX_HOST_CONNECTIONS are available since 7.30.0. Features of
+// later versions (HTTP/2 multiplexing, sharing of connections) are used when they are available.
+#if LIBCURL_VERSION_NUM < 0x071E00
+#error "libcurl 7.30.0 or later is required"
+#endif
+
+using namespace coding;
+using namespace std;
+
+namespace
+{
+// Number of idle easy handles which are kept for the following requests.
+size_t constexpr kMaxIdleHandles = 16;
+long constexpr kMaxHostConnections = 8;
+int constexpr kMultiWaitTimeoutMs = 1000;
+
+// Keeps libcurl state which is shared by all requests: easy handles, which are reset and
+// reused, and the share object with the connection, DNS and TLS session caches. So
+// sequential requests to a host reuse keep-alive connections, and requests of a batch
+// are multiplexed over HTTP/2 connections where the server supports it.
+class CurlSession
+{
+public:
+  static CurlSession & Instance()
+  {
+    static CurlSession session;
+    return session;
+  }
+
+  // Returns a handle with default options and the shared caches.
+  CURL * TakeHandle()
+  {
+    CURL * handle = nullptr;
+    {
+      lock_guard<mutex> lock(m_mutex);
+      if (!m_handles.empty())
+      {
+        handle = m_handles.back();
+        m_handles.pop_back();
+      }
+    }
+
+    if (handle)
+      curl_easy_reset(handle);
+    else
+      handle = curl_easy_init();
+
+    if (handle && m_share)
+      curl_easy_setopt(handle, CURLOPT_SHARE, m_share);
+    return handle;
+  }
+
+  void ReturnHandle(CURL * handle)
+  {
+    {
+      lock_guard<mutex> lock(m_mutex);
+      if (m_handles.size() < kMaxIdleHandles)
+      {
+        m_handles.push_back(handle);
+        return;
+      }
+    }
+    curl_easy_cleanup(handle);
+  }
+
+private:
+  CurlSession()
+  {
+    CHECK_EQUAL(curl_global_init(CURL_GLOBAL_DEFAULT), CURLE_OK, ());
+
+    m_share = curl_share_init();
+    if (!m_share)
+    {
+      LOG(LWARNING, ("Can't create curl share object, caches are not shared."));
+      return;
+    }
+
+    curl_share_setopt(m_share, CURLSHOPT_LOCKFUNC, &CurlSession::Lock);
+    curl_share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, &CurlSession::Unlock);
+    curl_share_setopt(m_share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+  }
+
+  ~CurlSession()
+  {
+    for (auto handle : m_handles)
+      curl_easy_cleanup(handle);
+    if (m_share)
+      curl_share_cleanup(m_share);
+    curl_global_cleanup();
+  }
+
+  static void Lock(CURL *, curl_lock_data data, curl_lock_access, void * session)
+  {
+    static_cast<CurlSession *>(session)->m_shareMutexes[data].lock();
+  }
+
+  static void Unlock(CURL *, curl_lock_data data, void * session)
+  {
+    static_cast<CurlSession *>(session)->m_shareMutexes[data].unlock();
+  }
+
+  CURLSH * m_share = nullptr;
+  array<mutex, CURL_LOCK_DATA_LAST> m_shareMutexes;
+
+  mutex m_mutex;
+  vector<CURL *> m_handles;
+
+  DISALLOW_COPY_AND_MOVE(CurlSession);
+};
+
+// State of a request which is run by libcurl.
+struct Transfer
+{
+  ~Transfer()
+  {
+    if (m_headers)
+      curl_slist_free_all(m_headers);
+    if (m_inputFile)
+      fclose(m_inputFile);
+    if (m_outputFile)
+      fclose(m_outputFile);
+    if (m_handle)
+      CurlSession::Instance().ReturnHandle(m_handle);
+  }
+
+  static size_t OnBody(char * data, size_t size, size_t count, void * transfer)
+  {
+    auto & self = *static_cast<Transfer *>(transfer);
+    size_t const bytes = size * count;
+    if (self.m_outputFile)
+      return fwrite(data, 1, bytes, self.m_outputFile);
+    self.m_body.append(data, bytes);
+    return bytes;
+  }
+
+  static size_t OnHeader(char * data, size_t size, size_t count, void * transfer)
+  {
+    auto & self = *static_cast<Transfer *>(transfer);
+    size_t const bytes = size * count;
+    // Headers of an interim response, like 100 Continue, are dropped.
+    if (bytes >= 5 && strncmp(data, "HTTP/", 5) == 0)
+      self.m_rawHeaders.clear();
+    self.m_rawHeaders.append(data, bytes);
+    return bytes;
+  }
+
+  CURL * m_handle = nullptr;
+  curl_slist * m_headers = nullptr;
+  FILE * m_inputFile = nullptr;
+  FILE * m_outputFile = nullptr;
+  string m_body;
+  string m_rawHeaders;
+  // Transfers which aren't finished by libcurl are failed.
+  CURLcode m_result = CURLE_FAILED_INIT;
+  array<char, CURL_ERROR_SIZE> m_error = {};
+};
+
+using Headers = vector<pair<string, string>>;
+
+Headers ParseHeaders(string const & raw)
+{
+  istringstream stream(raw);
+  Headers headers;
+  string line;
+  while (getline(stream, line))
+  {
+    auto const cr = line.rfind('\r');
+    if (cr != string::npos)
+      line.erase(cr);
+
+    auto const delims = line.find(": ");
+    if (delims != string::npos)
+      headers.emplace_back(line.substr(0, delims), line.substr(delims + 2));
+  }
+  return headers;
+}
+
+string Decompress(string const & compressed, string const & encoding)
+{
+  string decompressed;
+
+  if (encoding == "deflate")
+  {
+    ZLib::Inflate inflate(ZLib::Inflate::Format::ZLib);
+    inflate(compressed, back_inserter(decompressed));
+  }
+  else
+  {
+    ASSERT(false, ("Unsupported Content-Encoding:", encoding));
+  }
+
+  return decompressed;
+}
+}  // namespace
+
+namespace platform
+{
+bool HttpClient::RunHttpRequest()
+{
+  RunHttpRequests({this});
+  return m_errorCode != kNoError;
+}
+
+// static
+void HttpClient::RunHttpRequests(vector<HttpClient *> const & requests)
+{
+  // Sets up a transfer of |request|, returns false if it can't be started.
+  auto const prepare = [](HttpClient & request, Transfer & transfer)
+  {
+    request.m_errorCode = kNoError;
+    request.m_urlReceived.clear();
+    request.m_serverResponse.clear();
+
+    transfer.m_handle = CurlSession::Instance().TakeHandle();
+    if (!transfer.m_handle)
+      return false;
+
+    CURL * handle = transfer.m_handle;
+    curl_easy_setopt(handle, CURLOPT_URL, request.m_urlRequested.c_str());
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, transfer.m_error.data());
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, static_cast<long>(request.m_timeoutSec * 1000));
+#if LIBCURL_VERSION_NUM >= 0x072F00
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+#endif
+#if LIBCURL_VERSION_NUM >= 0x072B00
+    // Waits for a connection which can be multiplexed instead of opening a new one.
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+#endif
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, &Transfer::OnBody);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &transfer);
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, &Transfer::OnHeader);
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, &transfer);
+
+    for (auto const & header : request.m_headers)
+    {
+      // Empty values would remove headers which are added by libcurl.
+      if (!header.second.empty())
+      {
+        string const line = header.first + ": " + header.second;
+        transfer.m_headers = curl_slist_append(transfer.m_headers, line.c_str());
+      }
+    }
+    transfer.m_headers = curl_slist_append(transfer.m_headers, "Expect:");
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, transfer.m_headers);
+
+    if (!request.m_cookies.empty())
+      curl_easy_setopt(handle, CURLOPT_COOKIE, request.m_cookies.c_str());
+
+    if (!request.m_bodyData.empty())
+    {
+      curl_easy_setopt(handle, CURLOPT_POSTFIELDS, request.m_bodyData.data());
+      curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE_LARGE,
+                       static_cast<curl_off_t>(request.m_bodyData.size()));
+    }
+    else if (!request.m_inputFile.empty())
+    {
+      transfer.m_inputFile = fopen(request.m_inputFile.c_str(), "rb");
+      if (!transfer.m_inputFile)
+      {
+        LOG(LERROR, ("Can't open", request.m_inputFile));
+        return false;
+      }
+      fseek(transfer.m_inputFile, 0, SEEK_END);
+      long const size = ftell(transfer.m_inputFile);
+      fseek(transfer.m_inputFile, 0, SEEK_SET);
+      curl_easy_setopt(handle, CURLOPT_POST, 1L);
+      curl_easy_setopt(handle, CURLOPT_READDATA, transfer.m_inputFile);
+      curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(size));
+    }
+    curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, request.m_httpMethod.c_str());
+
+    if (!request.m_outputFile.empty())
+    {
+      transfer.m_outputFile = fopen(request.m_outputFile.c_str(), "wb");
+      if (!transfer.m_outputFile)
+      {
+        LOG(LERROR, ("Can't open", request.m_outputFile));
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Fills |request| by the finished |transfer|.
+  // Redirects are handled recursively as for other platforms.
+  auto const finish = [](HttpClient & request, Transfer & transfer)
+  {
+    if (transfer.m_outputFile)
+    {
+      fclose(transfer.m_outputFile);
+      transfer.m_outputFile = nullptr;
+    }
+
+    if (transfer.m_result != CURLE_OK)
+    {
+      LOG(LWARNING, ("Error", transfer.m_result, "while requesting", request.m_urlRequested,
+                     transfer.m_error.data()));
+      return;
+    }
+
+    long code = kNoError;
+    curl_easy_getinfo(transfer.m_handle, CURLINFO_RESPONSE_CODE, &code);
+    request.m_errorCode = static_cast<int>(code);
+
+    request.m_headers.clear();
+    string serverCookies;
+    string headerKey;
+    for (auto const & header : ParseHeaders(transfer.m_rawHeaders))
+    {
+      if (header.first == "Set-Cookie")
+      {
+        serverCookies += header.second + ", ";
+      }
+      else
+      {
+        if (header.first == "Location")
+          request.m_urlReceived = header.second;
+
+        if (request.m_loadHeaders)
+        {
+          headerKey = header.first;
+          strings::AsciiToLower(headerKey);
+          request.m_headers.emplace(headerKey, header.second);
+        }
+      }
+    }
+    request.m_headers.emplace("Set-Cookie", NormalizeServerCookies(move(serverCookies)));
+
+    if (request.m_urlReceived.empty())
+    {
+      request.m_urlReceived = request.m_urlRequested;
+      request.m_serverResponse = move(transfer.m_body);
+    }
+    else
+    {
+      LOG(LDEBUG, ("HTTP redirect", request.m_errorCode, "to", request.m_urlReceived));
+
+      HttpClient redirect(request.m_urlReceived);
+      redirect.SetCookies(request.CombinedCookies());
+
+      if (!redirect.RunHttpRequest())
+      {
+        request.m_errorCode = -1;
+        return;
+      }
+
+      request.m_errorCode = redirect.ErrorCode();
+      request.m_urlReceived = redirect.UrlReceived();
+      request.m_headers = move(redirect.m_headers);
+      request.m_serverResponse = move(redirect.m_serverResponse);
+    }
+
+    auto const it = request.m_headers.find("content-encoding");
+    if (it != request.m_headers.end())
+    {
+      request.m_serverResponse = Decompress(request.m_serverResponse, it->second);
+      LOG(LDEBUG, ("Response with", it->second, "is decompressed."));
+    }
+  };
+
+  vector<unique_ptr<Transfer>> transfers(requests.size());
+  vector<size_t> started;
+  for (size_t i = 0; i < requests.size(); ++i)
+  {
+    transfers[i] = my::make_unique<Transfer>();
+    if (prepare(*requests[i], *transfers[i]))
+      started.push_back(i);
+  }
+
+  if (started.size() == 1)
+  {
+    Transfer & transfer = *transfers[started.front()];
+    transfer.m_result = curl_easy_perform(transfer.m_handle);
+  }
+  else if (started.size() > 1)
+  {
+    CURLM * multi = curl_multi_init();
+    CHECK(multi, ());
+#if LIBCURL_VERSION_NUM >= 0x072B00
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
+    curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, kMaxHostConnections);
+
+    for (size_t const i : started)
+    {
+      curl_easy_setopt(transfers[i]->m_handle, CURLOPT_PRIVATE, transfers[i].get());
+      curl_multi_add_handle(multi, transfers[i]->m_handle);
+    }
+
+    int running = 0;
+    do
+    {
+      if (curl_multi_perform(multi, &running) != CURLM_OK)
+        break;
+      if (running != 0)
+        curl_multi_wait(multi, nullptr, 0, kMultiWaitTimeoutMs, nullptr);
+    } while (running != 0);
+
+    int left = 0;
+    while (CURLMsg * message = curl_multi_info_read(multi, &left))
+    {
+      if (message->msg != CURLMSG_DONE)
+        continue;
+
+      Transfer * transfer = nullptr;
+      curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &transfer);
+      transfer->m_result = message->data.result;
+    }
+
+    for (size_t const i : started)
+      curl_multi_remove_handle(multi, transfers[i]->m_handle);
+    curl_multi_cleanup(multi);
+  }
+
+  for (size_t const i : started)
+    finish(*requests[i], *transfers[i]);
+}
+}  // namespace platform
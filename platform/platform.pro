@@ -66,7 +66,11 @@ macx-*|iphone* {
   QMAKE_OBJECTIVE_CFLAGS += -fobjc-arc
 }
 
-linux*|win* {
+linux* {
+  SOURCES += http_client_libcurl.cpp
+}
+
+win* {
   SOURCES += http_client_curl.cpp
 }
 
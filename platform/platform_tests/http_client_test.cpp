@@ -0,0 +1,238 @@
+#include "testing/testing.hpp"
+
+#include "platform/http_client.hpp"
+
+#include "std/target_os.hpp"
+
+#if defined(OMIM_OS_LINUX)
+
+#include "base/stl_add.hpp"
+#include "base/string_utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace platform;
+using namespace std;
+
+namespace
+{
+// Minimal HTTP/1.1 server on the loopback interface which keeps connections alive.
+// It responds to "/echo" with the method and the body of a request and to "/redirect"
+// with a redirect to "/echo".
+class TestServer
+{
+public:
+  TestServer()
+  {
+    m_socket = socket(AF_INET, SOCK_STREAM, 0);
+    CHECK_GREATER_OR_EQUAL(m_socket, 0, ());
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    CHECK_EQUAL(bind(m_socket, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0, ());
+    CHECK_EQUAL(listen(m_socket, 16), 0, ());
+
+    socklen_t size = sizeof(addr);
+    CHECK_EQUAL(getsockname(m_socket, reinterpret_cast<sockaddr *>(&addr), &size), 0, ());
+    m_port = ntohs(addr.sin_port);
+
+    m_thread = thread([this] { Run(); });
+  }
+
+  ~TestServer()
+  {
+    shutdown(m_socket, SHUT_RDWR);
+    m_thread.join();
+    close(m_socket);
+
+    {
+      lock_guard<mutex> lock(m_mutex);
+      for (int const client : m_clients)
+        shutdown(client, SHUT_RDWR);
+    }
+    for (auto & worker : m_workers)
+      worker.join();
+  }
+
+  string GetUrl(string const & path) const
+  {
+    return "http://127.0.0.1:" + strings::to_string(m_port) + path;
+  }
+
+  size_t GetConnectionsCount() const { return m_connections; }
+
+private:
+  void Run()
+  {
+    while (true)
+    {
+      int const client = accept(m_socket, nullptr, nullptr);
+      if (client < 0)
+        break;
+
+      ++m_connections;
+      lock_guard<mutex> lock(m_mutex);
+      m_clients.push_back(client);
+      m_workers.emplace_back([this, client] { Serve(client); });
+    }
+  }
+
+  void Serve(int client)
+  {
+    string buffer;
+    char data[4096];
+    while (true)
+    {
+      size_t const headersEnd = buffer.find("\r\n\r\n");
+      if (headersEnd == string::npos)
+      {
+        ssize_t const read = recv(client, data, sizeof(data), 0);
+        if (read <= 0)
+          break;
+        buffer.append(data, static_cast<size_t>(read));
+        continue;
+      }
+
+      string const headers = buffer.substr(0, headersEnd);
+      size_t bodySize = 0;
+      auto const length = headers.find("Content-Length: ");
+      if (length != string::npos)
+        bodySize = strtoul(headers.c_str() + length + 16, nullptr, 10);
+
+      size_t const requestSize = headersEnd + 4 + bodySize;
+      while (buffer.size() < requestSize)
+      {
+        ssize_t const read = recv(client, data, sizeof(data), 0);
+        if (read <= 0)
+          return Close(client);
+        buffer.append(data, static_cast<size_t>(read));
+      }
+
+      string const method = headers.substr(0, headers.find(' '));
+      string const body = buffer.substr(headersEnd + 4, bodySize);
+      buffer.erase(0, requestSize);
+
+      string response;
+      if (headers.find(" /redirect ") != string::npos)
+      {
+        response = "HTTP/1.1 302 Found\r\nLocation: " + GetUrl("/echo") +
+                   "\r\nContent-Length: 0\r\n\r\n";
+      }
+      else
+      {
+        string const content = method + " " + body;
+        response = "HTTP/1.1 200 OK\r\nContent-Length: " + strings::to_string(content.size()) +
+                   "\r\nSet-Cookie: id=1; path=/\r\n\r\n" + content;
+      }
+
+      if (send(client, response.data(), response.size(), MSG_NOSIGNAL) !=
+          static_cast<ssize_t>(response.size()))
+      {
+        break;
+      }
+    }
+    Close(client);
+  }
+
+  void Close(int client)
+  {
+    lock_guard<mutex> lock(m_mutex);
+    shutdown(client, SHUT_RDWR);
+    close(client);
+    m_clients.erase(remove(m_clients.begin(), m_clients.end(), client), m_clients.end());
+  }
+
+  int m_socket = -1;
+  uint16_t m_port = 0;
+  atomic<size_t> m_connections{0};
+  thread m_thread;
+
+  mutex m_mutex;
+  vector<int> m_clients;
+  vector<thread> m_workers;
+};
+}  // namespace
+
+UNIT_TEST(HttpClient_KeepAlive)
+{
+  TestServer server;
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    HttpClient request(server.GetUrl("/echo"));
+    TEST(request.RunHttpRequest(), ());
+    TEST_EQUAL(request.ErrorCode(), 200, ());
+    TEST_EQUAL(request.ServerResponse(), "GET ", ());
+    TEST_EQUAL(request.CookieByName("id"), "1", ());
+  }
+
+  HttpClient request(server.GetUrl("/echo"));
+  request.SetBodyData(string("payload"), "text/plain");
+  TEST(request.RunHttpRequest(), ());
+  TEST_EQUAL(request.ErrorCode(), 200, ());
+  TEST_EQUAL(request.ServerResponse(), "POST payload", ());
+
+  // All of the requests use the same connection.
+  TEST_EQUAL(server.GetConnectionsCount(), 1, ());
+}
+
+UNIT_TEST(HttpClient_Redirect)
+{
+  TestServer server;
+
+  HttpClient request(server.GetUrl("/redirect"));
+  TEST(request.RunHttpRequest(), ());
+  TEST_EQUAL(request.ErrorCode(), 200, ());
+  TEST(request.WasRedirected(), ());
+  TEST_EQUAL(request.UrlReceived(), server.GetUrl("/echo"), ());
+  TEST_EQUAL(request.ServerResponse(), "GET ", ());
+}
+
+UNIT_TEST(HttpClient_Batch)
+{
+  size_t const kRequestsCount = 20;
+
+  TestServer server;
+
+  vector<unique_ptr<HttpClient>> requests;
+  vector<HttpClient *> batch;
+  for (size_t i = 0; i < kRequestsCount; ++i)
+  {
+    requests.push_back(my::make_unique<HttpClient>(server.GetUrl("/echo")));
+    requests.back()->SetBodyData(strings::to_string(i), "text/plain");
+    batch.push_back(requests.back().get());
+  }
+
+  // Request to a closed port fails without breaking the batch.
+  HttpClient failed("http://127.0.0.1:1/echo");
+  batch.push_back(&failed);
+
+  HttpClient::RunHttpRequests(batch);
+  for (size_t i = 0; i < kRequestsCount; ++i)
+  {
+    TEST_EQUAL(requests[i]->ErrorCode(), 200, (i));
+    TEST_EQUAL(requests[i]->ServerResponse(), "POST " + strings::to_string(i), (i));
+  }
+  TEST(failed.ErrorCode() == HttpClient::kNoError, (failed.ErrorCode()));
+  TEST(!failed.RunHttpRequest(), ());
+
+  // Connections of the batch are reused by the following batch.
+  size_t const connections = server.GetConnectionsCount();
+  HttpClient::RunHttpRequests(vector<HttpClient *>(batch.begin(), batch.end() - 1));
+  TEST_EQUAL(server.GetConnectionsCount(), connections, ());
+}
+#endif  // defined(OMIM_OS_LINUX)
@@ -27,6 +27,7 @@ SOURCES += \
     apk_test.cpp \
     country_file_tests.cpp \
     get_text_by_id_tests.cpp \
+    http_client_test.cpp \
     jansson_test.cpp \
     language_test.cpp \
     local_country_file_tests.cpp \
@@ -34,3 +35,4 @@ SOURCES += \
     measurement_tests.cpp \
     mwm_version_test.cpp \
     platform_test.cpp \
+    string_storage_tests.cpp \
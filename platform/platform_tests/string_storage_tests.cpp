@@ -0,0 +1,179 @@
+#include "testing/testing.hpp"
+
+#include "platform/platform.hpp"
+#include "platform/string_storage_base.hpp"
+
+#include "coding/file_name_utils.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+
+#include "base/string_utils.hpp"
+
+#include <string>
+
+using namespace platform;
+using namespace std;
+
+namespace
+{
+string const kStorageFile = "string_storage_test.ini";
+
+class ScopedStorageFiles
+{
+public:
+  ScopedStorageFiles() : m_path(GetPlatform().WritablePathForFile(kStorageFile)) { Delete(); }
+  ~ScopedStorageFiles() { Delete(); }
+
+  string const & GetPath() const { return m_path; }
+  string GetJournalPath() const { return m_path + ".journal"; }
+
+private:
+  void Delete()
+  {
+    uint64_t size;
+    if (my::GetFileSize(m_path, size))
+      my::DeleteFileX(m_path);
+    if (my::GetFileSize(GetJournalPath(), size))
+      my::DeleteFileX(GetJournalPath());
+  }
+
+  string const m_path;
+};
+
+void WriteFile(string const & path, string const & data)
+{
+  FileWriter writer(path);
+  writer.Write(data.data(), data.size());
+}
+
+string GetValue(StringStorageBase const & storage, string const & key)
+{
+  string value;
+  TEST(storage.GetValue(key, value), (key));
+  return value;
+}
+}  // namespace
+
+UNIT_TEST(StringStorage_WriteBehind)
+{
+  ScopedStorageFiles files;
+
+  {
+    StringStorageBase storage(files.GetPath());
+    for (size_t i = 0; i < 100; ++i)
+      storage.SetValue("Key" + strings::to_string(i), strings::to_string(i));
+    storage.DeleteKeyAndValue("Key0");
+
+    // Changes are visible before they're written.
+    string value;
+    TEST(!storage.GetValue("Key0", value), ());
+    TEST_EQUAL(GetValue(storage, "Key99"), "99", ());
+
+    storage.Flush();
+
+    StringStorageBase copy(files.GetPath());
+    TEST(!copy.GetValue("Key0", value), ());
+    for (size_t i = 1; i < 100; ++i)
+      TEST_EQUAL(GetValue(copy, "Key" + strings::to_string(i)), strings::to_string(i), ());
+
+    // Changes are written on destruction.
+    storage.SetValue("Key1", "One");
+  }
+
+  {
+    StringStorageBase storage(files.GetPath());
+    TEST_EQUAL(GetValue(storage, "Key1"), "One", ());
+    storage.Clear();
+  }
+
+  StringStorageBase storage(files.GetPath());
+  string value;
+  TEST(!storage.GetValue("Key1", value), ());
+}
+
+UNIT_TEST(StringStorage_Compaction)
+{
+  ScopedStorageFiles files;
+
+  string const value(100, 'x');
+  size_t const count = 2 * StringStorageBase::kMaxJournalSize / value.size();
+  {
+    StringStorageBase storage(files.GetPath());
+    for (size_t i = 0; i < count; ++i)
+    {
+      storage.SetValue(strings::to_string(i % 10), value + strings::to_string(i));
+      if (i % 100 == 0)
+        storage.Flush();
+    }
+  }
+
+  uint64_t size;
+  TEST(my::GetFileSize(files.GetJournalPath(), size), ());
+  TEST_LESS_OR_EQUAL(size, StringStorageBase::kMaxJournalSize, ());
+  TEST(my::GetFileSize(files.GetPath(), size), ());
+  TEST_LESS(size, 20 * value.size(), ());
+
+  StringStorageBase storage(files.GetPath());
+  for (size_t i = count - 10; i < count; ++i)
+    TEST_EQUAL(GetValue(storage, strings::to_string(i % 10)), value + strings::to_string(i), ());
+}
+
+UNIT_TEST(StringStorage_Recovery)
+{
+  ScopedStorageFiles files;
+
+  // Settings file of the old format.
+  WriteFile(files.GetPath(), "A=1\nB=2\nC=3\n");
+  {
+    // The last record of the journal is incomplete.
+    WriteFile(files.GetJournalPath(), "#0\nSA=10\nDB\nSD=4\nSC=30");
+    StringStorageBase storage(files.GetPath());
+    TEST_EQUAL(GetValue(storage, "A"), "10", ());
+    TEST_EQUAL(GetValue(storage, "C"), "3", ());
+    TEST_EQUAL(GetValue(storage, "D"), "4", ());
+    string value;
+    TEST(!storage.GetValue("B", value), ());
+
+    storage.SetValue("E", "5");
+  }
+
+  {
+    StringStorageBase storage(files.GetPath());
+    TEST_EQUAL(GetValue(storage, "C"), "3", ());
+    TEST_EQUAL(GetValue(storage, "E"), "5", ());
+  }
+
+  // The journal of another generation is ignored.
+  WriteFile(files.GetPath(), "#2\nA=1\n");
+  WriteFile(files.GetJournalPath(), "#1\nSA=10\n");
+  StringStorageBase storage(files.GetPath());
+  TEST_EQUAL(GetValue(storage, "A"), "1", ());
+  uint64_t size;
+  TEST(!my::GetFileSize(files.GetJournalPath(), size), ());
+}
+
+UNIT_TEST(StringStorage_WriteFailure)
+{
+  string const dir = GetPlatform().WritablePathForFile("string_storage_test_dir");
+  Platform::RmDirRecursively(dir);
+  string const path = my::JoinPath(dir, kStorageFile);
+
+  {
+    StringStorageBase storage(path);
+    storage.SetValue("A", "1");
+
+    // The directory doesn't exist, so the value is not written.
+    TEST(!storage.Flush(), ());
+
+    // Values which were not written are saved by a retry.
+    TEST_EQUAL(Platform::MkDir(dir), Platform::ERR_OK, ());
+    TEST(storage.Flush(), ());
+  }
+
+  {
+    StringStorageBase storage(path);
+    TEST_EQUAL(GetValue(storage, "A"), "1", ());
+  }
+
+  TEST(Platform::RmDirRecursively(dir), ());
+}
@@ -44,6 +44,9 @@ void Set(string const & key, Value const & value)
 
 inline void Delete(string const & key) { StringStorage::Instance().DeleteKeyAndValue(key); }
 inline void Clear() { StringStorage::Instance().Clear(); }
+/// Settings are saved in the background, call it to make sure they are written to the disk.
+/// @returns false if writing has failed.
+inline bool Flush() { return StringStorage::Instance().Flush(); }
 
 /// Use this function for running some stuff once according to date.
 /// @param[in]  date  Current date in format yymmdd.
@@ -68,6 +71,9 @@ public:
     return Instance().GetValue(key, strVal) && settings::FromString(strVal, outValue);
   }
 
+  // Blocks until all changes are written to the disk, returns false if writing has failed.
+  static bool Flush() { return Instance().StringStorageBase::Flush(); }
+
 private:
   static Settings & Instance();
   Settings();
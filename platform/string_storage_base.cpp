@@ -1,72 +1,170 @@
 #include "string_storage_base.hpp"
 
-#include "coding/reader_streambuf.hpp"
 #include "coding/file_reader.hpp"
-#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
 
 #include "base/logging.hpp"
 #include "base/exception.hpp"
-#include "base/stl_add.hpp"
+#include "base/string_utils.hpp"
 
-#include <istream>
+#include <chrono>
 
 using namespace std;
 
 namespace
 {
 constexpr char kDelimChar = '=';
-}  // namespace
+constexpr char kGenerationChar = '#';
 
-namespace platform
+// Journal records.
+constexpr char kSetRecord = 'S';
+constexpr char kDeleteRecord = 'D';
+constexpr char kClearRecord = 'C';
+
+// Changes which are made within this period are written to the disk together.
+auto constexpr kSaveDelay = chrono::milliseconds(300);
+// Failed writes are retried by compaction after this period.
+auto constexpr kRetryDelay = chrono::seconds(1);
+
+string MakeGenerationLine(uint64_t generation)
 {
-StringStorageBase::StringStorageBase(string const & path) : m_path(path)
+  return kGenerationChar + strings::to_string(generation) + '\n';
+}
+
+bool ReadFile(string const & path, string & data)
 {
   try
   {
-    LOG(LINFO, ("Settings path:", m_path));
-    ReaderStreamBuf buffer(make_unique<FileReader>(m_path));
-    istream stream(&buffer);
+    FileReader(path).ReadAsString(data);
+    return true;
+  }
+  catch (RootException const &)
+  {
+    return false;
+  }
+}
 
-    string line;
-    while (getline(stream, line))
-    {
-      if (line.empty())
-        continue;
+// Calls |fn| for every complete line of |data| and returns the size of the complete lines.
+template <typename Fn>
+size_t ForEachLine(string const & data, Fn && fn)
+{
+  size_t begin = 0;
+  while (begin < data.size())
+  {
+    size_t const end = data.find('\n', begin);
+    if (end == string::npos)
+      break;
+    if (end != begin)
+      fn(data.substr(begin, end - begin));
+    begin = end + 1;
+  }
+  return begin;
+}
 
-      size_t const delimPos = line.find(kDelimChar);
-      if (delimPos == string::npos)
-        continue;
+bool ParseGeneration(string const & line, uint64_t & generation)
+{
+  return !line.empty() && line[0] == kGenerationChar &&
+         strings::to_uint64(line.substr(1), generation);
+}
+}  // namespace
 
-      string const key = line.substr(0, delimPos);
-      string const value = line.substr(delimPos + 1);
-      if (!key.empty() && !value.empty())
-        m_values[key] = value;
-    }
-  }
-  catch (RootException const & ex)
+namespace platform
+{
+// static
+uint64_t constexpr StringStorageBase::kMaxJournalSize;
+
+StringStorageBase::StringStorageBase(string const & path)
+  : m_path(path), m_journalPath(path + ".journal")
+{
+  LOG(LINFO, ("Settings path:", m_path));
+  Load();
+  m_thread = thread(&StringStorageBase::ThreadRoutine, this);
+}
+
+StringStorageBase::~StringStorageBase()
+{
+  Flush();
   {
-    LOG(LWARNING, ("Loading settings:", ex.Msg()));
+    lock_guard<mutex> guard(m_mutex);
+    m_exit = true;
   }
+  m_changed.notify_one();
+  m_thread.join();
 }
 
-void StringStorageBase::Save() const
+void StringStorageBase::Load()
 {
+  string data;
+  bool const hasValues = ReadFile(m_path, data);
+
+  bool firstLine = true;
+  ForEachLine(data, [this, &firstLine](string const & line) {
+    // Files written before journaling have no generation line.
+    if (firstLine && ParseGeneration(line, m_generation))
+      return;
+    firstLine = false;
+
+    size_t const delimPos = line.find(kDelimChar);
+    if (delimPos == string::npos)
+      return;
+
+    string const key = line.substr(0, delimPos);
+    string const value = line.substr(delimPos + 1);
+    if (!key.empty() && !value.empty())
+      m_values[key] = value;
+  });
+
+  string journal;
+  if (ReadFile(m_journalPath, journal))
+    ReplayJournal(journal);
+  else if (!hasValues)
+    LOG(LWARNING, ("Can't load settings from", m_path));
+}
+
+void StringStorageBase::ReplayJournal(string const & journal)
+{
+  size_t const headerEnd = journal.find('\n');
+  uint64_t generation;
+  if (headerEnd == string::npos || !ParseGeneration(journal.substr(0, headerEnd), generation) ||
+      generation != m_generation)
+  {
+    // The journal is left from a compaction which was interrupted after the storage file
+    // had been replaced, all its changes are in the storage file.
+    my::DeleteFileX(m_journalPath);
+    return;
+  }
+
+  size_t const size =
+      headerEnd + 1 + ForEachLine(journal.substr(headerEnd + 1), [this](string const & line) {
+        switch (line[0])
+        {
+        case kSetRecord:
+        {
+          size_t const delimPos = line.find(kDelimChar);
+          if (delimPos != string::npos)
+            m_values[line.substr(1, delimPos - 1)] = line.substr(delimPos + 1);
+          break;
+        }
+        case kDeleteRecord: m_values.erase(line.substr(1)); break;
+        case kClearRecord: m_values.clear(); break;
+        default: LOG(LWARNING, ("Unknown settings journal record", line));
+        }
+      });
+
+  m_journalSize = size;
+  if (size == journal.size())
+    return;
+
+  // The last record was not written completely.
   try
   {
-    FileWriter file(m_path);
-    for (auto const & value : m_values)
-    {
-      string line(value.first);
-      line += kDelimChar;
-      line += value.second;
-      line += '\n';
-      file.Write(line.data(), line.size());
-    }
+    my::FileData file(m_journalPath, my::FileData::OP_WRITE_EXISTING);
+    file.Truncate(size);
   }
   catch (RootException const & ex)
   {
-    // Ignore all settings saving exceptions.
-    LOG(LWARNING, ("Saving settings:", ex.Msg()));
+    LOG(LWARNING, ("Can't truncate settings journal:", ex.Msg()));
+    m_compactionRequired = true;
   }
 }
 
@@ -74,7 +172,7 @@ void StringStorageBase::Clear()
 {
   lock_guard<mutex> guard(m_mutex);
   m_values.clear();
-  Save();
+  AddRecord(string(1, kClearRecord) + '\n');
 }
 
 bool StringStorageBase::GetValue(string const & key, string & outValue) const
@@ -93,8 +191,12 @@ void StringStorageBase::SetValue(string const & key, string && value)
 {
   lock_guard<mutex> guard(m_mutex);
 
+  auto const found = m_values.find(key);
+  if (found != m_values.end() && found->second == value)
+    return;
+
+  AddRecord(kSetRecord + key + kDelimChar + value + '\n');
   m_values[key] = move(value);
-  Save();
 }
 
 void StringStorageBase::DeleteKeyAndValue(string const & key)
@@ -105,7 +207,154 @@ void StringStorageBase::DeleteKeyAndValue(string const & key)
   if (found != m_values.end())
   {
     m_values.erase(found);
-    Save();
+    AddRecord(kDeleteRecord + key + '\n');
+  }
+}
+
+bool StringStorageBase::Flush()
+{
+  unique_lock<mutex> lock(m_mutex);
+  uint64_t const version = m_version;
+  if (m_savedVersion == version)
+    return true;
+
+  uint64_t const attempts = m_attempts;
+  m_flushRequested = true;
+  m_changed.notify_one();
+  m_saved.wait(lock, [this, version, attempts] {
+    return m_savedVersion >= version || (m_attempts != attempts && m_lastAttemptFailed);
+  });
+  return m_savedVersion >= version;
+}
+
+void StringStorageBase::AddRecord(string const & record)
+{
+  m_pending += record;
+  ++m_version;
+  m_changed.notify_one();
+}
+
+void StringStorageBase::ThreadRoutine()
+{
+  unique_lock<mutex> lock(m_mutex);
+  while (true)
+  {
+    m_changed.wait(lock, [this] { return m_exit || m_version != m_savedVersion; });
+    if (m_version == m_savedVersion)
+      return;
+
+    m_changed.wait_for(lock, kSaveDelay, [this] { return m_exit || m_flushRequested; });
+
+    uint64_t const version = m_version;
+    string records;
+    records.swap(m_pending);
+
+    bool const compact =
+        m_compactionRequired || m_journalSize + records.size() > kMaxJournalSize;
+    Container values;
+    if (compact)
+      values = m_values;
+
+    lock.unlock();
+    bool const saved = compact ? Compact(values) : AppendToJournal(records);
+    lock.lock();
+
+    ++m_attempts;
+    m_lastAttemptFailed = !saved;
+    if (saved)
+    {
+      m_savedVersion = version;
+      if (m_savedVersion == m_version)
+        m_flushRequested = false;
+    }
+    m_saved.notify_all();
+
+    if (!saved)
+    {
+      // |records| are dropped, all values are written by compaction on the next attempt.
+      if (m_exit)
+      {
+        LOG(LWARNING, ("Settings are not saved to", m_path));
+        return;
+      }
+      m_changed.wait_for(lock, kRetryDelay, [this] { return m_exit; });
+    }
   }
 }
+
+bool StringStorageBase::AppendToJournal(string const & records)
+{
+  try
+  {
+    if (m_journalSize == 0)
+    {
+      string const data = MakeGenerationLine(m_generation) + records;
+      my::FileData file(m_journalPath, my::FileData::OP_WRITE_TRUNCATE);
+      file.Write(data.data(), data.size());
+      file.Sync();
+      m_journalSize = data.size();
+    }
+    else
+    {
+      my::FileData file(m_journalPath, my::FileData::OP_APPEND);
+      file.Write(records.data(), records.size());
+      file.Sync();
+      m_journalSize += records.size();
+    }
+  }
+  catch (RootException const & ex)
+  {
+    // The journal may end with an incomplete record now, all values are saved by compaction.
+    LOG(LWARNING, ("Saving settings:", ex.Msg()));
+    m_compactionRequired = true;
+    return false;
+  }
+  return true;
+}
+
+bool StringStorageBase::Compact(Container const & values)
+{
+  uint64_t const generation = m_generation + 1;
+  string const tmpPath = m_path + ".tmp";
+  try
+  {
+    string data = MakeGenerationLine(generation);
+    for (auto const & value : values)
+    {
+      data += value.first;
+      data += kDelimChar;
+      data += value.second;
+      data += '\n';
+    }
+
+    my::FileData file(tmpPath, my::FileData::OP_WRITE_TRUNCATE);
+    file.Write(data.data(), data.size());
+    file.Sync();
+  }
+  catch (RootException const & ex)
+  {
+    // Ignore all settings saving exceptions.
+    LOG(LWARNING, ("Saving settings:", ex.Msg()));
+    my::DeleteFileX(tmpPath);
+    m_compactionRequired = true;
+    return false;
+  }
+
+  if (!my::RenameFileX(tmpPath, m_path))
+  {
+    LOG(LWARNING, ("Can't replace settings file", m_path));
+    my::DeleteFileX(tmpPath);
+    m_compactionRequired = true;
+    return false;
+  }
+
+  // The journal of the previous generation is ignored on loading if it's not deleted here.
+  uint64_t journalSize;
+  if (my::GetFileSize(m_journalPath, journalSize))
+    my::DeleteFileX(m_journalPath);
+  m_generation = generation;
+  m_journalSize = 0;
+  m_compactionRequired = false;
+  return true;
+}
 }  // namespace platform
@@ -1,25 +1,74 @@
 #pragma once
 
+#include <condition_variable>
+#include <cstdint>
 #include <map>
 #include <mutex>
 #include <string>
+#include <thread>
 
 namespace platform
 {
+// Key-value storage which is kept in memory and written to the disk on a background thread.
+//
+// Changes are appended to a journal file next to the storage file. Changes which are made
+// within a short period are written together. When the journal grows large it is compacted:
+// all values are written to the storage file which replaces the old one atomically,
+// and a new journal is started. Both files carry the generation of the storage,
+// so a journal which is left from a previous generation is never replayed.
+// An incomplete record at the end of the journal is dropped on loading.
 class StringStorageBase
 {
 public:
+  // Size of the journal which triggers compaction.
+  static uint64_t constexpr kMaxJournalSize = 64 * 1024;
+
   StringStorageBase(std::string const & path);
-  void Save() const;
+  ~StringStorageBase();
+
   void Clear();
   bool GetValue(std::string const & key, std::string & outValue) const;
   void SetValue(std::string const & key, std::string && value);
   void DeleteKeyAndValue(std::string const & key);
-  
+
+  // Blocks until all changes are written to the disk. Returns false if writing has failed,
+  // the changes are retried in the background then.
+  bool Flush();
+
 private:
   using Container = std::map<std::string, std::string>;
+
+  void Load();
+  void ReplayJournal(std::string const & journal);
+  void AddRecord(std::string const & record);
+
+  void ThreadRoutine();
+  // Both return false if the storage is not saved and compaction is required.
+  bool AppendToJournal(std::string const & records);
+  bool Compact(Container const & values);
+
   Container m_values;
-  mutable std::mutex m_mutex;
   std::string const m_path;
+  std::string const m_journalPath;
+
+  // Journal records which are not written yet.
+  std::string m_pending;
+  uint64_t m_version = 0;
+  uint64_t m_savedVersion = 0;
+  bool m_flushRequested = false;
+  bool m_exit = false;
+  // Number of writes made by the background thread and the result of the last one.
+  uint64_t m_attempts = 0;
+  bool m_lastAttemptFailed = false;
+
+  // Accessed by the background thread only, after loading.
+  uint64_t m_generation = 0;
+  uint64_t m_journalSize = 0;
+  bool m_compactionRequired = false;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_changed;
+  std::condition_variable m_saved;
+  std::thread m_thread;
 };
 }  // namespace platform
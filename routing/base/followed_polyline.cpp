@@ -8,6 +8,14 @@ namespace routing
 using namespace std;
 using Iter = routing::FollowedPolyline::Iter;
 
+namespace
+{
+// Segments are looked up by the index for polylines and intervals of at least this size.
+size_t constexpr kMinSegmentsCountForIndex = 64;
+// Rects of segments which only touch the query rect are found too.
+double constexpr kSegIndexEps = 1e-9;
+}  // namespace
+
 Iter FollowedPolyline::Begin() const
 {
   ASSERT(IsValid(), ());
@@ -77,6 +85,7 @@ void FollowedPolyline::Swap(FollowedPolyline & rhs)
   m_poly.Swap(rhs.m_poly);
   m_segDistance.swap(rhs.m_segDistance);
   m_segProj.swap(rhs.m_segProj);
+  swap(m_segIndex, rhs.m_segIndex);
   swap(m_current, rhs.m_current);
   swap(m_nextCheckpointIndex, rhs.m_nextCheckpointIndex);
 }
@@ -102,9 +111,49 @@ void FollowedPolyline::Update()
     m_segProj[i].SetBounds(p1, p2);
   }
 
+  m_segIndex.Clear();
+  if (n >= kMinSegmentsCountForIndex)
+  {
+    vector<pair<uint32_t, m2::RectD>> segments;
+    segments.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      m2::RectD rect(m_poly.GetPoint(i), m_poly.GetPoint(i + 1));
+      segments.emplace_back(static_cast<uint32_t>(i), rect);
+    }
+    m_segIndex.Build(move(segments));
+  }
+
   m_current = Iter(m_poly.Front(), 0);
 }
 
+template <class Fn>
+void FollowedPolyline::ForEachSegmentInRect(m2::RectD const & posRect, size_t startIdx,
+                                            size_t endIdx, Fn && fn) const
+{
+  if (endIdx - startIdx < kMinSegmentsCountForIndex || m_segIndex.IsEmpty())
+  {
+    for (size_t i = startIdx; i < endIdx; ++i)
+      fn(i);
+    return;
+  }
+
+  // A projection inside |posRect| lies on a segment, so the rect of the segment intersects
+  // |posRect|. Segments are sorted to keep the choice between equal projections the same
+  // as for the scan of the interval.
+  m2::RectD rect = posRect;
+  rect.Inflate(kSegIndexEps, kSegIndexEps);
+  vector<uint32_t> segments;
+  m_segIndex.ForEachInRect(rect, [&](uint32_t i) {
+    if (i >= startIdx && i < endIdx)
+      segments.push_back(i);
+  });
+  sort(segments.begin(), segments.end());
+
+  for (uint32_t const i : segments)
+    fn(i);
+}
+
 template <class DistanceFn>
 Iter FollowedPolyline::GetClosestProjectionInInterval(m2::RectD const & posRect,
                                                       DistanceFn const & distFn, size_t startIdx,
@@ -118,12 +167,11 @@ Iter FollowedPolyline::GetClosestProjectionInInterval(m2::RectD const & posRect,
 
   m2::PointD const currPos = posRect.Center();
 
-  for (size_t i = startIdx; i < endIdx; ++i)
-  {
+  ForEachSegmentInRect(posRect, startIdx, endIdx, [&](size_t i) {
     m2::PointD const pt = m_segProj[i](currPos);
 
     if (!posRect.IsPointInside(pt))
-      continue;
+      return;
 
     Iter it(pt, i);
     double const dp = distFn(it);
@@ -132,7 +180,7 @@ Iter FollowedPolyline::GetClosestProjectionInInterval(m2::RectD const & posRect,
       res = it;
       minDist = dp;
     }
-  }
+  });
 
   return res;
 }
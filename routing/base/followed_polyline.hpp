@@ -2,9 +2,11 @@
 
 #include "geometry/mercator.hpp"
 
+#include "geometry/packed_tree.hpp"
 #include "geometry/point2d.hpp"
 #include "geometry/polyline2d.hpp"
 
+#include <cstdint>
 #include <vector>
 
 namespace routing
@@ -92,6 +94,12 @@ private:
 
   void Update();
 
+  /// Calls |fn| for indices of segments in [startIdx, endIdx) in increasing order which may have
+  /// a projection of the center of |posRect| inside |posRect|.
+  template <class Fn>
+  void ForEachSegmentInRect(m2::RectD const & posRect, size_t startIdx, size_t endIdx,
+                            Fn && fn) const;
+
   m2::PolylineD m_poly;
 
   /// Iterator with the current position. Position sets with UpdateProjection methods.
@@ -101,6 +109,8 @@ private:
   std::vector<m2::ProjectionToSection<m2::PointD>> m_segProj;
   /// Accumulated cache of segments length in meters.
   std::vector<double> m_segDistance;
+  /// Index of segments by their rects, it's built for long polylines only.
+  m4::PackedTree<uint32_t> m_segIndex;
 };
 
 }  // namespace routing
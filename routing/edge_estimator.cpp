@@ -139,9 +139,17 @@ public:
   double CalcSegmentWeight(Segment const & segment, RoadGeometry const & road) const override;
   double GetUTurnPenalty() const override;
   bool LeapIsAllowed(NumMwmId mwmId) const override;
+  void SetDeparture(m2::PointD const & start, uint32_t timeOfDaySec) override;
+  void ResetDeparture() override { m_hasDeparture = false; }
 
 private:
+  SpeedGroup GetSpeedGroup(Segment const & segment, RoadGeometry const & road) const;
+
   shared_ptr<TrafficStash> m_trafficStash;
+
+  bool m_hasDeparture = false;
+  m2::PointD m_departurePoint;
+  uint32_t m_departureTimeOfDaySec = 0;
 };
 
 CarEstimator::CarEstimator(shared_ptr<TrafficStash> trafficStash, double maxSpeedKMpH)
@@ -150,6 +158,36 @@ CarEstimator::CarEstimator(shared_ptr<TrafficStash> trafficStash, double maxSpee
 {
 }
 
+void CarEstimator::SetDeparture(m2::PointD const & start, uint32_t timeOfDaySec)
+{
+  m_hasDeparture = true;
+  m_departurePoint = start;
+  m_departureTimeOfDaySec = timeOfDaySec;
+}
+
+SpeedGroup CarEstimator::GetSpeedGroup(Segment const & segment, RoadGeometry const & road) const
+{
+  // Current traffic is used for the segments which are reached during this time
+  // after the departure, time profiles are used for the rest of the route.
+  double constexpr kCurrentTrafficHorizonSec = 30 * 60;
+
+  SpeedGroup const current = m_trafficStash->GetSpeedGroup(segment);
+  if (!m_hasDeparture || !m_trafficStash->HasTimeProfiles())
+    return current;
+
+  // Time of arrival to the segment is estimated by the distance from the start with
+  // the speed of leap edges. So weight of a segment doesn't depend on a path to it
+  // and A* is still applicable.
+  m2::PointD const & point = road.GetPoint(segment.GetPointId(false /* front */));
+  double const arrivalSec = CalcLeapWeight(m_departurePoint, point);
+  if (arrivalSec < kCurrentTrafficHorizonSec)
+    return current;
+
+  SpeedGroup const expected = m_trafficStash->GetSpeedGroup(
+      segment, m_departureTimeOfDaySec + static_cast<uint32_t>(arrivalSec));
+  return expected != SpeedGroup::Unknown ? expected : current;
+}
+
 double CarEstimator::CalcSegmentWeight(Segment const & segment, RoadGeometry const & road) const
 {
   // Current time estimation are too optimistic.
@@ -162,7 +200,7 @@ double CarEstimator::CalcSegmentWeight(Segment const & segment, RoadGeometry con
 
   if (m_trafficStash)
   {
-    SpeedGroup const speedGroup = m_trafficStash->GetSpeedGroup(segment);
+    SpeedGroup const speedGroup = GetSpeedGroup(segment, road);
     ASSERT_LESS(speedGroup, SpeedGroup::Count, ());
     double const trafficFactor = CalcTrafficFactor(speedGroup);
     result *= trafficFactor;
@@ -14,6 +14,7 @@
 
 #include "geometry/point2d.hpp"
 
+#include <cstdint>
 #include <memory>
 
 namespace routing
@@ -40,6 +41,12 @@ public:
   // Check wherether leap is allowed on specified mwm or not.
   virtual bool LeapIsAllowed(NumMwmId mwmId) const = 0;
 
+  // Enables time-dependent weights of segments for a route which starts at |start|
+  // at |timeOfDaySec| seconds since local midnight. Estimators which don't take
+  // traffic into account ignore it.
+  virtual void SetDeparture(m2::PointD const & /* start */, uint32_t /* timeOfDaySec */) {}
+  virtual void ResetDeparture() {}
+
   static std::shared_ptr<EdgeEstimator> Create(VehicleType, double maxSpeedKMpH,
                                                std::shared_ptr<TrafficStash>);
 
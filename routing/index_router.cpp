@@ -35,6 +35,7 @@
 #include "base/stl_helpers.hpp"
 
 #include <algorithm>
+#include <ctime>
 #include <map>
 #include <utility>
 
@@ -114,6 +115,17 @@ shared_ptr<TrafficStash> CreateTrafficStash(VehicleType vehicleType, shared_ptr<
   return make_shared<TrafficStash>(trafficCache, numMwmIds);
 }
 
+// Returns the current local time in seconds since midnight.
+uint32_t GetCurrentTimeOfDaySec()
+{
+  time_t const now = time(nullptr);
+  tm const * localTime = localtime(&now);
+  if (localTime == nullptr)
+    return 0;
+  return static_cast<uint32_t>(localTime->tm_hour * 60 * 60 + localTime->tm_min * 60 +
+                               localTime->tm_sec);
+}
+
 template <typename Graph>
 IRouter::ResultCode ConvertResult(typename AStarAlgorithm<Graph>::Result result)
 {
@@ -279,6 +291,16 @@ double IndexRouter::BestEdgeComparator::GetSquaredDist(Edge const & edge) const
   return squaredDistance(m_point);
 }
 
+// IndexRouter::DepartureGuard --------------------------------------------------------------------
+IndexRouter::DepartureGuard::DepartureGuard(IndexRouter const & router, m2::PointD const & start)
+  : m_estimator(*router.m_estimator)
+{
+  if (router.m_timeDependentTraffic)
+    m_estimator.SetDeparture(start, GetCurrentTimeOfDaySec());
+}
+
+IndexRouter::DepartureGuard::~DepartureGuard() { m_estimator.ResetDeparture(); }
+
 // IndexRouter ------------------------------------------------------------------------------------
 IndexRouter::IndexRouter(VehicleType vehicleType, bool loadAltitudes,
                          CountryParentNameGetterFn const & countryParentNameGetterFn,
@@ -305,6 +327,7 @@ IndexRouter::IndexRouter(VehicleType vehicleType, bool loadAltitudes,
         m_vehicleType, CalcMaxSpeed(*m_numMwmIds, *m_vehicleModelFactory, m_vehicleType),
         m_trafficStash))
   , m_directionsEngine(CreateDirectionsEngine(m_vehicleType, m_numMwmIds, m_index))
+  , m_timeDependentTraffic(false)
 {
   CHECK(!m_name.empty(), ());
   CHECK(m_numMwmIds, ());
@@ -400,6 +423,7 @@ IRouter::ResultCode IndexRouter::DoCalculateRoute(Checkpoints const & checkpoint
     return IRouter::NeedMoreMaps;
 
   TrafficStash::Guard guard(m_trafficStash);
+  DepartureGuard departureGuard(*this, checkpoints.GetPointFrom());
   auto graph = MakeWorldGraph();
 
   vector<Segment> segments;
@@ -559,6 +583,7 @@ IRouter::ResultCode IndexRouter::AdjustRoute(Checkpoints const & checkpoints,
 {
   my::Timer timer;
   TrafficStash::Guard guard(m_trafficStash);
+  DepartureGuard departureGuard(*this, checkpoints.GetPointFrom());
   auto graph = MakeWorldGraph();
   graph->SetMode(WorldGraph::Mode::NoLeaps);
 
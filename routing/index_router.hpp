@@ -21,6 +21,7 @@
 
 #include "std/unique_ptr.hpp"
 
+#include <atomic>
 #include <functional>
 #include <set>
 #include <string>
@@ -69,7 +70,23 @@ public:
                             bool adjustToPrevRoute, RouterDelegate const & delegate,
                             Route & route) override;
 
+  // Enables time-dependent traffic: speed groups of the time profiles at the estimated
+  // time of arrival are used for the segments which are far from the start of a route.
+  void SetTimeDependentTraffic(bool enabled) { m_timeDependentTraffic = enabled; }
+
 private:
+  // Sets departure of the edge estimator if time-dependent traffic is enabled and resets
+  // it on destruction.
+  class DepartureGuard final
+  {
+  public:
+    DepartureGuard(IndexRouter const & router, m2::PointD const & start);
+    ~DepartureGuard();
+
+  private:
+    EdgeEstimator & m_estimator;
+  };
+
   IRouter::ResultCode DoCalculateRoute(Checkpoints const & checkpoints,
                                        m2::PointD const & startDirection,
                                        RouterDelegate const & delegate, Route & route);
@@ -123,6 +140,7 @@ private:
   std::shared_ptr<EdgeEstimator> m_estimator;
   std::unique_ptr<IDirectionsEngine> m_directionsEngine;
   std::unique_ptr<SegmentedRoute> m_lastRoute;
+  std::atomic<bool> m_timeDependentTraffic;
   std::unique_ptr<FakeEdgesContainer> m_lastFakeEdges;
 };
 }  // namespace routing
@@ -705,16 +705,33 @@ void RoutingSession::OnTrafficInfoRemoved(MwmSet::MwmId const & mwmId)
   RebuildRouteOnTrafficUpdate();
 }
 
+void RoutingSession::OnTrafficInfoUpdated(MwmSet::MwmId const & mwmId,
+                                          TrafficInfo::Coloring && delta)
+{
+  {
+    threads::MutexGuard guard(m_routingSessionMutex);
+    ApplyDelta(mwmId, delta);
+  }
+  RebuildRouteOnTrafficUpdate();
+}
+
+void RoutingSession::SetTrafficTimeProfile(MwmSet::MwmId const & mwmId,
+                                           shared_ptr<TimeProfile const> profile)
+{
+  threads::MutexGuard guard(m_routingSessionMutex);
+  SetTimeProfile(mwmId, move(profile));
+}
+
 shared_ptr<TrafficInfo::Coloring> RoutingSession::GetTrafficInfo(MwmSet::MwmId const & mwmId) const
 {
   threads::MutexGuard guard(m_routingSessionMutex);
   return TrafficCache::GetTrafficInfo(mwmId);
 }
 
-void RoutingSession::CopyTraffic(std::map<MwmSet::MwmId, std::shared_ptr<traffic::TrafficInfo::Coloring>> & trafficColoring) const
+shared_ptr<TrafficSnapshot const> RoutingSession::GetSnapshot() const
 {
   threads::MutexGuard guard(m_routingSessionMutex);
-  TrafficCache::CopyTraffic(trafficColoring);
+  return TrafficCache::GetSnapshot();
 }
 
 string DebugPrint(RoutingSession::State state)
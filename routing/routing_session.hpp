@@ -165,10 +165,17 @@ public:
   void OnTrafficInfoClear() override;
   void OnTrafficInfoAdded(traffic::TrafficInfo && info) override;
   void OnTrafficInfoRemoved(MwmSet::MwmId const & mwmId) override;
+  void OnTrafficInfoUpdated(MwmSet::MwmId const & mwmId,
+                            traffic::TrafficInfo::Coloring && delta) override;
+
+  // Sets typical speeds by time of day which are used for time-dependent routing.
+  // Null or empty |profile| removes the time profile of the mwm.
+  void SetTrafficTimeProfile(MwmSet::MwmId const & mwmId,
+                             shared_ptr<traffic::TimeProfile const> profile);
 
   // TrafficCache overrides:
   shared_ptr<traffic::TrafficInfo::Coloring> GetTrafficInfo(MwmSet::MwmId const & mwmId) const override;
-  void CopyTraffic(std::map<MwmSet::MwmId, std::shared_ptr<traffic::TrafficInfo::Coloring>> & trafficColoring) const override;
+  shared_ptr<traffic::TrafficSnapshot const> GetSnapshot() const override;
 
 private:
   struct DoReadyCallback
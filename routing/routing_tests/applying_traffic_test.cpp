@@ -7,6 +7,7 @@
 
 #include "routing/routing_tests/index_graph_tools.hpp"
 
+#include "traffic/time_profile.hpp"
 #include "traffic/traffic_info.hpp"
 
 #include "routing_common/car_model.hpp"
@@ -108,6 +109,11 @@ public:
     m_trafficStash->SetColoring(kTestNumMwmId, coloring);
   }
 
+  void SetTimeProfile(shared_ptr<TimeProfile const> profile)
+  {
+    m_trafficStash->SetTimeProfile(kTestNumMwmId, profile);
+  }
+
   shared_ptr<EdgeEstimator> GetEstimator() const { return m_estimator; }
 
   shared_ptr<TrafficStash> GetTrafficStash() const { return m_trafficStash; }
@@ -216,6 +222,42 @@ UNIT_CLASS_TEST(ApplyingTrafficTest, XXGraph_G0onF3andF6andG4onF8andF4)
   TestRouteGeometry(starter, AStarAlgorithm<IndexGraphStarter>::Result::OK, expectedGeom);
 }
 
+// Route through XX graph with SpeedGroup::G0 on F3 in the time profile.
+UNIT_CLASS_TEST(ApplyingTrafficTest, XXGraph_TimeProfileG0onF3)
+{
+  TimeProfile::Buckets buckets;
+  buckets.fill(SpeedGroup::G0);
+  auto profile = make_shared<TimeProfile>();
+  profile->Set({3 /* feature id */, 0 /* segment id */, TrafficInfo::RoadSegmentId::kForwardDirection},
+               buckets);
+  SetTimeProfile(profile);
+  TEST(GetTrafficStash()->Has(kTestNumMwmId), ());
+
+  unique_ptr<WorldGraph> graph = BuildXXGraph(GetEstimator());
+  auto const start = IndexGraphStarter::MakeFakeEnding(
+      Segment(kTestNumMwmId, 9, 0, true /* forward */), m2::PointD(2.0, -1.0), *graph);
+  auto const finish = IndexGraphStarter::MakeFakeEnding(
+      Segment(kTestNumMwmId, 6, 0, true /* forward */), m2::PointD(3.0, 3.0), *graph);
+
+  // Time profiles are not used without departure.
+  {
+    IndexGraphStarter starter(start, finish, 0 /* fakeNumerationStart */,
+                              false /* strictForward */, *graph);
+    vector<m2::PointD> const expectedGeom = {{2 /* x */, -1 /* y */}, {2, 0}, {1, 1}, {2, 2}, {3, 3}};
+    TestRouteGeometry(starter, AStarAlgorithm<IndexGraphStarter>::Result::OK, expectedGeom);
+  }
+
+  // F3 is far enough from the start to be estimated by the time profile.
+  GetEstimator()->SetDeparture(m2::PointD(2.0, -1.0), 8 * 60 * 60 /* timeOfDaySec */);
+  {
+    IndexGraphStarter starter(start, finish, 0 /* fakeNumerationStart */,
+                              false /* strictForward */, *graph);
+    vector<m2::PointD> const expectedGeom = {{2 /* x */, -1 /* y */}, {2, 0}, {3, 0}, {3, 1}, {2, 2}, {3, 3}};
+    TestRouteGeometry(starter, AStarAlgorithm<IndexGraphStarter>::Result::OK, expectedGeom);
+  }
+  GetEstimator()->ResetDeparture();
+}
+
 // Route through XX graph with changing traffic.
 UNIT_CLASS_TEST(ApplyingTrafficTest, XXGraph_ChangingTraffic)
 {
@@ -4,6 +4,12 @@
 
 #include "geometry/polyline2d.hpp"
 
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include <limits>
+#include <vector>
+
 namespace routing_test
 {
 using namespace routing;
@@ -12,6 +18,38 @@ namespace
 {
   static const m2::PolylineD kTestDirectedPolyline1({{0.0, 0.0}, {3.0, 0.0}, {5.0, 0.0}});
   static const m2::PolylineD kTestDirectedPolyline2({{6.0, 0.0}, {7.0, 0.0}});
+
+  // Projection of |posRect| center to the |polyline| which is chosen in the same way as
+  // FollowedPolyline::UpdateProjection() does, by the scan of all of the segments.
+  FollowedPolyline::Iter GetProjectionByScan(m2::PolylineD const & polyline,
+                                             m2::RectD const & posRect, size_t currentIdx)
+  {
+    m2::PointD const currPos = posRect.Center();
+    auto const getClosest = [&](size_t startIdx, size_t endIdx) {
+      FollowedPolyline::Iter res;
+      double minDist = std::numeric_limits<double>::max();
+      for (size_t i = startIdx; i < endIdx; ++i)
+      {
+        m2::ProjectionToSection<m2::PointD> proj;
+        proj.SetBounds(polyline.GetPoint(i), polyline.GetPoint(i + 1));
+        m2::PointD const pt = proj(currPos);
+        if (!posRect.IsPointInside(pt))
+          continue;
+        double const dist = MercatorBounds::DistanceOnEarth(pt, currPos);
+        if (dist < minDist)
+        {
+          res = FollowedPolyline::Iter(pt, i);
+          minDist = dist;
+        }
+      }
+      return res;
+    };
+
+    size_t const segmentsCount = polyline.GetSize() - 1;
+    size_t const hoppingBorderIdx = std::min(segmentsCount, currentIdx + 2);
+    auto const res = getClosest(currentIdx, hoppingBorderIdx);
+    return res.IsValid() ? res : getClosest(hoppingBorderIdx, segmentsCount);
+  }
 }  // namespace
 
 UNIT_TEST(FollowedPolylineAppend)
@@ -142,4 +180,59 @@ UNIT_TEST(FollowedPolylineGetDistanceFromBeginM)
       MercatorBounds::DistanceOnEarth(kTestDirectedPolyline1.Front(), point);
   TEST_ALMOST_EQUAL_ULPS(distance, masterDistance, ());
 }
+
+UNIT_TEST(FollowedPolylineReplay)
+{
+  // Zigzag route of about 10 meters long segments.
+  double const kStep = 1e-4;
+  size_t const kPointsCount = 20000;
+  std::vector<m2::PointD> points;
+  points.reserve(kPointsCount);
+  for (size_t i = 0; i < kPointsCount; ++i)
+    points.emplace_back(i * kStep, (i % 2 == 0 ? 0.0 : kStep));
+  m2::PolylineD const route(points);
+
+  // Track follows the route with a drift and sometimes leaves it or jumps ahead.
+  std::vector<m2::RectD> track;
+  for (size_t i = 0; i + 1 < kPointsCount; i += 3)
+  {
+    if (i % 999 == 0)
+      i += 1500;
+    if (i + 1 >= kPointsCount)
+      break;
+    m2::PointD const pt = (route.GetPoint(i) + route.GetPoint(i + 1)) / 2.0 +
+                          m2::PointD(0.0, (i % 7 == 0 ? 5.0 : 0.3) * kStep);
+    track.push_back(MercatorBounds::RectByCenterXYAndSizeInMeters(pt, 30.0));
+  }
+
+  FollowedPolyline polyline(route.Begin(), route.End());
+  size_t expectedIdx = 0;
+  my::Timer timer;
+  double scanSeconds = 0.0;
+  for (auto const & posRect : track)
+  {
+    timer.Reset();
+    auto const expected = GetProjectionByScan(route, posRect, expectedIdx);
+    scanSeconds += timer.ElapsedSeconds();
+
+    auto const res = polyline.UpdateProjection(posRect);
+    TEST_EQUAL(res.IsValid(), expected.IsValid(), ());
+    if (!expected.IsValid())
+      continue;
+
+    expectedIdx = expected.m_ind;
+    TEST_EQUAL(res.m_ind, expected.m_ind, ());
+    TEST_EQUAL(res.m_pt, expected.m_pt, ());
+  }
+
+  FollowedPolyline replayed(route.Begin(), route.End());
+  timer.Reset();
+  for (auto const & posRect : track)
+    replayed.UpdateProjection(posRect);
+  double const indexSeconds = timer.ElapsedSeconds();
+
+  TEST_EQUAL(replayed.GetCurrentIter().m_ind, polyline.GetCurrentIter().m_ind, ());
+  LOG(LINFO, ("Replay of", track.size(), "positions, scan:", scanSeconds,
+              "s, segments index:", indexSeconds, "s"));
+}
 }  // namespace routing_test
@@ -2,10 +2,19 @@
 
 #include "base/checked_cast.hpp"
 
-#include <map>
-
 namespace routing
 {
+namespace
+{
+traffic::TrafficInfo::RoadSegmentId GetRoadSegmentId(Segment const & segment)
+{
+  return traffic::TrafficInfo::RoadSegmentId(
+      segment.GetFeatureId(), base::asserted_cast<uint16_t>(segment.GetSegmentIdx()),
+      segment.IsForward() ? traffic::TrafficInfo::RoadSegmentId::kForwardDirection
+                          : traffic::TrafficInfo::RoadSegmentId::kReverseDirection);
+}
+}  // namespace
+
 TrafficStash::TrafficStash(traffic::TrafficCache const & source, shared_ptr<NumMwmIds> numMwmIds)
   : m_source(source), m_numMwmIds(std::move(numMwmIds))
 {
@@ -19,10 +28,7 @@ traffic::SpeedGroup TrafficStash::GetSpeedGroup(Segment const & segment) const
     return traffic::SpeedGroup::Unknown;
 
   auto const & coloring = itMwm->second;
-  auto const itSeg = coloring->find(traffic::TrafficInfo::RoadSegmentId(
-      segment.GetFeatureId(), base::asserted_cast<uint16_t>(segment.GetSegmentIdx()),
-      segment.IsForward() ? traffic::TrafficInfo::RoadSegmentId::kForwardDirection
-                          : traffic::TrafficInfo::RoadSegmentId::kReverseDirection));
+  auto const itSeg = coloring->find(GetRoadSegmentId(segment));
 
   if (itSeg == coloring->cend())
     return traffic::SpeedGroup::Unknown;
@@ -30,26 +36,61 @@ traffic::SpeedGroup TrafficStash::GetSpeedGroup(Segment const & segment) const
   return itSeg->second;
 }
 
+traffic::SpeedGroup TrafficStash::GetSpeedGroup(Segment const & segment,
+                                                uint32_t timeOfDaySec) const
+{
+  auto itMwm = m_mwmToTimeProfile.find(segment.GetMwmId());
+  if (itMwm == m_mwmToTimeProfile.cend())
+    return traffic::SpeedGroup::Unknown;
+
+  return itMwm->second->GetSpeedGroup(GetRoadSegmentId(segment), timeOfDaySec);
+}
+
 void TrafficStash::SetColoring(NumMwmId numMwmId,
                                std::shared_ptr<traffic::TrafficInfo::Coloring> coloring)
 {
   m_mwmToTraffic[numMwmId] = coloring;
+  m_snapshot.reset();
+}
+
+void TrafficStash::SetTimeProfile(NumMwmId numMwmId,
+                                  std::shared_ptr<traffic::TimeProfile const> profile)
+{
+  m_mwmToTimeProfile[numMwmId] = profile;
+  m_snapshot.reset();
 }
 
 bool TrafficStash::Has(NumMwmId numMwmId) const
 {
-  return m_mwmToTraffic.find(numMwmId) != m_mwmToTraffic.cend();
+  return m_mwmToTraffic.find(numMwmId) != m_mwmToTraffic.cend() ||
+         m_mwmToTimeProfile.find(numMwmId) != m_mwmToTimeProfile.cend();
 }
 
-void TrafficStash::CopyTraffic()
+void TrafficStash::UpdateFromSource()
 {
-  std::map<MwmSet::MwmId, std::shared_ptr<traffic::TrafficInfo::Coloring>> copy;
-  m_source.CopyTraffic(copy);
-  for (auto const & kv : copy)
+  auto snapshot = m_source.GetSnapshot();
+  CHECK(snapshot, ());
+  if (snapshot == m_snapshot)
+    return;
+
+  auto const getNumMwmId = [this](MwmSet::MwmId const & mwmId) {
+    return m_numMwmIds->GetId(mwmId.GetInfo()->GetLocalFile().GetCountryFile());
+  };
+
+  m_mwmToTraffic.clear();
+  for (auto const & kv : snapshot->m_colorings)
+  {
+    CHECK(kv.second, ());
+    m_mwmToTraffic[getNumMwmId(kv.first)] = kv.second;
+  }
+
+  m_mwmToTimeProfile.clear();
+  for (auto const & kv : snapshot->m_timeProfiles)
   {
-    auto const numMwmId = m_numMwmIds->GetId(kv.first.GetInfo()->GetLocalFile().GetCountryFile());
     CHECK(kv.second, ());
-    SetColoring(numMwmId, kv.second);
+    m_mwmToTimeProfile[getNumMwmId(kv.first)] = kv.second;
   }
+
+  m_snapshot = move(snapshot);
 }
 }  // namespace routing
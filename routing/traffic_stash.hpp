@@ -3,6 +3,7 @@
 #include "routing/num_mwm_id.hpp"
 #include "routing/segment.hpp"
 
+#include "traffic/time_profile.hpp"
 #include "traffic/traffic_cache.hpp"
 #include "traffic/traffic_info.hpp"
 
@@ -10,6 +11,7 @@
 
 #include "base/assert.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 
@@ -18,19 +20,14 @@ namespace routing
 class TrafficStash final
 {
 public:
+  // Takes the current traffic snapshot of the source for the lifetime of the guard.
   class Guard final
   {
   public:
     explicit Guard(std::shared_ptr<TrafficStash> stash) : m_stash(std::move(stash))
     {
       if (m_stash)
-        m_stash->CopyTraffic();
-    }
-
-    ~Guard()
-    {
-      if (m_stash)
-        m_stash->Clear();
+        m_stash->UpdateFromSource();
     }
 
   private:
@@ -40,16 +37,25 @@ public:
   TrafficStash(traffic::TrafficCache const & source, std::shared_ptr<NumMwmIds> numMwmIds);
 
   traffic::SpeedGroup GetSpeedGroup(Segment const & segment) const;
+  // Returns speed group of |segment| by the time profile at |timeOfDaySec| seconds since
+  // midnight or SpeedGroup::Unknown if there is no time profile for the segment.
+  traffic::SpeedGroup GetSpeedGroup(Segment const & segment, uint32_t timeOfDaySec) const;
   void SetColoring(NumMwmId numMwmId, std::shared_ptr<traffic::TrafficInfo::Coloring> coloring);
+  void SetTimeProfile(NumMwmId numMwmId, std::shared_ptr<traffic::TimeProfile const> profile);
+  // Returns true if there is current traffic or a time profile for the mwm.
   bool Has(NumMwmId numMwmId) const;
+  bool HasTimeProfiles() const { return !m_mwmToTimeProfile.empty(); }
 
 private:
-  void CopyTraffic();
-
-  void Clear() { m_mwmToTraffic.clear(); }
+  // Switches the stash to the current snapshot of the source. Snapshots are
+  // immutable, so colorings are reindexed only if the source has been updated.
+  void UpdateFromSource();
 
   traffic::TrafficCache const & m_source;
   shared_ptr<NumMwmIds> m_numMwmIds;
+  // Snapshot the maps below were built from, null if they were changed by hand.
+  std::shared_ptr<traffic::TrafficSnapshot const> m_snapshot;
   std::unordered_map<NumMwmId, std::shared_ptr<traffic::TrafficInfo::Coloring>> m_mwmToTraffic;
+  std::unordered_map<NumMwmId, std::shared_ptr<traffic::TimeProfile const>> m_mwmToTimeProfile;
 };
 }  // namespace routing
@@ -23,6 +23,7 @@ CBV CategoriesCache::Get(MwmContext const & context)
 
   auto const id = context.m_handle.GetId();
   auto const it = m_cache.find(id);
+  m_stats.Add(it != m_cache.cend() /* hit */);
   if (it != m_cache.cend())
     return it->second;
 
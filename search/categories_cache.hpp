@@ -2,6 +2,7 @@
 
 #include "search/categories_set.hpp"
 #include "search/cbv.hpp"
+#include "search/search_profile.hpp"
 
 #include "indexer/mwm_set.hpp"
 
@@ -37,12 +38,16 @@ public:
 
   inline void Clear() { m_cache.clear(); }
 
+  inline CacheStats const & GetStats() const { return m_stats; }
+  inline void ResetStats() { m_stats = CacheStats(); }
+
 private:
   CBV Load(MwmContext const & context) const;
 
   CategoriesSet m_categories;
   my::Cancellable const & m_cancellable;
   map<MwmSet::MwmId, CBV> m_cache;
+  CacheStats m_stats;
 };
 
 class StreetsCache : public CategoriesCache
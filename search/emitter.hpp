@@ -10,9 +10,11 @@ namespace search
 class Emitter
 {
 public:
-  inline void Init(SearchParams::TOnResults onResults)
+  // |profile| is attached to the end marker results, if it's not null.
+  inline void Init(SearchParams::TOnResults onResults, SearchProfile const * profile = nullptr)
   {
     m_onResults = onResults;
+    m_profile = profile;
     m_results.Clear();
   }
 
@@ -32,6 +34,8 @@ public:
   inline void Finish(bool cancelled)
   {
     m_results.SetEndMarker(cancelled);
+    if (m_profile)
+      m_results.SetProfile(make_shared<SearchProfile>(*m_profile));
     if (m_onResults)
       m_onResults(m_results);
     else
@@ -40,6 +44,7 @@ public:
 
 private:
   SearchParams::TOnResults m_onResults;
+  SearchProfile const * m_profile = nullptr;
   Results m_results;
 };
 }  // namespace search
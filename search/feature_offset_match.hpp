@@ -6,6 +6,7 @@
 #include "search/token_slice.hpp"
 
 #include "indexer/trie.hpp"
+#include "indexer/trie_reader.hpp"
 
 #include "base/dfa_helpers.hpp"
 #include "base/levenshtein_dfa.hpp"
@@ -16,7 +17,6 @@
 #include "base/uni_string_dfa.hpp"
 
 #include "std/algorithm.hpp"
-#include "std/queue.hpp"
 #include "std/target_os.hpp"
 #include "std/unique_ptr.hpp"
 #include "std/unordered_set.hpp"
@@ -29,8 +29,8 @@ namespace impl
 {
 namespace
 {
-template <typename Value>
-bool FindLangIndex(trie::Iterator<ValueList<Value>> const & trieRoot, uint8_t lang, uint32_t & langIx)
+template <typename TrieNode>
+bool FindLangIndex(TrieNode const & trieRoot, uint8_t lang, uint32_t & langIx)
 {
   ASSERT_LESS(trieRoot.m_edge.size(), numeric_limits<uint32_t>::max(), ());
 
@@ -47,52 +47,66 @@ bool FindLangIndex(trie::Iterator<ValueList<Value>> const & trieRoot, uint8_t la
   }
   return false;
 }
+
+// Moves |it| along |label| and returns false as soon as |it| rejects.
+template <typename DFAIt, typename Label>
+bool MoveAlongLabel(DFAIt & it, Label const & label)
+{
+  for (auto const c : label)
+  {
+    it.Move(c);
+    if (it.Rejects())
+      return false;
+  }
+  return true;
+}
 }  // namespace
 
-template <typename Value, typename DFA, typename ToDo>
-bool MatchInTrie(trie::Iterator<ValueList<Value>> const & trieRoot,
-                 strings::UniChar const * rootPrefix, size_t rootPrefixSize, DFA const & dfa,
-                 ToDo && toDo)
+template <typename TrieReader, typename DFA, typename ToDo>
+bool MatchInTrie(TrieReader & trieReader, trie::NodePosition const & trieRoot,
+                 strings::UniString const & rootPrefix, DFA const & dfa, ToDo && toDo)
 {
-  using TrieDFAIt = shared_ptr<trie::Iterator<ValueList<Value>>>;
   using DFAIt = typename DFA::Iterator;
-  using State = pair<TrieDFAIt, DFAIt>;
+  using State = pair<trie::NodePosition, DFAIt>;
 
-  queue<State> q;
+  // Depth-first traversal keeps only the positions of the nodes to visit, so nodes
+  // are decoded one by one into the buffers of |trieReader|.
+  vector<State> states;
 
   {
     auto it = dfa.Begin();
-    DFAMove(it, rootPrefix, rootPrefix + rootPrefixSize);
+    DFAMove(it, rootPrefix.begin(), rootPrefix.end());
     if (it.Rejects())
       return false;
-    q.emplace(trieRoot.Clone(), it);
+    states.emplace_back(trieRoot, it);
   }
 
   bool found = false;
 
-  while (!q.empty())
+  while (!states.empty())
   {
-    auto const p = q.front();
-    q.pop();
+    auto const position = states.back().first;
+    auto const dfaIt = states.back().second;
+    states.pop_back();
+
+    // Leaves have no edges, so there is nothing to read if their values are not needed.
+    if (position.m_isLeaf && !dfaIt.Accepts())
+      continue;
 
-    auto const & trieIt = p.first;
-    auto const & dfaIt = p.second;
+    auto const & node = trieReader.Read(position);
 
     if (dfaIt.Accepts())
     {
-      trieIt->m_valueList.ForEach(toDo);
+      node.m_valueList.ForEach(toDo);
       found = true;
     }
 
-    size_t const numEdges = trieIt->m_edge.size();
+    size_t const numEdges = node.m_edge.size();
     for (size_t i = 0; i < numEdges; ++i)
     {
-      auto const & edge = trieIt->m_edge[i];
-
       auto curIt = dfaIt;
-      strings::DFAMove(curIt, edge.m_label.begin(), edge.m_label.end());
-      if (!curIt.Rejects())
-        q.emplace(trieIt->GoToEdge(i), curIt);
+      if (MoveAlongLabel(curIt, node.m_edge[i].m_label))
+        states.emplace_back(node.GetChild(i), curIt);
     }
   }
 
@@ -155,29 +169,18 @@ public:
 };
 }  // namespace impl
 
-template <typename Value>
 struct TrieRootPrefix
 {
-  using Iterator = trie::Iterator<ValueList<Value>>;
-
-  Iterator const & m_root;
-  strings::UniChar const * m_prefix;
-  size_t m_prefixSize;
-
-  TrieRootPrefix(Iterator const & root, typename Iterator::Edge::TEdgeLabel const & edge)
-    : m_root(root)
+  template <typename Label>
+  TrieRootPrefix(trie::NodePosition const & root, Label const & edge) : m_root(root)
   {
-    if (edge.size() == 1)
-    {
-      m_prefix = 0;
-      m_prefixSize = 0;
-    }
-    else
-    {
-      m_prefix = &edge[1];
-      m_prefixSize = edge.size() - 1;
-    }
+    // The first char of the edge is the language code.
+    if (edge.size() > 1)
+      m_prefix.assign(edge.begin() + 1, edge.end());
   }
+
+  trie::NodePosition m_root;
+  strings::UniString m_prefix;
 };
 
 template <typename Filter, typename Value>
@@ -224,20 +227,23 @@ struct SearchTrieRequest
 // Calls |toDo| for each feature accepted by at least one DFA.
 //
 // *NOTE* |toDo| may be called several times for the same feature.
-template <typename DFA, typename Value, typename ToDo>
-void MatchInTrie(vector<DFA> const & dfas, TrieRootPrefix<Value> const & trieRoot, ToDo && toDo)
+template <typename DFA, typename TrieReader, typename ToDo>
+void MatchInTrie(vector<DFA> const & dfas, TrieReader & trieReader,
+                 TrieRootPrefix const & trieRoot, ToDo && toDo)
 {
   for (auto const & dfa : dfas)
-    impl::MatchInTrie(trieRoot.m_root, trieRoot.m_prefix, trieRoot.m_prefixSize, dfa, toDo);
+    impl::MatchInTrie(trieReader, trieRoot.m_root, trieRoot.m_prefix, dfa, toDo);
 }
 
 // Calls |toDo| for each feature in categories branch matching to |request|.
 //
 // *NOTE* |toDo| may be called several times for the same feature.
-template <typename DFA, typename Value, typename ToDo>
-bool MatchCategoriesInTrie(SearchTrieRequest<DFA> const & request,
-                           trie::Iterator<ValueList<Value>> const & trieRoot, ToDo && toDo)
+template <typename DFA, typename TrieReader, typename ToDo>
+bool MatchCategoriesInTrie(SearchTrieRequest<DFA> const & request, TrieReader & trieReader,
+                           ToDo && toDo)
 {
+  auto const & trieRoot = trieReader.Read(trieReader.GetRoot());
+
   uint32_t langIx = 0;
   if (!impl::FindLangIndex(trieRoot, search::kCategoriesLang, langIx))
     return false;
@@ -245,18 +251,20 @@ bool MatchCategoriesInTrie(SearchTrieRequest<DFA> const & request,
   auto const & edge = trieRoot.m_edge[langIx].m_label;
   ASSERT_GREATER_OR_EQUAL(edge.size(), 1, ());
 
-  auto const catRoot = trieRoot.GoToEdge(langIx);
-  MatchInTrie(request.m_categories, TrieRootPrefix<Value>(*catRoot, edge), toDo);
+  MatchInTrie(request.m_categories, trieReader, TrieRootPrefix(trieRoot.GetChild(langIx), edge),
+              toDo);
 
   return true;
 }
 
 // Calls |toDo| with trie root prefix and language code on each
 // language allowed by |request|.
-template <typename DFA, typename Value, typename ToDo>
-void ForEachLangPrefix(SearchTrieRequest<DFA> const & request,
-                       trie::Iterator<ValueList<Value>> const & trieRoot, ToDo && toDo)
+template <typename DFA, typename TrieReader, typename ToDo>
+void ForEachLangPrefix(SearchTrieRequest<DFA> const & request, TrieReader & trieReader,
+                       ToDo && toDo)
 {
+  // The root is cached by |trieReader|, so it stays valid while |toDo| reads other nodes.
+  auto const & trieRoot = trieReader.Read(trieReader.GetRoot());
   ASSERT_LESS(trieRoot.m_edge.size(), numeric_limits<uint32_t>::max(), ());
 
   uint32_t const numLangs = static_cast<uint32_t>(trieRoot.m_edge.size());
@@ -267,8 +275,7 @@ void ForEachLangPrefix(SearchTrieRequest<DFA> const & request,
     int8_t const lang = static_cast<int8_t>(edge[0]);
     if (edge[0] < search::kCategoriesLang && request.IsLangExist(lang))
     {
-      auto const langRoot = trieRoot.GoToEdge(langIx);
-      TrieRootPrefix<Value> langPrefix(*langRoot, edge);
+      TrieRootPrefix langPrefix(trieRoot.GetChild(langIx), edge);
       toDo(langPrefix, lang);
     }
   }
@@ -276,19 +283,21 @@ void ForEachLangPrefix(SearchTrieRequest<DFA> const & request,
 
 // Calls |toDo| for each feature whose description matches to
 // |request|.  Each feature will be passed to |toDo| only once.
-template <typename DFA, typename Value, typename Filter, typename ToDo>
-void MatchFeaturesInTrie(SearchTrieRequest<DFA> const & request,
-                         trie::Iterator<ValueList<Value>> const & trieRoot, Filter const & filter,
-                         ToDo && toDo)
+template <typename DFA, typename TrieReader, typename Filter, typename ToDo>
+void MatchFeaturesInTrie(SearchTrieRequest<DFA> const & request, TrieReader & trieReader,
+                         Filter const & filter, ToDo && toDo)
 {
+  using Value = typename TrieReader::TValue;
+
   TrieValuesHolder<Filter, Value> categoriesHolder(filter);
-  bool const categoriesMatched = MatchCategoriesInTrie(request, trieRoot, categoriesHolder);
+  bool const categoriesMatched = MatchCategoriesInTrie(request, trieReader, categoriesHolder);
 
   impl::OffsetIntersector<Filter, Value> intersector(filter);
 
-  ForEachLangPrefix(request, trieRoot,
-                    [&request, &intersector](TrieRootPrefix<Value> & langRoot, int8_t /* lang */) {
-                      MatchInTrie(request.m_names, langRoot, intersector);
+  ForEachLangPrefix(request, trieReader,
+                    [&request, &trieReader, &intersector](TrieRootPrefix & langRoot,
+                                                          int8_t /* lang */) {
+                      MatchInTrie(request.m_names, trieReader, langRoot, intersector);
                     });
 
   if (categoriesMatched)
@@ -298,19 +307,20 @@ void MatchFeaturesInTrie(SearchTrieRequest<DFA> const & request,
   intersector.ForEachResult(forward<ToDo>(toDo));
 }
 
-template <typename Value, typename Filter, typename ToDo>
-void MatchPostcodesInTrie(TokenSlice const & slice,
-                          trie::Iterator<ValueList<Value>> const & trieRoot,
+template <typename TrieReader, typename Filter, typename ToDo>
+void MatchPostcodesInTrie(TokenSlice const & slice, TrieReader & trieReader,
                           Filter const & filter, ToDo && toDo)
 {
   using namespace strings;
+  using Value = typename TrieReader::TValue;
+
+  auto const & trieRoot = trieReader.Read(trieReader.GetRoot());
 
   uint32_t langIx = 0;
   if (!impl::FindLangIndex(trieRoot, search::kPostcodesLang, langIx))
     return;
 
-  auto const & edge = trieRoot.m_edge[langIx].m_label;
-  auto const postcodesRoot = trieRoot.GoToEdge(langIx);
+  TrieRootPrefix const postcodesRoot(trieRoot.GetChild(langIx), trieRoot.m_edge[langIx].m_label);
 
   impl::OffsetIntersector<Filter, Value> intersector(filter);
   for (size_t i = 0; i < slice.Size(); ++i)
@@ -319,13 +329,13 @@ void MatchPostcodesInTrie(TokenSlice const & slice,
     {
       vector<PrefixDFAModifier<UniStringDFA>> dfas;
       slice.Get(i).ForEach([&dfas](UniString const & s) { dfas.emplace_back(UniStringDFA(s)); });
-      MatchInTrie(dfas, TrieRootPrefix<Value>(*postcodesRoot, edge), intersector);
+      MatchInTrie(dfas, trieReader, postcodesRoot, intersector);
     }
     else
     {
       vector<UniStringDFA> dfas;
       slice.Get(i).ForEach([&dfas](UniString const & s) { dfas.emplace_back(s); });
-      MatchInTrie(dfas, TrieRootPrefix<Value>(*postcodesRoot, edge), intersector);
+      MatchInTrie(dfas, trieReader, postcodesRoot, intersector);
     }
 
     intersector.NextStep();
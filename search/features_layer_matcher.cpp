@@ -9,17 +9,17 @@
 
 namespace search
 {
-/// Max distance from house to street where we do search matching
-/// even if there is no exact street written for this house.
-int constexpr kMaxApproxStreetDistanceM = 100;
+static_assert(FeaturesLayerMatcher::kInvalidId == BuildingsTable::kInvalidStreetId,
+              "Invalid street ids of the matcher and the buildings table must be the same.");
 
-FeaturesLayerMatcher::FeaturesLayerMatcher(Index const & index, my::Cancellable const & cancellable)
+FeaturesLayerMatcher::FeaturesLayerMatcher(Index const & index, my::Cancellable const & cancellable,
+                                           StreetVicinityLoader::GeometryCache & streetGeometryCache)
   : m_context(nullptr)
   , m_postcodes(nullptr)
   , m_reverseGeocoder(index)
   , m_nearbyStreetsCache("FeatureToNearbyStreets")
   , m_matchingStreetsCache("BuildingToStreet")
-  , m_loader(scales::GetUpperScale(), ReverseGeocoder::kLookupRadiusM)
+  , m_loader(scales::GetUpperScale(), ReverseGeocoder::kLookupRadiusM, streetGeometryCache)
   , m_cancellable(cancellable)
 {
 }
@@ -46,6 +46,37 @@ void FeaturesLayerMatcher::OnQueryFinished()
   m_loader.OnQueryFinished();
 }
 
+m2::PointD FeaturesLayerMatcher::GetCenter(uint32_t id)
+{
+  m2::PointD center;
+  if (!m_context->IsEdited(id) && m_context->GetCenter(id, center))
+    return center;
+
+  FeatureType feature;
+  GetByIndex(id, feature);
+  return feature::GetCenter(feature, FeatureType::WORST_GEOMETRY);
+}
+
+m2::RectD FeaturesLayerMatcher::GetBuildingRect(uint32_t id)
+{
+  BuildingsTable::Building building;
+  if (m_context->GetBuilding(id, building))
+  {
+    if (building.m_rect.IsValid())
+      return building.m_rect;
+    return MercatorBounds::RectByCenterXYAndSizeInMeters(building.m_center, kBuildingRadiusMeters);
+  }
+
+  FeatureType feature;
+  GetByIndex(id, feature);
+  if (feature.GetFeatureType() == feature::GEOM_POINT)
+  {
+    auto const center = feature::GetCenter(feature, FeatureType::WORST_GEOMETRY);
+    return MercatorBounds::RectByCenterXYAndSizeInMeters(center, kBuildingRadiusMeters);
+  }
+  return feature.GetLimitRect(FeatureType::WORST_GEOMETRY);
+}
+
 uint32_t FeaturesLayerMatcher::GetMatchingStreet(uint32_t houseId)
 {
   FeatureType feature;
@@ -95,6 +126,12 @@ FeaturesLayerMatcher::TStreets const & FeaturesLayerMatcher::GetNearbyStreetsImp
 
 uint32_t FeaturesLayerMatcher::GetMatchingStreetImpl(uint32_t houseId, FeatureType & houseFeature)
 {
+  // Streets of the buildings which are not edited are precomputed by
+  // the generator, unless the streets of the mwm are edited.
+  BuildingsTable::Building building;
+  if (!m_context->HasEditedStreets() && m_context->GetBuilding(houseId, building))
+    return building.m_streetId;
+
   // Check if this feature is modified - the logic will be different.
   string streetName;
   bool const edited =
@@ -132,7 +169,7 @@ uint32_t FeaturesLayerMatcher::GetMatchingStreetImpl(uint32_t houseId, FeatureTy
 
   // If there is no saved street for feature, assume that it's a nearest street if it's too close.
   if (result == kInvalidId && !streets.empty() &&
-      streets[0].m_distanceMeters < kMaxApproxStreetDistanceM)
+      streets[0].m_distanceMeters < ReverseGeocoder::kMaxApproxStreetDistanceM)
   {
     result = streets[0].m_id.m_index;
   }
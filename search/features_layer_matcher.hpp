@@ -61,7 +61,8 @@ public:
   static int constexpr kBuildingRadiusMeters = 50;
   static int constexpr kStreetRadiusMeters = 100;
 
-  FeaturesLayerMatcher(Index const & index, my::Cancellable const & cancellable);
+  FeaturesLayerMatcher(Index const & index, my::Cancellable const & cancellable,
+                       StreetVicinityLoader::GeometryCache & streetGeometryCache);
   void SetContext(MwmContext * context);
   void SetPostcodes(CBV const * postcodes);
 
@@ -118,31 +119,12 @@ private:
     poiCenters.reserve(pois.size());
 
     for (size_t i = 0; i < pois.size(); ++i)
-    {
-      FeatureType poiFt;
-      GetByIndex(pois[i], poiFt);
-      poiCenters.emplace_back(feature::GetCenter(poiFt, FeatureType::WORST_GEOMETRY), i /* id */);
-    }
+      poiCenters.emplace_back(GetCenter(pois[i]), i /* id */);
 
     vector<PointRectMatcher::RectIdPair> buildingRects;
     buildingRects.reserve(buildings.size());
     for (size_t i = 0; i < buildings.size(); ++i)
-    {
-      FeatureType buildingFt;
-      GetByIndex(buildings[i], buildingFt);
-      if (buildingFt.GetFeatureType() == feature::GEOM_POINT)
-      {
-        auto const center = feature::GetCenter(buildingFt, FeatureType::WORST_GEOMETRY);
-        buildingRects.emplace_back(
-            MercatorBounds::RectByCenterXYAndSizeInMeters(center, kBuildingRadiusMeters),
-            i /* id */);
-      }
-      else
-      {
-        buildingRects.emplace_back(buildingFt.GetLimitRect(FeatureType::WORST_GEOMETRY),
-                                   i /* id */);
-      }
-    }
+      buildingRects.emplace_back(GetBuildingRect(buildings[i]), i /* id */);
 
     PointRectMatcher::Match(poiCenters, buildingRects, PointRectMatcher::RequestType::Any,
                             [&](size_t poiId, size_t buildingId) {
@@ -162,22 +144,53 @@ private:
     if (queryParse.empty())
       return;
 
+    bool const hasBuildingsTable = m_context->HasBuildingsTable();
+    // Streets of the buildings table are matched by the generator, so
+    // they are ignored when streets are created or deleted by user.
+    bool const useTableStreets = hasBuildingsTable && !m_context->HasEditedStreets();
     for (size_t i = 0; i < pois.size(); ++i)
     {
-      m_context->ForEachFeature(
-          MercatorBounds::RectByCenterXYAndSizeInMeters(poiCenters[i].m_point, kBuildingRadiusMeters),
-          [&](FeatureType & ft) {
-            if (m_postcodes && !m_postcodes->HasBit(ft.GetID().m_index))
-              return;
-            if (house_numbers::HouseNumbersMatch(strings::MakeUniString(ft.GetHouseNumber()),
-                                                 queryParse))
-            {
-              double const distanceM =
-                  MercatorBounds::DistanceOnEarth(feature::GetCenter(ft), poiCenters[i].m_point);
-              if (distanceM < kBuildingRadiusMeters)
-                fn(pois[i], ft.GetID().m_index);
-            }
-          });
+      auto const & poiCenter = poiCenters[i].m_point;
+      auto const matchBuilding = [&](uint32_t id, strings::UniString const & houseNumber,
+                                     m2::PointD const & center) {
+        if (house_numbers::HouseNumbersMatch(houseNumber, queryParse) &&
+            MercatorBounds::DistanceOnEarth(center, poiCenter) < kBuildingRadiusMeters)
+        {
+          fn(pois[i], id);
+        }
+      };
+
+      auto const rect =
+          MercatorBounds::RectByCenterXYAndSizeInMeters(poiCenter, kBuildingRadiusMeters);
+
+      if (!hasBuildingsTable)
+      {
+        m_context->ForEachFeature(rect, [&](FeatureType & ft) {
+          if (m_postcodes && !m_postcodes->HasBit(ft.GetID().m_index))
+            return;
+          matchBuilding(ft.GetID().m_index, strings::MakeUniString(ft.GetHouseNumber()),
+                        feature::GetCenter(ft));
+        });
+        continue;
+      }
+
+      // Only edited features have to be loaded, all other features
+      // which are not in the buildings table have no house numbers.
+      m_context->ForEachIndex(rect, [&](uint32_t id) {
+        if (m_postcodes && !m_postcodes->HasBit(id))
+          return;
+
+        BuildingsTable::Building building;
+        if (m_context->GetBuilding(id, building))
+        {
+          matchBuilding(id, building.m_houseNumber, building.m_center);
+          return;
+        }
+
+        FeatureType ft;
+        if (m_context->IsEdited(id) && m_context->GetFeature(id, ft))
+          matchBuilding(id, strings::MakeUniString(ft.GetHouseNumber()), feature::GetCenter(ft));
+      });
     }
   }
 
@@ -196,11 +209,7 @@ private:
     poiCenters.reserve(pois.size());
 
     for (size_t i = 0; i < pois.size(); ++i)
-    {
-      FeatureType poiFt;
-      GetByIndex(pois[i], poiFt);
-      poiCenters.emplace_back(feature::GetCenter(poiFt, FeatureType::WORST_GEOMETRY), i /* id */);
-    }
+      poiCenters.emplace_back(GetCenter(pois[i]), i /* id */);
 
     vector<PointRectMatcher::RectIdPair> streetRects;
     streetRects.reserve(streets.size());
@@ -282,8 +291,16 @@ private:
     vector<house_numbers::Token> queryParse;
     ParseQuery(child.m_subQuery, child.m_lastTokenIsPrefix, queryParse);
 
+    bool const hasBuildingsTable = m_context->HasBuildingsTable();
+    // Streets of the buildings table are matched by the generator, so
+    // they are ignored when streets are created or deleted by user.
+    bool const useTableStreets = hasBuildingsTable && !m_context->HasEditedStreets();
+
+    // |building| is not null when the feature is in the buildings
+    // table, otherwise |feature| is loaded if needed.
     uint32_t numFilterInvocations = 0;
-    auto houseNumberFilter = [&](uint32_t id, FeatureType & feature, bool & loaded) -> bool {
+    auto houseNumberFilter = [&](uint32_t id, BuildingsTable::Building const * building,
+                                 FeatureType & feature, bool & loaded) -> bool {
       ++numFilterInvocations;
       if ((numFilterInvocations & 0xFF) == 0)
         BailIfCancelled(m_cancellable);
@@ -294,6 +311,17 @@ private:
       if (m_postcodes && !m_postcodes->HasBit(id))
         return false;
 
+      if (building)
+      {
+        return child.m_hasDelayedFeatures &&
+               house_numbers::HouseNumbersMatch(building->m_houseNumber, queryParse);
+      }
+
+      // Features which are neither in the buildings table nor edited
+      // have no house numbers.
+      if (hasBuildingsTable && !m_context->IsEdited(id))
+        return false;
+
       if (!loaded)
       {
         GetByIndex(id, feature);
@@ -308,11 +336,12 @@ private:
     };
 
     unordered_map<uint32_t, bool> cache;
-    auto cachingHouseNumberFilter = [&](uint32_t id, FeatureType & feature, bool & loaded) -> bool {
+    auto cachingHouseNumberFilter = [&](uint32_t id, BuildingsTable::Building const * building,
+                                        FeatureType & feature, bool & loaded) -> bool {
       auto const it = cache.find(id);
       if (it != cache.cend())
         return it->second;
-      bool const result = houseNumberFilter(id, feature, loaded);
+      bool const result = houseNumberFilter(id, building, feature, loaded);
       cache[id] = result;
       return result;
     };
@@ -331,7 +360,21 @@ private:
       {
         FeatureType feature;
         bool loaded = false;
-        if (!cachingHouseNumberFilter(houseId, feature, loaded))
+
+        BuildingsTable::Building building;
+        if (hasBuildingsTable && m_context->GetBuilding(houseId, building))
+        {
+          if (cachingHouseNumberFilter(houseId, &building, feature, loaded) &&
+              (useTableStreets ? building.m_streetId : GetMatchingStreet(houseId)) == streetId &&
+              calculator.GetProjection(building.m_center, proj) &&
+              proj.m_distMeters <= ReverseGeocoder::kLookupRadiusM)
+          {
+            fn(houseId, streetId);
+          }
+          continue;
+        }
+
+        if (!cachingHouseNumberFilter(houseId, nullptr /* building */, feature, loaded))
           continue;
 
         if (!loaded)
@@ -368,6 +411,14 @@ private:
   TStreets const & GetNearbyStreets(uint32_t featureId, FeatureType & feature);
   TStreets const & GetNearbyStreetsImpl(uint32_t featureId, FeatureType & feature);
 
+  // Returns the center of the |id| feature, the centers table is used
+  // when possible.
+  m2::PointD GetCenter(uint32_t id);
+
+  // Returns the rect which the POIs located in the |id| building
+  // belong to.
+  m2::RectD GetBuildingRect(uint32_t id);
+
   inline void GetByIndex(uint32_t id, FeatureType & ft) const
   {
     /// @todo Add Cache for feature id -> (point, name / house number).
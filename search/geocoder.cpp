@@ -446,6 +446,7 @@ void Geocoder::ClearCaches()
   m_localityRectsCache.Clear();
 
   m_matchersCache.clear();
+  m_streetGeometryCache.Clear();
   m_streetsCache.Clear();
   m_hotelsCache.Clear();
   m_hotelsFilter.ClearCaches();
@@ -470,6 +471,16 @@ void Geocoder::GoImpl(vector<shared_ptr<MwmInfo>> & infos, bool inViewport)
 {
   // base::PProf pprof("/tmp/geocoder.prof");
 
+  m_streetsCache.ResetStats();
+  m_pivotRectsCache.ResetStats();
+  MY_SCOPE_GUARD(updateProfile, [this]()
+                 {
+                   if (!m_params.m_profile)
+                     return;
+                   m_params.m_profile->m_streetsCache += m_streetsCache.GetStats();
+                   m_params.m_profile->m_pivotRectsCache += m_pivotRectsCache.GetStats();
+                 });
+
   try
   {
     // Tries to find world and fill localities table.
@@ -518,26 +529,40 @@ void Geocoder::GoImpl(vector<shared_ptr<MwmInfo>> & infos, bool inViewport)
       ASSERT(context, ());
       m_context = move(context);
 
+      SearchProfile::MwmStats mwmStats;
+      mwmStats.m_name = m_context->GetName();
+      my::Timer mwmTimer;
+
       MY_SCOPE_GUARD(cleanup, [&]()
                      {
                        LOG(LDEBUG, (m_context->GetName(), "geocoding complete."));
                        m_matcher->OnQueryFinished();
                        m_matcher = nullptr;
                        m_context.reset();
+
+                       if (m_params.m_profile)
+                       {
+                         mwmStats.m_seconds = mwmTimer.ElapsedSeconds();
+                         m_params.m_profile->m_mwms.push_back(mwmStats);
+                       }
                      });
 
       auto it = m_matchersCache.find(m_context->GetId());
+      if (m_params.m_profile)
+        m_params.m_profile->m_matchersCache.Add(it != m_matchersCache.end() /* hit */);
       if (it == m_matchersCache.end())
       {
-        it = m_matchersCache.insert(make_pair(m_context->GetId(), my::make_unique<FeaturesLayerMatcher>(
-                                                                      m_index, m_cancellable)))
-                 .first;
+        auto matcher = my::make_unique<FeaturesLayerMatcher>(m_index, m_cancellable,
+                                                             m_streetGeometryCache);
+        it = m_matchersCache.insert(make_pair(m_context->GetId(), move(matcher))).first;
       }
       m_matcher = it->second.get();
       m_matcher->SetContext(m_context.get());
 
       BaseContext ctx;
       InitBaseContext(ctx);
+      for (auto const & features : ctx.m_features)
+        mwmStats.m_numRetrieved += features.PopCount();
 
       if (inViewport)
       {
@@ -585,6 +610,7 @@ void Geocoder::GoImpl(vector<shared_ptr<MwmInfo>> & infos, bool inViewport)
 
 void Geocoder::InitBaseContext(BaseContext & ctx)
 {
+  ProfileStageTimer timer(m_params.m_profile, SearchProfile::STAGE_RETRIEVAL);
   Retrieval retrieval(*m_context, m_cancellable);
 
   ctx.m_usedTokens.assign(m_params.GetNumTokens(), false);
@@ -644,6 +670,7 @@ void Geocoder::FillLocalityCandidates(BaseContext const & ctx, CBV const & filte
 
 void Geocoder::FillLocalitiesTable(BaseContext const & ctx)
 {
+  ProfileStageTimer timer(m_params.m_profile, SearchProfile::STAGE_LOCALITIES);
   vector<Locality> preLocalities;
 
   CBV filter;
@@ -726,6 +753,7 @@ void Geocoder::FillLocalitiesTable(BaseContext const & ctx)
 
 void Geocoder::FillVillageLocalities(BaseContext const & ctx)
 {
+  ProfileStageTimer timer(m_params.m_profile, SearchProfile::STAGE_LOCALITIES);
   vector<Locality> preLocalities;
   FillLocalityCandidates(ctx, ctx.m_villages /* filter */, kMaxNumVillages, preLocalities);
 
@@ -1000,7 +1028,10 @@ void Geocoder::WithPostcodes(BaseContext & ctx, TFn && fn)
 void Geocoder::GreedilyMatchStreets(BaseContext & ctx)
 {
   vector<StreetsMatcher::Prediction> predictions;
-  StreetsMatcher::Go(ctx, *m_filter, m_params, predictions);
+  {
+    ProfileStageTimer timer(m_params.m_profile, SearchProfile::STAGE_STREETS_MATCHING);
+    StreetsMatcher::Go(ctx, *m_filter, m_params, predictions);
+  }
 
   for (auto const & prediction : predictions)
     CreateStreetsLayerAndMatchLowerLayers(ctx, prediction);
@@ -1276,6 +1307,8 @@ void Geocoder::FindPaths(BaseContext const & ctx)
     m_matcher->SetPostcodes(&m_postcodes.m_features);
   else
     m_matcher->SetPostcodes(nullptr);
+
+  ProfileStageTimer timer(m_params.m_profile, SearchProfile::STAGE_PATH_FINDING);
   m_finder.ForEachReachableVertex(
       *m_matcher, sortedLayers, [this, &ctx, &innermostLayer](IntersectionResult const & result)
       {
@@ -1382,6 +1415,7 @@ void Geocoder::MatchUnclassified(BaseContext & ctx, size_t curToken)
 
 CBV Geocoder::RetrievePostcodeFeatures(MwmContext const & context, TokenSlice const & slice)
 {
+  ProfileStageTimer timer(m_params.m_profile, SearchProfile::STAGE_RETRIEVAL);
   Retrieval retrieval(context, m_cancellable);
   return CBV(retrieval.RetrievePostcodeFeatures(slice));
 }
@@ -1389,6 +1423,7 @@ CBV Geocoder::RetrievePostcodeFeatures(MwmContext const & context, TokenSlice co
 CBV Geocoder::RetrieveGeometryFeatures(MwmContext const & context, m2::RectD const & rect,
                                        RectId id)
 {
+  ProfileStageTimer timer(m_params.m_profile, SearchProfile::STAGE_RETRIEVAL);
   switch (id)
   {
   case RECT_ID_PIVOT: return m_pivotRectsCache.Get(context, rect, m_params.GetScale());
@@ -17,6 +17,8 @@
 #include "search/pre_ranking_info.hpp"
 #include "search/query_params.hpp"
 #include "search/ranking_utils.hpp"
+#include "search/search_profile.hpp"
+#include "search/street_vicinity_loader.hpp"
 #include "search/streets_matcher.hpp"
 #include "search/token_range.hpp"
 
@@ -85,6 +87,9 @@ public:
     shared_ptr<hotels_filter::Rule> m_hotelsFilter;
     bool m_cianMode = false;
     set<uint32_t> m_preferredTypes;
+
+    // Profile of the query, may be null.
+    SearchProfile * m_profile = nullptr;
   };
 
   Geocoder(Index const & index, storage::CountryInfoGetter const & infoGetter,
@@ -265,6 +270,9 @@ private:
   // This filter is used to throw away excess features.
   FeaturesFilter const * m_filter;
 
+  // Geometries of streets shared by all matchers.
+  StreetVicinityLoader::GeometryCache m_streetGeometryCache;
+
   // Features matcher for layers intersection.
   map<MwmSet::MwmId, unique_ptr<FeaturesLayerMatcher>> m_matchersCache;
   FeaturesLayerMatcher * m_matcher;
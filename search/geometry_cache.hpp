@@ -1,6 +1,7 @@
 #pragma once
 
 #include "search/cbv.hpp"
+#include "search/search_profile.hpp"
 
 #include "indexer/mwm_set.hpp"
 
@@ -39,6 +40,9 @@ public:
 
   inline void Clear() { m_entries.clear(); }
 
+  inline CacheStats const & GetStats() const { return m_stats; }
+  inline void ResetStats() { m_stats = CacheStats(); }
+
 protected:
   struct Entry
   {
@@ -56,6 +60,7 @@ protected:
   {
     auto & entries = m_entries[id];
     auto it = find_if(entries.begin(), entries.end(), forward<TPred>(pred));
+    m_stats.Add(it != entries.end() /* hit */);
     if (it != entries.end())
     {
       if (it != entries.begin())
@@ -77,6 +82,7 @@ protected:
   map<MwmSet::MwmId, deque<Entry>> m_entries;
   size_t const m_maxNumEntries;
   my::Cancellable const & m_cancellable;
+  CacheStats m_stats;
 };
 
 class PivotRectsCache : public GeometryCache
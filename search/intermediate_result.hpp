@@ -191,6 +191,14 @@ public:
     m_distanceToPivot = info.m_distanceToPivot;
   }
 
+  // |rank| is the linear model rank of the value computed in advance, see RankingInfoBatch.
+  IndexedValue(unique_ptr<PreResult2> value, double rank)
+    : m_value(move(value)), m_rank(rank), m_distanceToPivot(numeric_limits<double>::max())
+  {
+    if (m_value)
+      m_distanceToPivot = m_value->GetRankingInfo().m_distanceToPivot;
+  }
+
   PreResult2 const & operator*() const { return *m_value; }
 
   inline double GetRank() const { return m_rank; }
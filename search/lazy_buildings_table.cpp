@@ -0,0 +1,48 @@
+#include "search/lazy_buildings_table.hpp"
+
+#include "indexer/index.hpp"
+
+#include "defines.hpp"
+
+namespace search
+{
+LazyBuildingsTable::LazyBuildingsTable(MwmValue & value)
+  : m_value(value)
+  , m_state(STATE_NOT_LOADED)
+  , m_reader(unique_ptr<ModelReader>())
+{
+}
+
+void LazyBuildingsTable::EnsureTableLoaded()
+{
+  if (m_state != STATE_NOT_LOADED)
+    return;
+
+  if (!m_value.m_cont.IsExist(BUILDINGS_FILE_TAG))
+  {
+    m_state = STATE_FAILED;
+    return;
+  }
+
+  m_reader = m_value.m_cont.GetReader(BUILDINGS_FILE_TAG);
+  if (!m_reader.GetPtr())
+  {
+    m_state = STATE_FAILED;
+    return;
+  }
+
+  m_table = BuildingsTable::Load(*m_reader.GetPtr(), m_value.GetHeader().GetDefCodingParams());
+  if (m_table)
+    m_state = STATE_LOADED;
+  else
+    m_state = STATE_FAILED;
+}
+
+bool LazyBuildingsTable::Get(uint32_t id, BuildingsTable::Building & building)
+{
+  EnsureTableLoaded();
+  if (m_state != STATE_LOADED)
+    return false;
+  return m_table->Get(id, building);
+}
+}  // namespace search
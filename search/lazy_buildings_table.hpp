@@ -0,0 +1,38 @@
+#pragma once
+
+#include "indexer/buildings_table.hpp"
+
+#include "coding/file_container.hpp"
+
+#include "std/unique_ptr.hpp"
+
+class MwmValue;
+
+namespace search
+{
+class LazyBuildingsTable
+{
+public:
+  enum State
+  {
+    STATE_NOT_LOADED,
+    STATE_LOADED,
+    STATE_FAILED
+  };
+
+  explicit LazyBuildingsTable(MwmValue & value);
+
+  inline State GetState() const { return m_state; }
+
+  void EnsureTableLoaded();
+
+  WARN_UNUSED_RESULT bool Get(uint32_t id, BuildingsTable::Building & building);
+
+private:
+  MwmValue & m_value;
+  State m_state;
+
+  FilesContainerR::TReader m_reader;
+  unique_ptr<BuildingsTable> m_table;
+};
+}  // namespace search
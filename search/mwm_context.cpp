@@ -1,5 +1,7 @@
 #include "search/mwm_context.hpp"
 
+#include "indexer/ftypes_matcher.hpp"
+
 namespace search
 {
 void CoverRect(m2::RectD const & rect, int scale, covering::IntervalsT & result)
@@ -15,6 +17,7 @@ MwmContext::MwmContext(MwmSet::MwmHandle handle)
   , m_vector(m_value.m_cont, m_value.GetHeader(), m_value.m_table.get())
   , m_index(m_value.m_cont.GetReader(INDEX_FILE_TAG), m_value.m_factory)
   , m_centers(m_value)
+  , m_buildings(m_value)
 {
 }
 
@@ -45,4 +48,34 @@ bool MwmContext::GetStreetIndex(uint32_t houseId, uint32_t & streetId)
   }
   return m_houseToStreetTable->Get(houseId, streetId);
 }
+
+bool MwmContext::HasEditedStreets()
+{
+  if (m_editedStreetsChecked)
+    return m_hasEditedStreets;
+  m_editedStreetsChecked = true;
+
+  auto const & editor = osm::Editor::Instance();
+  auto const & isStreet = ftypes::IsStreetChecker::Instance();
+  for (auto const status : {osm::Editor::FeatureStatus::Deleted,
+                            osm::Editor::FeatureStatus::Obsolete,
+                            osm::Editor::FeatureStatus::Created})
+  {
+    for (uint32_t const index : editor.GetFeaturesByStatus(GetId(), status))
+    {
+      FeatureType ft;
+      if (status == osm::Editor::FeatureStatus::Created)
+        VERIFY(editor.GetEditedFeature(GetId(), index, ft), ());
+      else
+        m_vector.GetByIndex(index, ft);
+
+      if (isStreet(ft))
+      {
+        m_hasEditedStreets = true;
+        return m_hasEditedStreets;
+      }
+    }
+  }
+  return m_hasEditedStreets;
+}
 }  // namespace search
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "search/house_to_street_table.hpp"
+#include "search/lazy_buildings_table.hpp"
 #include "search/lazy_centers_table.hpp"
 
 #include "indexer/features_vector.hpp"
@@ -76,6 +77,34 @@ public:
     return m_centers.Get(index, center);
   }
 
+  // Returns false if there is no entry for the feature in the
+  // buildings table, or if the feature is edited by user, as the
+  // table keeps the original data.
+  WARN_UNUSED_RESULT inline bool GetBuilding(uint32_t index, BuildingsTable::Building & building)
+  {
+    if (IsEdited(index))
+      return false;
+    return m_buildings.Get(index, building);
+  }
+
+  // Returns true if all buildings of the mwm which are not edited by
+  // user can be read by GetBuilding().
+  inline bool HasBuildingsTable()
+  {
+    m_buildings.EnsureTableLoaded();
+    return m_buildings.GetState() == LazyBuildingsTable::STATE_LOADED;
+  }
+
+  // Returns true if streets of the mwm are created or deleted by
+  // user. Streets of the buildings table are matched by the generator
+  // and are out of date in this case.
+  bool HasEditedStreets();
+
+  inline bool IsEdited(uint32_t index) const
+  {
+    return GetEditedStatus(index) != osm::Editor::FeatureStatus::Untouched;
+  }
+
   MwmSet::MwmHandle m_handle;
   MwmValue & m_value;
 
@@ -103,6 +132,10 @@ private:
   ScaleIndex<ModelReaderPtr> m_index;
   unique_ptr<HouseToStreetTable> m_houseToStreetTable;
   LazyCentersTable m_centers;
+  LazyBuildingsTable m_buildings;
+
+  bool m_editedStreetsChecked = false;
+  bool m_hasEditedStreets = false;
 
   DISALLOW_COPY_AND_MOVE(MwmContext);
 };
@@ -200,8 +200,11 @@ void PreRanker::Filter(bool viewportSearch)
 
 void PreRanker::UpdateResults(bool lastUpdate)
 {
-  FillMissingFieldsInPreResults();
-  Filter(m_viewportSearch);
+  {
+    ProfileStageTimer timer(m_params.m_profile, SearchProfile::STAGE_PRE_RANKING);
+    FillMissingFieldsInPreResults();
+    Filter(m_viewportSearch);
+  }
   m_numSentResults += m_results.size();
   m_ranker.SetPreResults1(move(m_results));
   m_results.clear();
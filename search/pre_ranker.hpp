@@ -43,6 +43,9 @@ public:
     int m_scale = 0;
 
     size_t m_batchSize = 100;
+
+    // Profile of the query, may be null.
+    SearchProfile * m_profile = nullptr;
   };
 
   PreRanker(Index const & index, Ranker & ranker, size_t limit);
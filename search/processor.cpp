@@ -46,6 +46,7 @@
 #include "base/stl_add.hpp"
 #include "base/stl_helpers.hpp"
 #include "base/string_utils.hpp"
+#include "base/timer.hpp"
 
 #include "std/algorithm.hpp"
 #include "std/function.hpp"
@@ -469,6 +470,9 @@ void Processor::Search(SearchParams const & params, m2::RectD const & viewport)
   SetViewport(viewport, true /* forceUpdate */);
   SetOnResults(params.m_onResults);
 
+  m_profile.Clear();
+  my::Timer timer;
+
   Geocoder::Params geocoderParams;
   InitGeocoder(geocoderParams);
   InitPreRanker(geocoderParams);
@@ -501,6 +505,9 @@ void Processor::Search(SearchParams const & params, m2::RectD const & viewport)
   if (!viewportSearch && !IsCancelled())
     SendStatistics(params, viewport, m_emitter.GetResults());
 
+  m_profile.m_totalSeconds = timer.ElapsedSeconds();
+  LOG(LDEBUG, (m_profile));
+
   // Emit finish marker to client.
   m_emitter.Finish(IsCancelled());
 }
@@ -572,6 +579,7 @@ void Processor::InitGeocoder(Geocoder::Params & params)
   params.m_hotelsFilter = m_hotelsFilter;
   params.m_cianMode = m_cianMode;
   params.m_preferredTypes = m_preferredTypes;
+  params.m_profile = &m_profile;
 
   m_geocoder.SetParams(params);
 }
@@ -589,6 +597,7 @@ void Processor::InitPreRanker(Geocoder::Params const & geocoderParams)
   }
   params.m_accuratePivotCenter = GetPivotPoint();
   params.m_scale = geocoderParams.GetScale();
+  params.m_profile = &m_profile;
 
   m_preRanker.Init(params);
 }
@@ -621,10 +630,11 @@ void Processor::InitRanker(Geocoder::Params const & geocoderParams)
   params.m_categoryLocales = GetCategoryLocales();
   params.m_accuratePivotCenter = GetPivotPoint();
   params.m_viewportSearch = viewportSearch;
+  params.m_profile = &m_profile;
   m_ranker.Init(params, geocoderParams);
 }
 
-void Processor::InitEmitter() { m_emitter.Init(m_onResults); }
+void Processor::InitEmitter() { m_emitter.Init(m_onResults, &m_profile); }
 
 void Processor::ClearCaches()
 {
@@ -9,6 +9,7 @@
 #include "search/rank_table_cache.hpp"
 #include "search/ranker.hpp"
 #include "search/search_params.hpp"
+#include "search/search_profile.hpp"
 #include "search/search_trie.hpp"
 #include "search/suggest.hpp"
 #include "search/token_slice.hpp"
@@ -181,6 +182,9 @@ protected:
 
   VillagesCache m_villagesCache;
 
+  // Profile of the current query.
+  SearchProfile m_profile;
+
   Emitter m_emitter;
   Ranker m_ranker;
   PreRanker m_preRanker;
@@ -12,6 +12,7 @@
 
 #include "std/algorithm.hpp"
 #include "std/iterator.hpp"
+#include "std/numeric.hpp"
 #include "std/unique_ptr.hpp"
 
 namespace search
@@ -65,6 +66,20 @@ NameScores GetNameScores(FeatureType const & ft, Geocoder::Params const & params
   return bestScores;
 }
 
+// Computes distances from |centers| to |pivot| by a single pass over
+// contiguous coordinates.
+void GetDistancesToPivot(vector<m2::PointD> const & centers, m2::PointD const & pivot,
+                         vector<double> & distances)
+{
+  size_t const n = centers.size();
+  distances.resize(n);
+
+  m2::PointD const * cs = centers.data();
+  double * out = distances.data();
+  for (size_t i = 0; i < n; ++i)
+    out[i] = MercatorBounds::DistanceOnEarth(cs[i], pivot);
+}
+
 void RemoveDuplicatingLinear(vector<IndexedValue> & values)
 {
   PreResult2::LessLinearTypesF lessCmp;
@@ -184,15 +199,24 @@ class PreResult2Maker
     return true;
   }
 
+public:
+  explicit PreResult2Maker(Ranker & ranker, Index const & index,
+                           storage::CountryInfoGetter const & infoGetter,
+                           Geocoder::Params const & params)
+    : m_ranker(ranker), m_index(index), m_params(params), m_infoGetter(infoGetter)
+  {
+  }
+
   // For the best performance, incoming ids should be sorted by id.first (mwm file id).
-  bool LoadFeature(FeatureID const & id, FeatureType & ft, m2::PointD & center, string & name,
-                   string & country)
+  // The feature is fully parsed, so it may be used after the loader is switched
+  // to another mwm.
+  bool LoadFeature(FeatureID const & id, FeatureType & ft, m2::PointD & center, string & country)
   {
     if (!LoadFeature(id, ft))
       return false;
 
     center = feature::GetCenter(ft);
-    m_ranker.GetBestMatchName(ft, name);
+    ft.ParseEverything();
 
     // Country (region) name is a file name if feature isn't from
     // World.mwm.
@@ -205,40 +229,34 @@ class PreResult2Maker
     return true;
   }
 
-  void InitRankingInfo(FeatureType const & ft, m2::PointD const & center, PreResult1 const & res,
-                       search::RankingInfo & info)
+  // Returns scores of the names of the feature and of its street
+  // (for buildings) against the query tokens.
+  NameScores GetResultNameScores(FeatureType const & ft, PreResult1 const & res)
   {
     auto const & preInfo = res.GetInfo();
 
-    auto const & pivot = m_ranker.m_params.m_accuratePivotCenter;
-
-    info.m_distanceToPivot = MercatorBounds::DistanceOnEarth(center, pivot);
-    info.m_rank = preInfo.m_rank;
-    info.m_type = preInfo.m_type;
-
-    auto const nameScores = GetNameScores(ft, m_params, preInfo.InnermostTokenRange(), info.m_type);
-
-    auto nameScore = nameScores.m_nameScore;
-    auto errorsMade = nameScores.m_errorsMade;
+    auto scores = GetNameScores(ft, m_params, preInfo.InnermostTokenRange(), preInfo.m_type);
 
-    if (info.m_type != Model::TYPE_STREET &&
+    if (preInfo.m_type != Model::TYPE_STREET &&
         preInfo.m_geoParts.m_street != IntersectionResult::kInvalidId)
     {
       auto const & mwmId = ft.GetID().m_mwmId;
       FeatureType street;
       if (LoadFeature(FeatureID(mwmId, preInfo.m_geoParts.m_street), street))
       {
-        auto const nameScores = GetNameScores(
+        auto const streetScores = GetNameScores(
             street, m_params, preInfo.m_tokenRange[Model::TYPE_STREET], Model::TYPE_STREET);
-        nameScore = min(nameScore, nameScores.m_nameScore);
-        errorsMade += nameScores.m_errorsMade;
+        scores.m_nameScore = min(scores.m_nameScore, streetScores.m_nameScore);
+        scores.m_errorsMade += streetScores.m_errorsMade;
       }
     }
 
-    info.m_nameScore = nameScore;
-    info.m_errorsMade = errorsMade;
+    return scores;
+  }
 
-    TokenSlice slice(m_params, preInfo.InnermostTokenRange());
+  void InitCategories(FeatureType const & ft, PreResult1 const & res, search::RankingInfo & info)
+  {
+    TokenSlice slice(m_params, res.GetInfo().InnermostTokenRange());
     feature::TypesHolder holder(ft);
     vector<pair<size_t, size_t>> matched(slice.Size());
     ForEachCategoryType(QuerySlice(slice), m_ranker.m_params.m_categoryLocales,
@@ -285,35 +303,6 @@ class PreResult2Maker
     default: return 0;
     }
   }
-
-public:
-  explicit PreResult2Maker(Ranker & ranker, Index const & index,
-                           storage::CountryInfoGetter const & infoGetter,
-                           Geocoder::Params const & params)
-    : m_ranker(ranker), m_index(index), m_params(params), m_infoGetter(infoGetter)
-  {
-  }
-
-  unique_ptr<PreResult2> operator()(PreResult1 const & res1)
-  {
-    FeatureType ft;
-    m2::PointD center;
-    string name;
-    string country;
-
-    if (!LoadFeature(res1.GetId(), ft, center, name, country))
-      return unique_ptr<PreResult2>();
-
-    auto res2 = make_unique<PreResult2>(ft, center, m_ranker.m_params.m_position /* pivot */, name,
-                                        country);
-
-    search::RankingInfo info;
-    InitRankingInfo(ft, center, res1, info);
-    info.m_rank = NormalizeRank(info.m_rank, info.m_type, center, country);
-    res2->SetRankingInfo(move(info));
-
-    return res2;
-  }
 };
 
 // static
@@ -355,13 +344,89 @@ bool Ranker::IsResultExists(PreResult2 const & p, vector<IndexedValue> const & v
 
 void Ranker::MakePreResult2(Geocoder::Params const & geocoderParams, vector<IndexedValue> & cont)
 {
+  // Features are loaded in order of their ids, i.e. mwm by mwm and by
+  // feature index inside an mwm, so every mwm is opened only once and
+  // feature data is read in the order of its offsets.
+  vector<size_t> order(m_preResults1.size());
+  iota(order.begin(), order.end(), 0);
+  sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs)
+       {
+         return m_preResults1[lhs].GetId() < m_preResults1[rhs].GetId();
+       });
+
+  size_t const n = m_preResults1.size();
   PreResult2Maker maker(*this, m_index, m_infoGetter, geocoderParams);
-  for (auto const & r : m_preResults1)
+
+  // Loaded features and their properties are kept in separate arrays
+  // in the order of pre-results, so every ranking feature below is
+  // computed by its own pass over the whole batch.
+  vector<FeatureType> features(n);
+  vector<m2::PointD> centers(n);
+  vector<string> countries(n);
+  vector<bool> loaded(n);
+  {
+    ProfileStageTimer timer(m_params.m_profile, SearchProfile::STAGE_FEATURES_LOADING);
+    for (size_t i : order)
+      loaded[i] = maker.LoadFeature(m_preResults1[i].GetId(), features[i], centers[i], countries[i]);
+    if (m_params.m_profile)
+      m_params.m_profile->m_numFeaturesLoaded += n;
+  }
+
+  vector<unique_ptr<PreResult2>> results(n);
+  vector<double> ranks;
+  {
+    ProfileStageTimer timer(m_params.m_profile, SearchProfile::STAGE_SCORING);
+
+    vector<double> distances;
+    GetDistancesToPivot(centers, m_params.m_accuratePivotCenter, distances);
+
+    // Names are matched in the order of ids too, as streets of
+    // buildings are loaded from the same mwms.
+    vector<string> names(n);
+    vector<NameScores> nameScores(n);
+    for (size_t i : order)
+    {
+      if (!loaded[i])
+        continue;
+      GetBestMatchName(features[i], names[i]);
+      nameScores[i] = maker.GetResultNameScores(features[i], m_preResults1[i]);
+    }
+
+    RankingInfoBatch batch;
+    batch.Reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (!loaded[i])
+        continue;
+
+      auto const & preInfo = m_preResults1[i].GetInfo();
+      results[i] = make_unique<PreResult2>(features[i], centers[i],
+                                           m_params.m_position /* pivot */, names[i],
+                                           countries[i]);
+
+      search::RankingInfo info;
+      info.m_distanceToPivot = distances[i];
+      info.m_type = preInfo.m_type;
+      info.m_rank = maker.NormalizeRank(preInfo.m_rank, info.m_type, centers[i], countries[i]);
+      info.m_nameScore = nameScores[i].m_nameScore;
+      info.m_errorsMade = nameScores[i].m_errorsMade;
+      maker.InitCategories(features[i], m_preResults1[i], info);
+
+      batch.Add(info);
+      results[i]->SetRankingInfo(move(info));
+    }
+    batch.GetLinearModelRanks(ranks);
+  }
+
+  // Results are filtered in the original order of pre-results, as the
+  // first one of duplicating results is kept.
+  size_t rankIndex = 0;
+  for (auto & p : results)
   {
-    auto p = maker(r);
     if (!p)
       continue;
 
+    double const rank = ranks[rankIndex++];
     if (geocoderParams.m_mode == Mode::Viewport &&
         !geocoderParams.m_pivot.IsPointInside(p->GetCenter()))
     {
@@ -369,8 +434,8 @@ void Ranker::MakePreResult2(Geocoder::Params const & geocoderParams, vector<Inde
     }
 
     if (!IsResultExists(*p, cont))
-      cont.push_back(IndexedValue(move(p)));
-  };
+      cont.push_back(IndexedValue(move(p), rank));
+  }
 }
 
 Result Ranker::MakeResult(PreResult2 const & r) const
@@ -380,6 +445,7 @@ Result Ranker::MakeResult(PreResult2 const & r) const
   MakeResultHighlight(res);
   if (ftypes::IsLocalityChecker::Instance().GetType(r.GetTypes()) == ftypes::NONE)
   {
+    ProfileStageTimer timer(m_params.m_profile, SearchProfile::STAGE_LOCALITIES);
     string city;
     m_localities.GetLocality(res.GetFeatureCenter(), city);
     res.AppendCity(city);
@@ -527,57 +593,62 @@ void Ranker::ProcessSuggestions(vector<IndexedValue> & vec) const
 
 void Ranker::UpdateResults(bool lastUpdate)
 {
-  BailIfCancelled();
-
-  MakePreResult2(m_geocoderParams, m_tentativeResults);
-  RemoveDuplicatingLinear(m_tentativeResults);
-  if (m_tentativeResults.empty())
-    return;
-
-  if (m_params.m_viewportSearch)
   {
-    sort(m_tentativeResults.begin(), m_tentativeResults.end(),
-         my::LessBy(&IndexedValue::GetDistanceToPivot));
-  }
-  else
-  {
-    sort(m_tentativeResults.rbegin(), m_tentativeResults.rend(),
-         my::LessBy(&IndexedValue::GetRank));
-    ProcessSuggestions(m_tentativeResults);
-  }
-
-  // Emit feature results.
-  size_t count = m_emitter.GetResults().GetCount();
-  size_t i = 0;
-  for (; i < m_tentativeResults.size(); ++i)
-  {
-    if (!lastUpdate && i >= kBatchSize && !m_params.m_viewportSearch)
-      break;
+    // The timer is stopped before Emit(): the time spent in the
+    // client callback is not ranking.
+    ProfileStageTimer timer(m_params.m_profile, SearchProfile::STAGE_RANKING);
     BailIfCancelled();
 
+    MakePreResult2(m_geocoderParams, m_tentativeResults);
+    RemoveDuplicatingLinear(m_tentativeResults);
+    if (m_tentativeResults.empty())
+      return;
+
     if (m_params.m_viewportSearch)
     {
-      m_emitter.AddResultNoChecks(
-          (*m_tentativeResults[i])
-              .GenerateFinalResult(m_infoGetter, &m_categories, &m_params.m_preferredTypes,
-                                   m_params.m_currentLocaleCode,
-                                   nullptr /* Viewport results don't need calculated address */));
+      sort(m_tentativeResults.begin(), m_tentativeResults.end(),
+           my::LessBy(&IndexedValue::GetDistanceToPivot));
     }
     else
     {
-      if (count >= m_params.m_limit)
+      sort(m_tentativeResults.rbegin(), m_tentativeResults.rend(),
+           my::LessBy(&IndexedValue::GetRank));
+      ProcessSuggestions(m_tentativeResults);
+    }
+
+    // Emit feature results.
+    size_t count = m_emitter.GetResults().GetCount();
+    size_t i = 0;
+    for (; i < m_tentativeResults.size(); ++i)
+    {
+      if (!lastUpdate && i >= kBatchSize && !m_params.m_viewportSearch)
         break;
+      BailIfCancelled();
 
-      LOG(LDEBUG, (m_tentativeResults[i]));
+      if (m_params.m_viewportSearch)
+      {
+        m_emitter.AddResultNoChecks(
+            (*m_tentativeResults[i])
+                .GenerateFinalResult(m_infoGetter, &m_categories, &m_params.m_preferredTypes,
+                                     m_params.m_currentLocaleCode,
+                                     nullptr /* Viewport results don't need calculated address */));
+      }
+      else
+      {
+        if (count >= m_params.m_limit)
+          break;
+
+        LOG(LDEBUG, (m_tentativeResults[i]));
 
-      auto const & preResult2 = *m_tentativeResults[i];
-      if (m_emitter.AddResult(MakeResult(preResult2)))
-        ++count;
+        auto const & preResult2 = *m_tentativeResults[i];
+        if (m_emitter.AddResult(MakeResult(preResult2)))
+          ++count;
+      }
     }
-  }
-  m_tentativeResults.erase(m_tentativeResults.begin(), m_tentativeResults.begin() + i);
+    m_tentativeResults.erase(m_tentativeResults.begin(), m_tentativeResults.begin() + i);
 
-  m_preResults1.clear();
+    m_preResults1.clear();
+  }
 
   BailIfCancelled();
   m_emitter.Emit();
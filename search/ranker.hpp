@@ -9,6 +9,7 @@
 #include "search/result.hpp"
 #include "search/reverse_geocoder.hpp"
 #include "search/search_params.hpp"
+#include "search/search_profile.hpp"
 #include "search/suggest.hpp"
 #include "search/utils.hpp"
 
@@ -67,6 +68,9 @@ public:
     Locales m_categoryLocales;
 
     size_t m_limit = 0;
+
+    // Profile of the query, may be null.
+    SearchProfile * m_profile = nullptr;
   };
 
   static size_t const kBatchSize;
@@ -36,6 +36,36 @@ double TransformDistance(double distance)
 {
   return min(distance, RankingInfo::kMaxDistMeters) / RankingInfo::kMaxDistMeters;
 }
+
+double TransformRank(uint8_t rank)
+{
+  return static_cast<double>(rank) / numeric_limits<uint8_t>::max();
+}
+
+double GetBias(RankingInfo const & info)
+{
+  auto nameScore = info.m_nameScore;
+  if (info.m_pureCats || info.m_falseCats)
+  {
+    // If the feature was matched only by categorial tokens, it's
+    // better for ranking to set name score to zero.  For example,
+    // when we're looking for a "cafe", cafes "Cafe Pushkin" and
+    // "Lermontov" both match to the request, but must be ranked in
+    // accordance to their distances to the user position or viewport,
+    // in spite of "Cafe Pushkin" has a non-zero name rank.
+    nameScore = NAME_SCORE_ZERO;
+  }
+
+  return kNameScore[nameScore] + kType[info.m_type] + info.m_falseCats * kFalseCats;
+}
+
+// NOTE: both single and batch computations must use this function
+// to get exactly the same ranks.
+inline double GetLinearModelRank(double distanceToPivot, double rank, double errorsMade,
+                                 double bias)
+{
+  return kDistanceToPivot * distanceToPivot + kRank * rank + kErrorsMade * errorsMade + bias;
+}
 }  // namespace
 
 // static
@@ -86,27 +116,50 @@ double RankingInfo::GetLinearModelRank() const
   // this in mind when you're going to change scoring_model.py or this
   // code. We're working on automatic rank calculation code generator
   // integrated in the build system.
-  double const distanceToPivot = TransformDistance(m_distanceToPivot);
-  double const rank = static_cast<double>(m_rank) / numeric_limits<uint8_t>::max();
-
-  auto nameScore = m_nameScore;
-  if (m_pureCats || m_falseCats)
-  {
-    // If the feature was matched only by categorial tokens, it's
-    // better for ranking to set name score to zero.  For example,
-    // when we're looking for a "cafe", cafes "Cafe Pushkin" and
-    // "Lermontov" both match to the request, but must be ranked in
-    // accordance to their distances to the user position or viewport,
-    // in spite of "Cafe Pushkin" has a non-zero name rank.
-    nameScore = NAME_SCORE_ZERO;
-  }
-
-  return kDistanceToPivot * distanceToPivot + kRank * rank + kNameScore[nameScore] +
-         kErrorsMade * GetErrorsMade() + kType[m_type] + m_falseCats * kFalseCats;
+  return ::search::GetLinearModelRank(TransformDistance(m_distanceToPivot), TransformRank(m_rank),
+                                      static_cast<double>(GetErrorsMade()), GetBias(*this));
 }
 
 size_t RankingInfo::GetErrorsMade() const
 {
   return m_errorsMade.IsValid() ? m_errorsMade.m_errorsMade : 0;
 }
+
+void RankingInfoBatch::Reserve(size_t n)
+{
+  m_distances.reserve(n);
+  m_ranks.reserve(n);
+  m_errorsMade.reserve(n);
+  m_biases.reserve(n);
+}
+
+void RankingInfoBatch::Clear()
+{
+  m_distances.clear();
+  m_ranks.clear();
+  m_errorsMade.clear();
+  m_biases.clear();
+}
+
+void RankingInfoBatch::Add(RankingInfo const & info)
+{
+  m_distances.push_back(TransformDistance(info.m_distanceToPivot));
+  m_ranks.push_back(TransformRank(info.m_rank));
+  m_errorsMade.push_back(static_cast<double>(info.GetErrorsMade()));
+  m_biases.push_back(GetBias(info));
+}
+
+void RankingInfoBatch::GetLinearModelRanks(vector<double> & ranks) const
+{
+  size_t const n = Size();
+  ranks.resize(n);
+
+  double const * distances = m_distances.data();
+  double const * rs = m_ranks.data();
+  double const * errorsMade = m_errorsMade.data();
+  double const * biases = m_biases.data();
+  double * out = ranks.data();
+  for (size_t i = 0; i < n; ++i)
+    out[i] = ::search::GetLinearModelRank(distances[i], rs[i], errorsMade[i], biases[i]);
+}
 }  // namespace search
@@ -5,6 +5,7 @@
 #include "search/ranking_utils.hpp"
 
 #include "std/iostream.hpp"
+#include "std/vector.hpp"
 
 class FeatureType;
 
@@ -49,5 +50,33 @@ struct RankingInfo
   size_t GetErrorsMade() const;
 };
 
+// Structure-of-arrays representation of a batch of ranking infos.
+// Linear model ranks of the whole batch are computed by a single loop
+// over contiguous arrays of factors, which is easily vectorized by
+// the compiler, instead of a call of GetLinearModelRank() per result.
+class RankingInfoBatch
+{
+public:
+  void Reserve(size_t n);
+  void Clear();
+  void Add(RankingInfo const & info);
+
+  size_t Size() const { return m_distances.size(); }
+
+  // Fills |ranks| with the same values as GetLinearModelRank() returns
+  // for the added infos, in the order of addition.
+  void GetLinearModelRanks(vector<double> & ranks) const;
+
+private:
+  // Transformed distances to the pivot.
+  vector<double> m_distances;
+  // Normalized ranks.
+  vector<double> m_ranks;
+  vector<double> m_errorsMade;
+  // Sums of the coefficients of the categorial factors (name score, type
+  // and false cats), they don't depend on other factors.
+  vector<double> m_biases;
+};
+
 string DebugPrint(RankingInfo const & info);
 }  // namespace search
@@ -201,6 +201,7 @@ void Results::Clear()
 {
   m_results.clear();
   m_status = Status::None;
+  m_profile.reset();
 }
 
 size_t Results::GetSuggestsCount() const
@@ -1,5 +1,6 @@
 #pragma once
 #include "search/ranking_info.hpp"
+#include "search/search_profile.hpp"
 
 #include "indexer/feature_decl.hpp"
 
@@ -10,6 +11,7 @@
 
 #include "base/buffer_vector.hpp"
 
+#include "std/shared_ptr.hpp"
 #include "std/string.hpp"
 
 
@@ -179,6 +181,11 @@ public:
 
   inline void Swap(Results & rhs) { m_results.swap(rhs.m_results); }
 
+  // Profile of the query, it's attached to the end marker results only,
+  // so it's null for intermediate results.
+  inline shared_ptr<SearchProfile const> const & GetProfile() const { return m_profile; }
+  inline void SetProfile(shared_ptr<SearchProfile const> profile) { m_profile = move(profile); }
+
 private:
   enum class Status
   {
@@ -195,6 +202,7 @@ private:
 
   vector<Result> m_results;
   Status m_status;
+  shared_ptr<SearchProfile const> m_profile;
 };
 
 struct AddressInfo
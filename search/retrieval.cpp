@@ -198,7 +198,7 @@ bool MatchFeatureByPostcode(FeatureType const & ft, TokenSlice const & slice)
 
 template <typename Value, typename DFA>
 unique_ptr<coding::CompressedBitVector> RetrieveAddressFeaturesImpl(
-    Retrieval::TrieRoot<Value> const & root, MwmContext const & context,
+    Retrieval::TrieReader<Value> & trie, MwmContext const & context,
     my::Cancellable const & cancellable, SearchTrieRequest<DFA> const & request)
 {
   EditedFeaturesHolder holder(context.GetId());
@@ -206,7 +206,7 @@ unique_ptr<coding::CompressedBitVector> RetrieveAddressFeaturesImpl(
   FeaturesCollector collector(cancellable, features);
 
   MatchFeaturesInTrie(
-      request, root,
+      request, trie,
       [&holder](uint64_t featureIndex) {
         return !holder.ModifiedOrDeleted(base::asserted_cast<uint32_t>(featureIndex));
       },
@@ -222,7 +222,7 @@ unique_ptr<coding::CompressedBitVector> RetrieveAddressFeaturesImpl(
 
 template <typename Value>
 unique_ptr<coding::CompressedBitVector> RetrievePostcodeFeaturesImpl(
-    Retrieval::TrieRoot<Value> const & root, MwmContext const & context,
+    Retrieval::TrieReader<Value> & trie, MwmContext const & context,
     my::Cancellable const & cancellable, TokenSlice const & slice)
 {
   EditedFeaturesHolder holder(context.GetId());
@@ -230,7 +230,7 @@ unique_ptr<coding::CompressedBitVector> RetrievePostcodeFeaturesImpl(
   FeaturesCollector collector(cancellable, features);
 
   MatchPostcodesInTrie(
-      slice, root,
+      slice, trie,
       [&holder](uint64_t featureIndex) {
         return !holder.ModifiedOrDeleted(base::asserted_cast<uint32_t>(featureIndex));
       },
@@ -288,11 +288,11 @@ struct RetrievePostcodeFeaturesAdaptor
 };
 
 template <typename Value>
-unique_ptr<Retrieval::TrieRoot<Value>> ReadTrie(MwmValue & value, ModelReaderPtr & reader)
+unique_ptr<Retrieval::TrieReader<Value>> ReadTrie(MwmValue & value, ModelReaderPtr & reader)
 {
   serial::CodingParams params(trie::GetCodingParams(value.GetHeader().GetDefCodingParams()));
-  return trie::ReadTrie<SubReaderWrapper<Reader>, ValueList<Value>>(
-      SubReaderWrapper<Reader>(reader.GetPtr()), SingleValueSerializer<Value>(params));
+  return make_unique<Retrieval::TrieReader<Value>>(SubReaderWrapper<Reader>(reader.GetPtr()),
+                                                   SingleValueSerializer<Value>(params));
 }
 }  // namespace
 
@@ -309,10 +309,10 @@ Retrieval::Retrieval(MwmContext const & context, my::Cancellable const & cancell
   switch (m_format)
   {
   case version::MwmTraits::SearchIndexFormat::FeaturesWithRankAndCenter:
-    m_root0 = ReadTrie<FeatureWithRankAndCenter>(value, m_reader);
+    m_trie0 = ReadTrie<FeatureWithRankAndCenter>(value, m_reader);
     break;
   case version::MwmTraits::SearchIndexFormat::CompressedBitVector:
-    m_root1 = ReadTrie<FeatureIndexValue>(value, m_reader);
+    m_trie1 = ReadTrie<FeatureIndexValue>(value, m_reader);
     break;
   }
 }
@@ -361,15 +361,15 @@ unique_ptr<coding::CompressedBitVector> Retrieval::Retrieve(Args &&... args)
   case version::MwmTraits::SearchIndexFormat::FeaturesWithRankAndCenter:
   {
     R<FeatureWithRankAndCenter> r;
-    ASSERT(m_root0, ());
-    return r(*m_root0, m_context, m_cancellable, forward<Args>(args)...);
+    ASSERT(m_trie0, ());
+    return r(*m_trie0, m_context, m_cancellable, forward<Args>(args)...);
   }
   break;
   case version::MwmTraits::SearchIndexFormat::CompressedBitVector:
   {
     R<FeatureIndexValue> r;
-    ASSERT(m_root1, ());
-    return r(*m_root1, m_context, m_cancellable, forward<Args>(args)...);
+    ASSERT(m_trie1, ());
+    return r(*m_trie1, m_context, m_cancellable, forward<Args>(args)...);
   }
   break;
   }
@@ -2,10 +2,14 @@
 
 #include "search/feature_offset_match.hpp"
 #include "search/query_params.hpp"
+#include "search/search_index_values.hpp"
+
+#include "indexer/trie_reader.hpp"
 
 #include "platform/mwm_traits.hpp"
 
 #include "coding/reader.hpp"
+#include "coding/reader_wrapper.hpp"
 
 #include "geometry/rect2d.hpp"
 
@@ -30,8 +34,11 @@ class TokenSlice;
 class Retrieval
 {
 public:
-  template<typename Value>
-  using TrieRoot = trie::Iterator<ValueList<Value>>;
+  // The reader caches the upper levels of the search index trie, so all requests
+  // to the same Retrieval share them.
+  template <typename Value>
+  using TrieReader =
+      trie::NodeReader<SubReaderWrapper<Reader>, ValueList<Value>, SingleValueSerializer<Value>>;
 
   Retrieval(MwmContext const & context, my::Cancellable const & cancellable);
 
@@ -67,7 +74,7 @@ private:
 
   version::MwmTraits::SearchIndexFormat m_format;
 
-  unique_ptr<TrieRoot<FeatureWithRankAndCenter>> m_root0;
-  unique_ptr<TrieRoot<FeatureIndexValue>> m_root1;
+  unique_ptr<TrieReader<FeatureWithRankAndCenter>> m_trie0;
+  unique_ptr<TrieReader<FeatureIndexValue>> m_trie1;
 };
 }  // namespace search
@@ -2,16 +2,23 @@
 
 #include "search/mwm_context.hpp"
 
+#include "indexer/cell_id.hpp"
 #include "indexer/feature.hpp"
 #include "indexer/feature_algo.hpp"
+#include "indexer/feature_covering.hpp"
 #include "indexer/ftypes_matcher.hpp"
 #include "indexer/index.hpp"
 #include "indexer/scales.hpp"
 #include "indexer/search_string_utils.hpp"
 
+#include "base/stl_add.hpp"
 #include "base/stl_helpers.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/atomic.hpp"
 #include "std/limits.hpp"
+#include "std/map.hpp"
+#include "std/thread.hpp"
 
 namespace search
 {
@@ -21,8 +28,70 @@ size_t constexpr kSimilarityThresholdPercent = 10;
 int constexpr kQueryScale = scales::GetUpperScale();
 /// Max number of tries (nearest houses with housenumber) to check when getting point address.
 size_t constexpr kMaxNumTriesToApproxAddress = 10;
+/// Level of cells GetNearbyAddresses() groups points by, cells are about 1km wide.
+int constexpr kBatchCellLevel = 15;
+
+int64_t GetBatchCellId(m2::PointD const & p)
+{
+  using TConverter = CellIdConverter<MercatorBounds, RectId>;
+  return TConverter::ToCellId(MercatorBounds::ClampX(p.x), MercatorBounds::ClampY(p.y))
+      .AncestorAtLevel(kBatchCellLevel)
+      .ToInt64(RectId::DEPTH_LEVELS);
+}
 } // namespace
 
+class ReverseGeocoder::BatchCache
+{
+public:
+  /// Address of a building found by GetNearbyAddress(HouseTable &, ...), it doesn't depend
+  /// on the point the building was found for.
+  struct BuildingAddress
+  {
+    bool m_found = false;
+    Street m_street;
+  };
+
+  explicit BatchCache(Index const & index) : m_index(index), m_table(index) {}
+
+  /// @return nullptr when the feature is not a building with house number.
+  FeatureType const * GetBuilding(FeatureID const & id)
+  {
+    auto const res = m_buildings.emplace(id, unique_ptr<FeatureType>());
+    if (!res.second)
+      return res.first->second.get();
+
+    // Obsolete features are skipped by Index::ForEachInRect().
+    if (osm::Editor::Instance().GetFeatureStatus(id) == osm::Editor::FeatureStatus::Obsolete)
+      return nullptr;
+
+    auto & guard = m_guards[id.m_mwmId];
+    if (!guard)
+      guard = my::make_unique<Index::FeaturesLoaderGuard>(m_index, id.m_mwmId);
+
+    auto ft = my::make_unique<FeatureType>();
+    if (guard->GetFeatureByIndex(id.m_index, *ft) && !ft->GetHouseNumber().empty())
+      res.first->second = move(ft);
+    return res.first->second.get();
+  }
+
+  HouseTable & GetHouseTable() { return m_table; }
+  map<FeatureID, BuildingAddress> & GetAddresses() { return m_addresses; }
+
+  /// Mwms are kept locked while the cache is alive.
+  void Clear()
+  {
+    m_buildings.clear();
+    m_addresses.clear();
+  }
+
+private:
+  Index const & m_index;
+  HouseTable m_table;
+  map<MwmSet::MwmId, unique_ptr<Index::FeaturesLoaderGuard>> m_guards;
+  map<FeatureID, unique_ptr<FeatureType>> m_buildings;
+  map<FeatureID, BuildingAddress> m_addresses;
+};
+
 ReverseGeocoder::ReverseGeocoder(Index const & index) : m_index(index) {}
 
 void ReverseGeocoder::GetNearbyStreets(MwmSet::MwmId const & id, m2::PointD const & center,
@@ -32,18 +101,10 @@ void ReverseGeocoder::GetNearbyStreets(MwmSet::MwmId const & id, m2::PointD cons
 
   auto const addStreet = [&](FeatureType & ft)
   {
-    if (ft.GetFeatureType() != feature::GEOM_LINE ||
-        !ftypes::IsStreetChecker::Instance()(ft))
-    {
-      return;
-    }
-
     string name;
-    if (!ft.GetName(StringUtf8Multilang::kDefaultCode, name))
+    if (!GetStreetName(ft, name))
       return;
 
-    ASSERT(!name.empty(), ());
-
     streets.emplace_back(ft.GetID(), feature::GetMinDistanceMeters(ft, center), name);
   };
 
@@ -61,6 +122,19 @@ void ReverseGeocoder::GetNearbyStreets(FeatureType & ft, vector<Street> & street
   GetNearbyStreets(ft.GetID().m_mwmId, feature::GetCenter(ft), streets);
 }
 
+// static
+bool ReverseGeocoder::GetStreetName(FeatureType & ft, string & name)
+{
+  if (ft.GetFeatureType() != feature::GEOM_LINE || !ftypes::IsStreetChecker::Instance()(ft))
+    return false;
+
+  if (!ft.GetName(StringUtf8Multilang::kDefaultCode, name))
+    return false;
+
+  ASSERT(!name.empty(), ());
+  return true;
+}
+
 // static
 size_t ReverseGeocoder::GetMatchedStreetIndex(strings::UniString const & keyName,
                                               vector<Street> const & streets)
@@ -125,6 +199,67 @@ void ReverseGeocoder::GetNearbyAddress(m2::PointD const & center, Address & addr
   }
 }
 
+void ReverseGeocoder::GetNearbyAddresses(vector<m2::PointD> const & centers,
+                                         vector<Address> & addrs, size_t threadsCount) const
+{
+  addrs.assign(centers.size(), Address());
+
+  // Indices of points sorted by cells, so neighbouring cells go one after another.
+  vector<pair<int64_t, size_t>> points;
+  points.reserve(centers.size());
+  for (size_t i = 0; i < centers.size(); ++i)
+    points.emplace_back(GetBatchCellId(centers[i]), i);
+  sort(points.begin(), points.end());
+
+  // Beginnings of cells in |points|.
+  vector<size_t> cells;
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    if (i == 0 || points[i].first != points[i - 1].first)
+      cells.push_back(i);
+  }
+  cells.push_back(points.size());
+
+  size_t const cellsCount = cells.size() - 1;
+  atomic<size_t> nextCell(0);
+  auto const processCells = [&]()
+  {
+    BatchCache cache(m_index);
+    for (size_t cell = nextCell++; cell < cellsCount; cell = nextCell++)
+    {
+      cache.Clear();
+      for (size_t i = cells[cell]; i < cells[cell + 1]; ++i)
+      {
+        size_t const ind = points[i].second;
+        GetNearbyAddress(centers[ind], cache, addrs[ind]);
+      }
+    }
+  };
+
+  threadsCount = max(static_cast<size_t>(1), min(threadsCount, cellsCount));
+  vector<thread> threads;
+  for (size_t i = 1; i < threadsCount; ++i)
+    threads.emplace_back(processCells);
+  processCells();
+  for (auto & t : threads)
+    t.join();
+}
+
+void ReverseGeocoder::GetNearbyAddress(m2::PointD const & center, BatchCache & cache,
+                                       Address & addr) const
+{
+  vector<Building> buildings;
+  GetNearbyBuildings(center, cache, buildings);
+
+  size_t triesCount = 0;
+  for (auto const & b : buildings)
+  {
+    // The same tries as in GetNearbyAddress(center, addr).
+    if (GetNearbyAddress(cache, b, addr) || (++triesCount == kMaxNumTriesToApproxAddress))
+      break;
+  }
+}
+
 bool ReverseGeocoder::GetExactAddress(FeatureType const & ft, Address & addr) const
 {
   if (ft.GetHouseNumber().empty())
@@ -163,6 +298,26 @@ bool ReverseGeocoder::GetNearbyAddress(HouseTable & table, Building const & bld,
   }
 }
 
+bool ReverseGeocoder::GetNearbyAddress(BatchCache & cache, Building const & bld,
+                                       Address & addr) const
+{
+  auto const res = cache.GetAddresses().emplace(bld.m_id, BatchCache::BuildingAddress());
+  auto & cached = res.first->second;
+  if (res.second)
+  {
+    Address bldAddr;
+    cached.m_found = GetNearbyAddress(cache.GetHouseTable(), bld, bldAddr);
+    cached.m_street = bldAddr.m_street;
+  }
+
+  if (!cached.m_found)
+    return false;
+
+  addr.m_building = bld;
+  addr.m_street = cached.m_street;
+  return true;
+}
+
 void ReverseGeocoder::GetNearbyBuildings(m2::PointD const & center, vector<Building> & buildings) const
 {
   m2::RectD const rect = GetLookupRect(center, kLookupRadiusM);
@@ -177,6 +332,23 @@ void ReverseGeocoder::GetNearbyBuildings(m2::PointD const & center, vector<Build
   sort(buildings.begin(), buildings.end(), my::LessBy(&Building::m_distanceMeters));
 }
 
+void ReverseGeocoder::GetNearbyBuildings(m2::PointD const & center, BatchCache & cache,
+                                         vector<Building> & buildings) const
+{
+  m2::RectD const rect = GetLookupRect(center, kLookupRadiusM);
+
+  // ViewportWithLowLevels covering gives the same features as ForEachInRect() does.
+  auto const addBuilding = [&](FeatureID const & id)
+  {
+    FeatureType const * ft = cache.GetBuilding(id);
+    if (ft)
+      buildings.push_back(FromFeature(*ft, feature::GetMinDistanceMeters(*ft, center)));
+  };
+
+  m_index.ForEachFeatureIDInRect(addBuilding, rect, kQueryScale, covering::ViewportWithLowLevels);
+  sort(buildings.begin(), buildings.end(), my::LessBy(&Building::m_distanceMeters));
+}
+
 // static
 ReverseGeocoder::Building ReverseGeocoder::FromFeature(FeatureType const & ft, double distMeters)
 {
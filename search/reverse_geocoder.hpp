@@ -42,6 +42,10 @@ public:
   /// All "Nearby" functions work in this lookup radius.
   static int constexpr kLookupRadiusM = 500;
 
+  /// Max distance from house to street where we do search matching
+  /// even if there is no exact street written for this house.
+  static int constexpr kMaxApproxStreetDistanceM = 100;
+
   explicit ReverseGeocoder(Index const & index);
 
   using Street = Object;
@@ -60,6 +64,11 @@ public:
     }
   };
 
+  static m2::RectD GetLookupRect(m2::PointD const & center, double radiusM);
+
+  /// @returns false if |ft| is not a street which GetNearbyStreets() returns.
+  static bool GetStreetName(FeatureType & ft, string & name);
+
   static size_t GetMatchedStreetIndex(strings::UniString const & keyName,
                                       vector<Street> const & streets);
 
@@ -89,6 +98,11 @@ public:
 
   /// @return The nearest exact address where building has house number and valid street match.
   void GetNearbyAddress(m2::PointD const & center, Address & addr) const;
+  /// Batch version of GetNearbyAddress(), |addrs[i]| is the same as the address for |centers[i]|.
+  /// Points are grouped by cells, features and streets of a cell are loaded once and shared by
+  /// all its points. Cells are processed by |threadsCount| threads.
+  void GetNearbyAddresses(vector<m2::PointD> const & centers, vector<Address> & addrs,
+                          size_t threadsCount = 1) const;
   /// @param addr (out) the exact address of a feature.
   /// @returns false if  can't extruct address or ft have no house number.
   bool GetExactAddress(FeatureType const & ft, Address & addr) const;
@@ -106,13 +120,19 @@ private:
     bool Get(FeatureID const & fid, uint32_t & streetIndex);
   };
 
+  /// Features and addresses of buildings shared by the points of a cell in GetNearbyAddresses().
+  class BatchCache;
+
   bool GetNearbyAddress(HouseTable & table, Building const & bld, Address & addr) const;
+  void GetNearbyAddress(m2::PointD const & center, BatchCache & cache, Address & addr) const;
+  bool GetNearbyAddress(BatchCache & cache, Building const & bld, Address & addr) const;
 
   /// @return Sorted by distance houses vector with valid house number.
   void GetNearbyBuildings(m2::PointD const & center, vector<Building> & buildings) const;
+  void GetNearbyBuildings(m2::PointD const & center, BatchCache & cache,
+                          vector<Building> & buildings) const;
 
   static Building FromFeature(FeatureType const & ft, double distMeters);
-  static m2::RectD GetLookupRect(m2::PointD const & center, double radiusM);
 };
 
 } // namespace search
@@ -47,6 +47,7 @@ HEADERS += \
     keyword_lang_matcher.hpp \
     keyword_matcher.hpp \
     latlon_match.hpp \
+    lazy_buildings_table.hpp \
     lazy_centers_table.hpp \
     locality_finder.hpp \
     locality_scorer.hpp \
@@ -71,6 +72,7 @@ HEADERS += \
     reverse_geocoder.hpp \
     search_index_values.hpp \
     search_params.hpp \
+    search_profile.hpp \
     search_trie.hpp \
     segment_tree.hpp \
     stats_cache.hpp \
@@ -115,6 +117,7 @@ SOURCES += \
     keyword_lang_matcher.cpp \
     keyword_matcher.cpp \
     latlon_match.cpp \
+    lazy_buildings_table.cpp \
     lazy_centers_table.cpp \
     locality_finder.cpp \
     locality_scorer.cpp \
@@ -136,6 +139,7 @@ SOURCES += \
     retrieval.cpp \
     reverse_geocoder.cpp \
     search_params.cpp \
+    search_profile.cpp \
     segment_tree.cpp \
     street_vicinity_loader.cpp \
     streets_matcher.cpp \
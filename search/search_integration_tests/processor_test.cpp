@@ -15,6 +15,8 @@
 #include "indexer/ftypes_matcher.hpp"
 #include "indexer/index.hpp"
 
+#include "coding/file_container.hpp"
+
 #include "geometry/mercator.hpp"
 #include "geometry/point2d.hpp"
 #include "geometry/rect2d.hpp"
@@ -25,9 +27,12 @@
 #include "base/math.hpp"
 #include "base/string_utils.hpp"
 
+#include "std/algorithm.hpp"
 #include "std/shared_ptr.hpp"
 #include "std/vector.hpp"
 
+#include "defines.hpp"
+
 using namespace generator::tests_support;
 using namespace search::tests_support;
 
@@ -326,6 +331,43 @@ UNIT_CLASS_TEST(ProcessorTest, DisableSuggests)
   }
 }
 
+UNIT_CLASS_TEST(ProcessorTest, SearchProfile)
+{
+  string const countryName = "Wonderland";
+  TestPOI cafe(m2::PointD(1.0, 1.0), "London Cafe", "en");
+
+  auto wonderlandId = BuildCountry(countryName, [&](TestMwmBuilder & builder)
+                                   {
+                                     builder.Add(cafe);
+                                   });
+
+  SetViewport(m2::RectD(m2::PointD(0.5, 0.5), m2::PointD(1.5, 1.5)));
+  {
+    SearchParams params;
+    params.m_query = "london cafe";
+    params.m_inputLocale = "en";
+    params.m_mode = Mode::Everywhere;
+
+    TestSearchRequest request(m_engine, params, m_viewport);
+    request.Run();
+    TRules rules = {ExactMatch(wonderlandId, cafe)};
+    TEST(ResultsMatch(request.Results(), rules), ());
+
+    auto const & profile = request.Profile();
+    TEST_GREATER(profile.m_totalSeconds, 0.0, (profile));
+    TEST_GREATER_OR_EQUAL(profile.m_totalSeconds,
+                          profile.m_stageSeconds[SearchProfile::STAGE_RANKING], (profile));
+    TEST_GREATER(profile.m_numFeaturesLoaded, 0, (profile));
+
+    auto const it = find_if(profile.m_mwms.begin(), profile.m_mwms.end(),
+                            [&](SearchProfile::MwmStats const & stats) {
+                              return stats.m_name == countryName;
+                            });
+    TEST(it != profile.m_mwms.end(), (profile));
+    TEST_GREATER(it->m_numRetrieved, 0, (profile));
+  }
+}
+
 UNIT_CLASS_TEST(ProcessorTest, TestRankingInfo)
 {
   string const countryName = "Wonderland";
@@ -507,6 +549,77 @@ UNIT_CLASS_TEST(ProcessorTest, TestHouseNumbers)
   }
 }
 
+UNIT_CLASS_TEST(ProcessorTest, TestHouseNumbersWithoutBuildingsTable)
+{
+  string const countryName = "Wonderland";
+
+  TestStreet mainStreet(vector<m2::PointD>{m2::PointD(0.0, 0.0), m2::PointD(0.01, 0.0)},
+                        "Main street", "en");
+  TestStreet sideStreet(vector<m2::PointD>{m2::PointD(0.0, 0.0008), m2::PointD(0.01, 0.0008)},
+                        "Side street", "en");
+
+  TestBuilding building1(m2::PointD(0.001, 0.0002), "", "1", mainStreet, "en");
+  TestBuilding building2(vector<m2::PointD>{m2::PointD(0.0019, 0.0001), m2::PointD(0.0021, 0.0001),
+                                            m2::PointD(0.0021, 0.0003), m2::PointD(0.0019, 0.0003),
+                                            m2::PointD(0.0019, 0.0001)},
+                         "", "2", mainStreet, "en");
+  TestBuilding building3(m2::PointD(0.003, 0.0006), "", "1", sideStreet, "en");
+  TestBuilding building4(m2::PointD(0.004, 0.0001), "", "3", "en");
+
+  TestPOI cafe(m2::PointD(0.002, 0.0002), "Cafe", "en");
+  cafe.SetTypes({{"amenity", "cafe"}});
+
+  BuildCountry(countryName, [&](TestMwmBuilder & builder) {
+    builder.Add(mainStreet);
+    builder.Add(sideStreet);
+    builder.Add(building1);
+    builder.Add(building2);
+    builder.Add(building3);
+    builder.Add(building4);
+    builder.Add(cafe);
+  });
+
+  vector<string> const queries = {"Main street 1",      "1 Main street", "Side street 1",
+                                  "Main street 2",      "Main street 3", "Side street 3",
+                                  "Cafe Main street 2", "Cafe 2",        "Main street 1 Cafe"};
+
+  auto const runQueries = [&]() -> vector<vector<uint32_t>> {
+    vector<vector<uint32_t>> results;
+    for (auto const & query : queries)
+    {
+      auto request = MakeRequest(query);
+      vector<uint32_t> ids;
+      for (auto const & result : request->Results())
+      {
+        if (result.GetResultType() == Result::RESULT_FEATURE)
+          ids.push_back(result.GetFeatureID().m_index);
+      }
+      sort(ids.begin(), ids.end());
+      results.push_back(move(ids));
+    }
+    return results;
+  };
+
+  auto const withTable = runQueries();
+  TEST(!withTable[0].empty(), ());
+
+  // The mwm is registered again without the buildings section, so
+  // FeaturesLayerMatcher reads the features themselves.
+  auto const & file = m_files.back();
+  TEST(m_engine.DeregisterMap(file.GetCountryFile()), ());
+  {
+    FilesContainerW container(file.GetPath(MapOptions::Map), FileWriter::OP_WRITE_EXISTING);
+    container.DeleteSection(BUILDINGS_FILE_TAG);
+  }
+  TEST(!FilesContainerR(file.GetPath(MapOptions::Map)).IsExist(BUILDINGS_FILE_TAG), ());
+  auto const result = m_engine.RegisterMap(file);
+  TEST_EQUAL(result.second, MwmSet::RegResult::Success, ());
+
+  auto const withoutTable = runQueries();
+  for (size_t i = 0; i < queries.size(); ++i)
+    TEST_EQUAL(withTable[i], withoutTable[i], (queries[i]));
+}
+
 UNIT_CLASS_TEST(ProcessorTest, TestPostcodes)
 {
   string const countryName = "Russia";
@@ -0,0 +1,86 @@
+#include "search/search_profile.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/sstream.hpp"
+
+namespace search
+{
+// CacheStats --------------------------------------------------------------------------------------
+double CacheStats::GetHitRate() const
+{
+  size_t const total = m_numHits + m_numMisses;
+  return total == 0 ? 0.0 : static_cast<double>(m_numHits) / total;
+}
+
+CacheStats & CacheStats::operator+=(CacheStats const & rhs)
+{
+  m_numHits += rhs.m_numHits;
+  m_numMisses += rhs.m_numMisses;
+  return *this;
+}
+
+// SearchProfile -----------------------------------------------------------------------------------
+void SearchProfile::Clear()
+{
+  *this = SearchProfile();
+}
+
+string DebugPrint(SearchProfile::Stage stage)
+{
+  switch (stage)
+  {
+  case SearchProfile::STAGE_RETRIEVAL: return "Retrieval";
+  case SearchProfile::STAGE_STREETS_MATCHING: return "StreetsMatching";
+  case SearchProfile::STAGE_PATH_FINDING: return "PathFinding";
+  case SearchProfile::STAGE_PRE_RANKING: return "PreRanking";
+  case SearchProfile::STAGE_RANKING: return "Ranking";
+  case SearchProfile::STAGE_FEATURES_LOADING: return "FeaturesLoading";
+  case SearchProfile::STAGE_SCORING: return "Scoring";
+  case SearchProfile::STAGE_LOCALITIES: return "Localities";
+  case SearchProfile::STAGE_COUNT: return "Count";
+  }
+  ASSERT(false, ("Unknown stage:", static_cast<int>(stage)));
+  return "Unknown";
+}
+
+string DebugPrint(CacheStats const & stats)
+{
+  ostringstream os;
+  os << "CacheStats [";
+  os << "m_numHits:" << stats.m_numHits << ",";
+  os << "m_numMisses:" << stats.m_numMisses;
+  os << "]";
+  return os.str();
+}
+
+string DebugPrint(SearchProfile::MwmStats const & stats)
+{
+  ostringstream os;
+  os << "MwmStats [";
+  os << "m_name:" << stats.m_name << ",";
+  os << "m_numRetrieved:" << stats.m_numRetrieved << ",";
+  os << "m_seconds:" << stats.m_seconds;
+  os << "]";
+  return os.str();
+}
+
+string DebugPrint(SearchProfile const & profile)
+{
+  ostringstream os;
+  os << "SearchProfile [";
+  for (size_t i = 0; i < SearchProfile::STAGE_COUNT; ++i)
+  {
+    os << DebugPrint(static_cast<SearchProfile::Stage>(i)) << ":" << profile.m_stageSeconds[i]
+       << ",";
+  }
+  os << "m_totalSeconds:" << profile.m_totalSeconds << ",";
+  os << "m_mwms:" << ::DebugPrint(profile.m_mwms) << ",";
+  os << "m_streetsCache:" << DebugPrint(profile.m_streetsCache) << ",";
+  os << "m_pivotRectsCache:" << DebugPrint(profile.m_pivotRectsCache) << ",";
+  os << "m_matchersCache:" << DebugPrint(profile.m_matchersCache) << ",";
+  os << "m_numFeaturesLoaded:" << profile.m_numFeaturesLoaded;
+  os << "]";
+  return os.str();
+}
+}  // namespace search
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "base/timer.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+namespace search
+{
+// Hits and misses of a cache.
+struct CacheStats
+{
+  inline void Add(bool hit) { hit ? ++m_numHits : ++m_numMisses; }
+
+  // Returns the ratio of hits to all queries or 0.0 when the cache was not used.
+  double GetHitRate() const;
+
+  CacheStats & operator+=(CacheStats const & rhs);
+
+  size_t m_numHits = 0;
+  size_t m_numMisses = 0;
+};
+
+// Profile of a single search query: wall times of the search stages,
+// retrieval statistics of mwms and statistics of caches. It's filled
+// by the search pipeline and is passed to the client with the end
+// marker Results. Collection costs a couple of timer calls per stage
+// and per mwm, so it's always on.
+struct SearchProfile
+{
+  enum Stage
+  {
+    // Retrieval of features from search index and geometry index.
+    STAGE_RETRIEVAL,
+    STAGE_STREETS_MATCHING,
+    // FeaturesLayerPathFinder.
+    STAGE_PATH_FINDING,
+    STAGE_PRE_RANKING,
+    STAGE_RANKING,
+    // Parts of ranking: loading of features with computation of their
+    // ranking factors, and computation of linear model ranks.
+    STAGE_FEATURES_LOADING,
+    STAGE_SCORING,
+    // Filling of localities table and search of localities for results.
+    STAGE_LOCALITIES,
+    STAGE_COUNT
+  };
+
+  struct MwmStats
+  {
+    string m_name;
+    // Sum of sizes of features sets retrieved for the query tokens.
+    uint64_t m_numRetrieved = 0;
+    // Wall time of geocoding in the mwm.
+    double m_seconds = 0.0;
+  };
+
+  void Clear();
+
+  // Stages are nested (e.g. ranking is performed when the pre-ranker
+  // is updated during geocoding), so stage times are not additive.
+  double m_stageSeconds[STAGE_COUNT] = {};
+  double m_totalSeconds = 0.0;
+
+  vector<MwmStats> m_mwms;
+
+  CacheStats m_streetsCache;
+  CacheStats m_pivotRectsCache;
+  CacheStats m_matchersCache;
+
+  size_t m_numFeaturesLoaded = 0;
+};
+
+// Adds time spent in the scope to |stage| of |profile|. Does nothing when |profile| is null.
+class ProfileStageTimer
+{
+public:
+  ProfileStageTimer(SearchProfile * profile, SearchProfile::Stage stage)
+    : m_profile(profile), m_stage(stage)
+  {
+  }
+
+  ~ProfileStageTimer()
+  {
+    if (m_profile)
+      m_profile->m_stageSeconds[m_stage] += m_timer.ElapsedSeconds();
+  }
+
+private:
+  SearchProfile * m_profile;
+  SearchProfile::Stage m_stage;
+  my::Timer m_timer;
+};
+
+string DebugPrint(SearchProfile::Stage stage);
+string DebugPrint(CacheStats const & stats);
+string DebugPrint(SearchProfile::MwmStats const & stats);
+string DebugPrint(SearchProfile const & profile);
+}  // namespace search
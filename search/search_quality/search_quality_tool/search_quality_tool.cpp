@@ -11,6 +11,7 @@
 #include "search/processor_factory.hpp"
 #include "search/ranking_info.hpp"
 #include "search/result.hpp"
+#include "search/search_profile.hpp"
 #include "search/search_quality/helpers.hpp"
 #include "search/search_tests_support/test_search_engine.hpp"
 #include "search/search_tests_support/test_search_request.hpp"
@@ -37,6 +38,7 @@
 #include "std/cmath.hpp"
 #include "std/cstdio.hpp"
 #include "std/fstream.hpp"
+#include "std/function.hpp"
 #include "std/iomanip.hpp"
 #include "std/iostream.hpp"
 #include "std/limits.hpp"
@@ -65,6 +67,7 @@ DEFINE_int32(top, 1, "Number of top results to show for every query");
 DEFINE_string(viewport, "", "Viewport to use when searching (default, moscow, london, zurich)");
 DEFINE_string(check_completeness, "", "Path to the file with completeness data");
 DEFINE_string(ranking_csv_file, "", "File ranking info will be exported to");
+DEFINE_bool(profile, false, "Aggregate search profiles of all queries and print percentiles");
 
 map<string, m2::RectD> const kViewports = {
     {"default", m2::RectD(m2::PointD(0.0, 0.0), m2::PointD(1.0, 1.0))},
@@ -187,6 +190,74 @@ void CalcStatistics(vector<double> const & a, double & avg, double & maximum, do
   stdDev = sqrt(var);
 }
 
+// Returns the |p|-th percentile of |values| by the nearest-rank method, 0 <= |p| <= 100.
+double GetPercentile(vector<double> values, double p)
+{
+  if (values.empty())
+    return 0.0;
+  sort(values.begin(), values.end());
+  size_t rank = static_cast<size_t>(ceil(p / 100.0 * values.size()));
+  if (rank > 0)
+    --rank;
+  return values[min(rank, values.size() - 1)];
+}
+
+void PrintPercentiles(string const & name, vector<double> const & values)
+{
+  cout << setw(20) << left << name << right;
+  for (double const p : {50.0, 90.0, 99.0, 100.0})
+    cout << setw(12) << GetPercentile(values, p);
+  cout << endl;
+}
+
+// Prints percentiles of stage times and other values collected in
+// |profiles| and cumulative hit rates of the caches.
+void PrintProfileStatistics(vector<SearchProfile> const & profiles)
+{
+  cout << fixed << setprecision(3);
+  cout << endl << "Search profile of " << profiles.size() << " queries:" << endl;
+  cout << setw(20) << left << "" << right << setw(12) << "p50" << setw(12) << "p90"
+       << setw(12) << "p99" << setw(12) << "max" << endl;
+
+  vector<double> values(profiles.size());
+  auto const printValues = [&](string const & name, function<double(SearchProfile const &)> fn)
+  {
+    transform(profiles.begin(), profiles.end(), values.begin(), fn);
+    PrintPercentiles(name, values);
+  };
+
+  printValues("Total, s", [](SearchProfile const & p) { return p.m_totalSeconds; });
+  for (size_t i = 0; i < SearchProfile::STAGE_COUNT; ++i)
+  {
+    auto const stage = static_cast<SearchProfile::Stage>(i);
+    printValues(DebugPrint(stage) + ", s",
+                [i](SearchProfile const & p) { return p.m_stageSeconds[i]; });
+  }
+  printValues("Features loaded", [](SearchProfile const & p) {
+    return static_cast<double>(p.m_numFeaturesLoaded);
+  });
+  printValues("Mwms", [](SearchProfile const & p) { return static_cast<double>(p.m_mwms.size()); });
+  printValues("Retrieved", [](SearchProfile const & p) {
+    uint64_t numRetrieved = 0;
+    for (auto const & mwm : p.m_mwms)
+      numRetrieved += mwm.m_numRetrieved;
+    return static_cast<double>(numRetrieved);
+  });
+
+  CacheStats streetsCache;
+  CacheStats pivotRectsCache;
+  CacheStats matchersCache;
+  for (auto const & p : profiles)
+  {
+    streetsCache += p.m_streetsCache;
+    pivotRectsCache += p.m_pivotRectsCache;
+    matchersCache += p.m_matchersCache;
+  }
+  cout << "Streets cache hit rate: " << streetsCache.GetHitRate() << endl;
+  cout << "Pivot rects cache hit rate: " << pivotRectsCache.GetHitRate() << endl;
+  cout << "Matchers cache hit rate: " << matchersCache.GetHitRate() << endl;
+}
+
 // Unlike strings::Tokenize, this function allows for empty tokens.
 void Split(string const & s, char delim, vector<string> & parts)
 {
@@ -488,5 +559,14 @@ int main(int argc, char * argv[])
   cout << "Average response time: " << averageTime << "s"
        << " (std. dev. " << stdDevTime << "s)" << endl;
 
+  if (FLAGS_profile)
+  {
+    vector<SearchProfile> profiles;
+    profiles.reserve(requests.size());
+    for (auto const & request : requests)
+      profiles.push_back(request->Profile());
+    PrintProfileStatistics(profiles);
+  }
+
   return 0;
 }
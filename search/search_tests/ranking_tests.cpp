@@ -1,6 +1,7 @@
 #include "testing/testing.hpp"
 
 #include "search/query_params.hpp"
+#include "search/ranking_info.hpp"
 #include "search/ranking_utils.hpp"
 #include "search/token_range.hpp"
 #include "search/token_slice.hpp"
@@ -13,6 +14,7 @@
 
 #include "std/cstdint.hpp"
 #include "std/string.hpp"
+#include "std/vector.hpp"
 
 using namespace search;
 using namespace strings;
@@ -55,4 +57,37 @@ UNIT_TEST(NameTest_Smoke)
   TEST_EQUAL(GetScore("фото на документы", "фото", TokenRange(0, 1)), NAME_SCORE_PREFIX, ());
   TEST_EQUAL(GetScore("фотоателье", "фото", TokenRange(0, 1)), NAME_SCORE_PREFIX, ());
 }
+
+UNIT_TEST(RankingInfoBatch_Smoke)
+{
+  vector<RankingInfo> infos;
+  for (size_t i = 0; i < 50; ++i)
+  {
+    RankingInfo info;
+    info.m_distanceToPivot = i * 1e5;
+    info.m_rank = static_cast<uint8_t>(i * 5);
+    info.m_nameScore = static_cast<NameScore>(i % NAME_SCORE_COUNT);
+    if (i % 3 != 0)
+      info.m_errorsMade = ErrorsMade(i % 4);
+    info.m_type = static_cast<Model::Type>(i % Model::TYPE_COUNT);
+    info.m_pureCats = i % 5 == 0;
+    info.m_falseCats = i % 7 == 0;
+    infos.push_back(info);
+  }
+
+  RankingInfoBatch batch;
+  for (auto const & info : infos)
+    batch.Add(info);
+  TEST_EQUAL(batch.Size(), infos.size(), ());
+
+  vector<double> ranks;
+  batch.GetLinearModelRanks(ranks);
+  TEST_EQUAL(ranks.size(), infos.size(), ());
+  for (size_t i = 0; i < infos.size(); ++i)
+    TEST_EQUAL(ranks[i], infos[i].GetLinearModelRank(), (i, infos[i]));
+
+  batch.Clear();
+  batch.GetLinearModelRanks(ranks);
+  TEST(ranks.empty(), ());
+}
 }  // namespace
@@ -39,6 +39,7 @@ SOURCES += \
     query_saver_tests.cpp \
     ranking_tests.cpp \
     segment_tree_tests.cpp \
+    street_vicinity_loader_test.cpp \
     string_intersection_test.cpp \
     string_match_test.cpp \
 
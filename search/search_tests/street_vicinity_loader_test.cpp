@@ -0,0 +1,57 @@
+#include "testing/testing.hpp"
+
+#include "search/street_vicinity_loader.hpp"
+
+#include "indexer/feature_decl.hpp"
+#include "indexer/mwm_set.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "std/shared_ptr.hpp"
+
+using namespace search;
+
+namespace
+{
+using TCache = StreetVicinityLoader::GeometryCache;
+
+UNIT_TEST(StreetVicinityLoader_GeometryCache)
+{
+  MwmSet::MwmId const mwm1(make_shared<MwmInfo>());
+  MwmSet::MwmId const mwm2(make_shared<MwmInfo>());
+
+  TCache cache;
+
+  bool found;
+  auto & geometry = cache.Find(FeatureID(mwm1, 5), found);
+  TEST(!found, ());
+  geometry.m_points = {m2::PointD(0, 0), m2::PointD(1, 1)};
+
+  TEST_EQUAL(cache.Find(FeatureID(mwm1, 5), found).m_points.size(), 2, ());
+  TEST(found, ());
+
+  // Streets of different mwms don't collide.
+  cache.Find(FeatureID(mwm2, 5), found);
+  TEST(!found, ());
+  cache.Find(FeatureID(mwm1, 5), found);
+  TEST(found, ());
+
+  // The number of streets is bounded.
+  uint32_t const kNumStreets = 16 * (1 << TCache::kLogCacheSize);
+  for (uint32_t id = 0; id < kNumStreets; ++id)
+    cache.Find(FeatureID(mwm1, id), found);
+
+  uint32_t numFound = 0;
+  for (uint32_t id = 0; id < kNumStreets; ++id)
+  {
+    cache.Find(FeatureID(mwm1, id), found);
+    if (found)
+      ++numFound;
+  }
+  TEST_LESS_OR_EQUAL(numFound, 1 << TCache::kLogCacheSize, ());
+
+  cache.Clear();
+  cache.Find(FeatureID(mwm2, 5), found);
+  TEST(!found, ());
+}
+}  // namespace
@@ -61,6 +61,13 @@ vector<search::Result> const & TestSearchRequest::Results() const
   return m_results;
 }
 
+search::SearchProfile const & TestSearchRequest::Profile() const
+{
+  lock_guard<mutex> lock(m_mu);
+  CHECK(m_done, ("This function may be called only when request is processed."));
+  return m_profile;
+}
+
 void TestSearchRequest::Start()
 {
   m_engine.Search(m_params, m_viewport);
@@ -89,6 +96,8 @@ void TestSearchRequest::OnResults(search::Results const & results)
   lock_guard<mutex> lock(m_mu);
   if (results.IsEndMarker())
   {
+    if (results.GetProfile())
+      m_profile = *results.GetProfile();
     m_done = true;
     m_endTime = m_timer.TimeElapsed();
     m_cv.notify_one();
@@ -34,6 +34,7 @@ public:
   // Call these functions only after call to Wait().
   steady_clock::duration ResponseTime() const;
   vector<search::Result> const & Results() const;
+  search::SearchProfile const & Profile() const;
 
 protected:
   TestSearchRequest(TestSearchEngine & engine, string const & query, string const & locale,
@@ -58,6 +59,7 @@ protected:
   mutable mutex m_mu;
 
   vector<search::Result> m_results;
+  search::SearchProfile m_profile;
   bool m_done = false;
 
   my::Timer m_timer;
@@ -13,8 +13,27 @@
 
 namespace search
 {
-StreetVicinityLoader::StreetVicinityLoader(int scale, double offsetMeters)
-  : m_context(nullptr), m_scale(scale), m_offsetMeters(offsetMeters), m_cache("Streets")
+// static
+uint32_t const StreetVicinityLoader::GeometryCache::kLogCacheSize;
+
+StreetVicinityLoader::StreetGeometry & StreetVicinityLoader::GeometryCache::Find(
+    FeatureID const & featureId, bool & found)
+{
+  auto res = m_cache.insert(make_pair(featureId.m_mwmId, TMwmCache()));
+  if (res.second)
+    res.first->second.Init(kLogCacheSize);
+  return res.first->second.Find(featureId.m_index, found);
+}
+
+void StreetVicinityLoader::GeometryCache::Clear() { m_cache.clear(); }
+
+StreetVicinityLoader::StreetVicinityLoader(int scale, double offsetMeters,
+                                           GeometryCache & geometryCache)
+  : m_context(nullptr)
+  , m_scale(scale)
+  , m_offsetMeters(offsetMeters)
+  , m_cache("Streets")
+  , m_geometryCache(geometryCache)
 {
 }
 
@@ -29,7 +48,7 @@ void StreetVicinityLoader::SetContext(MwmContext * context)
   m_scale = my::clamp(m_scale, scaleRange.first, scaleRange.second);
 }
 
-void StreetVicinityLoader::OnQueryFinished() { m_cache.ClearIfNeeded(); }
+void StreetVicinityLoader::OnQueryFinished() { m_cache.Clear(); }
 
 StreetVicinityLoader::Street const & StreetVicinityLoader::GetStreet(uint32_t featureId)
 {
@@ -42,6 +61,36 @@ StreetVicinityLoader::Street const & StreetVicinityLoader::GetStreet(uint32_t fe
 }
 
 void StreetVicinityLoader::LoadStreet(uint32_t featureId, Street & street)
+{
+  // Edited streets are not cached, as the cache is not invalidated
+  // on edits.
+  StreetGeometry edited;
+  StreetGeometry const * geometry = &edited;
+  if (m_context->IsEdited(featureId))
+  {
+    LoadGeometry(featureId, edited);
+  }
+  else
+  {
+    bool found;
+    auto & cached = m_geometryCache.Find(FeatureID(m_context->GetId(), featureId), found);
+    if (!found)
+    {
+      cached = StreetGeometry();
+      LoadGeometry(featureId, cached);
+    }
+    geometry = &cached;
+  }
+
+  if (geometry->m_points.empty())
+    return;
+
+  street.m_rect = geometry->m_rect;
+  m_context->ForEachIndex(geometry->m_intervals, m_scale, MakeBackInsertFunctor(street.m_features));
+  street.m_calculator = make_unique<ProjectionOnStreetCalculator>(geometry->m_points);
+}
+
+void StreetVicinityLoader::LoadGeometry(uint32_t featureId, StreetGeometry & geometry)
 {
   FeatureType feature;
   if (!m_context->GetFeature(featureId, feature))
@@ -50,18 +99,15 @@ void StreetVicinityLoader::LoadStreet(uint32_t featureId, Street & street)
   if (feature.GetFeatureType() != feature::GEOM_LINE)
     return;
 
-  vector<m2::PointD> points;
-  feature.ForEachPoint(MakeBackInsertFunctor(points), FeatureType::BEST_GEOMETRY);
-  ASSERT(!points.empty(), ());
+  feature.ForEachPoint(MakeBackInsertFunctor(geometry.m_points), FeatureType::BEST_GEOMETRY);
+  ASSERT(!geometry.m_points.empty(), ());
 
-  for (auto const & point : points)
-    street.m_rect.Add(MercatorBounds::RectByCenterXYAndSizeInMeters(point, m_offsetMeters));
+  for (auto const & point : geometry.m_points)
+    geometry.m_rect.Add(MercatorBounds::RectByCenterXYAndSizeInMeters(point, m_offsetMeters));
 
-  covering::CoveringGetter coveringGetter(street.m_rect, covering::ViewportWithLowLevels);
+  covering::CoveringGetter coveringGetter(geometry.m_rect, covering::ViewportWithLowLevels);
   auto const & intervals = coveringGetter.Get(m_scale);
-  m_context->ForEachIndex(intervals, m_scale, MakeBackInsertFunctor(street.m_features));
-
-  street.m_calculator = make_unique<ProjectionOnStreetCalculator>(points);
+  geometry.m_intervals.assign(intervals.begin(), intervals.end());
 }
 
 }  // namespace search
@@ -6,12 +6,19 @@
 
 #include "indexer/feature.hpp"
 #include "indexer/feature_algo.hpp"
+#include "indexer/feature_covering.hpp"
+#include "indexer/feature_decl.hpp"
+#include "indexer/mwm_set.hpp"
 
+#include "geometry/point2d.hpp"
 #include "geometry/rect2d.hpp"
 
+#include "base/cache.hpp"
 #include "base/macros.hpp"
 
+#include "std/map.hpp"
 #include "std/unordered_map.hpp"
+#include "std/vector.hpp"
 
 namespace search
 {
@@ -40,7 +47,33 @@ public:
     DISALLOW_COPY(Street);
   };
 
-  StreetVicinityLoader(int scale, double offsetMeters);
+  // Geometry of a street and a covering of its vicinity.
+  struct StreetGeometry
+  {
+    vector<m2::PointD> m_points;
+    m2::RectD m_rect;
+    covering::IntervalsT m_intervals;
+  };
+
+  // Cache of street geometries which is kept between queries and
+  // shared by loaders of different mwms. At most 2^kLogCacheSize
+  // streets are kept for an mwm. All loaders which share a cache must
+  // use the same scale and offset.
+  class GeometryCache
+  {
+  public:
+    static uint32_t const kLogCacheSize = 10;
+
+    StreetGeometry & Find(FeatureID const & featureId, bool & found);
+
+    void Clear();
+
+  private:
+    using TMwmCache = my::Cache<uint32_t, StreetGeometry>;
+    map<MwmSet::MwmId, TMwmCache> m_cache;
+  };
+
+  StreetVicinityLoader(int scale, double offsetMeters, GeometryCache & geometryCache);
   void SetContext(MwmContext * context);
 
   // Calls |fn| on each index in |sortedIds| where sortedIds[index]
@@ -82,12 +115,16 @@ public:
 
 private:
   void LoadStreet(uint32_t featureId, Street & street);
+  void LoadGeometry(uint32_t featureId, StreetGeometry & geometry);
 
   MwmContext * m_context;
   int m_scale;
   double const m_offsetMeters;
 
+  // Streets of the current query. Features in a street's vicinity are
+  // not kept between queries, as they depend on user edits.
   Cache<uint32_t, Street> m_cache;
+  GeometryCache & m_geometryCache;
 
   DISALLOW_COPY_AND_MOVE(StreetVicinityLoader);
 };
@@ -8,6 +8,7 @@
 using std::fixed;
 using std::hex;
 using std::left;
+using std::right;
 using std::setfill;
 using std::setprecision;
 using std::setw;
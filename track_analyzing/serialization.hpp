@@ -67,8 +67,7 @@ public:
 
           std::vector<uint8_t> buffer;
           MemWriter<decltype(buffer)> memWriter(buffer);
-          coding::TrafficGPSEncoder::SerializeDataPoints(coding::TrafficGPSEncoder::kLatestVersion,
-                                                         memWriter, dataPoints);
+          coding::TrafficGPSEncoder::SerializeDataPoints(kDataPointsVersion, memWriter, dataPoints);
 
           WriteSize(sink, buffer.size());
           sink.Write(buffer.data(), buffer.size());
@@ -122,8 +121,7 @@ public:
           ReaderSource<MemReader> memSrc(memReader);
 
           std::vector<DataPoint> dataPoints;
-          coding::TrafficGPSEncoder::DeserializeDataPoints(
-              coding::TrafficGPSEncoder::kLatestVersion, memSrc, dataPoints);
+          coding::TrafficGPSEncoder::DeserializeDataPoints(kDataPointsVersion, memSrc, dataPoints);
           CHECK_EQUAL(numSegments, dataPoints.size(), ("mwm:", mwmName, "user:", user));
 
           MatchedTrack & track = tracks[iTrack];
@@ -137,6 +135,8 @@ public:
   }
 
 private:
+  // Stored tracks have no version, so the version of data points is fixed.
+  static uint32_t constexpr kDataPointsVersion = 1;
   static uint8_t constexpr kForward = 0;
   static uint8_t constexpr kBackward = 1;
 
@@ -1,9 +1,11 @@
 #include "tracking/protocol.hpp"
 
 #include "coding/endianness.hpp"
+#include "coding/reader.hpp"
 #include "coding/writer.hpp"
 
 #include "base/assert.hpp"
+#include "base/logging.hpp"
 
 #include "std/cstdint.hpp"
 #include "std/sstream.hpp"
@@ -23,6 +25,7 @@ vector<uint8_t> CreateDataPacketImpl(Container const & points,
   {
   case tracking::Protocol::PacketType::DataV0: version = 0; break;
   case tracking::Protocol::PacketType::DataV1: version = 1; break;
+  case tracking::Protocol::PacketType::DataV2: version = 2; break;
   case tracking::Protocol::PacketType::AuthV0: ASSERT(false, ("Not a DATA packet.")); break;
   }
 
@@ -33,12 +36,25 @@ vector<uint8_t> CreateDataPacketImpl(Container const & points,
 
   return packet;
 }
+
+bool GetDataVersion(tracking::Protocol::PacketType type, uint32_t & version)
+{
+  switch (type)
+  {
+  case tracking::Protocol::PacketType::DataV0: version = 0; return true;
+  case tracking::Protocol::PacketType::DataV1: version = 1; return true;
+  case tracking::Protocol::PacketType::DataV2: version = 2; return true;
+  case tracking::Protocol::PacketType::AuthV0: return false;
+  }
+  return false;
+}
 }  // namespace
 
 namespace tracking
 {
 uint8_t const Protocol::kOk[4] = {'O', 'K', '\n', '\n'};
 uint8_t const Protocol::kFail[4] = {'F', 'A', 'I', 'L'};
+uint32_t const Protocol::kMaxPayloadSize = 0x00FFFFFF - 1;
 
 static_assert(sizeof(Protocol::kFail) >= sizeof(Protocol::kOk), "");
 
@@ -92,7 +108,8 @@ string Protocol::DecodeAuthPacket(Protocol::PacketType type, vector<uint8_t> con
   {
   case Protocol::PacketType::AuthV0: return string(begin(data), end(data));
   case Protocol::PacketType::DataV0:
-  case Protocol::PacketType::DataV1: ASSERT(false, ("Not an AUTH packet.")); break;
+  case Protocol::PacketType::DataV1:
+  case Protocol::PacketType::DataV2: ASSERT(false, ("Not an AUTH packet.")); break;
   }
   return string();
 }
@@ -111,11 +128,62 @@ Protocol::DataElementsVec Protocol::DecodeDataPacket(PacketType type, vector<uin
   case Protocol::PacketType::DataV1:
     Encoder::DeserializeDataPoints(1 /* version */, src, points);
     break;
+  case Protocol::PacketType::DataV2:
+    Encoder::DeserializeDataPoints(2 /* version */, src, points);
+    break;
   case Protocol::PacketType::AuthV0: ASSERT(false, ("Not a DATA packet.")); break;
   }
   return points;
 }
 
+//  static
+size_t Protocol::DecodeDataPackets(uint8_t const * data, size_t size, DataElementsVec & points,
+                                   vector<DecodedPacket> & packets)
+{
+  size_t const kHeaderSize = sizeof(uint32_t);
+
+  size_t pos = 0;
+  while (size - pos >= kHeaderSize)
+  {
+    uint8_t const * header = data + pos;
+    size_t const payloadSize = (static_cast<size_t>(header[1]) << 16) |
+                               (static_cast<size_t>(header[2]) << 8) | header[3];
+    if (size - pos - kHeaderSize < payloadSize)
+      break;
+
+    DecodedPacket packet;
+    packet.m_type = PacketType(header[0]);
+    packet.m_pointsBegin = points.size();
+
+    uint32_t version;
+    if (GetDataVersion(packet.m_type, version))
+    {
+      // Payloads are decoded with the bounds check since they come from the network.
+      MemReaderWithExceptions memReader(header + kHeaderSize, payloadSize);
+      ReaderSource<MemReaderWithExceptions> src(memReader);
+      try
+      {
+        Encoder::DeserializeDataPoints(version, src, points);
+      }
+      catch (Reader::Exception const & e)
+      {
+        LOG(LWARNING, ("Can't decode packet", DebugPrint(packet.m_type), e.Msg()));
+        points.resize(packet.m_pointsBegin);
+        packet.m_isValid = false;
+      }
+    }
+    else
+    {
+      packet.m_isValid = packet.m_type == PacketType::AuthV0;
+    }
+
+    packet.m_pointsEnd = points.size();
+    packets.push_back(packet);
+    pos += kHeaderSize + payloadSize;
+  }
+  return pos;
+}
+
 //  static
 void Protocol::InitHeader(vector<uint8_t> & packet, PacketType type, uint32_t payloadSize)
 {
@@ -123,7 +191,7 @@ void Protocol::InitHeader(vector<uint8_t> & packet, PacketType type, uint32_t pa
   uint32_t & size = *reinterpret_cast<uint32_t *>(packet.data());
   size = payloadSize;
 
-  ASSERT_LESS(size, 0x00FFFFFF, ());
+  ASSERT_LESS_OR_EQUAL(size, kMaxPayloadSize, ());
 
   if (!IsBigEndian())
     size = ReverseByteOrder(size);
@@ -138,6 +206,7 @@ string DebugPrint(Protocol::PacketType type)
   case Protocol::PacketType::AuthV0: return "AuthV0";
   case Protocol::PacketType::DataV0: return "DataV0";
   case Protocol::PacketType::DataV1: return "DataV1";
+  case Protocol::PacketType::DataV2: return "DataV2";
   }
   stringstream ss;
   ss << "Unknown(" << static_cast<uint32_t>(type) << ")";
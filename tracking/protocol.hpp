@@ -33,11 +33,26 @@ public:
     AuthV0 = 0x81,
     DataV0 = 0x82,
     DataV1 = 0x92,
+    DataV2 = 0xA2,
 
     CurrentAuth = AuthV0,
-    CurrentData = DataV1
+    CurrentData = DataV2
   };
 
+  // Packet of a stream which is decoded by DecodeDataPackets().
+  struct DecodedPacket
+  {
+    PacketType m_type = PacketType::CurrentData;
+    // Range of points of the packet in the vector of decoded points.
+    size_t m_pointsBegin = 0;
+    size_t m_pointsEnd = 0;
+    // False for a data packet whose payload can't be decoded and for an unknown packet.
+    bool m_isValid = true;
+  };
+
+  // Maximal payload size of a packet, size of a payload is stored in three bytes.
+  static uint32_t const kMaxPayloadSize;
+
   static vector<uint8_t> CreateHeader(PacketType type, uint32_t payloadSize);
   static vector<uint8_t> CreateAuthPacket(string const & clientId);
   static vector<uint8_t> CreateDataPacket(DataElementsCirc const & points, PacketType type);
@@ -47,6 +62,14 @@ public:
   static string DecodeAuthPacket(PacketType type, vector<uint8_t> const & data);
   static DataElementsVec DecodeDataPacket(PacketType type, vector<uint8_t> const & data);
 
+  // Decodes all complete packets of the stream of |size| bytes at |data|. Points of data
+  // packets are appended to |points| and packets are appended to |packets|. Points are
+  // decoded in place, so a server which reuses the vectors decodes thousands of packets
+  // without allocations. Returns the number of bytes of complete packets, the rest of
+  // the stream must be passed again with the following bytes.
+  static size_t DecodeDataPackets(uint8_t const * data, size_t size, DataElementsVec & points,
+                                  vector<DecodedPacket> & packets);
+
 private:
   static void InitHeader(vector<uint8_t> & packet, PacketType type, uint32_t payloadSize);
 };
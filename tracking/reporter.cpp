@@ -18,6 +18,9 @@ double constexpr kMinDelaySeconds = 1.0;
 double constexpr kReconnectDelaySeconds = 60.0;
 double constexpr kNotChargingEventPeriod = 5 * 60.0;
 size_t constexpr kRealTimeBufferSize = 60;
+// Points are sent before the push delay passes when so many of them are collected,
+// so that they aren't dropped from the buffer for long push delays.
+size_t constexpr kMaxBatchSize = kRealTimeBufferSize / 2;
 } // namespace
 
 namespace tracking
@@ -74,6 +77,9 @@ void Reporter::AddLocation(location::GpsInfo const & info, traffic::SpeedGroup t
   m_input.push_back(
       DataPoint(info.m_timestamp, ms::LatLon(info.m_latitude, info.m_longitude),
                 static_cast<std::underlying_type<traffic::SpeedGroup>::type>(traffic)));
+
+  if (m_input.size() >= kMaxBatchSize)
+    m_cv.notify_one();
 }
 
 void Reporter::Run()
@@ -104,7 +110,10 @@ void Reporter::Run()
 
     auto const passedMs = duration_cast<milliseconds>(steady_clock::now() - startTime);
     if (passedMs < m_pushDelay)
-      m_cv.wait_for(lock, m_pushDelay - passedMs, [this]{return m_isFinished;});
+    {
+      m_cv.wait_for(lock, m_pushDelay - passedMs,
+                    [this] { return m_isFinished || m_input.size() >= kMaxBatchSize; });
+    }
   }
 
   LOG(LINFO, ("Tracking Reporter finished"));
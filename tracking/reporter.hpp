@@ -60,7 +60,8 @@ private:
   function<void()> m_idleFn;
   // Input buffer for incoming points. Worker thread steals it contents.
   vector<DataPoint> m_input;
-  // Last collected points, sends periodically to server.
+  // Last collected points, sends periodically to server. Points are sent earlier
+  // when a batch of them is collected.
   boost::circular_buffer<DataPoint> m_points;
   double m_lastGpsTime = 0.0;
   bool m_isFinished = false;
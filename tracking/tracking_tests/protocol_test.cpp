@@ -2,8 +2,31 @@
 
 #include "tracking/protocol.hpp"
 
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include "std/cmath.hpp"
+
 using namespace tracking;
 
+namespace
+{
+// Points of a car which moves with a varying speed and reports a point every second.
+Protocol::DataElementsVec MakeTrack(size_t size, uint64_t startTimestamp)
+{
+  Protocol::DataElementsVec points;
+  double lat = 55.75;
+  double lon = 37.61;
+  for (size_t i = 0; i < size; ++i)
+  {
+    lat += 1e-4 * (1.0 + 0.5 * sin(i / 10.0));
+    lon += 1e-4 * (1.0 + 0.5 * cos(i / 15.0));
+    points.emplace_back(startTimestamp + i, ms::LatLon(lat, lon), static_cast<uint8_t>(i / 20 % 3));
+  }
+  return points;
+}
+}  // namespace
+
 UNIT_TEST(Protocol_CreateAuthPacket)
 {
   auto packet = Protocol::CreateAuthPacket("ABC");
@@ -104,4 +127,138 @@ UNIT_TEST(Protocol_DecodeDataPacket)
 
   DecodeDataPacketVersionTest(points, Protocol::PacketType::DataV0);
   DecodeDataPacketVersionTest(points, Protocol::PacketType::DataV1);
+  DecodeDataPacketVersionTest(points, Protocol::PacketType::DataV2);
+
+  auto const track = MakeTrack(60 /* size */, 1500000000 /* startTimestamp */);
+  DecodeDataPacketVersionTest(track, Protocol::PacketType::DataV1);
+  DecodeDataPacketVersionTest(track, Protocol::PacketType::DataV2);
+
+  Protocol::DataElementsCirc circ(track.size());
+  circ.insert(circ.end(), track.begin(), track.end());
+  TEST_EQUAL(Protocol::CreateDataPacket(circ, Protocol::PacketType::DataV2),
+             Protocol::CreateDataPacket(track, Protocol::PacketType::DataV2), ());
+}
+
+UNIT_TEST(Protocol_DataV2_Size)
+{
+  auto const track = MakeTrack(60 /* size */, 1500000000 /* startTimestamp */);
+  auto const packetV1 = Protocol::CreateDataPacket(track, Protocol::PacketType::DataV1);
+  auto const packetV2 = Protocol::CreateDataPacket(track, Protocol::PacketType::DataV2);
+  LOG(LINFO, ("DataV1:", packetV1.size(), "bytes, DataV2:", packetV2.size(), "bytes"));
+  TEST_LESS(packetV2.size() * 2, packetV1.size(), ());
+
+  // Traffic of the points is restored.
+  auto const payload =
+      vector<uint8_t>(begin(packetV2) + sizeof(uint32_t /* header */), end(packetV2));
+  auto const result = Protocol::DecodeDataPacket(Protocol::PacketType::DataV2, payload);
+  TEST_EQUAL(result.size(), track.size(), ());
+  for (size_t i = 0; i < track.size(); ++i)
+    TEST_EQUAL(result[i].m_traffic, track[i].m_traffic, (i));
+}
+
+UNIT_TEST(Protocol_DecodeDataPackets)
+{
+  auto const track = MakeTrack(30 /* size */, 1500000000 /* startTimestamp */);
+  Protocol::DataElementsVec const first(track.begin(), track.begin() + 10);
+  Protocol::DataElementsVec const second(track.begin() + 10, track.end());
+
+  vector<uint8_t> stream = Protocol::CreateAuthPacket("ABC");
+  auto const append = [&stream](vector<uint8_t> const & packet) {
+    stream.insert(stream.end(), packet.begin(), packet.end());
+  };
+  append(Protocol::CreateDataPacket(first, Protocol::PacketType::DataV1));
+  append(Protocol::CreateDataPacket(second, Protocol::PacketType::DataV2));
+
+  // Packet with a broken payload.
+  auto broken = Protocol::CreateDataPacket(second, Protocol::PacketType::DataV2);
+  broken[sizeof(uint32_t /* header */)] = 0x7F;
+  append(broken);
+
+  append(Protocol::CreateDataPacket(second, Protocol::PacketType::DataV2));
+  size_t const complete = stream.size();
+  stream.resize(stream.size() - 3);
+
+  Protocol::DataElementsVec points;
+  vector<Protocol::DecodedPacket> packets;
+  size_t const decoded = Protocol::DecodeDataPackets(stream.data(), stream.size(), points, packets);
+
+  auto const lastPacketSize =
+      Protocol::CreateDataPacket(second, Protocol::PacketType::DataV2).size();
+  TEST_EQUAL(decoded, complete - lastPacketSize, ());
+  TEST_EQUAL(packets.size(), 4, ());
+
+  TEST_EQUAL(packets[0].m_type, Protocol::PacketType::AuthV0, ());
+  TEST(packets[0].m_isValid, ());
+  TEST_EQUAL(packets[0].m_pointsBegin, packets[0].m_pointsEnd, ());
+
+  TEST_EQUAL(packets[1].m_type, Protocol::PacketType::DataV1, ());
+  TEST(packets[1].m_isValid, ());
+  TEST_EQUAL(packets[1].m_pointsBegin, 0, ());
+  TEST_EQUAL(packets[1].m_pointsEnd, first.size(), ());
+
+  TEST_EQUAL(packets[2].m_type, Protocol::PacketType::DataV2, ());
+  TEST(packets[2].m_isValid, ());
+  TEST_EQUAL(packets[2].m_pointsBegin, first.size(), ());
+  TEST_EQUAL(packets[2].m_pointsEnd, track.size(), ());
+
+  TEST(!packets[3].m_isValid, ());
+  TEST_EQUAL(packets[3].m_pointsBegin, packets[3].m_pointsEnd, ());
+
+  TEST_EQUAL(points.size(), track.size(), ());
+  for (size_t i = 0; i < track.size(); ++i)
+  {
+    TEST_EQUAL(points[i].m_timestamp, track[i].m_timestamp, (i));
+    TEST(my::AlmostEqualAbs(points[i].m_latLon.lat, track[i].m_latLon.lat, 1e-5), (i));
+    TEST(my::AlmostEqualAbs(points[i].m_latLon.lon, track[i].m_latLon.lon, 1e-5), (i));
+  }
+}
+
+UNIT_TEST(Protocol_DecodeDataPackets_Throughput)
+{
+  size_t const kNumPackets = 5000;
+
+  auto const track = MakeTrack(20 /* size */, 1500000000 /* startTimestamp */);
+  vector<uint8_t> streamV1;
+  vector<uint8_t> streamV2;
+  for (size_t i = 0; i < kNumPackets; ++i)
+  {
+    auto const packetV1 = Protocol::CreateDataPacket(track, Protocol::PacketType::DataV1);
+    streamV1.insert(streamV1.end(), packetV1.begin(), packetV1.end());
+    auto const packetV2 = Protocol::CreateDataPacket(track, Protocol::PacketType::DataV2);
+    streamV2.insert(streamV2.end(), packetV2.begin(), packetV2.end());
+  }
+
+  // Decoding of packets one by one as it's done by the server now.
+  my::Timer timer;
+  size_t numPoints = 0;
+  for (size_t pos = 0; pos < streamV1.size();)
+  {
+    vector<uint8_t> header(streamV1.begin() + pos, streamV1.begin() + pos + sizeof(uint32_t));
+    auto const typeAndSize = Protocol::DecodeHeader(header);
+    pos += header.size();
+    vector<uint8_t> payload(streamV1.begin() + pos, streamV1.begin() + pos + typeAndSize.second);
+    pos += payload.size();
+    numPoints += Protocol::DecodeDataPacket(typeAndSize.first, payload).size();
+  }
+  double const singleSeconds = timer.ElapsedSeconds();
+  TEST_EQUAL(numPoints, kNumPackets * track.size(), ());
+
+  // The server reuses vectors, so the first pass only warms them up.
+  Protocol::DataElementsVec points;
+  vector<Protocol::DecodedPacket> packets;
+  TEST_EQUAL(Protocol::DecodeDataPackets(streamV2.data(), streamV2.size(), points, packets),
+             streamV2.size(), ());
+  points.clear();
+  packets.clear();
+
+  timer.Reset();
+  TEST_EQUAL(Protocol::DecodeDataPackets(streamV2.data(), streamV2.size(), points, packets),
+             streamV2.size(), ());
+  double const bulkSeconds = timer.ElapsedSeconds();
+  TEST_EQUAL(packets.size(), kNumPackets, ());
+  TEST_EQUAL(points.size(), kNumPackets * track.size(), ());
+
+  LOG(LINFO, ("Decoding of", kNumPackets, "packets: DecodeDataPacket", singleSeconds,
+              "seconds,", streamV1.size(), "bytes; DecodeDataPackets", bulkSeconds, "seconds,",
+              streamV2.size(), "bytes"));
 }
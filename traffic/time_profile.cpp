@@ -0,0 +1,29 @@
+#include "traffic/time_profile.hpp"
+
+namespace traffic
+{
+// static
+uint32_t constexpr TimeProfile::kSecondsInDay;
+uint32_t constexpr TimeProfile::kBucketSeconds;
+size_t constexpr TimeProfile::kBucketsCount;
+
+// static
+size_t TimeProfile::GetBucket(uint32_t timeOfDaySec)
+{
+  return (timeOfDaySec % kSecondsInDay) / kBucketSeconds;
+}
+
+void TimeProfile::Set(TrafficInfo::RoadSegmentId const & id, Buckets const & buckets)
+{
+  m_profiles[id] = buckets;
+}
+
+SpeedGroup TimeProfile::GetSpeedGroup(TrafficInfo::RoadSegmentId const & id,
+                                      uint32_t timeOfDaySec) const
+{
+  auto const it = m_profiles.find(id);
+  if (it == m_profiles.cend())
+    return SpeedGroup::Unknown;
+  return it->second[GetBucket(timeOfDaySec)];
+}
+}  // namespace traffic
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "traffic/speed_groups.hpp"
+#include "traffic/traffic_info.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+namespace traffic
+{
+// Typical speed groups of road segments of one mwm by time of day.
+// A day is split into buckets of equal length, every segment of the profile
+// has a speed group for every bucket.
+class TimeProfile
+{
+public:
+  static uint32_t constexpr kSecondsInDay = 24 * 60 * 60;
+  static uint32_t constexpr kBucketSeconds = 15 * 60;
+  static size_t constexpr kBucketsCount = kSecondsInDay / kBucketSeconds;
+
+  using Buckets = std::array<SpeedGroup, kBucketsCount>;
+
+  // Returns the bucket of the time which is |timeOfDaySec| seconds since midnight.
+  // Times outside of a day are wrapped around.
+  static size_t GetBucket(uint32_t timeOfDaySec);
+
+  void Set(TrafficInfo::RoadSegmentId const & id, Buckets const & buckets);
+
+  // Returns speed group of the segment at |timeOfDaySec| seconds since midnight
+  // or SpeedGroup::Unknown if there is no profile for the segment.
+  SpeedGroup GetSpeedGroup(TrafficInfo::RoadSegmentId const & id, uint32_t timeOfDaySec) const;
+
+  size_t GetSize() const { return m_profiles.size(); }
+  bool IsEmpty() const { return m_profiles.empty(); }
+
+private:
+  std::map<TrafficInfo::RoadSegmentId, Buckets> m_profiles;
+};
+}  // namespace traffic
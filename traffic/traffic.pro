@@ -8,10 +8,12 @@ include($$ROOT_DIR/common.pri)
 
 SOURCES += \
     speed_groups.cpp \
+    time_profile.cpp \
     traffic_cache.cpp \
     traffic_info.cpp \
 
 HEADERS += \
     speed_groups.hpp \
+    time_profile.hpp \
     traffic_cache.hpp \
     traffic_info.hpp \
@@ -1,30 +1,85 @@
 #include "traffic/traffic_cache.hpp"
 
+#include "base/assert.hpp"
+
 namespace traffic
 {
 using namespace std;
 
+TrafficCache::TrafficCache() : m_snapshot(make_shared<TrafficSnapshot>()) {}
+
 void TrafficCache::Set(MwmSet::MwmId const & mwmId, TrafficInfo::Coloring && coloring)
 {
-  m_trafficColoring[mwmId] = make_shared<TrafficInfo::Coloring>(move(coloring));
+  auto snapshot = MakeNextSnapshot();
+  snapshot->m_colorings[mwmId] = make_shared<TrafficInfo::Coloring>(move(coloring));
+  m_snapshot = move(snapshot);
+}
+
+void TrafficCache::ApplyDelta(MwmSet::MwmId const & mwmId, TrafficInfo::Coloring const & delta)
+{
+  if (delta.empty())
+    return;
+
+  auto snapshot = MakeNextSnapshot();
+  auto & coloring = snapshot->m_colorings[mwmId];
+  coloring = coloring ? make_shared<TrafficInfo::Coloring>(*coloring)
+                      : make_shared<TrafficInfo::Coloring>();
+
+  for (auto const & kv : delta)
+  {
+    if (kv.second == SpeedGroup::Unknown)
+      coloring->erase(kv.first);
+    else
+      (*coloring)[kv.first] = kv.second;
+  }
+
+  if (coloring->empty())
+    snapshot->m_colorings.erase(mwmId);
+  m_snapshot = move(snapshot);
+}
+
+void TrafficCache::SetTimeProfile(MwmSet::MwmId const & mwmId,
+                                  shared_ptr<TimeProfile const> profile)
+{
+  auto snapshot = MakeNextSnapshot();
+  if (profile && !profile->IsEmpty())
+    snapshot->m_timeProfiles[mwmId] = move(profile);
+  else
+    snapshot->m_timeProfiles.erase(mwmId);
+  m_snapshot = move(snapshot);
 }
 
-void TrafficCache::Remove(MwmSet::MwmId const & mwmId) { m_trafficColoring.erase(mwmId); }
+void TrafficCache::Remove(MwmSet::MwmId const & mwmId)
+{
+  auto snapshot = MakeNextSnapshot();
+  snapshot->m_colorings.erase(mwmId);
+  m_snapshot = move(snapshot);
+}
 
 shared_ptr<TrafficInfo::Coloring> TrafficCache::GetTrafficInfo(MwmSet::MwmId const & mwmId) const
 {
-  auto it = m_trafficColoring.find(mwmId);
+  auto const & colorings = m_snapshot->m_colorings;
+  auto it = colorings.find(mwmId);
 
-  if (it == m_trafficColoring.cend())
+  if (it == colorings.cend())
     return shared_ptr<TrafficInfo::Coloring>();
   return it->second;
 }
 
-void TrafficCache::CopyTraffic(
-    map<MwmSet::MwmId, shared_ptr<traffic::TrafficInfo::Coloring>> & trafficColoring) const
+shared_ptr<TrafficSnapshot const> TrafficCache::GetSnapshot() const { return m_snapshot; }
+
+void TrafficCache::Clear()
 {
-  trafficColoring = m_trafficColoring;
+  auto snapshot = MakeNextSnapshot();
+  snapshot->m_colorings.clear();
+  m_snapshot = move(snapshot);
 }
 
-void TrafficCache::Clear() { m_trafficColoring.clear(); }
+shared_ptr<TrafficSnapshot> TrafficCache::MakeNextSnapshot() const
+{
+  ASSERT(m_snapshot, ());
+  auto snapshot = make_shared<TrafficSnapshot>(*m_snapshot);
+  ++snapshot->m_version;
+  return snapshot;
+}
 }  // namespace traffic
@@ -1,32 +1,58 @@
 #pragma once
 
+#include "traffic/time_profile.hpp"
 #include "traffic/traffic_info.hpp"
 
 #include "indexer/mwm_set.hpp"
 
+#include <cstdint>
 #include <map>
 #include <memory>
 
 namespace traffic
 {
+// Immutable state of traffic in all mwms. Every update of TrafficCache publishes
+// a new snapshot and leaves the previous ones untouched, so a router may hold
+// a snapshot while building a route without locks and copying of colorings.
+// Colorings and time profiles of mwms which are not changed by an update
+// are shared between the snapshots.
+struct TrafficSnapshot
+{
+  using Colorings = std::map<MwmSet::MwmId, std::shared_ptr<TrafficInfo::Coloring>>;
+  using TimeProfiles = std::map<MwmSet::MwmId, std::shared_ptr<TimeProfile const>>;
+
+  // Incremented on every update of the cache.
+  uint64_t m_version = 0;
+  // Colorings must not be modified after the snapshot is published.
+  Colorings m_colorings;
+  TimeProfiles m_timeProfiles;
+};
+
 class TrafficCache
 {
 public:
-  TrafficCache() : m_trafficColoring() {}
+  TrafficCache();
   virtual ~TrafficCache() = default;
 
   virtual shared_ptr<traffic::TrafficInfo::Coloring> GetTrafficInfo(
       MwmSet::MwmId const & mwmId) const;
-  virtual void CopyTraffic(
-      std::map<MwmSet::MwmId, std::shared_ptr<traffic::TrafficInfo::Coloring>> & trafficColoring)
-      const;
+  // Returns the current snapshot, never null.
+  virtual std::shared_ptr<TrafficSnapshot const> GetSnapshot() const;
 
 protected:
   void Set(MwmSet::MwmId const & mwmId, TrafficInfo::Coloring && mwmIdAndColoring);
+  // Applies per-segment changes |delta| to the coloring of the mwm. SpeedGroup::Unknown
+  // in |delta| removes the segment from the coloring. Only the coloring of |mwmId| is copied.
+  void ApplyDelta(MwmSet::MwmId const & mwmId, TrafficInfo::Coloring const & delta);
+  void SetTimeProfile(MwmSet::MwmId const & mwmId, std::shared_ptr<TimeProfile const> profile);
+  // Remove() and Clear() drop current colorings only, time profiles are kept.
   void Remove(MwmSet::MwmId const & mwmId);
   void Clear();
 
 private:
-  std::map<MwmSet::MwmId, std::shared_ptr<traffic::TrafficInfo::Coloring>> m_trafficColoring;
+  // Returns a copy of the current snapshot with the incremented version.
+  std::shared_ptr<TrafficSnapshot> MakeNextSnapshot() const;
+
+  std::shared_ptr<TrafficSnapshot const> m_snapshot;
 };
 }  // namespace traffic
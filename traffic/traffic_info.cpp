@@ -228,6 +228,38 @@ void TrafficInfo::CombineColorings(vector<TrafficInfo::RoadSegmentId> const & ke
   ASSERT_EQUAL(numUnexpectedKeys, 0, ());
 }
 
+// static
+void TrafficInfo::GetColoringDelta(TrafficInfo::Coloring const & from,
+                                   TrafficInfo::Coloring const & to,
+                                   TrafficInfo::Coloring & delta)
+{
+  delta.clear();
+  auto itFrom = from.cbegin();
+  auto itTo = to.cbegin();
+  while (itFrom != from.cend() || itTo != to.cend())
+  {
+    if (itTo == to.cend() || (itFrom != from.cend() && itFrom->first < itTo->first))
+    {
+      if (itFrom->second != SpeedGroup::Unknown)
+        delta.emplace_hint(delta.end(), itFrom->first, SpeedGroup::Unknown);
+      ++itFrom;
+    }
+    else if (itFrom == from.cend() || itTo->first < itFrom->first)
+    {
+      if (itTo->second != SpeedGroup::Unknown)
+        delta.emplace_hint(delta.end(), itTo->first, itTo->second);
+      ++itTo;
+    }
+    else
+    {
+      if (itFrom->second != itTo->second)
+        delta.emplace_hint(delta.end(), itTo->first, itTo->second);
+      ++itFrom;
+      ++itTo;
+    }
+  }
+}
+
 // static
 void TrafficInfo::SerializeTrafficKeys(vector<RoadSegmentId> const & keys, vector<uint8_t> & result)
 {
@@ -108,6 +108,12 @@ public:
                                TrafficInfo::Coloring const & knownColors,
                                TrafficInfo::Coloring & result);
 
+  // Fills |delta| with the segments which differ in |from| and |to|, so that applying
+  // |delta| to |from| gives |to|. Segments which are missing in |to| get SpeedGroup::Unknown.
+  // Missing segments and segments with SpeedGroup::Unknown are treated as equal.
+  static void GetColoringDelta(TrafficInfo::Coloring const & from,
+                               TrafficInfo::Coloring const & to, TrafficInfo::Coloring & delta);
+
   // Serializes the keys of the coloring map to |result|.
   // The keys are road segments ids which do not change during
   // an mwm's lifetime so there's no point in downloading them every time.
@@ -167,6 +173,10 @@ public:
   virtual void OnTrafficInfoClear() = 0;
   virtual void OnTrafficInfoAdded(traffic::TrafficInfo && info) = 0;
   virtual void OnTrafficInfoRemoved(MwmSet::MwmId const & mwmId) = 0;
+  // |delta| contains changed segments of the mwm only, segments with
+  // SpeedGroup::Unknown are removed from the current traffic.
+  virtual void OnTrafficInfoUpdated(MwmSet::MwmId const & mwmId,
+                                    TrafficInfo::Coloring && delta) = 0;
 };
 
 string DebugPrint(TrafficInfo::RoadSegmentId const & id);
@@ -0,0 +1,99 @@
+#include "testing/testing.hpp"
+
+#include "traffic/speed_groups.hpp"
+#include "traffic/time_profile.hpp"
+#include "traffic/traffic_cache.hpp"
+#include "traffic/traffic_info.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include <memory>
+#include <utility>
+
+using namespace std;
+using namespace traffic;
+
+namespace
+{
+class TestTrafficCache : public TrafficCache
+{
+public:
+  using TrafficCache::ApplyDelta;
+  using TrafficCache::Clear;
+  using TrafficCache::Remove;
+  using TrafficCache::Set;
+  using TrafficCache::SetTimeProfile;
+};
+
+TrafficInfo::RoadSegmentId const kSegment0(0 /* fid */, 0 /* idx */,
+                                           TrafficInfo::RoadSegmentId::kForwardDirection);
+TrafficInfo::RoadSegmentId const kSegment1(1 /* fid */, 0 /* idx */,
+                                           TrafficInfo::RoadSegmentId::kForwardDirection);
+
+UNIT_TEST(TrafficCache_Snapshots)
+{
+  TestTrafficCache cache;
+  MwmSet::MwmId const mwmId;
+
+  auto const empty = cache.GetSnapshot();
+  TEST(empty, ());
+  TEST(empty->m_colorings.empty(), ());
+
+  cache.Set(mwmId, TrafficInfo::Coloring({{kSegment0, SpeedGroup::G1}}));
+  auto const first = cache.GetSnapshot();
+  TEST_GREATER(first->m_version, empty->m_version, ());
+  TEST(empty->m_colorings.empty(), ());
+  TEST_EQUAL(first->m_colorings.size(), 1, ());
+
+  cache.ApplyDelta(mwmId, {{kSegment0, SpeedGroup::Unknown}, {kSegment1, SpeedGroup::G3}});
+  auto const second = cache.GetSnapshot();
+  TEST_GREATER(second->m_version, first->m_version, ());
+
+  // The previous snapshot is not changed by the delta.
+  auto const & firstColoring = *first->m_colorings.at(mwmId);
+  TEST_EQUAL(firstColoring.size(), 1, ());
+  TEST_EQUAL(firstColoring.at(kSegment0), SpeedGroup::G1, ());
+
+  auto const & secondColoring = *second->m_colorings.at(mwmId);
+  TEST_EQUAL(secondColoring.size(), 1, ());
+  TEST_EQUAL(secondColoring.at(kSegment1), SpeedGroup::G3, ());
+
+  // A delta which removes all the segments removes the coloring of the mwm.
+  cache.ApplyDelta(mwmId, {{kSegment1, SpeedGroup::Unknown}});
+  TEST(cache.GetSnapshot()->m_colorings.empty(), ());
+
+  auto profile = make_shared<TimeProfile>();
+  TimeProfile::Buckets buckets;
+  buckets.fill(SpeedGroup::G5);
+  buckets[TimeProfile::GetBucket(8 * 60 * 60)] = SpeedGroup::G0;
+  profile->Set(kSegment0, buckets);
+  cache.SetTimeProfile(mwmId, profile);
+
+  // Time profiles are kept when the current traffic is cleared.
+  cache.Set(mwmId, TrafficInfo::Coloring({{kSegment0, SpeedGroup::G1}}));
+  cache.Clear();
+  auto const third = cache.GetSnapshot();
+  TEST(third->m_colorings.empty(), ());
+  TEST_EQUAL(third->m_timeProfiles.size(), 1, ());
+  TEST_EQUAL(second->m_colorings.size(), 1, ());
+
+  // An empty profile removes the time profile of the mwm.
+  cache.SetTimeProfile(mwmId, make_shared<TimeProfile>());
+  TEST(cache.GetSnapshot()->m_timeProfiles.empty(), ());
+}
+
+UNIT_TEST(TimeProfile_Smoke)
+{
+  TimeProfile profile;
+  TimeProfile::Buckets buckets;
+  buckets.fill(SpeedGroup::G5);
+  buckets[TimeProfile::GetBucket(8 * 60 * 60)] = SpeedGroup::G0;
+  profile.Set(kSegment0, buckets);
+
+  TEST_EQUAL(profile.GetSpeedGroup(kSegment0, 8 * 60 * 60 + 10), SpeedGroup::G0, ());
+  TEST_EQUAL(profile.GetSpeedGroup(kSegment0, 9 * 60 * 60), SpeedGroup::G5, ());
+  // Time of the next day is wrapped around.
+  TEST_EQUAL(profile.GetSpeedGroup(kSegment0, 32 * 60 * 60), SpeedGroup::G0, ());
+  TEST_EQUAL(profile.GetSpeedGroup(kSegment1, 8 * 60 * 60), SpeedGroup::Unknown, ());
+}
+}  // namespace
@@ -138,4 +138,25 @@ UNIT_TEST(TrafficInfo_UpdateTrafficData)
   for (size_t i = 0; i < keys.size(); ++i)
     TEST_EQUAL(info.GetSpeedGroup(keys[i]), values2[i], ());
 }
+
+UNIT_TEST(TrafficInfo_GetColoringDelta)
+{
+  TrafficInfo::RoadSegmentId const id0(0, 0, 0);
+  TrafficInfo::RoadSegmentId const id1(1, 0, 0);
+  TrafficInfo::RoadSegmentId const id2(1, 0, 1);
+  TrafficInfo::RoadSegmentId const id3(2, 0, 0);
+
+  TrafficInfo::Coloring const from = {
+      {id0, SpeedGroup::G1}, {id1, SpeedGroup::G2}, {id2, SpeedGroup::Unknown}};
+  TrafficInfo::Coloring const to = {
+      {id1, SpeedGroup::G2}, {id2, SpeedGroup::G3}, {id3, SpeedGroup::Unknown}};
+
+  TrafficInfo::Coloring delta;
+  TrafficInfo::GetColoringDelta(from, to, delta);
+  TrafficInfo::Coloring const expected = {{id0, SpeedGroup::Unknown}, {id2, SpeedGroup::G3}};
+  TEST_EQUAL(delta, expected, ());
+
+  TrafficInfo::GetColoringDelta(to, to, delta);
+  TEST(delta.empty(), ());
+}
 }  // namespace traffic
@@ -26,4 +26,5 @@ win*|linux* {
 
 SOURCES += \
     $$ROOT_DIR/testing/testingmain.cpp \
+    traffic_cache_test.cpp \
     traffic_info_test.cpp \
@@ -108,6 +108,7 @@ std::string DebugPrint(Version const & v)
   switch (v)
   {
   case Version::V0: return "Version 0";
+  case Version::V1: return "Version 1";
   }
 
   ASSERT(false, ("Unknown version", static_cast<uint64_t>(v)));
@@ -30,7 +30,10 @@ using UGCOffset = uint64_t;
 enum class Version : uint64_t
 {
   V0 = 0,
-  Latest = V0
+  // Texts are compressed by the SymbolTable codec instead of BWT, the rest of the layout
+  // is the same as in V0.
+  V1 = 1,
+  Latest = V1
 };
 
 class UGCSeriaizer
@@ -52,10 +55,12 @@ public:
     CollectTexts();
   }
 
+  // Versions other than the latest one are written to test backward compatibility.
   template <typename Sink>
-  void Serialize(Sink & sink)
+  void Serialize(Sink & sink, Version version = Version::Latest)
   {
-    WriteToSink(sink, Version::Latest);
+    ASSERT(version == Version::V0 || version == Version::V1, (version));
+    WriteToSink(sink, version);
 
     auto const startPos = sink.Pos();
 
@@ -74,7 +79,7 @@ public:
     SerializeIndex(sink, ugcOffsets);
 
     header.m_textsOffset = sink.Pos() - startPos;
-    SerializeTexts(sink);
+    SerializeTexts(sink, version);
 
     header.m_eosOffset = sink.Pos() - startPos;
     sink.Seek(startPos);
@@ -132,11 +137,14 @@ public:
       WriteToSink(sink, offset);
   }
 
-  // Serializes texts in a compressed storage with block access.
+  // Serializes texts in a compressed storage with block access. Texts are read
+  // one by one, so since V1 they are compressed individually for fast random access.
   template <typename Sink>
-  void SerializeTexts(Sink & sink)
+  void SerializeTexts(Sink & sink, Version version)
   {
-    coding::BlockedTextStorageWriter<Sink> writer(sink, 200000 /* blockSize */);
+    auto const codec = version == Version::V0 ? coding::BlockedTextStorageCodec::BWT
+                                              : coding::BlockedTextStorageCodec::SymbolTable;
+    coding::BlockedTextStorageWriter<Sink> writer(sink, 200000 /* blockSize */, codec);
     for (auto const & collection : m_texts)
     {
       for (auto const & text : collection)
@@ -173,7 +181,9 @@ public:
 
     switch (v)
     {
-    case Version::V0: return DeserializeV0(*subReader, index, ugc);
+    // The codec of texts is stored in the texts section, so V1 is read as V0.
+    case Version::V0:
+    case Version::V1: return DeserializeV0(*subReader, index, ugc);
     default: ASSERT(false, ("Cannot deserialize ugc for version", v));
     }
 
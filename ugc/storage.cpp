@@ -11,8 +11,16 @@
 #include "coding/file_reader.hpp"
 #include "coding/file_writer.hpp"
 #include "coding/internal/file_data.hpp"
+#include "coding/mmap_reader.hpp"
+#include "coding/read_write_utils.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/stl_add.hpp"
 
 #include <algorithm>
+#include <cstring>
+#include <future>
 #include <utility>
 
 #include "3party/jansson/myjansson.hpp"
@@ -26,16 +34,145 @@ namespace
 string const kIndexFileName = "index.json";
 string const kUGCUpdateFileName = "ugc.update.bin";
 string const kTmpFileExtension = ".tmp";
+string const kLegacyFileExtension = ".legacy";
+
+uint32_t const kLogMagic = 0x4C434755;  // "UGCL"
+uint32_t const kLogVersion = 1;
+// Magic and version.
+uint64_t const kLogHeaderSize = 2 * sizeof(uint32_t);
+
+// Every record of the log is: kind (uint8_t), size of the body (varuint) and the body.
+enum class RecordKind : uint8_t
+{
+  // Key of the feature and the serialized update.
+  Update = 0,
+  // All previous updates are synchronized, the body is empty.
+  Synchronized = 1
+};
 
 using Sink = MemWriter<vector<char>>;
+using BinarySink = MemWriter<vector<uint8_t>>;
 
 string GetUGCFilePath() { return my::JoinPath(GetPlatform().WritableDir(), kUGCUpdateFileName); }
 
 string GetIndexFilePath() { return my::JoinPath(GetPlatform().WritableDir(), kIndexFileName); }
 
-bool GetUGCFileSize(uint64_t & size)
+uint64_t DoubleToBits(double value)
+{
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+double BitsToDouble(uint64_t bits)
 {
-  return GetPlatform().GetFileSizeByName(kUGCUpdateFileName, size);
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+vector<uint8_t> MakeRecord(RecordKind kind, vector<uint8_t> const & body)
+{
+  vector<uint8_t> record;
+  BinarySink sink(record);
+  WriteToSink(sink, static_cast<uint8_t>(kind));
+  WriteVarUint(sink, static_cast<uint64_t>(body.size()));
+  sink.Write(body.data(), body.size());
+  return record;
+}
+
+vector<uint8_t> MakeUpdateRecord(Storage::UGCIndex const & index, UGCUpdate const & ugc)
+{
+  vector<uint8_t> body;
+  {
+    BinarySink sink(body);
+    WriteToSink(sink, DoubleToBits(index.m_mercator.x));
+    WriteToSink(sink, DoubleToBits(index.m_mercator.y));
+    WriteToSink(sink, index.m_type);
+    WriteToSink(sink, index.m_featureId);
+    WriteToSink(sink, index.m_dataVersion);
+    rw::Write(sink, index.m_mwmName);
+    Serialize(sink, ugc);
+  }
+  return MakeRecord(RecordKind::Update, body);
+}
+
+void WriteLogHeader(FileWriter & writer)
+{
+  WriteToSink(writer, kLogMagic);
+  WriteToSink(writer, kLogVersion);
+}
+
+bool IsLogHeaderValid(MmapReader const & data)
+{
+  if (data.Size() < kLogHeaderSize)
+    return false;
+
+  MemReader reader(data.Data(), kLogHeaderSize);
+  ReaderSource<MemReader> src(reader);
+  return ReadPrimitiveFromSource<uint32_t>(src) == kLogMagic &&
+         ReadPrimitiveFromSource<uint32_t>(src) == kLogVersion;
+}
+
+struct Record
+{
+  RecordKind m_kind = RecordKind::Update;
+  // Key of the feature with the offset of the record, for updates only.
+  Storage::UGCIndex m_index;
+  uint64_t m_payloadOffset = 0;
+  uint64_t m_payloadSize = 0;
+  // Offset of the next record.
+  uint64_t m_end = 0;
+};
+
+// Reads the record at |offset| of the log of |size| bytes.
+// Returns false if there is no complete record at |offset|.
+bool ReadRecord(uint8_t const * data, uint64_t size, uint64_t offset, Record & record)
+{
+  if (offset >= size)
+    return false;
+
+  try
+  {
+    MemReaderWithExceptions reader(data + offset, static_cast<size_t>(size - offset));
+    ReaderSource<MemReaderWithExceptions> src(reader);
+    auto const kind = ReadPrimitiveFromSource<uint8_t>(src);
+    auto const bodySize = ReadVarUint<uint64_t>(src);
+    uint64_t const bodyOffset = offset + src.Pos();
+    if (bodySize > size - bodyOffset)
+      return false;
+    record.m_end = bodyOffset + bodySize;
+
+    switch (static_cast<RecordKind>(kind))
+    {
+    case RecordKind::Synchronized:
+      record.m_kind = RecordKind::Synchronized;
+      return bodySize == 0;
+    case RecordKind::Update:
+    {
+      record.m_kind = RecordKind::Update;
+      MemReaderWithExceptions bodyReader(data + bodyOffset, static_cast<size_t>(bodySize));
+      ReaderSource<MemReaderWithExceptions> bodySrc(bodyReader);
+      auto & index = record.m_index;
+      index.m_mercator.x = BitsToDouble(ReadPrimitiveFromSource<uint64_t>(bodySrc));
+      index.m_mercator.y = BitsToDouble(ReadPrimitiveFromSource<uint64_t>(bodySrc));
+      index.m_type = ReadPrimitiveFromSource<uint32_t>(bodySrc);
+      index.m_featureId = ReadPrimitiveFromSource<uint32_t>(bodySrc);
+      index.m_dataVersion = ReadPrimitiveFromSource<int64_t>(bodySrc);
+      rw::Read(bodySrc, index.m_mwmName);
+      index.m_offset = offset;
+      index.m_deleted = false;
+      index.m_synchronized = false;
+      record.m_payloadOffset = bodyOffset + bodySrc.Pos();
+      record.m_payloadSize = bodySize - bodySrc.Pos();
+      return true;
+    }
+    }
+  }
+  catch (Reader::Exception const &)
+  {
+  }
+  return false;
 }
 
 void DeserializeUGCIndex(string const & jsonData, vector<Storage::UGCIndex> & res)
@@ -72,11 +209,15 @@ string SerializeUGCIndex(vector<Storage::UGCIndex> const & indexes)
 }
 }  // namespace
 
+// static
+size_t const Storage::kMinIndexesForCompaction = 100;
+
+Storage::Storage(Index const & index) : m_index(index) {}
+
+Storage::~Storage() { m_compactionThread.Shutdown(base::WorkerThread::Exit::SkipPending); }
+
 UGCUpdate Storage::GetUGCUpdate(FeatureID const & id) const
 {
-  if (m_UGCIndexes.empty())
-    return {};
-
   auto const feature = GetFeature(id);
   CHECK_EQUAL(feature->GetFeatureType(), feature::EGeomType::GEOM_POINT, ());
   auto const & mercator = feature->GetCenter();
@@ -84,34 +225,14 @@ UGCUpdate Storage::GetUGCUpdate(FeatureID const & id) const
   th.SortBySpec();
   auto const type = th.GetBestType();
 
-  auto const index = find_if(
-      m_UGCIndexes.begin(), m_UGCIndexes.end(), [type, &mercator](UGCIndex const & index) -> bool {
-        return type == index.m_type && mercator == index.m_mercator && !index.m_deleted;
-      });
-
-  if (index == m_UGCIndexes.end())
+  lock_guard<mutex> lock(m_mutex);
+  auto const it = m_keys.find(Key(type, mercator));
+  if (it == m_keys.end())
     return {};
 
-  auto const offset = index->m_offset;
-  auto const size = UGCSizeAtIndex(distance(m_UGCIndexes.begin(), index));
-  vector<uint8_t> buf;
-  buf.resize(size);
-  auto const ugcFilePath = GetUGCFilePath();
-  try
-  {
-    FileReader r(ugcFilePath);
-    r.Read(offset, buf.data(), size);
-  }
-  catch (FileReader::Exception const & exception)
-  {
-    LOG(LERROR, ("Exception while reading file:", ugcFilePath, "reason:", exception.Msg()));
-    return {};
-  }
-
-  MemReader r(buf.data(), buf.size());
-  NonOwningReaderSource source(r);
   UGCUpdate update;
-  Deserialize(source, update);
+  if (!ReadUpdate(m_UGCIndexes[it->second], update))
+    return {};
   return update;
 }
 
@@ -123,168 +244,404 @@ void Storage::SetUGCUpdate(FeatureID const & id, UGCUpdate const & ugc)
   feature::TypesHolder th(*feature);
   th.SortBySpec();
   auto const type = th.GetBestType();
-  for (auto & index : m_UGCIndexes)
-  {
-    if (type == index.m_type && mercator == index.m_mercator && !index.m_deleted)
-    {
-      index.m_deleted = true;
-      m_numberOfDeleted++;
-      break;
-    }
-  }
-  // TODO: Call Defragmentation().
 
   UGCIndex index;
-  uint64_t offset;
-  if (!GetUGCFileSize(offset))
-    offset = 0;
-
   index.m_mercator = mercator;
   index.m_type = type;
   index.m_mwmName = id.GetMwmName();
   index.m_dataVersion = id.GetMwmVersion();
   index.m_featureId = id.m_index;
-  index.m_offset = offset;
+  auto const record = MakeUpdateRecord(index, ugc);
+
+  lock_guard<mutex> lock(m_mutex);
+  index.m_offset = max(m_dataSize, kLogHeaderSize);
+  if (!Append(record))
+    return;
+  AddIndex(move(index));
+
+  if (!m_compactionScheduled && m_UGCIndexes.size() >= kMinIndexesForCompaction &&
+      NeedCompaction())
+  {
+    m_compactionScheduled = true;
+    m_compactionThread.Push([this] { Compact(); });
+  }
+}
+
+void Storage::Load()
+{
+  lock_guard<mutex> compactionLock(m_compactionMutex);
+  lock_guard<mutex> lock(m_mutex);
+  LoadImpl();
+}
+
+void Storage::LoadImpl()
+{
+  ResetIndex();
 
   auto const ugcFilePath = GetUGCFilePath();
+  uint64_t size = 0;
+  if (!my::GetFileSize(ugcFilePath, size) || size == 0)
+    return;
+
   try
   {
-    FileWriter w(ugcFilePath, FileWriter::Op::OP_APPEND);
-    Serialize(w, ugc);
-    m_UGCIndexes.emplace_back(move(index));
+    m_dataSize = size;
+    if (!IsLogHeaderValid(GetData()))
+    {
+      LOG(LWARNING, ("Unknown format of", ugcFilePath, "it's moved aside."));
+      ResetIndex();
+      my::RenameFileX(ugcFilePath, ugcFilePath + kLegacyFileExtension);
+      return;
+    }
   }
-  catch (FileWriter::Exception const & exception)
+  catch (Reader::Exception const & exception)
   {
-    LOG(LERROR, ("Exception while writing file:", ugcFilePath, "reason:", exception.Msg()));
+    LOG(LERROR, ("Exception while reading file:", ugcFilePath, "reason:", exception.Msg()));
+    ResetIndex();
     return;
   }
-}
 
-void Storage::Load()
-{
   string data;
   auto const indexFilePath = GetIndexFilePath();
+  vector<UGCIndex> checkpoint;
   try
   {
     FileReader r(indexFilePath);
     r.ReadAsString(data);
+    DeserializeUGCIndex(data, checkpoint);
   }
-  catch (FileReader::Exception const & exception)
+  catch (RootException const & exception)
   {
     LOG(LWARNING, ("Exception while reading file:", indexFilePath, "reason:", exception.Msg()));
-    return;
+    checkpoint.clear();
   }
 
-  DeserializeUGCIndex(data, m_UGCIndexes);
-  for (auto const & i : m_UGCIndexes)
+  uint64_t offset = kLogHeaderSize;
+  if (!checkpoint.empty() && !LoadCheckpoint(checkpoint, offset))
   {
-    if (i.m_deleted)
+    LOG(LWARNING, (indexFilePath, "doesn't match", ugcFilePath, "the index is rebuilt."));
+    ResetIndex();
+    m_dataSize = size;
+    offset = kLogHeaderSize;
+  }
+
+  Replay(offset);
+}
+
+void Storage::ResetIndex()
+{
+  m_UGCIndexes.clear();
+  m_keys.clear();
+  m_numberOfDeleted = 0;
+  m_data.reset();
+  m_dataSize = 0;
+}
+
+bool Storage::LoadCheckpoint(vector<UGCIndex> const & checkpoint, uint64_t & end)
+{
+  auto const & data = GetData();
+  end = kLogHeaderSize;
+  for (auto const & i : checkpoint)
+  {
+    Record record;
+    if (i.m_offset < end || !ReadRecord(data.Data(), m_dataSize, i.m_offset, record) ||
+        record.m_kind != RecordKind::Update || record.m_index.m_type != i.m_type ||
+        record.m_index.m_featureId != i.m_featureId ||
+        record.m_index.m_dataVersion != i.m_dataVersion ||
+        record.m_index.m_mwmName != i.m_mwmName)
+    {
+      return false;
+    }
+
+    // Keys are taken from the log, they are stored there exactly.
+    auto & index = record.m_index;
+    index.m_deleted = i.m_deleted;
+    index.m_synchronized = i.m_synchronized;
+    if (index.m_deleted)
+    {
       ++m_numberOfDeleted;
+    }
+    else if (!m_keys.emplace(Key(index.m_type, index.m_mercator), m_UGCIndexes.size()).second)
+    {
+      return false;
+    }
+
+    m_UGCIndexes.push_back(move(index));
+    end = record.m_end;
   }
+  return true;
+}
+
+void Storage::Replay(uint64_t offset)
+{
+  if (offset >= m_dataSize)
+    return;
+
+  auto const & data = GetData();
+  while (offset < m_dataSize)
+  {
+    Record record;
+    if (!ReadRecord(data.Data(), m_dataSize, offset, record))
+    {
+      LOG(LWARNING, ("Incomplete record at", offset, "of", GetUGCFilePath(), "the log is cut off."));
+      Truncate(offset);
+      return;
+    }
+
+    if (record.m_kind == RecordKind::Update)
+      AddIndex(move(record.m_index));
+    else
+      MarkAsSynchronized();
+    offset = record.m_end;
+  }
+}
+
+void Storage::AddIndex(UGCIndex && index)
+{
+  auto const position = m_UGCIndexes.size();
+  auto const it = m_keys.emplace(Key(index.m_type, index.m_mercator), position);
+  if (!it.second)
+  {
+    m_UGCIndexes[it.first->second].m_deleted = true;
+    ++m_numberOfDeleted;
+    it.first->second = position;
+  }
+  m_UGCIndexes.push_back(move(index));
+}
+
+void Storage::MarkAsSynchronized()
+{
+  for (auto & index : m_UGCIndexes)
+    index.m_synchronized = true;
+}
+
+bool Storage::Append(vector<uint8_t> const & record)
+{
+  auto const ugcFilePath = GetUGCFilePath();
+  try
+  {
+    FileWriter w(ugcFilePath, FileWriter::Op::OP_APPEND);
+    if (m_dataSize == 0)
+    {
+      WriteLogHeader(w);
+      m_dataSize = kLogHeaderSize;
+    }
+    w.Write(record.data(), record.size());
+  }
+  catch (FileWriter::Exception const & exception)
+  {
+    LOG(LERROR, ("Exception while writing file:", ugcFilePath, "reason:", exception.Msg()));
+    // A partially written record is cut off, so the next one is appended to the valid log.
+    Truncate(m_dataSize);
+    return false;
+  }
+
+  m_dataSize += record.size();
+  return true;
+}
+
+void Storage::Truncate(uint64_t size)
+{
+  m_data.reset();
+  auto const ugcFilePath = GetUGCFilePath();
+  try
+  {
+    FileWriter w(ugcFilePath, FileWriter::Op::OP_WRITE_EXISTING, true /* truncOnClose */);
+    w.Seek(size);
+  }
+  catch (FileWriter::Exception const & exception)
+  {
+    LOG(LERROR, ("Exception while truncating file:", ugcFilePath, "reason:", exception.Msg()));
+  }
+  m_dataSize = size;
+}
+
+MmapReader const & Storage::GetData() const
+{
+  CHECK_GREATER(m_dataSize, 0, ());
+  // The log is only appended between compactions, so the mapping is stale if the size differs.
+  if (!m_data || m_data->Size() != m_dataSize)
+  {
+    m_data.reset();
+    m_data = my::make_unique<MmapReader>(GetUGCFilePath());
+    CHECK_EQUAL(m_data->Size(), m_dataSize, ());
+  }
+  return *m_data;
+}
+
+bool Storage::ReadUpdate(UGCIndex const & index, UGCUpdate & update) const
+{
+  auto const ugcFilePath = GetUGCFilePath();
+  try
+  {
+    auto const & data = GetData();
+    Record record;
+    if (!ReadRecord(data.Data(), m_dataSize, index.m_offset, record) ||
+        record.m_kind != RecordKind::Update)
+    {
+      LOG(LERROR, ("Invalid record at", index.m_offset, "of", ugcFilePath));
+      return false;
+    }
+
+    MemReader r(data.Data() + record.m_payloadOffset, static_cast<size_t>(record.m_payloadSize));
+    NonOwningReaderSource source(r);
+    Deserialize(source, update);
+  }
+  catch (Reader::Exception const & exception)
+  {
+    LOG(LERROR, ("Exception while reading file:", ugcFilePath, "reason:", exception.Msg()));
+    return false;
+  }
+  return true;
 }
 
 void Storage::SaveIndex() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  SaveIndexImpl();
+}
+
+void Storage::SaveIndexImpl() const
 {
   if (m_UGCIndexes.empty())
     return;
 
+  // The index is replaced atomically, so a crash leaves either the old or the new checkpoint.
   auto const jsonData = SerializeUGCIndex(m_UGCIndexes);
   auto const indexFilePath = GetIndexFilePath();
+  auto const tmpIndexFilePath = indexFilePath + kTmpFileExtension;
   try
   {
-    FileWriter w(indexFilePath);
+    FileWriter w(tmpIndexFilePath);
     w.Write(jsonData.c_str(), jsonData.length());
   }
   catch (FileWriter::Exception const & exception)
   {
-    LOG(LERROR, ("Exception while writing file:", indexFilePath, "reason:", exception.Msg()));
+    LOG(LERROR, ("Exception while writing file:", tmpIndexFilePath, "reason:", exception.Msg()));
+    my::DeleteFileX(tmpIndexFilePath);
+    return;
+  }
+
+  if (!my::RenameFileX(tmpIndexFilePath, indexFilePath))
+  {
+    LOG(LERROR, ("Can't rename file:", tmpIndexFilePath, "to:", indexFilePath));
+    my::DeleteFileX(tmpIndexFilePath);
   }
 }
 
+bool Storage::NeedCompaction() const
+{
+  return m_numberOfDeleted != 0 && m_numberOfDeleted >= m_UGCIndexes.size() / 2;
+}
+
 void Storage::Defragmentation()
 {
-  auto const indexesSize = m_UGCIndexes.size();
-  if (m_numberOfDeleted < indexesSize / 2)
-    return;
+  {
+    lock_guard<mutex> lock(m_mutex);
+    if (!NeedCompaction())
+      return;
+  }
+  Compact();
+}
+
+void Storage::Compact()
+{
+  lock_guard<mutex> compactionLock(m_compactionMutex);
+
+  // Records before |snapshotSize| are not changed until the compaction is finished,
+  // so they are copied without blocking of other methods.
+  vector<UGCIndex> live;
+  uint64_t snapshotSize = 0;
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_compactionScheduled = false;
+    if (m_numberOfDeleted == 0)
+      return;
+
+    snapshotSize = m_dataSize;
+    live.reserve(m_UGCIndexes.size() - m_numberOfDeleted);
+    for (auto const & index : m_UGCIndexes)
+    {
+      if (!index.m_deleted)
+        live.push_back(index);
+    }
+  }
+
+  // Synchronized records precede the others, they are followed by a marker in the new log.
+  auto const numberOfSynchronized = static_cast<size_t>(
+      count_if(live.begin(), live.end(), [](UGCIndex const & i) { return i.m_synchronized; }));
+  auto const marker = MakeRecord(RecordKind::Synchronized, {});
 
   auto const ugcFilePath = GetUGCFilePath();
   auto const tmpUGCFilePath = ugcFilePath + kTmpFileExtension;
-
+  unique_lock<mutex> lock(m_mutex, defer_lock);
   try
   {
-    FileReader r(ugcFilePath);
-    FileWriter w(tmpUGCFilePath, FileWriter::Op::OP_APPEND);
-    uint64_t actualOffset = 0;
-    for (size_t i = 0; i < indexesSize; ++i)
+    FileWriter w(tmpUGCFilePath);
+    WriteLogHeader(w);
+    {
+      MmapReader data(ugcFilePath);
+      CHECK_GREATER_OR_EQUAL(data.Size(), snapshotSize, ());
+      for (size_t i = 0; i < live.size(); ++i)
+      {
+        Record record;
+        CHECK(ReadRecord(data.Data(), snapshotSize, live[i].m_offset, record), (live[i].m_offset));
+        w.Write(data.Data() + live[i].m_offset, record.m_end - live[i].m_offset);
+        if (i + 1 == numberOfSynchronized)
+          w.Write(marker.data(), marker.size());
+      }
+    }
+
+    // Records which were appended during the copying.
+    lock.lock();
+    if (m_dataSize > snapshotSize)
     {
-      auto & index = m_UGCIndexes[i];
-      if (index.m_deleted)
-        continue;
-
-      auto const offset = index.m_offset;
-      auto const size = UGCSizeAtIndex(i);
-      vector<uint8_t> buf;
-      buf.resize(size);
-      r.Read(offset, buf.data(), size);
-      w.Write(buf.data(), size);
-      index.m_offset = actualOffset;
-      actualOffset += size;
+      auto const & data = GetData();
+      w.Write(data.Data() + snapshotSize, m_dataSize - snapshotSize);
     }
   }
-  catch (FileReader::Exception const & exception)
+  catch (Reader::Exception const & exception)
   {
     LOG(LERROR, ("Exception while reading file:", ugcFilePath, "reason:", exception.Msg()));
+    my::DeleteFileX(tmpUGCFilePath);
     return;
   }
   catch (FileWriter::Exception const & exception)
   {
     LOG(LERROR, ("Exception while writing file:", tmpUGCFilePath, "reason:", exception.Msg()));
+    my::DeleteFileX(tmpUGCFilePath);
     return;
   }
 
-  m_UGCIndexes.erase(remove_if(m_UGCIndexes.begin(), m_UGCIndexes.end(),
-                               [](UGCIndex const & i) -> bool { return i.m_deleted; }), m_UGCIndexes.end());
-
-  CHECK(my::DeleteFileX(ugcFilePath), ());
-  CHECK(my::RenameFileX(tmpUGCFilePath, ugcFilePath), ());
+  m_data.reset();
+  if (!my::RenameFileX(tmpUGCFilePath, ugcFilePath))
+  {
+    LOG(LERROR, ("Can't rename file:", tmpUGCFilePath, "to:", ugcFilePath));
+    my::DeleteFileX(tmpUGCFilePath);
+    return;
+  }
 
-  m_numberOfDeleted = 0;
+  ResetIndex();
+  CHECK(my::GetFileSize(ugcFilePath, m_dataSize), ());
+  Replay(kLogHeaderSize);
+  SaveIndexImpl();
 }
 
 string Storage::GetUGCToSend() const
 {
+  lock_guard<mutex> lock(m_mutex);
   if (m_UGCIndexes.empty())
     return string();
 
   auto array = my::NewJSONArray();
-  auto const indexesSize = m_UGCIndexes.size();
-  auto const ugcFilePath = GetUGCFilePath();
-  FileReader r(ugcFilePath);
-  vector<uint8_t> buf;
-  for (size_t i = 0; i < indexesSize; ++i)
+  for (auto const & index : m_UGCIndexes)
   {
-    buf.clear();
-    auto const & index = m_UGCIndexes[i];
     if (index.m_synchronized)
       continue;
 
-    auto const offset = index.m_offset;
-    auto const bufSize = UGCSizeAtIndex(i);
-    buf.resize(bufSize);
-    try
-    {
-      r.Read(offset, buf.data(), bufSize);
-    }
-    catch (FileReader::Exception const & exception)
-    {
-      LOG(LERROR, ("Exception while reading file:", ugcFilePath, "reason:", exception.Msg()));
-      return string();
-    }
-
-    MemReader r(buf.data(), buf.size());
-    NonOwningReaderSource source(r);
     UGCUpdate update;
-    Deserialize(source, update);
+    if (!ReadUpdate(index, update))
+      return string();
 
     vector<char> data;
     {
@@ -315,41 +672,28 @@ string Storage::GetUGCToSend() const
 
 void Storage::MarkAllAsSynchronized()
 {
+  lock_guard<mutex> lock(m_mutex);
   if (m_UGCIndexes.empty())
     return;
 
-  size_t numberOfUnsynchronized = 0;
-  for (auto & index : m_UGCIndexes)
-  {
-    if (!index.m_synchronized)
-    {
-      index.m_synchronized = true;
-      numberOfUnsynchronized++;
-    }
-  }
+  auto const unsynchronized =
+      find_if(m_UGCIndexes.begin(), m_UGCIndexes.end(),
+              [](UGCIndex const & index) { return !index.m_synchronized; });
+  if (unsynchronized == m_UGCIndexes.end())
+    return;
 
-  if (numberOfUnsynchronized == 0)
+  if (!Append(MakeRecord(RecordKind::Synchronized, {})))
     return;
 
-  auto const indexPath = GetIndexFilePath();
-  my::DeleteFileX(indexPath);
-  SaveIndex();
+  MarkAsSynchronized();
+  SaveIndexImpl();
 }
 
-uint64_t Storage::UGCSizeAtIndex(size_t const indexPosition) const
+void Storage::WaitForCompactionForTesting()
 {
-  CHECK(!m_UGCIndexes.empty(), ());
-  auto const indexesSize = m_UGCIndexes.size();
-  CHECK_LESS(indexPosition, indexesSize, ());
-  auto const indexOffset = m_UGCIndexes[indexPosition].m_offset;
-  uint64_t nextOffset;
-  if (indexPosition == indexesSize - 1)
-    CHECK(GetUGCFileSize(nextOffset), ());
-  else
-    nextOffset = m_UGCIndexes[indexPosition + 1].m_offset;
-
-  CHECK_GREATER(nextOffset, indexOffset, ());
-  return nextOffset - indexOffset;
+  promise<void> done;
+  m_compactionThread.Push([&done] { done.set_value(); });
+  done.get_future().wait();
 }
 
 unique_ptr<FeatureType> Storage::GetFeature(FeatureID const & id) const
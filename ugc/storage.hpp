@@ -6,17 +6,38 @@
 
 #include "base/thread_checker.hpp"
 #include "base/visitor.hpp"
+#include "base/worker_thread.hpp"
 
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
 #include <vector>
 
 class Index;
 class FeatureType;
+class MmapReader;
 struct FeatureID;
 
 namespace ugc
 {
+// Storage of UGC updates which are made by the user.
+//
+// Updates are kept in an append-only log: every SetUGCUpdate() appends a record with
+// the key of the feature and the serialized update, MarkAllAsSynchronized() appends
+// a marker record. The log is memory-mapped for reading, the in-memory index of the log
+// maps keys of features to their latest records.
+//
+// The index file is a checkpoint of the log: it's written atomically and Load() replays
+// only records after the checkpoint. A checkpoint which doesn't match the log is ignored
+// and the whole log is replayed, an incomplete record at the end of the log is cut off.
+//
+// Records which are overwritten by newer updates are dropped by compaction which is
+// started on a background thread when they take at least a half of the log.
+//
+// *NOTE* All methods except testing ones are thread-safe.
 class Storage
 {
 public:
@@ -37,7 +58,11 @@ public:
     uint32_t m_featureId = 0;
   };
 
-  explicit Storage(Index const & index) : m_index(index) {}
+  // Minimal number of records in the log which triggers background compaction.
+  static size_t const kMinIndexesForCompaction;
+
+  explicit Storage(Index const & index);
+  ~Storage();
 
   UGCUpdate GetUGCUpdate(FeatureID const & id) const;
   void SetUGCUpdate(FeatureID const & id, UGCUpdate const & ugc);
@@ -51,12 +76,59 @@ public:
   std::vector<UGCIndex> const & GetIndexesForTesting() const { return m_UGCIndexes; }
   size_t GetNumberOfDeletedForTesting() const { return m_numberOfDeleted; }
 
+  // Waits until scheduled compaction is finished.
+  void WaitForCompactionForTesting();
+
 private:
-  uint64_t UGCSizeAtIndex(size_t const indexPosition) const;
+  struct Key
+  {
+    Key(uint32_t type, m2::PointD const & mercator) : m_type(type), m_mercator(mercator) {}
+
+    bool operator<(Key const & rhs) const
+    {
+      return std::tie(m_type, m_mercator.x, m_mercator.y) <
+             std::tie(rhs.m_type, rhs.m_mercator.x, rhs.m_mercator.y);
+    }
+
+    uint32_t m_type;
+    m2::PointD m_mercator;
+  };
+
+  void LoadImpl();
+  void SaveIndexImpl() const;
+  void ResetIndex();
+  // Builds the index of the log records which are listed in |checkpoint|, |end| is set to
+  // the end of the last of them. Returns false if the checkpoint doesn't match the log.
+  bool LoadCheckpoint(std::vector<UGCIndex> const & checkpoint, uint64_t & end);
+  // Applies records of the log in [|offset|, end of the log) to the index.
+  void Replay(uint64_t offset);
+  void AddIndex(UGCIndex && index);
+  void MarkAsSynchronized();
+
+  bool Append(std::vector<uint8_t> const & record);
+  void Truncate(uint64_t size);
+  // Returns the mapping of the whole log.
+  MmapReader const & GetData() const;
+  bool ReadUpdate(UGCIndex const & index, UGCUpdate & update) const;
+
+  bool NeedCompaction() const;
+  void Compact();
+
   std::unique_ptr<FeatureType> GetFeature(FeatureID const & id) const;
 
   Index const & m_index;
   std::vector<UGCIndex> m_UGCIndexes;
   size_t m_numberOfDeleted = 0;
+  // Positions of the latest records of features in |m_UGCIndexes|.
+  std::map<Key, size_t> m_keys;
+  uint64_t m_dataSize = 0;
+  mutable std::unique_ptr<MmapReader> m_data;
+  mutable std::mutex m_mutex;
+
+  // Serializes compactions, must be locked before |m_mutex|.
+  std::mutex m_compactionMutex;
+  bool m_compactionScheduled = false;
+  // Must be the last member, so the thread is joined before other members are destroyed.
+  base::WorkerThread m_compactionThread;
 };
 }  // namespace ugc
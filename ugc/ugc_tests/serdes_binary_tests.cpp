@@ -53,7 +53,7 @@ UNIT_TEST(TranslationKeys_Smoke)
   TEST_EQUAL(texts, serializer.GetTexts(), ());
 }
 
-UNIT_TEST(BinarySerDes_Smoke)
+void TestSerDes(Version version)
 {
   vector<uint8_t> buffer;
 
@@ -70,7 +70,13 @@ UNIT_TEST(BinarySerDes_Smoke)
     Sink sink(buffer);
     UGCSeriaizer ser(move(holder.m_ugcs));
     TEST_EQUAL(GetExpectedTranslationKeys(), ser.GetTranslationKeys(), ());
-    ser.Serialize(sink);
+    ser.Serialize(sink, version);
+  }
+
+  {
+    MemReader reader(buffer.data(), buffer.size());
+    NonOwningReaderSource source(reader);
+    TEST_EQUAL(ReadPrimitiveFromSource<Version>(source), version, ());
   }
 
   UGCDeserializer des;
@@ -103,4 +109,9 @@ UNIT_TEST(BinarySerDes_Smoke)
     TEST_EQUAL(ugc, expectedUGC2, ());
   }
 }
+
+UNIT_TEST(BinarySerDes_Smoke) { TestSerDes(Version::Latest); }
+
+// Sections of V0 with BWT compressed texts are still read.
+UNIT_TEST(BinarySerDes_V0) { TestSerDes(Version::V0); }
 }  // namespace
@@ -16,6 +16,7 @@
 #include "indexer/mwm_set.hpp"
 
 #include "coding/file_name_utils.hpp"
+#include "coding/file_writer.hpp"
 #include "coding/internal/file_data.hpp"
 
 #include "platform/local_country_file_utils.hpp"
@@ -39,10 +40,9 @@ bool DeleteIndexFile()
   return my::DeleteFileX(my::JoinPath(GetPlatform().WritableDir(), "index.json"));
 }
 
-bool DeleteUGCFile()
-{
-  return my::DeleteFileX(my::JoinPath(GetPlatform().WritableDir(), "ugc.update.bin"));
-}
+string GetUGCFilePath() { return my::JoinPath(GetPlatform().WritableDir(), "ugc.update.bin"); }
+
+bool DeleteUGCFile() { return my::DeleteFileX(GetUGCFilePath()); }
 }  // namespace
 
 namespace ugc_tests
@@ -204,6 +204,7 @@ UNIT_TEST(StorageTests_DuplicatesAndDefragmentationSmoke)
   TEST_EQUAL(storage.GetNumberOfDeletedForTesting(), 0, ());
   TEST_EQUAL(last, storage.GetUGCUpdate(cafeId), ());
   TEST_EQUAL(first, storage.GetUGCUpdate(railwayId), ());
+  TEST(DeleteIndexFile(), ());
   TEST(DeleteUGCFile(), ());
 }
 
@@ -259,3 +260,84 @@ UNIT_TEST(StorageTest_LoadIndex)
   TEST(DeleteIndexFile(), ());
   TEST(DeleteUGCFile(), ());
 }
+
+UNIT_TEST(StorageTest_RecoveryFromLog)
+{
+  auto & builder = MwmBuilder::Builder();
+  m2::PointD const cafePoint(1.0, 1.0);
+  m2::PointD const railwayPoint(2.0, 2.0);
+  builder.Build({TestCafe(cafePoint), TestRailway(railwayPoint)});
+  auto const cafeId = builder.FeatureIdForCafeAtPoint(cafePoint);
+  auto const railwayId = builder.FeatureIdForRailwayAtPoint(railwayPoint);
+  auto const first = MakeTestUGCUpdate(Time(chrono::hours(24 * 10)));
+  auto const second = MakeTestUGCUpdate(Time(chrono::hours(24 * 300)));
+
+  {
+    Storage storage(builder.GetIndex());
+    storage.Load();
+    storage.SetUGCUpdate(cafeId, first);
+    storage.SetUGCUpdate(railwayId, first);
+    storage.SaveIndex();
+    // The update is not in the saved index.
+    storage.SetUGCUpdate(cafeId, second);
+  }
+
+  {
+    // Incomplete record at the end of the log.
+    FileWriter w(GetUGCFilePath(), FileWriter::Op::OP_APPEND);
+    uint8_t const tail[] = {0, 0x80};
+    w.Write(tail, sizeof(tail));
+  }
+
+  Storage storage(builder.GetIndex());
+  storage.Load();
+  TEST_EQUAL(storage.GetIndexesForTesting().size(), 3, ());
+  TEST_EQUAL(storage.GetNumberOfDeletedForTesting(), 1, ());
+  TEST_EQUAL(second, storage.GetUGCUpdate(cafeId), ());
+  TEST_EQUAL(first, storage.GetUGCUpdate(railwayId), ());
+
+  storage.SetUGCUpdate(railwayId, second);
+  TEST_EQUAL(second, storage.GetUGCUpdate(railwayId), ());
+  TEST(DeleteIndexFile(), ());
+  TEST(DeleteUGCFile(), ());
+}
+
+UNIT_TEST(StorageTest_BackgroundCompaction)
+{
+  auto & builder = MwmBuilder::Builder();
+  m2::PointD const cafePoint(1.0, 1.0);
+  m2::PointD const railwayPoint(2.0, 2.0);
+  builder.Build({TestCafe(cafePoint), TestRailway(railwayPoint)});
+  auto const cafeId = builder.FeatureIdForCafeAtPoint(cafePoint);
+  auto const railwayId = builder.FeatureIdForRailwayAtPoint(railwayPoint);
+  auto const first = MakeTestUGCUpdate(Time(chrono::hours(24 * 10)));
+  auto const second = MakeTestUGCUpdate(Time(chrono::hours(24 * 300)));
+
+  {
+    Storage storage(builder.GetIndex());
+    storage.Load();
+    storage.SetUGCUpdate(railwayId, first);
+    storage.MarkAllAsSynchronized();
+    for (size_t i = 0; i < Storage::kMinIndexesForCompaction; ++i)
+      storage.SetUGCUpdate(cafeId, i % 2 == 0 ? first : second);
+
+    storage.WaitForCompactionForTesting();
+    TEST_LESS(storage.GetIndexesForTesting().size(), Storage::kMinIndexesForCompaction, ());
+    TEST_EQUAL(second, storage.GetUGCUpdate(cafeId), ());
+    TEST_EQUAL(first, storage.GetUGCUpdate(railwayId), ());
+    storage.SaveIndex();
+  }
+
+  Storage storage(builder.GetIndex());
+  storage.Load();
+  TEST_LESS(storage.GetIndexesForTesting().size(), Storage::kMinIndexesForCompaction, ());
+  TEST_EQUAL(second, storage.GetUGCUpdate(cafeId), ());
+  TEST_EQUAL(first, storage.GetUGCUpdate(railwayId), ());
+  storage.Defragmentation();
+  auto const & indexArray = storage.GetIndexesForTesting();
+  TEST_EQUAL(indexArray.size(), 2, ());
+  TEST(indexArray[0].m_synchronized, ());
+  TEST(!indexArray[1].m_synchronized, ());
+  TEST(DeleteIndexFile(), ());
+  TEST(DeleteUGCFile(), ());
+}